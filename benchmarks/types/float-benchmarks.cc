@@ -0,0 +1,124 @@
+#include <bit>
+#include <charconv>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include "types/Float.hh"
+#include "types/String.hh"
+#include "types/help/floating.hh"
+
+/// Creates the doubles of pseudo-random bits, skipping the infinities and NaNs, or of pseudo-random cents
+/// below a thousand, the bulk of the numbers in tables.
+std::vector<double> randomDoubles(const size_t count, const bool isShort) {
+  std::vector<double> values;
+  uint64_t state = 1;
+  while (values.size() < count) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    const auto value = isShort ? static_cast<double>(state >> 47) / 100 : std::bit_cast<double>(state);
+    if (value - value == 0) values.push_back(value);
+  }
+  return values;
+}
+
+/// Converts the doubles into their shortest text, one literal per entry.
+std::vector<std::string> randomLiterals(const size_t count, const bool isShort) {
+  std::vector<std::string> literals;
+  for (const double value : randomDoubles(count, isShort)) {
+    char characters[mamba::MaximalFloatReprSize];
+    literals.emplace_back(characters, mamba::formatShortestFloat(value, characters));
+  }
+  return literals;
+}
+
+/// Formats 1000 doubles, of random bits if state.range(0) is 0 or short ones otherwise.
+void formattingFloat(benchmark::State& state) {
+  const std::vector<double> values = randomDoubles(1000, state.range(0) != 0);
+  char characters[mamba::MaximalFloatReprSize];
+  for (auto _ : state) {
+    for (const double value : values) benchmark::DoNotOptimize(mamba::formatShortestFloat(value, characters));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * values.size()));
+}
+
+void formattingStandard(benchmark::State& state) {
+  const std::vector<double> values = randomDoubles(1000, state.range(0) != 0);
+  char characters[mamba::MaximalFloatReprSize];
+  for (auto _ : state) {
+    for (const double value : values) {
+      benchmark::DoNotOptimize(std::to_chars(characters, characters + sizeof(characters), value));
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * values.size()));
+}
+
+/// Formats 1000 doubles into strings with repr(), dropping them with their frame in every iteration.
+void reprFloat(benchmark::State& state) {
+  const std::vector<double> values = randomDoubles(1000, state.range(0) != 0);
+  mamba::split();
+  for (auto _ : state) {
+    mamba::split();
+    for (const double value : values) benchmark::DoNotOptimize(mamba::Float(value).repr());
+    mamba::untie();
+  }
+  mamba::untie();
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * values.size()));
+}
+
+/// Parses 1000 shortest literals, of random bits if state.range(0) is 0 or short ones otherwise.
+void parsingFloat(benchmark::State& state) {
+  const std::vector<std::string> literals = randomLiterals(1000, state.range(0) != 0);
+  double value;
+  for (auto _ : state) {
+    for (const std::string& literal : literals) {
+      benchmark::DoNotOptimize(mamba::parseFloat(literal.data(), literal.data() + literal.size(), value));
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * literals.size()));
+}
+
+void parsingStandard(benchmark::State& state) {
+  const std::vector<std::string> literals = randomLiterals(1000, state.range(0) != 0);
+  double value;
+  for (auto _ : state) {
+    for (const std::string& literal : literals) {
+      benchmark::DoNotOptimize(std::from_chars(literal.data(), literal.data() + literal.size(), value));
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * literals.size()));
+}
+
+BENCHMARK(formattingFloat)->Arg(0)->Arg(1);
+BENCHMARK(formattingStandard)->Arg(0)->Arg(1);
+BENCHMARK(reprFloat)->Arg(0)->Arg(1);
+BENCHMARK(parsingFloat)->Arg(0)->Arg(1);
+BENCHMARK(parsingStandard)->Arg(0)->Arg(1);
+
+BENCHMARK_MAIN();
+/*=============================================================================
+Run on (1 X 2100 MHz CPU)
+CPU Caches:
+  L1 Data 48 KiB (x1)
+  L1 Instruction 32 KiB (x1)
+  L2 Unified 2048 KiB (x1)
+  L3 Unified 307200 KiB (x1)
+-------------------------------------------------------------------------------
+Benchmark                     Time             CPU   Iterations UserCounters...
+-------------------------------------------------------------------------------
+formattingFloat/0         29044 ns        28741 ns        21839 items_per_second=34.7935M/s
+formattingFloat/1         44461 ns        43596 ns        18926 items_per_second=22.9381M/s
+formattingStandard/0      46137 ns        44877 ns        15204 items_per_second=22.2833M/s
+formattingStandard/1      76132 ns        74675 ns        10215 items_per_second=13.3913M/s
+reprFloat/0              150780 ns       148260 ns         4166 items_per_second=6.74489M/s
+reprFloat/1              176941 ns       174153 ns         4400 items_per_second=5.74207M/s
+parsingFloat/0            48949 ns        48533 ns        13914 items_per_second=20.6044M/s
+parsingFloat/1            26120 ns        25261 ns        26106 items_per_second=39.587M/s
+parsingStandard/0         40631 ns        40118 ns        16629 items_per_second=24.9266M/s
+parsingStandard/1         21057 ns        20893 ns        31799 items_per_second=47.8637M/s
+The standard library runs Ryu for formatting and the same Eisel-Lemire algorithm for parsing, without
+the underscores and the special values of Python literals. The host is shared, so the runs vary by 30%.
+=============================================================================*/
@@ -0,0 +1,417 @@
+#include <gmp.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include "types/Integer.hh"
+
+/// Creates the integer of the given number of pseudo-random cells, with the top bit set.
+mamba::Integer randomInteger(const size_t size, uint64_t state) {
+  mamba::GarbageCollected<uint32_t> cells = mamba::gather(size * sizeof(uint32_t),
+                                                          mamba::GarbageCollectionGeneration::Eden);
+  for (size_t index = 0; index < size; ++index) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    cells.destination[index] = static_cast<uint32_t>(state >> 32);
+  }
+  cells.destination[size - 1] |= 0x80000000;
+  return cells;
+}
+
+/// Creates the GMP integer of the given number of pseudo-random bits, with the top bit set.
+void randomMultiprecision(mpz_t value, const size_t size, gmp_randstate_t state) {
+  mpz_init(value);
+  mpz_urandomb(value, state, 32 * size);
+  mpz_setbit(value, 32 * size - 1);
+}
+
+/// Runs the binary operation of Integer on operands of state.range(0) cells, dropping the results of every
+/// iteration with the frame they were allocated in.
+template<typename Operation> void benchmarkIntegers(benchmark::State& state, Operation operation) {
+  mamba::split();
+  const size_t size = state.range(0);
+  const mamba::Integer left = randomInteger(size, 1), right = randomInteger(size, 2);
+  for (auto _ : state) {
+    mamba::split();
+    benchmark::DoNotOptimize(operation(left, right));
+    mamba::untie();
+  }
+  mamba::untie();
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size * sizeof(uint32_t)));
+}
+
+/// Runs the binary operation of GMP on operands of state.range(0) cells, as the baseline.
+template<typename Operation> void benchmarkMultiprecision(benchmark::State& state, Operation operation) {
+  const size_t size = state.range(0);
+  gmp_randstate_t random;
+  gmp_randinit_default(random);
+  mpz_t left, right, result;
+  randomMultiprecision(left, size, random);
+  randomMultiprecision(right, size, random);
+  mpz_init2(result, 32 * size + 64);
+  for (auto _ : state) {
+    operation(result, left, right);
+    benchmark::ClobberMemory();
+  }
+  mpz_clears(left, right, result, nullptr);
+  gmp_randclear(random);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size * sizeof(uint32_t)));
+}
+
+static void additionInteger(benchmark::State& state) {
+  benchmarkIntegers(state, [](const mamba::Integer& left, const mamba::Integer& right) { return left + right; });
+}
+
+static void additionGMP(benchmark::State& state) {
+  benchmarkMultiprecision(state, [](mpz_t result, const mpz_t left, const mpz_t right) { mpz_add(result, left, right); });
+}
+
+static void subtractionInteger(benchmark::State& state) {
+  benchmarkIntegers(state, [](const mamba::Integer& left, const mamba::Integer& right) { return left - right; });
+}
+
+static void subtractionGMP(benchmark::State& state) {
+  benchmarkMultiprecision(state, [](mpz_t result, const mpz_t left, const mpz_t right) { mpz_sub(result, left, right); });
+}
+
+static void exclusiveOrInteger(benchmark::State& state) {
+  benchmarkIntegers(state, [](const mamba::Integer& left, const mamba::Integer& right) { return left ^ right; });
+}
+
+static void exclusiveOrGMP(benchmark::State& state) {
+  benchmarkMultiprecision(state, [](mpz_t result, const mpz_t left, const mpz_t right) { mpz_xor(result, left, right); });
+}
+
+static void negativeConjunctionInteger(benchmark::State& state) {
+  benchmarkIntegers(state, [](const mamba::Integer& left, const mamba::Integer& right) {
+    return (mamba::Integer() - left) & right;
+  });
+}
+
+static void negativeConjunctionGMP(benchmark::State& state) {
+  benchmarkMultiprecision(state, [](mpz_t result, const mpz_t left, const mpz_t right) {
+    mpz_neg(result, left);
+    mpz_and(result, result, right);
+  });
+}
+
+static void leftShiftInteger(benchmark::State& state) {
+  benchmarkIntegers(state, [](const mamba::Integer& left, const mamba::Integer&) { return left << mamba::Integer(77); });
+}
+
+static void leftShiftGMP(benchmark::State& state) {
+  benchmarkMultiprecision(state, [](mpz_t result, const mpz_t left, const mpz_t) { mpz_mul_2exp(result, left, 77); });
+}
+
+static void rightShiftInteger(benchmark::State& state) {
+  benchmarkIntegers(state, [](const mamba::Integer& left, const mamba::Integer&) { return left >> mamba::Integer(77); });
+}
+
+static void rightShiftGMP(benchmark::State& state) {
+  benchmarkMultiprecision(state, [](mpz_t result, const mpz_t left, const mpz_t) { mpz_fdiv_q_2exp(result, left, 77); });
+}
+
+static void bitCountInteger(benchmark::State& state) {
+  benchmarkIntegers(state, [](const mamba::Integer& left, const mamba::Integer&) { return left.bit_count(); });
+}
+
+static void bitCountGMP(benchmark::State& state) {
+  benchmarkMultiprecision(state, [](mpz_t, const mpz_t left, const mpz_t) { benchmark::DoNotOptimize(mpz_popcount(left)); });
+}
+
+/// Divides an integer of 2 * state.range(0) cells by one of state.range(0) cells.
+static void divisionInteger(benchmark::State& state) {
+  mamba::split();
+  const size_t size = state.range(0);
+  const mamba::Integer dividend = randomInteger(2 * size, 1), divisor = randomInteger(size, 2);
+  for (auto _ : state) {
+    mamba::split();
+    benchmark::DoNotOptimize(dividend / divisor);
+    mamba::untie();
+  }
+  mamba::untie();
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * 2 * size * sizeof(uint32_t)));
+}
+
+static void divisionGMP(benchmark::State& state) {
+  const size_t size = state.range(0);
+  gmp_randstate_t random;
+  gmp_randinit_default(random);
+  mpz_t dividend, divisor, quotient;
+  randomMultiprecision(dividend, 2 * size, random);
+  randomMultiprecision(divisor, size, random);
+  mpz_init2(quotient, 32 * size + 64);
+  for (auto _ : state) {
+    mpz_fdiv_q(quotient, dividend, divisor);
+    benchmark::ClobberMemory();
+  }
+  mpz_clears(dividend, divisor, quotient, nullptr);
+  gmp_randclear(random);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * 2 * size * sizeof(uint32_t)));
+}
+
+static void divisionByCellInteger(benchmark::State& state) {
+  benchmarkIntegers(state, [](const mamba::Integer& left, const mamba::Integer&) { return left / size_t{1000000007}; });
+}
+
+static void divisionByCellGMP(benchmark::State& state) {
+  benchmarkMultiprecision(state, [](mpz_t result, const mpz_t left, const mpz_t) {
+    mpz_fdiv_q_ui(result, left, 1000000007);
+  });
+}
+
+/// Raises an integer of state.range(0) cells to an exponent of the same size modulo an odd modulus of that
+/// size, in constant time or not.
+template<bool IsConstantTime> void benchmarkModularPower(benchmark::State& state) {
+  mamba::split();
+  const size_t size = state.range(0);
+  const mamba::Integer base = randomInteger(size, 1), exponent = randomInteger(size, 2);
+  const mamba::Integer modulus = randomInteger(size, 3) | mamba::Integer(1);
+  for (auto _ : state) {
+    mamba::split();
+    if constexpr (IsConstantTime) benchmark::DoNotOptimize(base.powConstantTime(exponent, modulus));
+    else benchmark::DoNotOptimize(base.pow(exponent, modulus));
+    mamba::untie();
+  }
+  mamba::untie();
+}
+
+template<bool IsConstantTime> void benchmarkModularPowerGMP(benchmark::State& state) {
+  const size_t size = state.range(0);
+  gmp_randstate_t random;
+  gmp_randinit_default(random);
+  mpz_t base, exponent, modulus, result;
+  randomMultiprecision(base, size, random);
+  randomMultiprecision(exponent, size, random);
+  randomMultiprecision(modulus, size, random);
+  mpz_setbit(modulus, 0);
+  mpz_init(result);
+  for (auto _ : state) {
+    if constexpr (IsConstantTime) mpz_powm_sec(result, base, exponent, modulus);
+    else mpz_powm(result, base, exponent, modulus);
+    benchmark::ClobberMemory();
+  }
+  mpz_clears(base, exponent, modulus, result, nullptr);
+  gmp_randclear(random);
+}
+
+static void modularPowerInteger(benchmark::State& state) {
+  benchmarkModularPower<false>(state);
+}
+
+static void modularPowerGMP(benchmark::State& state) {
+  benchmarkModularPowerGMP<false>(state);
+}
+
+static void constantTimeModularPowerInteger(benchmark::State& state) {
+  benchmarkModularPower<true>(state);
+}
+
+static void constantTimeModularPowerGMP(benchmark::State& state) {
+  benchmarkModularPowerGMP<true>(state);
+}
+
+static void toBytesInteger(benchmark::State& state) {
+  benchmarkIntegers(state, [](const mamba::Integer& left, const mamba::Integer&) {
+    return left.to_bytes(left.bit_length() / 8 + 1);
+  });
+}
+
+static void toBytesGMP(benchmark::State& state) {
+  std::vector<uint8_t> bytes(4 * state.range(0) + 8);
+  benchmarkMultiprecision(state, [&bytes](mpz_t, const mpz_t left, const mpz_t) {
+    size_t count;
+    benchmark::DoNotOptimize(mpz_export(bytes.data(), &count, 1, 1, 1, 0, left));
+  });
+}
+
+static void fromBytesInteger(benchmark::State& state) {
+  mamba::split();
+  const size_t size = state.range(0);
+  const mamba::GarbageCollected<std::byte> bytes = randomInteger(size, 1).to_bytes(4 * size + 1);
+  for (auto _ : state) {
+    mamba::split();
+    benchmark::DoNotOptimize(mamba::Integer::from_bytes(bytes));
+    mamba::untie();
+  }
+  mamba::untie();
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size * sizeof(uint32_t)));
+}
+
+static void fromBytesGMP(benchmark::State& state) {
+  const size_t size = state.range(0);
+  std::vector<uint8_t> bytes(4 * size);
+  for (size_t index = 0; index < bytes.size(); ++index) bytes[index] = static_cast<uint8_t>(index * 131 + 7);
+  mpz_t result;
+  mpz_init2(result, 32 * size);
+  for (auto _ : state) {
+    mpz_import(result, bytes.size(), 1, 1, 1, 0, bytes.data());
+    benchmark::ClobberMemory();
+  }
+  mpz_clear(result);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size * sizeof(uint32_t)));
+}
+
+/// Packs state.range(0) integers of up to 63 bits into fields of 8 bytes and unpacks them again.
+static void packedBytesInteger(benchmark::State& state) {
+  mamba::split();
+  const size_t count = state.range(0);
+  std::vector<mamba::Integer> fields(count), unpacked(count);
+  for (size_t index = 0; index < count; ++index) {
+    fields[index] = mamba::Integer(static_cast<int>(index * 2654435761U)) * size_t{1 + index % 1000};
+  }
+  for (auto _ : state) {
+    mamba::split();
+    const mamba::GarbageCollected<std::byte> bytes = mamba::Integer::to_bytes(fields.data(), count, 8);
+    benchmark::DoNotOptimize(mamba::Integer::from_bytes(bytes, 8, unpacked.data()));
+    mamba::untie();
+  }
+  mamba::untie();
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+static void packedBytesGMP(benchmark::State& state) {
+  const size_t count = state.range(0);
+  std::vector<mpz_t> fields(count);
+  std::vector<uint8_t> bytes(8 * count);
+  for (size_t index = 0; index < count; ++index) {
+    mpz_init_set_ui(fields[index], static_cast<uint32_t>(index * 2654435761U));
+    mpz_mul_ui(fields[index], fields[index], 1 + index % 1000);
+  }
+  for (auto _ : state) {
+    for (size_t index = 0; index < count; ++index) {
+      std::fill_n(bytes.data() + 8 * index, 8, 0);
+      const size_t length = (mpz_sizeinbase(fields[index], 2) + 7) / 8;
+      mpz_export(bytes.data() + 8 * index + 8 - length, nullptr, 1, 1, 1, 0, fields[index]);
+    }
+    for (size_t index = 0; index < count; ++index) mpz_import(fields[index], 8, 1, 1, 1, 0, bytes.data() + 8 * index);
+    benchmark::ClobberMemory();
+  }
+  for (mpz_t& field : fields) mpz_clear(field);
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+BENCHMARK(additionInteger)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(additionGMP)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(subtractionInteger)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(subtractionGMP)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(exclusiveOrInteger)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(exclusiveOrGMP)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(negativeConjunctionInteger)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(negativeConjunctionGMP)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(leftShiftInteger)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(leftShiftGMP)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(rightShiftInteger)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(rightShiftGMP)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(bitCountInteger)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(bitCountGMP)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(divisionInteger)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(divisionGMP)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(divisionByCellInteger)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(divisionByCellGMP)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(modularPowerInteger)->Arg(8)->Arg(16)->Arg(32)->Arg(64)->Arg(96);
+BENCHMARK(modularPowerGMP)->Arg(8)->Arg(16)->Arg(32)->Arg(64)->Arg(96);
+BENCHMARK(constantTimeModularPowerInteger)->Arg(8)->Arg(64);
+BENCHMARK(constantTimeModularPowerGMP)->Arg(8)->Arg(64);
+BENCHMARK(toBytesInteger)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(toBytesGMP)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(fromBytesInteger)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(fromBytesGMP)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(packedBytesInteger)->Arg(1000);
+BENCHMARK(packedBytesGMP)->Arg(1000);
+
+BENCHMARK_MAIN();
+/*==========================================================================================
+Run on (1 X 2100 MHz CPU)
+CPU Caches:
+  L1 Data 48 KiB (x1)
+  L1 Instruction 32 KiB (x1)
+  L2 Unified 2048 KiB (x1)
+  L3 Unified 307200 KiB (x1)
+---------------------------------------------------------------------------
+Benchmark                                Time             CPU   Iterations
+---------------------------------------------------------------------------
+additionInteger/8                     47.1 ns         46.8 ns      6037407
+additionInteger/64                    66.5 ns         63.7 ns      4272280
+additionInteger/1024                   510 ns          509 ns       599557
+additionGMP/8                         11.3 ns         10.6 ns     25121601
+additionGMP/64                        24.2 ns         24.0 ns     17029946
+additionGMP/1024                       311 ns          306 ns       966580
+subtractionInteger/8                  49.5 ns         48.9 ns      5495798
+subtractionInteger/64                 59.5 ns         57.6 ns      4104975
+subtractionInteger/1024                403 ns          377 ns       848578
+subtractionGMP/8                      11.7 ns         11.6 ns     24703057
+subtractionGMP/64                     26.6 ns         26.1 ns     15227187
+subtractionGMP/1024                    307 ns          305 ns       894795
+exclusiveOrInteger/8                  42.4 ns         41.9 ns      6428836
+exclusiveOrInteger/64                 46.2 ns         45.5 ns      6122929
+exclusiveOrInteger/1024                156 ns          155 ns      1908919
+exclusiveOrGMP/8                      14.7 ns         14.6 ns     18793003
+exclusiveOrGMP/64                     25.0 ns         24.5 ns     11059527
+exclusiveOrGMP/1024                    259 ns          257 ns      1143178
+negativeConjunctionInteger/8           112 ns          110 ns      2028081
+negativeConjunctionInteger/64          188 ns          186 ns      1713945
+negativeConjunctionInteger/1024       1937 ns         1916 ns       143817
+negativeConjunctionGMP/8              20.1 ns         19.7 ns     10605795
+negativeConjunctionGMP/64             32.3 ns         32.2 ns      7003607
+negativeConjunctionGMP/1024            609 ns          604 ns       777970
+leftShiftInteger/8                    44.5 ns         44.0 ns      6043013
+leftShiftInteger/64                   54.3 ns         54.2 ns      5217894
+leftShiftInteger/1024                  241 ns          238 ns      1204412
+leftShiftGMP/8                        15.5 ns         15.3 ns     19096459
+leftShiftGMP/64                       45.9 ns         45.3 ns      6244938
+leftShiftGMP/1024                      612 ns          566 ns       479292
+rightShiftInteger/8                   41.6 ns         41.4 ns      6142304
+rightShiftInteger/64                  54.6 ns         53.1 ns      4919236
+rightShiftInteger/1024                 241 ns          238 ns      1253926
+rightShiftGMP/8                       9.62 ns         9.58 ns     23115910
+rightShiftGMP/64                      41.9 ns         41.6 ns      6481682
+rightShiftGMP/1024                     613 ns          603 ns       458661
+bitCountInteger/8                     53.6 ns         53.2 ns      5409245
+bitCountInteger/64                    37.8 ns         37.4 ns      7371186
+bitCountInteger/1024                   356 ns          351 ns       827923
+bitCountGMP/8                         5.49 ns         5.47 ns     49020911
+bitCountGMP/64                        40.1 ns         39.2 ns      7723621
+bitCountGMP/1024                       621 ns          616 ns       472187
+divisionInteger/8                      285 ns          283 ns      2499840
+divisionInteger/64                    8075 ns         8023 ns        88939
+divisionInteger/1024                793368 ns       788680 ns          865
+divisionGMP/8                          106 ns          104 ns      6801742
+divisionGMP/64                        1661 ns         1645 ns       426274
+divisionGMP/1024                    160262 ns       158484 ns         4404
+divisionByCellInteger/8                118 ns          117 ns      6105487
+divisionByCellInteger/64               372 ns          362 ns      1922336
+divisionByCellInteger/1024            5497 ns         5038 ns       134390
+divisionByCellGMP/8                   26.2 ns         25.3 ns     23570038
+divisionByCellGMP/64                   153 ns          152 ns      4714066
+divisionByCellGMP/1024                2446 ns         2389 ns       294959
+modularPowerInteger/8                   28468 ns        28155 ns        29008
+modularPowerInteger/16                 184199 ns       182426 ns         3742
+modularPowerInteger/32                1208015 ns      1156420 ns          644
+modularPowerInteger/64                8592288 ns      8460932 ns           85
+modularPowerInteger/96               26332501 ns     26143128 ns           28
+modularPowerGMP/8                       15791 ns        15327 ns        43888
+modularPowerGMP/16                      94457 ns        92990 ns         7528
+modularPowerGMP/32                     642840 ns       635684 ns         1145
+modularPowerGMP/64                    4643627 ns      4568789 ns          151
+modularPowerGMP/96                   13115375 ns     12956489 ns           56
+constantTimeModularPowerInteger/8       37683 ns        37254 ns        18556
+constantTimeModularPowerInteger/64    9519557 ns      9335211 ns           73
+constantTimeModularPowerGMP/8           19344 ns        19034 ns        36245
+constantTimeModularPowerGMP/64        5115615 ns      5074750 ns          139
+toBytesInteger/8              48.5 ns         47.9 ns     16594450 bytes_per_second=636.597M/s
+toBytesInteger/64             56.5 ns         55.8 ns     11690752 bytes_per_second=4.27002G/s
+toBytesInteger/1024            231 ns          229 ns      3625060 bytes_per_second=16.6857G/s
+toBytesGMP/8                   152 ns          148 ns      4474833 bytes_per_second=206.34M/s
+toBytesGMP/64                  732 ns          727 ns       895050 bytes_per_second=336.036M/s
+toBytesGMP/1024              13746 ns        13581 ns        58596 bytes_per_second=287.634M/s
+fromBytesInteger/8            30.5 ns         30.2 ns     20949423 bytes_per_second=1010.07M/s
+fromBytesInteger/64           36.2 ns         35.9 ns     18948551 bytes_per_second=6.64171G/s
+fromBytesInteger/1024          177 ns          169 ns      3167095 bytes_per_second=22.595G/s
+fromBytesGMP/8                98.0 ns         96.4 ns      8998209 bytes_per_second=316.707M/s
+fromBytesGMP/64                665 ns          660 ns      1028884 bytes_per_second=369.817M/s
+fromBytesGMP/1024            10129 ns        10014 ns        84968 bytes_per_second=390.071M/s
+packedBytesInteger/1000      28860 ns        28409 ns        24427 items_per_second=35.1997M/s
+packedBytesGMP/1000          61145 ns        60218 ns        12669 items_per_second=16.6064M/s
+The Integer runs include allocating the result and dropping its frame in every iteration.
+============================================================================================*/
@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+#include "context.hh"
+#include "types/Tuple.hh"
+
+/// The number of the tuples packed in a frame, which fits into the pool even if none of them is released.
+constexpr int PackCount = 1000;
+
+/// Packs the pairs returned by a function and unpacks them, releasing their blocks if state.range(0) is 1.
+void packingPairs(benchmark::State& state) {
+  const bool isReleasing = state.range(0) != 0;
+  for (auto _ : state) {
+    mamba::split();
+    int64_t sum = 0;
+    for (int index = 0; index < PackCount; ++index) {
+      mamba::Tuple pair{index, index + 1};
+      sum += pair[0] == pair[1] ? 1 : 0;
+      if (isReleasing) pair.release();
+    }
+    benchmark::DoNotOptimize(sum);
+    mamba::untie();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * PackCount));
+}
+
+/// Hashes a tuple of 8 elements, which computes the hash once and then reads it from the header.
+void hashingTuple(benchmark::State& state) {
+  mamba::split();
+  const mamba::Tuple tuple{1, 2.5, 3, 4, 5, 6, 7, 8};
+  for (auto _ : state) benchmark::DoNotOptimize(tuple.hash());
+  mamba::untie();
+}
+
+BENCHMARK(packingPairs)->Arg(0)->Arg(1);
+BENCHMARK(hashingTuple);
+
+BENCHMARK_MAIN();
+/*=============================================================================
+Run on (1 X 2100 MHz CPU)
+CPU Caches:
+  L1 Data 48 KiB (x1)
+  L1 Instruction 32 KiB (x1)
+  L2 Unified 2048 KiB (x1)
+  L3 Unified 307200 KiB (x1)
+-------------------------------------------------------------------------
+Benchmark               Time             CPU   Iterations UserCounters...
+-------------------------------------------------------------------------
+packingPairs/0      35129 ns        33584 ns        21191 items_per_second=29.7762M/s
+packingPairs/1      38438 ns        37827 ns        17063 items_per_second=26.4359M/s
+hashingTuple         3.14 ns         3.04 ns    225469429
+The medians of 5 repetitions. Bumping the top of the stack is already cheaper than taking a block from a
+freelist, so releasing the pairs costs a tenth more time, but the frame takes the single block of 64 bytes
+instead of 64 kilobytes, which spares the collections of the frames that pack many tuples. The host is
+shared, so the runs vary by 30%.
+=============================================================================*/
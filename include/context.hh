@@ -55,9 +55,16 @@ namespace mamba {
     HostDoesNotHaveEnoughMemoryToStart, HostRanOutOfMemory, AttemptToAllocateBeyondLargestSize,
     // Unicode errors
     ASCIIToUTF8ConversionFailure, UTF8ToUTF8ConversionFailure, UTF16ToUTF8ConversionFailure,
-    UTF32ToUTF8ConversionFailure,
+    UTF32ToUTF8ConversionFailure, UTF8ToASCIIConversionFailure,
     // Miscellaneous
-    IntegerToStringConversionLimitViolation,
+    IntegerToStringConversionLimitViolation, SubstringNotFound, CodePointOutOfRange, FillCharacterNotSingle,
+    InvalidTranslationTable, EmptyReplacementPattern, InvalidIntegerLiteral, NegativeShiftCount,
+    IntegerTooLarge, DivisionByZero, NegativeExponent, ZeroModulus,
+    NonInvertibleBase, NegativeToUnsigned, InvalidFloatLiteral, IndexOutOfRange, PopFromEmptyList, ItemNotFound,
+    UnorderableTypes, KeyNotFound, ByteOutOfRange, ReadOnlyBuffer, InvalidHexadecimalLiteral,
+    // String formatting
+    InvalidFormatString, FormatSpecifierMismatch, FormatArgumentNotFound, FormatArgumentCountMismatch,
+    FormatArgumentTypeMismatch,
   };
 
   /// Raises a built-in exception.
@@ -94,7 +101,8 @@ namespace mamba {
   /// Changes the maximum number of digits on integer-to-string conversion. By default, it
   /// is set to 4000 digits, and anything beyond it raises ValueError. This function is
   /// equivalent to sys.set_int_max_str_digits().
-  /// @param limit The new limit to assign the value to.
+  /// @param limit The new limit to assign the value to, or 0 to lift the limit, which is safe for
+  /// trusted input now that the conversions take O(M(n) log n) rather than quadratic time.
   void setIntegerToStringConversionLimit(size_t limit);
 
   /// Pushes a new frame into call stack. This function should be called every time when
@@ -101,9 +101,15 @@ namespace mamba {
   /// @return A summary of the garbage collection. Can be inspected tp gather telemetry information.
   GarbageCollectionSummary collect(GarbageCollectionGeneration level, size_t extraAvailableMemoryNextRound = 0);
 
+  /// Gives the small allocation back to the memory pool of the current thread, whose next gather of a size that
+  /// fits into it reuses the allocation rather than growing the current frame, or marks the larger allocations
+  /// as garbage.
+  /// @param target The garbage-collected object that nothing refers to any longer.
+  void recycle(const GarbageCollected<>& target) noexcept;
+
   /// Marks the specified memory region as unused that will make it available to be collected by a major GC phase.
   /// @param target The garbagage-collected object that must be marked for deletion.
-  void mark(GarbageCollected<>& target) noexcept;
+  void mark(const GarbageCollected<>& target) noexcept;
 
   /// Provides the hint that the current memory context should be split, meaning that the next allocations may
   /// be performed separately from the previous context. This method provides the caller with more granular and
@@ -106,6 +106,22 @@ namespace os {
      */
     void write(const mamba::Bytes& content);
 
+    /**
+     * Writes the viewed bytes to the file straight from their buffer, such as a slice
+     * of a larger bytes object or bytearray. Only available in "wb" mode.
+     * @param content The view of the bytes to write to the file.
+     */
+    void write(const mamba::MemoryView& content);
+
+    /**
+     * Reads the file into the viewed buffer without copying, up to the length of the view.
+     * Available in the "rb" mode.
+     * @note Raises: TypeError if the view is read-only.
+     * @param buffer The writable view of the bytes to fill, such as a bytearray or its slice.
+     * @return The number of bytes read, which is less than the length of the view at the end of the file.
+     */
+    size_t readinto(const mamba::MemoryView& buffer);
+
     /**
      * Writes multiple lines to the end of the file.
      * @param lines The enumerable (list, tuple, etc.) containing the lines to write.
@@ -2,9 +2,9 @@
   SyncFile:        Bytes.hh
 
   Summary:     Defines the sequence of byte types in Python: bytes and
-               bytearray.
+               bytearray, and the memoryview of their buffers.
 
-  Classes:     Bytes, Bytearray
+  Classes:     Bytes, Bytearray, MemoryView
 
   Functions:   None
 
@@ -12,10 +12,192 @@
 ===================================================================+*/
 #pragma once
 
+#include <cstddef>
+#include <string_view>
+#include <sys/types.h>
+
+#include "../givers/memory.hh"
+#include "Object.hh"
+#include "help/search.hh"
+
 namespace mamba {
+  class Bytes;
+  class Bytearray;
+  class String;
+
+  /// Represents the built-in memoryview type in Python, the buffer protocol of the byte sequences: a
+  /// contiguous range of the bytes of a bytes object, a bytearray or any other buffer, such as the one a
+  /// file is read into, which the view points to without copying it. Slicing the view gives the view of the
+  /// subrange, so that the parts of a large buffer are searched, compared, written and filled in place. The
+  /// views of bytes are read-only, while the views of bytearrays write through to them.
+  /// @note The view does not own the bytes, which must stay alive and in place for as long as it is used,
+  /// so the views of a bytearray go stale once the bytearray grows.
+  class MemoryView {
+   public:
+    /// Creates the empty view.
+    MemoryView() noexcept = default;
+
+    /// Views the bytes, read-only.
+    explicit(false) MemoryView(const Bytes& bytes) noexcept; //NOLINT
+
+    /// Views the bytearray, writing through to it.
+    explicit(false) MemoryView(Bytearray& bytes) noexcept; //NOLINT
+
+    /// Views the raw buffer.
+    /// @param data The pointer to the first byte of the buffer.
+    /// @param size The number of bytes in the buffer.
+    /// @param isReadOnly Whether writing through the view is forbidden.
+    MemoryView(std::byte* data, size_t size, bool isReadOnly) noexcept;
+
+    /// Gives the byte at the index as an integer, counting from the end if the index is negative, as in
+    /// view[index].
+    /// @return The byte, or None if the index is out of range, in which case IndexError is raised.
+    Object operator[](ssize_t index) const noexcept;
+
+    /// Compares the viewed bytes, as in view == other.
+    bool operator==(const MemoryView& other) const noexcept;
+
+    /// Writes the byte at the index, as in view[index] = value, raising TypeError if the view is read-only,
+    /// ValueError if the value is not in range(256) and IndexError if the index is out of range.
+    void set(ssize_t index, int value) const noexcept;
+
+    /// Views the bytes from the start up to the stop, excluding it, without copying them, as in
+    /// view[start:stop]. The bounds are clamped to the view and count from the end if they are negative.
+    [[nodiscard]] MemoryView slice(ssize_t start, ssize_t stop) const noexcept;
+
+    /// Finds the first occurrence of the subsequence, as in bytes.find(sub).
+    /// @return The index of the first byte of the occurrence, or -1 if there is none.
+    [[nodiscard]] ssize_t find(const Needle& needle) const noexcept;
+
+    /// Counts the non-overlapping occurrences of the subsequence, as in bytes.count(sub). The subsequences
+    /// of a single byte are counted by comparing 16 or 32 bytes at once.
+    [[nodiscard]] size_t count(const Needle& needle) const noexcept;
+
+    /// Encodes every byte into 2 lowercase hexadecimal digits, as in bytes.hex().
+    [[nodiscard]] String hex() const noexcept;
+
+    /// Copies the viewed bytes into the bytes object, as in view.tobytes().
+    [[nodiscard]] Bytes tobytes() const noexcept;
+
+    /// Tells how many bytes the view spans.
+    [[nodiscard]] size_t len() const noexcept;
+
+    /// Tells if writing through the view is forbidden, as in view.readonly.
+    [[nodiscard]] bool isReadOnly() const noexcept;
+
+    /// Gives the first viewed byte, which the readers fill and the writers consume.
+    [[nodiscard]] std::byte* data() const noexcept;
+
+   private:
+    std::byte* start = nullptr;
+    size_t size = 0;
+    bool readOnly = true;
+  };
+
+  /// Represents the built-in bytes type in Python, the immutable sequence of bytes. The bytes are held in a
+  /// block of the pool, which the copies of the object share, since they never change.
+  class Bytes {
+   public:
+    /// Creates the empty bytes, which hold no block.
+    Bytes() noexcept = default;
+
+    /// Copies the raw bytes, as in b"literal".
+    explicit Bytes(const std::string_view& bytes) noexcept;
+
+    /// Copies the viewed bytes, as in bytes(view).
+    explicit Bytes(const MemoryView& view) noexcept;
+
+    /// Decodes the pairs of hexadecimal digits into bytes, skipping the whitespace between the pairs, as in
+    /// bytes.fromhex(text).
+    /// @return The bytes, or the empty bytes if the text is not hexadecimal, in which case ValueError is raised.
+    static Bytes fromhex(const String& text) noexcept;
+
+    /// Gives the byte at the index as an integer, as in bytes[index].
+    Object operator[](ssize_t index) const noexcept;
+
+    bool operator==(const Bytes& other) const noexcept;
+
+    [[nodiscard]] ssize_t find(const Needle& needle) const noexcept;
+
+    [[nodiscard]] size_t count(const Needle& needle) const noexcept;
+
+    /// Tells if the bytes contain the subsequence, as in sub in bytes.
+    [[nodiscard]] bool contains(const Needle& needle) const noexcept;
+
+    [[nodiscard]] String hex() const noexcept;
+
+    [[nodiscard]] size_t len() const noexcept;
+
+   private:
+    GarbageCollected<std::byte> buffer;
+    size_t size = 0;
+
+    friend class MemoryView;
+  };
+
+  /// Represents the built-in bytearray type in Python, the mutable sequence of bytes, which grows by half of
+  /// its capacity whenever it fills up, like the list. Copying the bytearray copies its bytes.
+  class Bytearray {
+   public:
+    /// Creates the empty bytearray, which holds no block.
+    Bytearray() noexcept = default;
+
+    /// Creates the bytearray of the number of zero bytes, as in bytearray(size).
+    explicit Bytearray(size_t size) noexcept;
+
+    /// Copies the viewed bytes, as in bytearray(view).
+    explicit Bytearray(const MemoryView& view) noexcept;
+
+    Bytearray(const Bytearray& other) noexcept;
+    Bytearray(Bytearray&& other) noexcept;
+
+    Bytearray& operator=(const Bytearray& other) noexcept;
+    Bytearray& operator=(Bytearray&& other) noexcept;
+
+    /// Gives the byte at the index as an integer, as in bytearray[index].
+    Object operator[](ssize_t index) const noexcept;
+
+    bool operator==(const Bytearray& other) const noexcept;
+
+    /// Writes the byte at the index, as in bytearray[index] = value.
+    void set(ssize_t index, int value) noexcept;
+
+    /// Appends the byte, raising ValueError if the value is not in range(256), as in bytearray.append(value).
+    void append(int value) noexcept;
+
+    /// Appends the viewed bytes, as in bytearray.extend(view) or bytearray += view. The view may be of the
+    /// bytearray itself.
+    void extend(const MemoryView& view) noexcept;
+
+    /// Removes every byte, keeping the capacity, as in bytearray.clear().
+    void clear() noexcept;
+
+    /// Grows the capacity to hold the number of bytes without reallocating, such as before a file is read
+    /// into the bytearray.
+    void reserve(size_t required) noexcept;
+
+    [[nodiscard]] ssize_t find(const Needle& needle) const noexcept;
+
+    [[nodiscard]] size_t count(const Needle& needle) const noexcept;
+
+    [[nodiscard]] String hex() const noexcept;
+
+    [[nodiscard]] size_t len() const noexcept;
+
+    ~Bytearray() = default;
+
+   private:
+    GarbageCollected<std::byte> buffer;
+    size_t size = 0, capacity = 0;
 
-  class Bytes{};
+    /// Grows the capacity by half, or to the required number of bytes if it is larger, and raises
+    /// MemoryError if the pool is exhausted.
+    /// @return False if the pool is exhausted, in which case the bytearray is left as it was.
+    bool ensureCapacity(size_t required) noexcept;
 
+    /// Views the bytes of the const bytearray, which the view is only read through.
+    [[nodiscard]] MemoryView getView() const noexcept;
 
-  class Bytearray {};
+    friend class MemoryView;
+  };
 }
@@ -0,0 +1,81 @@
+/*+===================================================================
+  SyncFile:       ConstantTable.hh
+
+  Summary:    Compiles the constant frozenset and dict literals into
+              minimal perfect hash tables for the membership tests and
+              the lookups of the microcode.
+
+  Classes:    ConstantTable
+
+  Functions:  None
+
+  Available under Apache License v2. Mamba Authors (2024)
+===================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../givers/memory.hh"
+#include "Dictionary.hh"
+#include "List.hh"
+#include "Object.hh"
+#include "Sets.hh"
+
+namespace mamba {
+  /// Represents the constant set or dict literal of the code, such as the one of x in {"a", "b", "c"} or of
+  /// the dispatch tables indexed in the inner loops, whose keys are known before the code runs and never
+  /// change. The keys are compiled once into the minimal perfect hash table with the hash-and-displace
+  /// method, like the translation tables of str.translate(): the hashes of the keys are distributed into
+  /// buckets of about 2 keys, and the buckets, the largest first, get the displacements that move all of
+  /// their keys into the free slots, so that the table has exactly as many slots as keys. A lookup hashes
+  /// the key, reads the displacement of its bucket and compares the key with the only slot it may be in,
+  /// with no probing and no empty slots to step over. The keys whose hashes are equal to the hashes of the
+  /// other keys, such as -1 and -2 in CPython, cannot be told apart by any displacement, so they are kept
+  /// after the table and only compared when the slot holds the key of the same hash. The handle is
+  /// trivially copyable, and its copies share the table.
+  class ConstantTable {
+   public:
+    /// Creates the empty table.
+    ConstantTable() noexcept = default;
+
+    /// Compiles the set literal for the membership tests, as in element in frozenset.
+    explicit ConstantTable(const Frozenset& elements) noexcept;
+
+    /// Compiles the dict literal for the lookups, as in dictionary[key].
+    explicit ConstantTable(const Dictionary& items) noexcept;
+
+    /// Gives the value of the key, or None for the keys of a set literal, as in dictionary[key].
+    /// @return The value, or None if there is no such key, in which case KeyError is raised.
+    Object operator[](const Object& key) const noexcept;
+
+    /// Tells if the table has the key, as in key in literal.
+    [[nodiscard]] bool contains(const Object& key) const noexcept;
+
+    /// Gives the value of the key, or the fallback if there is no such key, as in dictionary.get(key).
+    [[nodiscard]] Object get(const Object& key, const Object& fallback = {}) const noexcept;
+
+    [[nodiscard]] size_t len() const noexcept;
+
+   private:
+    /// The slot of a key, caching its hash, which rejects most of the missing keys without comparing them.
+    struct Slot {
+      uint64_t hash;
+      Object key, value;
+    };
+
+    /// The slots of the perfect hash table followed by the keys sharing their hashes with other keys.
+    Slot* slots = nullptr;
+    /// The displacements of the buckets, which follow the slots in the same block.
+    uint32_t* displacements = nullptr;
+    size_t size = 0, slotCount = 0, bucketCount = 0, twinCount = 0;
+
+    /// Compiles the keys and their values, if there are any, into the table, raising MemoryError if the pool
+    /// is exhausted, in which case the table stays empty.
+    void build(const List& keys, const List& values) noexcept;
+
+    /// Finds the slot of the key with a single probe of the table.
+    /// @return The slot, or nullptr if there is no such key.
+    [[nodiscard]] const Slot* find(const Object& key) const noexcept;
+  };
+}
@@ -3,7 +3,7 @@
 
   Summary:    Defines the mappings and dictionary datatype in Python.
 
-  Classes:    Dictionary
+  Classes:    Dictionary, SharedKeys
 
   Functions:  None
 
@@ -11,7 +11,191 @@
 ===================================================================+*/
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
+#include "../givers/memory.hh"
+#include "List.hh"
+#include "Object.hh"
+
 namespace mamba {
+  class SharedKeys;
+
+  /// Represents the built-in dict type in Python, a hash table that remembers the order its keys were
+  /// inserted in. Like in CPython, the table is compact: the entries are appended to a dense array in the
+  /// order of insertion, and a sparse index of slots, sized to a power of 2, maps the hashes to the
+  /// positions of the entries, taking only 4 bytes per slot rather than a whole entry. The index is a
+  /// Swiss table, see probing.hh, which matches 16 slots at once by the tags of the hashes kept in their
+  /// control bytes, so that a lookup nearly always reads one cache line of the index and then the single
+  /// entry that matches. The entries cache the hashes of their keys, which decide the equality of most
+  /// mismatching keys and let the table be rebuilt without hashing the keys again. The removed entries are
+  /// left in the array as vacant markers, and the array is compacted whenever it fills up.
+  ///
+  /// The attribute dictionaries of the instances of a class can be split instead, as in CPython: their
+  /// keys are kept once per class in SharedKeys, and every instance only holds the array of its values,
+  /// in the order of the shared keys. An instance sets the shared keys in their order, and only the one
+  /// that holds all of them may add a key to the end, which the later instances then share too. Only the
+  /// string keys are shared. Setting the keys in another order, setting a key the others do not share or
+  /// that is not a string, or removing a key combines the dictionary of the instance into a table of its
+  /// own, with the hashes the shared keys cached.
+  class Dictionary {
+   public:
+    Dictionary() noexcept = default;
+
+    /// Creates the empty dictionary that shares the keys, such as the attribute dictionary of an instance
+    /// of the class holding the keys.
+    explicit Dictionary(SharedKeys& keys) noexcept;
+
+    /// Copies the entries into a table of their own, as in dict(other).
+    Dictionary(const Dictionary& other) noexcept;
+    Dictionary(Dictionary&& other) noexcept;
+
+    Dictionary& operator=(const Dictionary& other) noexcept;
+    Dictionary& operator=(Dictionary&& other) noexcept;
+
+    /// Gives the value of the key, as in dictionary[key].
+    /// @return The value, or None if there is no such key, in which case KeyError is raised.
+    Object operator[](const Object& key) const noexcept;
+
+    /// Compares the dictionaries by their items, regardless of their order, as in dictionary == other.
+    bool operator==(const Dictionary& other) const noexcept;
+
+    /// Gives the value of the key, or the fallback if there is no such key, as in dictionary.get(key).
+    [[nodiscard]] Object get(const Object& key, const Object& fallback = {}) const noexcept;
+
+    /// Sets the value of the key, adding the key after the others if it is new, as in dictionary[key] = value.
+    void set(const Object& key, const Object& value) noexcept;
+
+    /// Gives the value of the key, setting it to the fallback first if there is no such key.
+    Object setdefault(const Object& key, const Object& fallback = {}) noexcept;
+
+    /// Removes the key and gives back its value, as in dictionary.pop(key).
+    /// @return The value, or None if there is no such key, in which case KeyError is raised.
+    Object pop(const Object& key) noexcept;
+
+    /// Removes the key, raising KeyError if there is no such key, as in del dictionary[key].
+    void remove(const Object& key) noexcept;
+
+    /// Sets the items of the other dictionary, in their order, reusing the hashes it cached.
+    void update(const Dictionary& other) noexcept;
+
+    /// Removes every item, releasing the table.
+    void clear() noexcept;
+
+    /// Tells if the dictionary has the key, as in key in dictionary.
+    [[nodiscard]] bool contains(const Object& key) const noexcept;
+
+    /// Tells how many items the dictionary holds.
+    [[nodiscard]] size_t len() const noexcept;
+
+    /// Gives the keys in the order of their insertion, as in list(dictionary).
+    [[nodiscard]] List keys() const noexcept;
+
+    /// Gives the values in the order of the insertion of their keys, as in list(dictionary.values()).
+    [[nodiscard]] List values() const noexcept;
+
+    /// Ensures that the dictionary can hold the given number of items without rebuilding its table, unless it
+    /// is split, in which case its values grow along with the shared keys.
+    void reserve(size_t capacity) noexcept;
+
+    /// Tells if the dictionary shares its keys and holds only its values.
+    [[nodiscard]] bool isSplit() const noexcept;
+
+   private:
+    /// The item along with the hash of its key, or a vacant key if the item was removed.
+    struct Entry {
+      uint64_t hash;
+      Object key, value;
+    };
+
+    /// The allocation holding the control bytes, the slots and the entries of the table, in this order.
+    GarbageCollected<std::byte> table;
+    /// The control bytes of the slots, aligned to 16 bytes.
+    uint8_t* controls = nullptr;
+    /// The positions of the entries the slots refer to.
+    uint32_t* slots = nullptr;
+    Entry* entries = nullptr;
+    /// The number of the slots, a power of 2 and a multiple of the group size, or 0 if there is no table.
+    size_t slotCount = 0;
+    /// The number of the entries appended to the array, including the vacant ones, and the number of the items.
+    size_t entryCount = 0, size = 0;
+    /// The keys of the split dictionary, or nullptr if the dictionary is combined.
+    SharedKeys* sharedKeys = nullptr;
+    /// The values of the split dictionary, one for each of the first shared keys, held in the table.
+    Object* sharedValues = nullptr;
+    size_t valueCapacity = 0;
+
+    /// Tells how many entries the table of the number of slots holds, which keeps an eighth of the slots
+    /// empty at least, so that the probes stay short and always end.
+    [[nodiscard]] static size_t getEntryCapacity(size_t slotCount) noexcept;
+
+    /// Replaces the table with one of the number of slots, copying the items of the source, which may be
+    /// this dictionary, into it in their order without the vacant entries, and raises MemoryError if the
+    /// pool is exhausted.
+    /// @return False if the pool is exhausted, in which case the table is left as it is.
+    bool rebuild(size_t newSlotCount, const Dictionary& source) noexcept;
+
+    /// Makes room for appending the entries of the items up to the required number, compacting the array if it
+    /// holds many vacant entries or growing the table otherwise.
+    /// @return False if the pool is exhausted.
+    bool ensureCapacity(size_t required) noexcept;
+
+    /// Tells if the entry holds the key with the hash.
+    static bool isSameKey(const Entry& entry, const Object& key, uint64_t hash) noexcept;
+
+    /// Finds the slot of the key with the hash.
+    /// @return The index of the slot, or SIZE_MAX if there is no such key.
+    [[nodiscard]] size_t find(const Object& key, uint64_t hash) const noexcept;
+
+    /// Finds the value of the key with the hash, whether the dictionary is split or combined.
+    /// @return The address of the value, or nullptr if there is no such key.
+    [[nodiscard]] Object* locate(const Object& key, uint64_t hash) const noexcept;
+
+    /// Tells how many positions the items can take, counting the vacant entries.
+    [[nodiscard]] size_t getPositionCount() const noexcept;
+
+    /// Reads the item at the position, whether the dictionary is split or combined.
+    /// @return False if the entry at the position is vacant.
+    bool readItem(size_t position, Entry& item) const noexcept;
+
+    /// Sets the value of the key with the hash, which the caller has computed or taken from another table.
+    void insert(const Object& key, const Object& value, uint64_t hash) noexcept;
+
+    /// Places the entry in the first vacant slot of the probe of its hash, which must not be in the table.
+    void place(uint64_t hash, size_t position) noexcept;
+
+    /// Removes the item in the slot, leaving a vacant entry behind.
+    void erase(size_t slot) noexcept;
+
+    /// Sets the value of the key in the split dictionary, if it is a string keeping the order of the shared keys.
+    /// @return False if the dictionary has to be combined to hold the key.
+    bool insertShared(const Object& key, const Object& value, uint64_t hash) noexcept;
+
+    /// Grows the array of the values of the split dictionary to hold the number of values.
+    /// @return False if the pool is exhausted, in which case MemoryError is raised.
+    bool ensureValueCapacity(size_t required) noexcept;
+
+    /// Converts the split dictionary into a combined one with a table of its own.
+    /// @return False if the pool is exhausted, in which case the dictionary stays split.
+    bool combine() noexcept;
+  };
+
+  /// Holds the keys shared by the split attribute dictionaries of the instances of a class, in the order the
+  /// instances set them. The keys are never removed, so their positions in the table are the positions of
+  /// the values in the dictionaries sharing them, and there are at most MaximalCount of them, beyond which
+  /// the dictionaries combine, since a class whose instances keep gaining distinct keys shares little.
+  class SharedKeys {
+   public:
+    /// The number of keys after which no more keys are shared, the limit CPython uses.
+    static constexpr size_t MaximalCount = 30;
+
+    /// Tells how many keys are shared.
+    [[nodiscard]] size_t len() const noexcept;
+
+   private:
+    /// The keys, mapped to None, at the positions of their values.
+    Dictionary keys;
 
-  class Dictionary {};
-}
\ No newline at end of file
+    friend class Dictionary;
+  };
+}
@@ -11,7 +11,63 @@
 ===================================================================+*/
 #pragma once
 
+#include <cstddef>
+
 namespace mamba {
+  class String;
+
+  /// Represents the built-in float type in Python, a double-precision binary floating point number
+  /// held inline. The arithmetic is that of the host, which rounds every result to the nearest double
+  /// like CPython does. The text conversions are exact in both directions: repr() prints the shortest
+  /// decimal that reads back as the same double, laid out like CPython, and the parsing constructor
+  /// rounds the literal correctly however many digits it has.
+  class Float {
+   public:
+    Float() noexcept = default;
+    explicit(false) Float(double primitiveFloat) noexcept;                //NOLINT
+
+    /// Parses the float literal, as in float(text). The literal may be surrounded by whitespace, start
+    /// with a sign and have single underscores between the digits, or be inf, infinity or nan in any case.
+    /// @param text The literal to parse. If it is not a valid literal, ValueError is raised and the
+    /// float is left zero.
+    explicit Float(const String& text) noexcept;
+
+    Float  operator+(const Float& other) const noexcept;
+    Float  operator-(const Float& other) const noexcept;
+    Float  operator*(const Float& other) const noexcept;
+    /// Divides the floats, raising ZeroDivisionError and returning zero if the divisor is zero.
+    Float  operator/(const Float& other) const noexcept;
+    Float  operator-() const noexcept;
+    Float& operator+=(const Float& other) noexcept;
+    Float& operator-=(const Float& other) noexcept;
+    Float& operator*=(const Float& other) noexcept;
+    Float& operator/=(const Float& other) noexcept;
+
+    bool operator==(const Float& other) const noexcept;
+    bool operator>(const Float& other) const noexcept;
+    bool operator<(const Float& other) const noexcept;
+    bool operator>=(const Float& other) const noexcept;
+    bool operator<=(const Float& other) const noexcept;
+
+    explicit operator double() const noexcept;
+
+    /// Converts the float into the shortest text that reads back as the same value, as in repr(number).
+    /// @return The digits in positional notation for the magnitudes from 1e-4 up to 1e16, and in
+    /// scientific notation outside, with at least one digit after the decimal point, or inf or nan.
+    [[nodiscard]] String repr() const noexcept;
+
+    /// Converts the float into its text representation, as in str(number), which is the same as repr().
+    [[nodiscard]] String str() const noexcept;
+
+    /// Computes the hash of the float, as in hash(number), which equals the hash of the integer of the same
+    /// value, see hashing.hh.
+    [[nodiscard]] size_t hash() const noexcept;
+
+    /// Tells if the float is finite and has no fractional part.
+    /// @see https://docs.python.org/3/library/stdtypes.html#float.is_integer
+    [[nodiscard]] bool is_integer() const noexcept;
 
-  class Float {};
-}
\ No newline at end of file
+   private:
+    double value = 0.0;
+  };
+}
@@ -16,23 +16,14 @@
 #include "../givers/memory.hh"
 
 namespace mamba {
-  /// Represents the built-in integer type in Python. One of its key aspects
-  /// is that integers in Python are arbitrary-length and must be able to grow
-  /// as long as the machine has enough GarbageCollectedStack to store them, hence we utilise
-  /// ActiveSetMemory allocator to store the whole numbers. Under the hood, we
-  /// store integers as a contiguous sequence of units called cells where each
-  /// cell stores 32 bits of data. In case if the integer is sufficiently small
-  /// and does not grow out of the 32-bit range, the integer value acts as the
-  /// primitive value and benefits from its efficiency. However, when it grows
-  /// out of that sizeInBytes, we use multiple cells for representing a larger value.
-  /// Conventionally, we then treat each cell as 2 blocks of 16-bit values.
-  /// When performing arithmetic on multiple wide integers, we add block by
-  /// cell. The second block acts as the padding where any necessary overflow
-  /// or underflow propagates ensuring the proper state of the integer. As the
-  /// consequence, values of these class may take more GarbageCollectedStack to be represented,
-  /// but they benefit from SIMD and can be highly efficiently processed: on SSE2,
-  /// integers up to 128 bits are as cheap as the primitives (340282366920938463463374607431768211456),
-  /// while on AVX 256 bits (115792089237316195423570985008687907853269984665640564039457584007913129639936).
+  class String;
+  enum class CellOperation : uint8_t;
+
+  /// Represents the built-in integer type in Python, which is arbitrary-length and grows as long as the
+  /// pool has room for it. The magnitude is kept as a sequence of 32-bit cells, the least significant
+  /// first, with the sign apart from it, and the cells are never written after the integer is constructed,
+  /// so copies share them. The values that fit into a signed machine word are held inline instead, with no
+  /// cells at all, and the results are brought back to the inline form whenever they fit.
   class Integer {
    public:
     Integer();
@@ -41,26 +32,38 @@ namespace mamba {
     Integer(const Integer& other);
     Integer(Integer&& other) noexcept;
 
+    /// Parses the decimal integer literal, as in int(text). The literal may be surrounded by whitespace,
+    /// start with a sign and have single underscores between the digits. The long literals are split in
+    /// halves at cached powers of ten.
+    /// @param text The literal to parse. If it is not a valid literal, ValueError is raised and the
+    /// integer is left zero, and so it is if it has more digits than getIntegerToStringConversionLimit().
+    explicit Integer(const String& text) noexcept;
+
     Integer&  operator=(int primitiveInteger) noexcept;
     Integer&  operator=(const Integer& other) noexcept = default;
     Integer&  operator=(Integer&& other) noexcept;
 
-    Integer operator+(const size_t other) const noexcept;
-    Integer&& operator=(const size_t other) const noexcept;
-    Integer&& operator*(const size_t other) const noexcept;
-    Integer&& operator/(const size_t other) const noexcept;
-    Integer&& operator%(const size_t other) const noexcept;
+    Integer  operator+(const size_t other) const noexcept;
+    Integer& operator=(const size_t other) noexcept;
+    Integer  operator*(const size_t other) const noexcept;
+    Integer   operator/(const size_t other) const noexcept;
+    Integer   operator%(const size_t other) const noexcept;
     Integer&  operator+=(const size_t other) noexcept;
     Integer&  operator-=(const size_t other) noexcept;
     Integer&  operator*=(const size_t other) noexcept;
     Integer&  operator/=(const size_t other) noexcept;
     Integer&  operator%=(const size_t other) noexcept;
 
-    Integer&& operator+(const Integer& other) const noexcept;
-    Integer&& operator-(const Integer& other) const noexcept;
-    Integer&& operator*(const Integer& other) const noexcept;
-    Integer&& operator/(const Integer& other) const noexcept;
-    Integer&& operator%(const Integer& other) const noexcept;
+    /// The inline operands check for overflow with the compiler builtins and only fall back to the cells
+    /// when the result outgrows the word. Addition and subtraction of the cells run on AVX2 or SSE2.
+    Integer   operator+(const Integer& other) const noexcept;
+    Integer   operator-(const Integer& other) const noexcept;
+    /// Multiplies with schoolbook, Karatsuba or Toom-3 multiplication as the operands grow.
+    Integer   operator*(const Integer& other) const noexcept;
+    /// Divides like the // and % operators of Python, flooring the quotient so that the remainder takes the
+    /// sign of the divisor, in about twice the time of multiplication on large operands.
+    Integer   operator/(const Integer& other) const noexcept;
+    Integer   operator%(const Integer& other) const noexcept;
     Integer&  operator+=(const Integer& other) noexcept;
     Integer&  operator-=(const Integer& other) noexcept;
     Integer&  operator*=(const Integer& other) noexcept;
@@ -73,19 +76,48 @@ namespace mamba {
     bool operator>=(const Integer& other) const noexcept;
     bool operator<=(const Integer& other) const noexcept;
 
-    Integer&& operator&(const Integer& other) const noexcept;
-    Integer&& operator|(const Integer& other) const noexcept;
-    Integer&& operator^(const Integer& other) const noexcept;
-    Integer&& operator~() const noexcept;
-    Integer&& operator<<(const Integer& other) const noexcept;
-    Integer&& operator>>(const Integer& other) const noexcept;
+    /// The bitwise operators treat negative values as two's complement with infinitely many leading ones, as
+    /// Python does, and they and the shifts process 256 bits at once with AVX2, or 128 with SSE2.
+    Integer   operator&(const Integer& other) const noexcept;
+    Integer   operator|(const Integer& other) const noexcept;
+    Integer   operator^(const Integer& other) const noexcept;
+    Integer   operator~() const noexcept;
+    Integer   operator<<(const Integer& other) const noexcept;
+    Integer   operator>>(const Integer& other) const noexcept;
     Integer&  operator&=(const Integer& other) noexcept;
     Integer&  operator|=(const Integer& other) noexcept;
     Integer&  operator^=(const Integer& other) noexcept;
     Integer&  operator<<=(const Integer& other) noexcept;
     Integer&  operator>>=(const Integer& other) noexcept;
 
-    [[nodiscard]] GarbageCollected<char>&& str();
+    /// Raises the integer to the power, as in pow(integer, exponent).
+    /// @param exponent The exponent. If it is negative, the power is not an integer, so ValueError is raised
+    /// and zero returned.
+    /// @return The power.
+    [[nodiscard]] Integer pow(const Integer& exponent) const noexcept;
+
+    /// Raises the integer to the power modulo the modulus, as in pow(integer, exponent, modulus), with
+    /// Montgomery multiplication and sliding windows over the exponent, see modular.hh.
+    /// @param exponent The exponent. If it is negative, the inverse of the integer modulo the modulus is
+    /// raised to its negation, and if there is no such inverse, ValueError is raised.
+    /// @param modulus The modulus. If it is zero, ValueError is raised.
+    /// @return The power reduced into the range between 0 and the modulus, which has the sign of the
+    /// modulus, or zero if an error was raised.
+    [[nodiscard]] Integer pow(const Integer& exponent, const Integer& modulus) const noexcept;
+
+    /// Raises the integer to the power modulo the modulus like pow(), in time that does not depend on the
+    /// bits of the exponent, only on its size, for the odd moduli of cryptography.
+    [[nodiscard]] Integer powConstantTime(const Integer& exponent, const Integer& modulus) const noexcept;
+
+    /// Converts the integer into its decimal text representation, as in str(integer), splitting it in halves
+    /// at cached powers of ten.
+    /// @return The digits of the integer, or the empty string if there are more of them than
+    /// getIntegerToStringConversionLimit(), in which case ValueError is raised.
+    [[nodiscard]] String str() const noexcept;
+
+    /// Computes the hash of the integer, as in hash(integer): its value modulo 2^61 - 1 like in CPython,
+    /// which the floats of the same value share, see hashing.hh.
+    [[nodiscard]] size_t hash() const noexcept;
 
     /// Tells how many bits are needed to represent this integer in binary
     /// excluding the sign bit and leading bits.
@@ -99,7 +131,8 @@ namespace mamba {
     /// @return The number of set bits in the integer binary representation.
     [[nodiscard]] size_t bit_count() const noexcept;
 
-    /// Converts the integer into a byte array.
+    /// Converts the integer into a byte array, copying the cells, which the kernels of serialisation.hh
+    /// reverse for big endian.
     /// @param length (optional) The number of bytes in the final byte array. If this value is larger
     /// than the integer is represented with, then the leading bytes are initialised to zero, but if
     /// the integer does not fit into this range, OverflowError is raised. Defaults to 1.
@@ -113,16 +146,36 @@ namespace mamba {
     /// and then be interpreted as an ASCII character, but do not do this with values larger than 255 (beware
     /// OverflowError).
     /// @throw OverflowError if integer is too big or some of the arguments are misled with the actual integer.
-    /// @return Movable GarbageCollected object containing the raw bytes.
-    static GarbageCollected<std::byte>&& to_bytes(unsigned int length = 1, bool isBigEndian = true,
-                                                  bool isSigned = true) noexcept;
+    /// @return GarbageCollected object containing the raw bytes, or an empty one if OverflowError is raised.
+    [[nodiscard]] GarbageCollected<std::byte> to_bytes(size_t length = 1, bool isBigEndian = true,
+                                                       bool isSigned = true) const noexcept;
+
+    /// Converts the integers into byte arrays of the same length, packed one after another into a single
+    /// buffer, as the fields of a binary message are.
+    /// @param integers The integers to convert.
+    /// @param count The number of the integers.
+    /// @param length The number of bytes of every integer.
+    /// @throw OverflowError if any of the integers does not fit into the length, as in to_bytes().
+    /// @return The count * length bytes, or an empty GarbageCollected object if OverflowError is raised.
+    [[nodiscard]] static GarbageCollected<std::byte> to_bytes(const Integer* integers, size_t count, size_t length,
+                                                              bool isBigEndian = true, bool isSigned = true) noexcept;
 
     /// Constructs an integer from the given byte array.
     /// @param bytes The GarbageCollected to the byte values.
     /// @param isBigEndian (optional) The most significant bit to interpret the bytes with. When set to true
     /// (default), the bytes are interpreted as big endian, otherwise as little endian.
     /// @param isSigned (optional) The flag that tells if the bytes must be interpreted as signed (default) or unsigned.
-    static Integer&& from_bytes(GarbageCollected<std::byte>& bytes, bool isBigEndian = true, bool isSigned = true) noexcept;
+    [[nodiscard]] static Integer from_bytes(const GarbageCollected<std::byte>& bytes, bool isBigEndian = true,
+                                            bool isSigned = true) noexcept;
+
+    /// Constructs the integers from the byte arrays of the same length packed one after another, as
+    /// written by the packed to_bytes(). The integers that do not fit inline share a single allocation.
+    /// @param bytes The packed byte arrays, whose bytes beyond the last whole array are ignored.
+    /// @param length The number of bytes of every integer, not zero.
+    /// @param integers The destination for bytes.capacity / length integers.
+    /// @return The number of integers constructed.
+    static size_t from_bytes(const GarbageCollected<std::byte>& bytes, size_t length, Integer* integers,
+                             bool isBigEndian = true, bool isSigned = true) noexcept;
 
     /// Finds out the pair of integers, numerator and denominator. When divided, they will yield the same
     /// integer as held by the object. Since there are infinite combinations of such pairs, this method will
@@ -136,7 +189,78 @@ namespace mamba {
     static bool is_integer() noexcept;
 
    private:
+    /// The cells of the magnitude, used only if the value does not fit inline.
     GarbageCollected<uint32_t> cells;
-    size_t numberOfCells = 1;
+    /// The number of cells of the magnitude, or 0 if the value is inline.
+    size_t numberOfCells = 0;
+    /// The inline value, used only if there are no cells.
+    int64_t value = 0;
+    bool isNegative = false;
+
+    /// The view of the magnitude as cells, whichever way the integer is stored.
+    struct Magnitude {
+      const uint32_t* cells;
+      size_t size;
+    };
+
+    /// Tells if the value is held inline rather than in the cells.
+    [[nodiscard]] bool isInline() const noexcept;
+
+    /// Exposes the magnitude as cells, spelling the inline value out into the storage.
+    /// @param storage The 2 cells the inline value is written into.
+    /// @return The cells of the magnitude without leading zero cells.
+    Magnitude getMagnitude(uint32_t* storage) const noexcept;
+
+    /// Creates the integer holding the value inline.
+    static Integer fromValue(int64_t value) noexcept;
+
+    /// Takes over the freshly computed cells, dropping their leading zero cells, or moves the value
+    /// inline if it fits.
+    /// @param buffer The cells of the magnitude.
+    /// @param size The number of cells written into the buffer.
+    /// @param isNegative The sign of the integer, ignored if the magnitude is zero.
+    Integer(const GarbageCollected<uint32_t>& buffer, size_t size, bool isNegative) noexcept;
+
+    /// Creates the integer from the magnitude that fits into a machine word, inline if the sign allows.
+    static Integer fromMagnitude(uint64_t magnitude, bool isNegative) noexcept;
+
+    /// Adds the magnitudes of the operands and gives the sum the requested sign.
+    static Integer addMagnitudes(const Integer& left, const Integer& right, bool isNegative) noexcept;
+
+    /// Subtracts the magnitude of the right operand from the left one, with the sign of the left one
+    /// flipped if the right magnitude is larger.
+    static Integer subtractMagnitudes(const Integer& left, const Integer& right, bool isNegative) noexcept;
+
+    /// Divides the operands, flooring the quotient as the // operator of Python does.
+    /// @return The quotient and the remainder, which has the sign of the divisor, or zeros if the divisor is
+    /// zero, in which case ZeroDivisionError is raised.
+    static std::pair<Integer, Integer> divide(const Integer& left, const Integer& right) noexcept;
+
+    /// Raises the base to the power modulo the modulus for both variants of the three-argument pow().
+    static Integer powModulo(const Integer& base, const Integer& exponent, const Integer& modulus,
+                             bool isConstantTime) noexcept;
+
+    /// Applies the bitwise operation to the operands in two's complement.
+    static Integer combine(const Integer& left, const Integer& right, CellOperation operation) noexcept;
+
+    /// Tells if the integer fits into the number of bytes, raising OverflowError if it does not.
+    [[nodiscard]] bool fitsIntoBytes(size_t length, bool isSigned) const noexcept;
+
+    /// Writes the integer into the number of bytes it is known to fit into.
+    void writeBytes(std::byte* destination, size_t length, bool isBigEndian) const noexcept;
+
+    /// Reads the integer from the number of bytes, allocating its cells from the given ones if it needs
+    /// any rather than gathering its own.
+    /// @param cells The getByteCellCapacity(length) cells to read into, or an empty GarbageCollected object
+    /// if the integer gathers its cells when it needs them.
+    static Integer readBytes(const std::byte* source, size_t length, bool isBigEndian, bool isSigned,
+                             const GarbageCollected<uint32_t>& cells) noexcept;
+
+    /// Reads the shift count of the shift operators.
+    /// @param count Output set to the shift count, or to UINT64_MAX if it does not fit into a machine word.
+    /// @return False if the count is negative, in which case ValueError is raised.
+    static bool getShiftCount(const Integer& other, uint64_t& count) noexcept;
+
+    friend class Object;
   };
 }
\ No newline at end of file
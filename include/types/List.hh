@@ -3,7 +3,7 @@
 
   Summary:    Represents dynamically-typed resizable lists in Python.
 
-  Classes:    List
+  Classes:    List, ListStorage
 
   Functions:  None
 
@@ -11,7 +11,148 @@
 ===================================================================+*/
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+
+#include "../givers/memory.hh"
+#include "Object.hh"
+
 namespace mamba {
+  /// Tells how a list holds its elements.
+  enum class ListStorage : uint8_t {
+    /// The integers that fit into machine words, unboxed into 8 bytes each.
+    Integers,
+    /// The floats, unboxed into 8 bytes each.
+    Floats,
+    /// The objects of any type, 16 bytes each.
+    Objects
+  };
+
+  /// Represents the built-in list type in Python, a contiguous array of elements on the pool that grows
+  /// by half of its capacity whenever it fills up, so that appending takes amortised constant time.
+  /// Most lists hold numbers of a single type, which the list stores unboxed, as the raw 8-byte
+  /// integers or doubles with no type tag, taking half the memory of objects and letting the searches
+  /// and the sort run over plain arrays. The storage is decided by the first element, and the first
+  /// element of another type, such as a float appended to integers or an integer too large for a
+  /// machine word, converts the list to objects for good, which takes a single pass over it.
+  class List {
+   public:
+    List() noexcept = default;
+
+    /// Copies the elements into a buffer of their own, as in list(other).
+    List(const List& other) noexcept;
+    List(List&& other) noexcept;
+
+    List& operator=(const List& other) noexcept;
+    List& operator=(List&& other) noexcept;
+
+    /// Gives the element at the index, counted from the end if it is negative, as in list[index].
+    /// @return The element, or None if the index is out of range, in which case IndexError is raised.
+    Object operator[](ssize_t index) const noexcept;
+
+    /// Compares the lists element by element, as in list == other.
+    bool operator==(const List& other) const noexcept;
+
+    /// Replaces the element at the index, counted from the end if it is negative, as in list[index] = item,
+    /// raising IndexError if the index is out of range.
+    void set(ssize_t index, const Object& item) noexcept;
+
+    /// Adds the element to the end of the list.
+    void append(const Object& item) noexcept;
+
+    /// Adds the elements of the other list, which may be this one, to the end of the list.
+    void extend(const List& other) noexcept;
+
+    /// Inserts the element before the index, which is counted from the end if it is negative and clamped to
+    /// the list like in Python.
+    void insert(ssize_t index, const Object& item) noexcept;
+
+    /// Removes the element at the index, the last one by default, and gives it back.
+    /// @return The element, or None if the list is empty or the index is out of range, in which case
+    /// IndexError is raised.
+    Object pop(ssize_t index = -1) noexcept;
+
+    /// Removes the first element equal to the given one, raising ValueError if there is none.
+    void remove(const Object& item) noexcept;
+
+    /// Removes every element, keeping the capacity.
+    void clear() noexcept;
+
+    /// Reverses the elements in place.
+    void reverse() noexcept;
+
+    /// Sorts the elements in ascending order, or in descending order if reversed, as in list.sort(). The
+    /// sort is stable, keeping the equal elements in their order either way, and adaptive: it takes linear
+    /// time on the lists that are sorted or reversed already and merges the sorted runs it finds. The
+    /// large lists of unboxed integers and floats are sorted by radix instead, and the strings by the
+    /// cached prefixes of their bytes before comparing them in full. The list must hold either numbers
+    /// or strings, and TypeError is raised otherwise, leaving the list unchanged, as is MemoryError if
+    /// the pool cannot hold the scratch space.
+    void sort(bool isReversed = false) noexcept;
+
+    /// Finds the first element equal to the given one.
+    /// @return The index of the element, or SIZE_MAX if there is none, in which case ValueError is raised.
+    [[nodiscard]] size_t index(const Object& item) const noexcept;
+
+    /// Counts the elements equal to the given one.
+    [[nodiscard]] size_t count(const Object& item) const noexcept;
+
+    /// Tells if any element equals the given one, as in item in list.
+    [[nodiscard]] bool contains(const Object& item) const noexcept;
+
+    /// Tells how many elements the list holds.
+    [[nodiscard]] size_t len() const noexcept;
+
+    /// Ensures that the list can grow to the given number of elements without reallocating its buffer.
+    void reserve(size_t capacity) noexcept;
+
+    /// Tells how the elements are stored.
+    [[nodiscard]] ListStorage getStorage() const noexcept;
+
+   private:
+    /// The allocation holding the elements, marked as garbage when it is replaced.
+    GarbageCollected<std::byte> buffer;
+    /// The first element, aligned within the buffer.
+    std::byte* items = nullptr;
+    /// The number of elements, and the number of them the buffer holds.
+    size_t size = 0, capacity = 0;
+    ListStorage storage = ListStorage::Integers;
+
+    /// Gives the elements as an array of the type of the storage.
+    template<typename T> [[nodiscard]] T* view() const noexcept {
+      return reinterpret_cast<T*>(items);
+    }
+
+    /// Tells how many bytes every element takes in the storage.
+    [[nodiscard]] static size_t getItemSize(ListStorage kind) noexcept;
+
+    /// Moves the elements into a new buffer of the given capacity, boxing them if the storage changes to
+    /// objects, and raises MemoryError if the pool is exhausted.
+    /// @return False if the pool is exhausted, in which case the list is left as it is.
+    bool reallocate(size_t newCapacity, ListStorage newStorage) noexcept;
+
+    /// Grows the buffer geometrically until it holds the number of elements.
+    /// @return False if the pool is exhausted.
+    bool ensureCapacity(size_t required) noexcept;
+
+    /// Switches the storage to the one that can hold the element as well, boxing the elements if needed.
+    /// @return False if the pool is exhausted.
+    bool accept(const Object& item) noexcept;
+
+    /// Reads the element at the index, boxing it into an object if it is unboxed.
+    [[nodiscard]] Object load(size_t index) const noexcept;
+
+    /// Writes the element, which the storage must accept, at the index.
+    void store(size_t index, const Object& item) noexcept;
+
+    /// Converts the index counted from the end if it is negative into a position, raising IndexError if
+    /// it is out of range.
+    /// @return False if the index is out of range.
+    bool locate(ssize_t index, size_t& position) const noexcept;
 
-  class List {};
-}
\ No newline at end of file
+    /// Finds the first element equal to the given one, or counts all of them.
+    /// @return The index of the first element, or SIZE_MAX if there is none, or the count.
+    [[nodiscard]] size_t search(const Object& item, bool isCounting) const noexcept;
+  };
+}
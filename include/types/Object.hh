@@ -1,4 +1,113 @@
+/*+===================================================================
+  SyncFile:       Object.hh
+
+  Summary:    Represents any value of the language in a single handle,
+              the element type of the heterogeneous containers.
+
+  Classes:    Object, ObjectType
+
+  Functions:  isNumericallyEqual()
+
+  Available under Apache License v2. Mamba Authors (2024)
+===================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
 namespace mamba {
+  class Float;
+  class Integer;
+  class String;
+
+  /// Tells which built-in type a value held by an Object has.
+  enum class ObjectType : uint8_t {
+    None, Integer, Float, String
+  };
+
+  /// Represents a value of any built-in type in 16 bytes, the way the containers hold their
+  /// elements when they are not all of one numeric type. The integers that fit into a machine
+  /// word and the floats are held inline, so that the handle is all they take, while the larger
+  /// integers and the strings are boxed: copied once onto the pool, where the handle points to
+  /// them. The values are immutable, so copies of the handle share the boxed value and the handle
+  /// is trivially copyable, which lets the containers move their elements with plain memory copies.
+  class Object {
+   public:
+    /// Creates None.
+    Object() noexcept = default;
+    explicit(false) Object(int number) noexcept;              //NOLINT
+    explicit(false) Object(double number) noexcept;           //NOLINT
+    explicit(false) Object(const Integer& number) noexcept;   //NOLINT
+    explicit(false) Object(const Float& number) noexcept;     //NOLINT
+    /// Boxes the string, raising MemoryError and leaving the object None if the pool is exhausted.
+    explicit(false) Object(const String& text) noexcept;      //NOLINT
+
+    /// Compares the values like the == operator of Python: the integers and the floats compare by their
+    /// exact numeric values, and the values of the other types only equal the values of the same type.
+    bool operator==(const Object& other) const noexcept;
+
+    /// Orders the values like the < operator of Python: the integers and the floats by their exact numeric
+    /// values, with NaN unordered with every number, and the strings by their code points. The values of
+    /// the other pairs of types are unordered, which the caller must check for, since Python raises
+    /// TypeError for them.
+    bool operator<(const Object& other) const noexcept;
+
+    /// Computes the hash of the value, as in hash(value), which the equal values share, including the
+    /// integers and the floats of the same value.
+    [[nodiscard]] size_t hash() const noexcept;
+
+    [[nodiscard]] ObjectType getType() const noexcept;
+
+    /// Gives the integer, which the object must hold.
+    [[nodiscard]] Integer asInteger() const noexcept;
+
+    /// Gives the float, which the object must hold.
+    [[nodiscard]] Float asFloat() const noexcept;
+
+    /// Gives the string, which the object must hold.
+    [[nodiscard]] const String& asString() const noexcept;
+
+   private:
+    ObjectType type = ObjectType::None;
+    /// Tells if the payload is the address of the boxed value rather than the value itself.
+    bool isBoxed = false;
+    union {
+      int64_t integer;
+      double number;
+      const void* address = nullptr;
+    } payload;
+
+    /// Creates the integer held inline.
+    static Object fromValue(int64_t value) noexcept;
+
+    /// Tells if the object holds an integer that fits into a machine word, and so is held inline.
+    [[nodiscard]] bool isSmallInteger() const noexcept;
+
+    /// Compares the boxed integer the object holds with the float by their exact values.
+    [[nodiscard]] bool isBoxedIntegerEqual(double number) const noexcept;
+
+    /// Creates the marker the hash tables leave in the entries of the removed elements: None marked as
+    /// boxed, which no value is.
+    static Object makeVacant() noexcept;
+
+    /// Tells if the object is the marker of a removed element.
+    [[nodiscard]] bool isVacant() const noexcept;
+
+    /// Compares the integer the object holds with the float by their exact values.
+    /// @return A negative number if the integer is less, a positive one if it is greater, and zero if they
+    /// are equal or the float is NaN.
+    [[nodiscard]] int compareWithFloat(double number) const noexcept;
+
+    friend class Dictionary;
+    friend class List;
+    friend class Set;
+  };
+
+  static_assert(std::is_trivially_copyable_v<Object>, "The containers copy their objects as bytes.");
 
-    class Object;
-}
\ No newline at end of file
+  /// Compares the integer and the float by their exact values, as Python does, rather than converting the
+  /// integer into a float, which rounds the integers above 2^53.
+  /// @return True if the float is an integer equal to the given one.
+  [[nodiscard]] bool isNumericallyEqual(int64_t integer, double number) noexcept;
+}
@@ -11,9 +11,171 @@
 ===================================================================+*/
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
+#include "../givers/memory.hh"
+#include "List.hh"
+#include "Object.hh"
+#include "help/hashing.hh"
+
 namespace mamba {
+  /// Represents the built-in set type in Python, an unordered collection of distinct hashable elements.
+  /// The elements are kept in a Swiss table, see probing.hh, right in their slots along with their cached
+  /// hashes, since a set has no order to keep in a separate array: a lookup matches the 16 control bytes
+  /// of a group at once by the tag of the hash, and then nearly always compares the single element whose
+  /// tag matches. The removed elements leave deleted control bytes behind, which the later insertions
+  /// reuse, and the table is rebuilt without them when they fill it up. The cached hashes let the set
+  /// algebra move the elements from table to table without hashing them again.
+  class Set {
+   public:
+    Set() noexcept = default;
+
+    /// Creates the set of the distinct items of the list, as in set(items).
+    explicit Set(const List& items) noexcept;
+
+    /// Copies the elements into a table of their own, as in set(other).
+    Set(const Set& other) noexcept;
+    Set(Set&& other) noexcept;
+
+    Set& operator=(const Set& other) noexcept;
+    Set& operator=(Set&& other) noexcept;
+
+    /// Compares the sets by their elements, as in set == other.
+    bool operator==(const Set& other) const noexcept;
+
+    /// Gives the elements of both sets, as in set | other.
+    Set operator|(const Set& other) const noexcept;
+
+    /// Gives the elements the sets have in common, as in set & other.
+    Set operator&(const Set& other) const noexcept;
+
+    /// Gives the elements of the set that the other one lacks, as in set - other.
+    Set operator-(const Set& other) const noexcept;
+
+    /// Adds the element if the set lacks it, as in set.add(element).
+    void add(const Object& element) noexcept;
+
+    /// Removes the element, raising KeyError if there is no such element, as in set.remove(element).
+    void remove(const Object& element) noexcept;
+
+    /// Removes the element if the set has it, as in set.discard(element).
+    void discard(const Object& element) noexcept;
+
+    /// Removes an arbitrary element and gives it back, as in set.pop().
+    /// @return The element, or None if the set is empty, in which case KeyError is raised.
+    Object pop() noexcept;
+
+    /// Adds the elements of the other set, reusing the hashes it cached, as in set.update(other).
+    void update(const Set& other) noexcept;
+
+    /// Removes every element, releasing the table.
+    void clear() noexcept;
+
+    /// Tells if the set has the element, as in element in set.
+    [[nodiscard]] bool contains(const Object& element) const noexcept;
+
+    /// Tells if every element of the set is in the other one, as in set <= other.
+    [[nodiscard]] bool issubset(const Set& other) const noexcept;
+
+    /// Tells how many elements the set holds.
+    [[nodiscard]] size_t len() const noexcept;
+
+    /// Gives the elements in the order of the table, as in list(set).
+    [[nodiscard]] List elements() const noexcept;
+
+    /// Ensures that the set can hold the given number of elements without rebuilding its table.
+    void reserve(size_t capacity) noexcept;
+
+   private:
+    /// The element along with its hash.
+    struct Slot {
+      uint64_t hash;
+      Object element;
+    };
+
+    /// The allocation holding the control bytes and then the slots of the table.
+    GarbageCollected<std::byte> table;
+    /// The control bytes of the slots, aligned to 16 bytes.
+    uint8_t* controls = nullptr;
+    Slot* slots = nullptr;
+    /// The number of the slots, a power of 2 and a multiple of the group size, or 0 if there is no table.
+    size_t slotCount = 0;
+    /// The number of the elements and the number of the slots whose elements were removed.
+    size_t size = 0, deletedCount = 0;
+    /// The group pop() starts searching from, since the groups before it were emptied by the earlier calls.
+    size_t finger = 0;
+
+    /// Tells how many elements the table of the number of slots holds, along with the deleted slots,
+    /// which keeps an eighth of the slots empty at least, so that the probes stay short and always end.
+    [[nodiscard]] static size_t getCapacity(size_t slotCount) noexcept;
+
+    /// Gives the number of slots of the smallest table holding the number of elements.
+    [[nodiscard]] static size_t getSlotCount(size_t required) noexcept;
+
+    /// Replaces the table with one of the number of slots, placing the elements of the source, which may be
+    /// this set, by their cached hashes, and raises MemoryError if the pool is exhausted.
+    /// @return False if the pool is exhausted, in which case the table is left as it is.
+    bool rebuild(size_t newSlotCount, const Set& source) noexcept;
+
+    /// Makes room for the elements up to the required number, dropping the deleted slots or growing the table.
+    /// @return False if the pool is exhausted.
+    bool ensureCapacity(size_t required) noexcept;
+
+    /// Tells if the slot holds the element with the hash.
+    static bool isSameElement(const Slot& slot, const Object& element, uint64_t hash) noexcept;
+
+    /// Finds the slot of the element with the hash.
+    /// @return The index of the slot, or SIZE_MAX if there is no such element.
+    [[nodiscard]] size_t find(const Object& element, uint64_t hash) const noexcept;
+
+    /// Adds the element with the hash, which the caller has computed or taken from another table.
+    void insert(const Object& element, uint64_t hash) noexcept;
+
+    /// Places the element in the first vacant slot of the probe of its hash, which must not be in the table.
+    void place(const Object& element, uint64_t hash) noexcept;
+
+    /// Removes the element in the slot, leaving a deleted control byte behind.
+    void erase(size_t slot) noexcept;
+
+    /// Calls the visitor with every slot holding an element, finding them a group of control bytes at a time,
+    /// until the visitor returns false.
+    /// @return False if the visitor stopped the visit.
+    template<typename Visitor> bool visit(Visitor&& visitor) const noexcept;
+
+    friend class Frozenset;
+  };
+
+  /// Represents the built-in frozenset type in Python, the immutable and hashable set. Its hash combines
+  /// the hashes of its elements regardless of their order, like in CPython, and is computed once, when it
+  /// is first needed, since the elements never change.
+  class Frozenset {
+   public:
+    Frozenset() noexcept = default;
+
+    /// Creates the frozenset of the elements of the set, as in frozenset(elements).
+    explicit Frozenset(Set elements) noexcept;
+
+    /// Creates the frozenset of the distinct items of the list, as in frozenset(items).
+    explicit Frozenset(const List& items) noexcept;
+
+    /// The operations of Set, which the frozenset supports apart from the ones that modify it.
+    bool operator==(const Frozenset& other) const noexcept;
+    Frozenset operator|(const Frozenset& other) const noexcept;
+    Frozenset operator&(const Frozenset& other) const noexcept;
+    Frozenset operator-(const Frozenset& other) const noexcept;
+
+    [[nodiscard]] bool contains(const Object& element) const noexcept;
+    [[nodiscard]] bool issubset(const Frozenset& other) const noexcept;
+    [[nodiscard]] size_t len() const noexcept;
+    [[nodiscard]] List elements() const noexcept;
 
-  class Frozenset {};
+    /// Hashes the frozenset like hash(frozenset) in CPython, caching the hash.
+    [[nodiscard]] size_t hash() const noexcept;
 
-  class Set {};
-}
\ No newline at end of file
+   private:
+    Set set;
+    /// The hash computed by the first call of hash(), or ReservedHash, which no frozenset hashes to, before it.
+    mutable uint64_t cachedHash = ReservedHash;
+  };
+}
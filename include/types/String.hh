@@ -15,15 +15,22 @@
 
 #include <cstddef>
 #include <array>
+#include <string_view>
+#include <sys/types.h>
 
 #include "interfaces.hh"
 #include "Dictionary.hh"
+#include "Float.hh"
 #include "Integer.hh"
 #include "Tuple.hh"
 #include "Bytes.hh"
 #include "List.hh"
 #include "../include/givers/memory.hh"
 #include "help/unicode.hh"
+#include "help/search.hh"
+#include "help/hashing.hh"
+#include "help/formatting.hh"
+#include "help/translation.hh"
 
 namespace mamba {
   const auto NumberOfOutposts = 10;
@@ -105,6 +112,10 @@ namespace mamba {
     /// @param integer The integer to convert.
     explicit String(const Integer& integer);
 
+    /// Converts the float into its shortest text representation, as in str(number).
+    /// @param number The float to convert.
+    explicit String(const Float& number);
+
     String&  operator=(const char* character) noexcept;
     String&  operator=(const std::string_view& other) noexcept;
     String&  operator=(const String& other) noexcept = default;
@@ -116,11 +127,22 @@ namespace mamba {
     String   operator[](const Range& range) noexcept;
     String   operator%(const Enumerable& placeholders) const noexcept;
 
-    /// The boolean comparison operators evaluate 2 strings for being lexicographically ordered.
-    /// If strings have different sizes, then lexicographically greater is the longer size and vice versa,
-    /// and for strings of even size, we need to find the first differing pair of graphemes and cast them into
-    /// Unicode code points and compare them. This behaviour is consistent with the equals operator as it checks
-    /// if the strings are the same.
+    /// Substitutes the arguments into the printf-style conversion specifiers of the string, such
+    /// as "%s", "%-10.3s" or "%(name)r", as in the `text % values` expression. The template is
+    /// compiled once and cached, see formatting.hh.
+    /// @param arguments The positional values, or the keyword values for the named specifiers.
+    /// @return New formatted string, or the empty string if an exception was raised.
+    String   operator%(const FormatArguments& arguments) const noexcept;
+
+    /// Substitutes the single value into the string, as in `"Hello, %s!" % name`.
+    /// @param argument The value to substitute.
+    /// @return New formatted string, or the empty string if an exception was raised.
+    String   operator%(const String& argument) const noexcept;
+
+    /// The boolean comparison operators evaluate 2 strings for being lexicographically ordered by their
+    /// Unicode code points, as in Python, where a string is greater than its proper prefixes. UTF-8 encodes
+    /// the code points so that their bytes order the same way, so the strings are compared byte by byte
+    /// and then by their sizes, without decoding them.
     bool operator==(const String& other) const noexcept;
     bool operator>(const String& other) const noexcept;
     bool operator<(const String& other) const noexcept;
@@ -137,12 +159,24 @@ namespace mamba {
     [[nodiscard]] const char* begin() const noexcept;
     [[nodiscard]] const char* end() const noexcept;
 
+    /// Tells if this string occurs in the haystack, as in the `needle in haystack` expression.
+    /// @param haystack The string to search in.
+    /// @return True if the haystack contains this string, false otherwise.
     [[nodiscard]] bool in(const String& haystack) const noexcept;
     [[nodiscard]] size_t len() const;
 
-    /// Reserves designated size for the strings.
+    /// Computes the hash of the string, as in hash(text), used to place it in dictionaries and sets.
+    /// The hash is computed on the first call with the keyed hashBytes() and cached in the string,
+    /// so repeated lookups with the same key do not read its bytes again. The cache is reset
+    /// whenever the content of the string is replaced.
+    /// @return The hash of the string, which is 0 for the empty string like in CPython.
+    [[nodiscard]] size_t hash() const noexcept;
+
+    /// Reserves designated size for the strings, so that it can grow up to the size in place. If
+    /// the buffer is too small, the content is copied into a new one, leaving the strings that
+    /// shared the previous buffer intact.
     /// @param size The expected size of the string in bytes.
-    /// @return GarbageCollected to self.
+    /// @return Reference to self.
     String& reserve(size_t size) noexcept;
 
     /// Unicode character iterator through the string. It yields
@@ -151,14 +185,16 @@ namespace mamba {
     /// @return Unicode iterator over the string object.
     [[nodiscard]] UTF8Walker iter() const;
 
-    /// Converts all characters to the upper case and returns a copy.
-    /// @return A copy of the string with all applicable characters in upper case.
+    /// Converts the first character into the title case and the remaining ones into the lower case.
+    /// @return A copy of the string with the first character capitalised.
     String capitalize() const noexcept;
 
     /// Converts all characters in lower case. This method is used as opposed to
     /// lowercase() in order to signal the intention to compare multiple strings
-    /// with varying cases.
-    /// @return A new string with all characters lowercase.
+    /// with varying cases. Unlike lower(), it applies the Unicode case folding,
+    /// so that "Straße" and "STRASSE" fold into the same string.
+    /// @return A new string with all characters lowercase. If the string did not contain
+    /// characters that fold, a copy-on-write reference is returned.
     String casefold() const noexcept;
 
     /// Generates a new string with this one being in the center
@@ -169,6 +205,13 @@ namespace mamba {
     /// @return A new centered string.
     String center(const size_t count, const String& padding = " ") const noexcept;
 
+    /// Counts the non-overlapping occurrences of the value in the string.
+    /// @param value The string to count.
+    /// @param start (optional) The index from which to begin counting.
+    /// @param end (optional) The index at which to stop counting.
+    /// @return The number of occurrences. An empty value is found between every pair of graphemes.
+    [[nodiscard]] size_t count(const Needle& value, size_t start = 0, size_t end = SIZE_MAX) const noexcept;
+
     /// Encodes the string into an array of bytes.
     /// @param encoding (optional) The string specifying the encoding to be used, default UTF-8.
     /// @param policy (optional) The policy to use if errors occurred during encoding, default strict.
@@ -189,11 +232,13 @@ namespace mamba {
     String expandtabs(size_t size = 8) const noexcept;
 
     /// Searches for the specified value in the string if it's present.
+    /// @note All search methods accept a precompiled Needle, to which strings convert implicitly. Compile
+    /// the needle once and pass it directly when the same value is searched for repeatedly.
     /// @param needle The string to search for in this string.
     /// @param start (optional) The position to start searching the string from.
     /// @param end (optional) The position to end searching string to.
     /// @return The index where the seeked string is located, -1 if it's not present.
-    [[nodiscard]] ssize_t find(const String& needle, size_t start = 0, const size_t end = SIZE_MAX) const noexcept;
+    [[nodiscard]] ssize_t find(const Needle& needle, size_t start = 0, const size_t end = SIZE_MAX) const noexcept;
 
     /// Substitutes the placeholders in the string ({name}, {0}, {}, etc.) with their corresponding
     /// values in the enumerable. Placeholders can be inserted by index or keyword.
@@ -201,22 +246,31 @@ namespace mamba {
     /// @return New formatted string.
     String format(const Enumerable& placeholders) const noexcept;
 
+    /// Substitutes the replacement fields in the string ({name}, {0}, {}, {!r:>10}, etc.) with the
+    /// arguments. The template is parsed once into a plan cached per thread, so the repeated calls
+    /// with the same template only resolve the arguments and write the result, see formatting.hh.
+    /// @param arguments The positional and keyword values to insert in the string.
+    /// @return New formatted string, or the empty string if an exception was raised.
+    String format(const FormatArguments& arguments) const noexcept;
+
     /// Searches for the value in the string and raises ValueError if not found.
     /// @param value The string to search for.
     /// @param start (optional) The index from which to search the string.
     /// @param end (optional) The index from which to end searching string.
     /// @return The index where the value begins, or raises ValueError if not found.
-    size_t index(const String& value, const size_t start = 0, const size_t end = SIZE_MAX) const noexcept;
+    size_t index(const Needle& value, const size_t start = 0, const size_t end = SIZE_MAX) const noexcept;
 
-    /// Tells if the string only contains ASCII letters (A-Za-z) and digits (0-9).
+    /// Tells if the string is not empty and only contains letters and characters representing numbers.
+    /// @note The is*() predicates classify the whole string at once on the first call and cache the
+    /// results, so every subsequent call takes constant time.
     /// @return True if all glyphs in the string are alphanumeric, false otherwise.
-    bool isalum() const noexcept;
+    bool isalnum() const noexcept;
 
-    /// Tells if the string only contains ASCII alphabet characters (A-Za-z).
+    /// Tells if the string is not empty and only contains letters of any alphabet, such as A-Z or Ж.
     /// @return True if all glyphs in the string are alphabetic, false otherwise.
     bool isalpha() const noexcept;
 
-    /// Tells if the string only contains ASCII characters.
+    /// Tells if the string only contains ASCII characters. Empty strings are ASCII.
     /// @return True if all glyphs in the string are ASCII, false otherwise.
     bool isascii() const noexcept;
 
@@ -225,8 +279,8 @@ namespace mamba {
     /// @return True if all characters represent a valid decimal value, false otherwise.
     bool isdecimal() const noexcept;
 
-    /// Tells if all characters in the string are ASCII digits from 0 to 9.
-    /// @return True if all characters are 0-9, false otherwise.
+    /// Tells if all characters in the string are digits, including decimals and exponents like ².
+    /// @return True if all characters are digits, false otherwise.
     bool isdigit() const noexcept;
 
     /// Tells if the string can be used as an identifier across most programming languages.
@@ -235,15 +289,15 @@ namespace mamba {
     /// @return True if the entire string is a valid identifier, false otherwise.
     bool isidentifier() const noexcept;
 
-     /// Tells if all characters in the string are either lowercase or does not have cases.
-     /// @return False if the string contains a single uppercase glyph, true otherwise.
-     bool islower() const noexcept;
+    /// Tells if all cased characters in the string are lowercase and there is at least one of them.
+    /// @return False if the string contains a single uppercase glyph or no cased ones, true otherwise.
+    bool islower() const noexcept;
 
-     /// Tells if all the characters in the string represent a number in one way or another.
-     /// Any Unicode decimals, fractions like ¾ or exponents like ² are considered numeric,
-     /// but fractions like 2.5 are not, since they contain the dot (.), which does not denote
-     /// a number.
-     /// @return True if all characters are numeric, false otherwise.
+    /// Tells if all the characters in the string represent a number in one way or another.
+    /// Any Unicode decimals, fractions like ¾ or exponents like ² are considered numeric,
+    /// but fractions like 2.5 are not, since they contain the dot (.), which does not denote
+    /// a number.
+    /// @return True if all characters are numeric, false otherwise.
     bool isnumeric() const noexcept;
 
     /// Tells if the entire string can be displayed as it's written in the source code.
@@ -263,8 +317,8 @@ namespace mamba {
     /// @return True if the string is a title, false otherwise.
     bool istitle() const noexcept;
 
-    /// Tells if the string is either upper-case or contains non-case characters.
-    /// @return False if the string a single lower-case character, true otherwise.
+    /// Tells if all cased characters in the string are uppercase and there is at least one of them.
+    /// @return False if the string contains a single lower-case glyph or no cased ones, true otherwise.
     bool isupper() const noexcept;
 
     /// Generates a new string where each item is converted into a string, concatenated
@@ -302,8 +356,8 @@ namespace mamba {
     /// @param replacementString A string as long as the first parameter. Every character in
     /// the replacement set will be replaced with the corresponding character in this argument by index.
     /// @param removeSet (optional) The set of characters to not include in the final string.
-    /// @return Translation table as a dictionary.
-    static Dictionary maketrans(const String& replacementSet,
+    /// @return Translation table compiled for the translate().
+    static Translator maketrans(const String& replacementSet,
                                 const String& replacementString, const String& removeSet = "");
 
     /// Searches for the specified string and returns a tuple containing 3 substrings: the part before the
@@ -319,21 +373,27 @@ namespace mamba {
     /// @param replacement The string to replace the target with.
     /// @param count (optional) The number or occurrences to replace. By default, all.
     /// @return New substituted string.
-    String replace(String& target, String& replacement, size_t count = SIZE_MAX) const noexcept;
+    String replace(const String& target, const String& replacement, size_t count = SIZE_MAX) const noexcept;
+
+    /// Replaces the occurrences of many strings at once in a single pass, leftmost first and longest first
+    /// among the ones starting at the same position. The replaced text is not searched again.
+    /// @param automaton The patterns and their replacements compiled together.
+    /// @return New substituted string.
+    String replace(const ReplacementAutomaton& automaton) const noexcept;
 
     /// Searches for the last occurrence of the string in the specified interval.
     /// @param value The value to find in the string.
     /// @param start (optional) The position from where to start searching.
     /// @param end (optional) The position from where to stop searching.
     /// @return The index of the last occurrence of the value, -1 if not found.
-    size_t rfind(const String& value, const size_t start = 0, const size_t end = SIZE_MAX) const noexcept;
+    ssize_t rfind(const Needle& value, const size_t start = 0, const size_t end = SIZE_MAX) const noexcept;
 
     /// Searches for the last occurrence of the string in the specified interval or raises ValueError.
     /// @param value The value to find in the string.
     /// @param start (optional) The position from where to start searching.
     /// @param end (optional) The position from where to stop searching.
     /// @return The index of the last occurrence of the value, raises ValueError is value was not found.
-    size_t rindex(const String& value, const size_t start = 0, const size_t end = SIZE_MAX) const noexcept;
+    size_t rindex(const Needle& value, const size_t start = 0, const size_t end = SIZE_MAX) const noexcept;
 
     /// Aligns the string to the right filling excessive space with the padding character.
     /// @param size The size of the final string.
@@ -397,14 +457,25 @@ namespace mamba {
     /// @return A new string with its case swapped.
     String swapcase() const noexcept;
 
+    /// Generates a new string where every word begins with a title-case character followed by
+    /// lowercase ones. A word is any sequence of cased characters, so "they're" becomes "They'Re".
+    /// @return A new string in the title case.
+    String title() const noexcept;
+
     /// For each key in the translation table, all occurrences in the string are replaced with the
     /// corresponding key value. The translation table can be generated with the maketrans method.
     /// @param table The dictionary or other mapping object that describes the translation to perform.
     /// @return A new translated string.
     String translate(const Dictionary& table) const noexcept;
 
+    /// Replaces every character with the one the compiled translation table maps it to.
+    /// @param table The table generated by the maketrans method.
+    /// @return A new translated string.
+    String translate(const Translator& table) const noexcept;
+
     /// Generates a new string with all characters turned into uppercase.
-    /// @return A new string where all characters are uppercase.
+    /// @return A new string where all characters are uppercase. If the string did not
+    /// contain lowercase characters, a copy-on-write reference is returned.
     String upper() const noexcept;
 
     /// Inserts zero digit characters (0) in the start of the string until it's length equals
@@ -418,11 +489,26 @@ namespace mamba {
     /// Metadata is used as the bitset containing 2 pieces of data. The last bit tells if the whole
     /// string only consists from the ASCII characters and is used in the isascii() method. The remaining
     /// bits are used to tell the last recently updated outpost and is used in updateOutpostCache method.
-    uint8_t lastRecentlyUpdatedOutpost = 0;
-    bool isOnlyAscii = false;
+    mutable uint8_t lastRecentlyUpdatedOutpost = 0;
+    bool isOnlyAscii = true;
+    mutable StringBitmask properties;
     GarbageCollected<char> stream;
-    size_t graphemes = 0;
-    std::array<Outpost, NumberOfOutposts> outposts;
+    size_t graphemes = 0, sizeInBytes = 0;
+    mutable size_t hashCode = 0;
+    mutable std::array<Outpost, NumberOfOutposts> outposts;
+
+    /// Adopts the buffer holding text that is already known to be valid UTF-8, such as the result of
+    /// transforming other strings, without verifying it again.
+    /// @param buffer The pool allocation holding the text followed by the zero terminator.
+    /// @param size The number of bytes in the text.
+    /// @param length The number of graphemes in the text.
+    /// @param isAscii Tells if the text only consists from ASCII characters.
+    String(const GarbageCollected<char>& buffer, size_t size, size_t length, bool isAscii) noexcept;
+
+    /// Implements the case methods: lower(), upper(), casefold(), swapcase(), title() and capitalize().
+    /// @param conversion The case conversion to perform.
+    /// @return The converted string, or a copy-on-write reference to this string if nothing changes.
+    String convertCase(CaseConversion conversion) const noexcept;
 
     /// For the input array of characters, this method verifies if it is valid UTF-8 encoded string. If yes,
     /// it counts and sets the related fields such as the size, graphemes and the is ASCII-only flag, but if not,
@@ -438,15 +524,41 @@ namespace mamba {
     /// @param slice The string slice to verify.
     void verifyEncodingAndConfigureString(const std::string_view& slice) noexcept;
 
+    /// Gives the results of the is*() predicates, classifying the string on the first call.
+    /// @return The bitmask of the whole string with InitialisedBit set.
+    const StringBitmask& getCharacterProperties() const noexcept;
+
     /// Selects an outpost to evict and overwrites it with new topical data.
     /// @param index The new grapheme index.
     /// @param destination The new relative offset where the grapheme begins.
-    void updateOutpostCache(size_t index, size_t destination) noexcept;
+    void updateOutpostCache(size_t index, size_t destination) const noexcept;
 
     /// Searches for the index of the char value where the specified grapheme begins.
     /// @param index The index of the grapheme in the string.
     /// @return The index of the byte where the grapheme begins.
-    size_t getGrapheme(size_t index);
+    size_t getGrapheme(size_t index) const noexcept;
+
+    /// The inverse of getGrapheme(): finds out which grapheme begins at the given byte. It is used to
+    /// translate the byte offsets produced by the search engine back into Python indexes.
+    /// @param destination The offset of the byte where a grapheme begins.
+    /// @return The index of the grapheme beginning at the byte.
+    size_t getGraphemeIndex(size_t destination) const noexcept;
+
+    /// Translates the optional start and end grapheme indexes taken by the search methods into byte
+    /// offsets, clamping them into the string the same way Python clamps slice bounds.
+    /// @param start The index of the first grapheme to search in.
+    /// @param end The index of the grapheme after the last one to search in.
+    /// @param beginning Output set to the offset of the first byte of the interval.
+    /// @param ending Output set to the offset of the byte after the interval.
+    /// @return False if the interval does not exist, such as when start lies beyond the end.
+    bool resolveSearchInterval(size_t start, size_t end, size_t& beginning, size_t& ending) const noexcept;
+
+    /// Pads the string with the fill character up to the size, the common part of center(), ljust() and rjust().
+    /// @param size The length of the final string.
+    /// @param padding The string of exactly one character to pad with, or TypeError is raised.
+    /// @param alignment Where to place the string: '<' to the left, '>' to the right or '^' in the centre.
+    /// @return The padded string, or this string if it is not shorter than the size.
+    String align(size_t size, const String& padding, char alignment) const noexcept;
 
     /// Creates a new substring from this string.
     /// @param beginning The index to the first byte to begin from.
@@ -459,6 +571,13 @@ namespace mamba {
     String generateSubstring(size_t beginning, size_t ending, size_t step = 0);
 
     friend std::ostream& operator<<(std::ostream& os, const String& text) noexcept;
+    friend class IncrementalUTF8Decoder;
+    friend class FormatPlan;
+    friend class StringBuilder;
+    friend class Translator;
+    friend class ReplacementAutomaton;
+    friend class Integer;
+    friend class MemoryView;
   };
 
 
@@ -11,7 +11,83 @@
 ===================================================================+*/
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <sys/types.h>
+
+#include "List.hh"
+#include "Object.hh"
+
 namespace mamba {
+  /// Represents the built-in tuple type in Python, the immutable sequence. The elements are held in a single
+  /// block of the pool right after a header keeping their number and the hash of the tuple, so that creating
+  /// the tuple takes one allocation, the handle is a single pointer, and the copies of the handle share the
+  /// elements, which never change. The hash is computed like in CPython the first time it is asked for and
+  /// kept in the header, where every copy finds it. Most tuples pack the several values of a return or the
+  /// items of a dictionary, and are unpacked right away, so their blocks are given back to the freelists of
+  /// the pool with release(), and the next tuple of the same arity, up to 8 elements, takes the block again
+  /// instead of growing the current frame.
+  class Tuple {
+   public:
+    /// Creates the empty tuple, which holds no block.
+    Tuple() noexcept = default;
+
+    /// Packs the elements, as in (first, second).
+    Tuple(std::initializer_list<Object> elements) noexcept;
+
+    /// Creates the tuple of the items of the list, as in tuple(items).
+    explicit Tuple(const List& items) noexcept;
+
+    /// Gives the element at the index, counting from the end if the index is negative, as in tuple[index].
+    /// @return The element, or None if the index is out of range, in which case IndexError is raised.
+    Object operator[](ssize_t index) const noexcept;
+
+    /// Compares the tuples element by element, as in tuple == other.
+    bool operator==(const Tuple& other) const noexcept;
+
+    /// Tells if the tuple has the element, as in element in tuple.
+    [[nodiscard]] bool contains(const Object& element) const noexcept;
+
+    /// Counts the elements equal to the given one, as in tuple.count(element).
+    [[nodiscard]] size_t count(const Object& element) const noexcept;
+
+    /// Finds the first element equal to the given one, as in tuple.index(element).
+    /// @return The index of the element, or SIZE_MAX if there is none, in which case ValueError is raised.
+    [[nodiscard]] size_t index(const Object& element) const noexcept;
+
+    /// Tells how many elements the tuple holds.
+    [[nodiscard]] size_t len() const noexcept;
+
+    /// Hashes the tuple like hash(tuple) in CPython, caching the hash.
+    [[nodiscard]] size_t hash() const noexcept;
+
+    /// Gives the block back to the pool and empties the tuple, once its elements are unpacked and no other
+    /// copy of the handle is used any longer, such as the tuple packing the values of a return.
+    void release() noexcept;
+
+   private:
+    /// The header of the block, which the elements follow.
+    struct Header {
+      /// The allocation the header was aligned in.
+      std::byte* allocation;
+      /// The hash computed by the first call of hash(), or ReservedHash, which no tuple hashes to, before it.
+      uint64_t hash;
+      size_t size;
+    };
+
+    Header* header = nullptr;
+
+    /// Tells how many bytes the block of the number of elements takes, with the room to align the header,
+    /// rounded up to whole words.
+    [[nodiscard]] static size_t getBlockSize(size_t size) noexcept;
+
+    /// Allocates the block of the number of elements, which the caller fills, and raises MemoryError if the
+    /// pool is exhausted.
+    /// @return False if the pool is exhausted, in which case the tuple stays empty.
+    bool allocate(size_t size) noexcept;
 
-  class Tuple {};
-}
\ No newline at end of file
+    /// Gives the elements following the header.
+    [[nodiscard]] Object* getElements() const noexcept;
+  };
+}
@@ -0,0 +1,161 @@
+/*+================================================================================================
+  File:        arithmetic.hh
+
+  Summary:     Low-level routines on the magnitudes of integers, stored as arrays of 32-bit cells
+               with the least significant cell first, behind the operators of Integer.
+
+  Notes:       Multiplication picks the algorithm by the size of the operands. Schoolbook is the
+               fastest below a few hundred decimal digits; Karatsuba splits the operands in halves and
+               replaces 4 half-sized products with 3, which gives O(n^1.585); Toom-3 splits them in
+               thirds and evaluates them at 5 points (0, 1, -1, -2 and infinity), replacing 9 products
+               with 5 for O(n^1.465). The interpolation of Toom-3 passes through negative values, which
+               are kept in two's complement in fixed-width buffers wide enough for every intermediate
+               result, so that the exact divisions by 2 and 3 become a shift and a multiplication by the
+               modular inverse of 3. Operands of very different sizes are cut into pieces the size of
+               the shorter one, so that the recursive algorithms always work on balanced halves.
+
+               The recursive algorithms need temporary cells for the evaluated operands and the partial
+               products. Callers allocate the whole scratch area once, sized by
+               getMultiplicationScratchSize(), and the recursion carves its buffers out of it from the
+               front, so that no level allocates on its own.
+
+               Division follows Algorithm D of Knuth: the divisor is shifted so that its top bit is set,
+               which keeps every estimated quotient cell at most 2 above the true one, and the estimate
+               is corrected with the 2 top cells of the divisor before it is multiplied and subtracted.
+               The estimates divide 2 cells by the top cell of the divisor with its reciprocal, after
+               Möller and Granlund, which takes 2 multiplications instead of a hardware division that
+               costs tens of cycles; the division by a single cell, behind the conversion to decimal
+               and the hashing of integers, runs the same way. Above a thousand decimal digits the
+               division switches to the recursion of Burnikel and Ziegler: the dividend is cut into
+               blocks the size of the divisor, and dividing 2 blocks by 1 is reduced to 2 divisions of
+               3 half-blocks by 2, each made of one half-sized division and one half-sized
+               multiplication, so that division takes about twice the time of multiplication instead of
+               quadratic time. Its scratch is carved from the front like the one of multiplication.
+
+               The linear routines, addition, subtraction, the bitwise operations, shifts and counting
+               the set bits, run on SSE2 or AVX2 kernels picked at runtime. Addition and subtraction add
+               the cells of a whole vector at once and then resolve the carries between its lanes in a
+               general purpose register, from the masks of the lanes that generate a carry and of the
+               lanes that pass it on. The operands below 16 cells skip the dispatch and run the scalar
+               loops, which are faster there.
+
+  Classes:     None
+
+  Functions:   gatherAlignedCells(), compareCells(), addCells(), subtractCells(), accumulateCells(),
+               deductCells(), multiplyCellsByCell(), getMultiplicationScratchSize(), multiplyCells(),
+               divideCellsByCell(), getDivisionScratchSize(), divideCells(), negateCells(),
+               combineCells(), shiftCellsLeft(), shiftCellsRight(), countCellBits()
+
+  Available under Apache Licence v2. Mamba Authors (2024)
+=================================================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../../givers/memory.hh"
+
+namespace mamba {
+  /// The size of the operands in cells from which Karatsuba multiplication outruns schoolbook.
+  constexpr size_t KaratsubaThreshold = 32;
+
+  /// The size of the operands in cells from which Toom-3 multiplication outruns Karatsuba.
+  constexpr size_t ToomCookThreshold = 160;
+
+  /// The size of the divisor and the quotient in cells from which Burnikel-Ziegler division outruns Algorithm D.
+  constexpr size_t BurnikelZieglerThreshold = 100;
+
+  /// The bitwise operations of combineCells().
+  enum class CellOperation : uint8_t {
+    And, Or, Xor
+  };
+
+  /// Allocates the cells on the pool aligned to their size, which the pool does not guarantee on its own.
+  /// @param count The number of cells.
+  /// @return The cells, with the capacity of exactly count cells from the aligned destination, which is
+  /// nullptr if the pool is exhausted.
+  GarbageCollected<uint32_t> gatherAlignedCells(size_t count) noexcept;
+
+  /// Compares 2 magnitudes, ignoring their leading zero cells.
+  /// @return Negative value if the left one is smaller, positive if it is larger, 0 if they are equal.
+  [[nodiscard]] int compareCells(const uint32_t* left, size_t leftSize, const uint32_t* right,
+                                 size_t rightSize) noexcept;
+
+  /// Adds 2 magnitudes. The sum may be written over the left operand.
+  /// @param left The longer operand.
+  /// @param right The shorter operand, with rightSize <= leftSize.
+  /// @param sum The destination for leftSize cells.
+  /// @return The carry out of the most significant cell, 0 or 1.
+  uint32_t addCells(const uint32_t* left, size_t leftSize, const uint32_t* right, size_t rightSize,
+                    uint32_t* sum) noexcept;
+
+  /// Subtracts the right magnitude from the left one. The difference may be written over the left operand.
+  /// @param left The longer operand.
+  /// @param right The shorter operand, with rightSize <= leftSize.
+  /// @param difference The destination for leftSize cells.
+  /// @return The borrow out of the most significant cell, 1 if the right operand was larger.
+  uint32_t subtractCells(const uint32_t* left, size_t leftSize, const uint32_t* right, size_t rightSize,
+                         uint32_t* difference) noexcept;
+
+  /// Adds the magnitude to the target in place, stopping as soon as the carry is absorbed.
+  /// @return The carry out of the most significant cell of the target.
+  uint32_t accumulateCells(uint32_t* target, size_t targetSize, const uint32_t* addend, size_t addendSize) noexcept;
+
+  /// Subtracts the magnitude from the target in place, stopping as soon as the borrow is absorbed.
+  /// @return The borrow out of the most significant cell of the target.
+  uint32_t deductCells(uint32_t* target, size_t targetSize, const uint32_t* subtrahend,
+                       size_t subtrahendSize) noexcept;
+
+  /// Multiplies the magnitude by a single cell. The product may be written over the operand.
+  /// @return The most significant cell of the product, which does not fit into size cells.
+  uint32_t multiplyCellsByCell(const uint32_t* cells, size_t size, uint32_t factor, uint32_t* product) noexcept;
+
+  /// Tells how many cells of scratch multiplyCells() needs for the operands of the given sizes.
+  /// @return The number of cells, or 0 if the product is computed without any scratch.
+  [[nodiscard]] size_t getMultiplicationScratchSize(size_t leftSize, size_t rightSize) noexcept;
+
+  /// Multiplies 2 magnitudes with the algorithm suited to their sizes.
+  /// @param product The destination for leftSize + rightSize cells, which must not overlap the operands.
+  /// @param scratch The temporary cells sized by getMultiplicationScratchSize(), or nullptr if they could
+  /// not be allocated, in which case the product is computed with schoolbook multiplication.
+  void multiplyCells(const uint32_t* left, size_t leftSize, const uint32_t* right, size_t rightSize,
+                     uint32_t* product, uint32_t* scratch) noexcept;
+
+  /// Divides the magnitude by a single cell, not zero. The quotient may be written over the dividend.
+  /// @param quotient The destination for size cells.
+  /// @return The remainder.
+  uint32_t divideCellsByCell(const uint32_t* cells, size_t size, uint32_t divisor, uint32_t* quotient) noexcept;
+
+  /// Tells how many cells of scratch divideCells() needs for the operands of the given sizes.
+  [[nodiscard]] size_t getDivisionScratchSize(size_t dividendSize, size_t divisorSize) noexcept;
+
+  /// Divides 2 magnitudes, truncating the quotient. None of the destinations may overlap the operands.
+  /// @param dividend The dividend, with dividendSize >= divisorSize.
+  /// @param divisor The divisor, whose most significant cell is not zero.
+  /// @param quotient The destination for dividendSize - divisorSize + 1 cells.
+  /// @param remainder The destination for divisorSize cells.
+  /// @param scratch The temporary cells sized by getDivisionScratchSize().
+  void divideCells(const uint32_t* dividend, size_t dividendSize, const uint32_t* divisor, size_t divisorSize,
+                   uint32_t* quotient, uint32_t* remainder, uint32_t* scratch) noexcept;
+
+  /// Negates the value held in two's complement in place, which also converts between a magnitude and
+  /// the two's complement of its negation.
+  void negateCells(uint32_t* cells, size_t size) noexcept;
+
+  /// Combines 2 arrays of cells of the same size bit by bit. The result may be written over either operand.
+  void combineCells(const uint32_t* left, const uint32_t* right, size_t size, uint32_t* result,
+                    CellOperation operation) noexcept;
+
+  /// Shifts the magnitude to the left by fewer than 32 bits.
+  /// @param result The destination for size cells, which must not overlap the operand.
+  /// @return The bits shifted out of the most significant cell, in the low bits of the cell.
+  uint32_t shiftCellsLeft(const uint32_t* cells, size_t size, unsigned shift, uint32_t* result) noexcept;
+
+  /// Shifts the magnitude to the right by fewer than 32 bits.
+  /// @param result The destination for size cells, which must not overlap the operand.
+  /// @return The bits shifted out of the least significant cell, in the high bits of the cell.
+  uint32_t shiftCellsRight(const uint32_t* cells, size_t size, unsigned shift, uint32_t* result) noexcept;
+
+  /// Counts the set bits of the magnitude.
+  [[nodiscard]] size_t countCellBits(const uint32_t* cells, size_t size) noexcept;
+}
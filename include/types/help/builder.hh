@@ -0,0 +1,106 @@
+/*+================================================================================================
+  File:        builder.hh
+
+  Summary:     Assembles new strings piece by piece from the values already known to be valid, such
+               as other strings, their slices, code points, integers and floats.
+
+  Notes:       Constructing a string from raw bytes validates them and counts the graphemes, which is
+               wasted work when the bytes come from other strings that were validated when they were
+               constructed themselves. The builder trusts its pieces instead: it keeps the grapheme
+               count and the ASCII flag up to date with every append and hands its buffer over to the
+               final string as is. The buffer grows geometrically on the pool with String::reserve(),
+               and the buffers left behind are marked as garbage right away, since nothing else refers
+               to them. Callers that know the final size up front should reserve it, so that the result
+               is written into a single buffer without any copy at all.
+
+  Classes:     StringBuilder
+
+  Functions:   None
+
+  Available under Apache Licence v2. Mamba Authors (2024)
+=================================================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../String.hh"
+
+namespace mamba {
+  /// Concatenates the pieces of a new string without validating them again, the primitive behind
+  /// concatenation, repetition, padding and replacement of strings.
+  class StringBuilder {
+   public:
+    StringBuilder() noexcept = default;
+
+    /// Creates the builder and reserves the space for the expected result.
+    /// @param sizeInBytes The expected size of the result in bytes.
+    explicit StringBuilder(size_t sizeInBytes) noexcept;
+
+    /// Ensures that the result can grow to the given size without reallocating the buffer.
+    /// @param sizeInBytes The expected size of the result in bytes.
+    /// @return Reference to self.
+    StringBuilder& reserve(size_t sizeInBytes) noexcept;
+
+    /// Appends the whole string.
+    /// @param text The string to append.
+    /// @return Reference to self.
+    StringBuilder& append(const String& text) noexcept;
+
+    /// Appends the slice of the string, text[start:end] in Python, with the indexes clamped the same way.
+    /// @param text The string to take the slice of.
+    /// @param start The index of the first grapheme of the slice.
+    /// @param end The index of the grapheme after the slice.
+    /// @return Reference to self.
+    StringBuilder& append(const String& text, size_t start, size_t end) noexcept;
+
+    /// Appends the bytes known to be valid UTF-8, such as a part of another string cut at grapheme
+    /// boundaries. The bytes are not validated, only their graphemes are counted.
+    /// @param data The pointer to the first byte to append.
+    /// @param sizeInBytes The number of bytes to append.
+    /// @return Reference to self.
+    StringBuilder& appendUTF8(const char* data, size_t sizeInBytes) noexcept;
+
+    /// Appends the character, as in chr(codePoint), optionally repeated.
+    /// @param codePoint The Unicode code point of the character. Surrogates and the values beyond U+10FFFF
+    /// cannot be represented in UTF-8, and raise ValueError.
+    /// @param count (optional) The number of times to append the character, default 1.
+    /// @return Reference to self.
+    StringBuilder& appendCharacter(uint32_t codePoint, size_t count = 1) noexcept;
+
+    /// Appends the decimal representation of the integer, as in str(value).
+    /// @param value The integer to append.
+    /// @return Reference to self.
+    StringBuilder& appendInteger(int64_t value) noexcept;
+
+    /// Appends the shortest decimal representation of the double, as in repr(value).
+    /// @param value The double to append.
+    /// @return Reference to self.
+    StringBuilder& appendFloat(double value) noexcept;
+
+    /// Tells how many graphemes were appended so far.
+    /// @return The length of the result.
+    [[nodiscard]] size_t len() const noexcept;
+
+    /// Finishes the string, handing the buffer over to it without copying or validating it. The builder
+    /// is empty afterwards and can be reused.
+    /// @return The built string, or the empty string if the pool ran out of memory while appending.
+    String build() noexcept;
+
+   private:
+    String text;
+    /// Tells if an allocation failed, in which case the next appends are ignored.
+    bool isExhausted = false;
+
+    /// Makes room for more bytes, growing the buffer geometrically.
+    /// @param moreBytes The number of bytes to append.
+    /// @return The pointer where the bytes are to be written, or nullptr if the pool ran out of memory.
+    char* prepare(size_t moreBytes) noexcept;
+
+    /// Records the appended bytes.
+    /// @param sizeInBytes The number of bytes written after prepare().
+    /// @param graphemes The number of graphemes in the written bytes.
+    /// @param isAscii Tells if the written bytes are ASCII.
+    void commit(size_t sizeInBytes, size_t graphemes, bool isAscii) noexcept;
+  };
+}
@@ -0,0 +1,54 @@
+/*+================================================================================================
+  File:        floating.hh
+
+  Summary:     Conversions between doubles and decimal text, behind Float::repr() and the parsing
+               constructor of Float.
+
+  Notes:       repr() prints the shortest decimal that reads back as the same double, which is
+               found with the Schubfach algorithm of Giulietti: the double and the midpoints to its
+               neighbours are scaled by a single 128-bit power of ten into fixed point, rounded to
+               odd so that the ties survive the truncation, and the shortest decimal is then either
+               the one the scaled value rounds to or the one with a digit less that still falls
+               between the midpoints. There is no loop over digits and no big integer, only 6
+               multiplications of 64 by 64 bits. The digits are then laid out the way CPython does,
+               in positional notation from 1e-4 up to 1e16 and in scientific notation outside.
+
+               Parsing reads the significand with the digits and underscores checked 8 bytes at a
+               time, keeping the first 19 significant digits. The exact small cases, up to 2^53
+               scaled by up to 10^22, take a single division or multiplication of doubles, which
+               is correctly rounded by itself. The others run the algorithm of Eisel and Lemire:
+               the significand is multiplied by the 128-bit mantissa of the power of ten, and the
+               top bits of the product give the result unless they sit too close to a tie, which
+               the low bits of the product tell. The rare close cases, and the literals of more
+               than 19 significant digits whose truncation changes the result, fall back to the
+               exact conversion of the standard library.
+
+               Both directions share the table of 128-bit powers of powers.hh.
+
+  Classes:     None
+
+  Functions:   formatShortestFloat(), parseFloat()
+
+  Available under Apache Licence v2. Mamba Authors (2024)
+=================================================================================================+*/
+#pragma once
+
+#include <cstddef>
+
+namespace mamba {
+  /// The largest number of characters formatShortestFloat() writes, reached by numbers such as
+  /// -2.2250738585072014e-308.
+  constexpr size_t MaximalFloatReprSize = 24;
+
+  /// Writes the shortest text that reads back as the same double, as in repr(value).
+  /// @param destination The destination for MaximalFloatReprSize characters.
+  /// @return The number of characters written.
+  size_t formatShortestFloat(double value, char* destination) noexcept;
+
+  /// Parses the float literal of float(), without the whitespace around it: the optional sign followed
+  /// by either a decimal number with optional fraction and exponent and single underscores between its
+  /// digits, or by inf, infinity or nan in any case.
+  /// @param value Output set to the nearest double, rounding the ties to even.
+  /// @return False if the text is not a valid literal, in which case the value is left untouched.
+  bool parseFloat(const char* first, const char* last, double& value) noexcept;
+}
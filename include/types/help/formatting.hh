@@ -0,0 +1,134 @@
+/*+================================================================================================
+  File:        formatting.hh
+
+  Summary:     Compiles the templates of str.format() and of the printf-style % operator into plans
+               that are rendered without parsing the template again.
+
+  Notes:       Logging and templated output call the same handful of templates over and over, so
+               parsing them on every call wastes most of the time spent formatting. A plan is the
+               template split once into the unescaped literal text and the sequence of placeholders
+               with their parsed specifiers (argument, conversion, fill, alignment, width, precision
+               and type). Plans are cached per thread in a small direct-mapped table keyed by the
+               cached hash of the template string, so a template kept in a variable or a constant is
+               found without hashing it again, and a hit costs a single comparison of the template
+               with the text the plan was compiled from. Rendering takes 2 passes over the plan: the first
+               one resolves the arguments and measures the result exactly, and the second one writes
+               it into a single buffer allocated in between, from which the string is constructed as
+               trusted without validating the UTF-8 again.
+
+               Only strings can be passed as arguments, since the other built-in types cannot be
+               converted into text yet. The numeric presentation types are parsed and kept in the plan
+               nevertheless, and raise the same exceptions as CPython does when they are applied to a
+               string. Nested replacement fields in format specifiers ("{:{width}}") and the attribute
+               and item access in field names ("{0.real}", "{0[1]}") are not supported and raise
+               ValueError.
+
+  Classes:     FormatSyntax, FormatArguments, FormatField, FormatPlan
+
+  Functions:   getFormatPlan()
+
+  Available under Apache Licence v2. Mamba Authors (2024)
+=================================================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mamba {
+  class String;
+
+  /// The precision value of the placeholders that do not specify it.
+  constexpr int32_t NoFormatPrecision = -1;
+
+  /// Tells which language the template is written in.
+  enum class FormatSyntax : uint8_t {
+    /// The replacement fields of str.format(), such as "{0}", "{name!r:>10}" or "{:.3}".
+    Braces,
+    /// The conversion specifiers of the % operator, such as "%s", "%(name)r" or "%-10.3s".
+    Percent
+  };
+
+  /// The values substituted into the placeholders of the template.
+  struct FormatArguments {
+    const String* positional = nullptr;
+    size_t positionalCount = 0;
+    /// The names of the keyword arguments, each one matching the value at the same index.
+    const String* keywordNames = nullptr;
+    const String* keywordValues = nullptr;
+    size_t keywordCount = 0;
+  };
+
+  /// The compiled placeholder of the template together with the literal text preceding it.
+  struct FormatField {
+    /// The number of bytes of the literal text between the previous placeholder and this one.
+    uint32_t literalSize = 0;
+    /// The index of the positional argument, used if the field is not named.
+    uint32_t argumentIndex = 0;
+    /// The location of the keyword in the names of the plan, used if the field is named.
+    uint32_t nameOffset = 0, nameSize = 0;
+    /// The hash of the keyword compared with the cached hashes of the argument names first.
+    uint64_t nameHash = 0;
+    uint32_t width = 0;
+    int32_t precision = NoFormatPrecision;
+    /// The conversion applied to the argument first: 's' for str(), 'r' for repr() and 'a' for ascii().
+    char conversion = 's';
+    /// The presentation type such as 's' or 'd', or 0 if the specifier omits it.
+    char type = 0;
+    /// The alignment ('<', '>', '^' or '='), or 0 for the default one of the argument type.
+    char align = 0;
+    /// The sign option ('+', '-' or ' '), or 0 if the specifier omits it.
+    char sign = 0;
+    /// The UTF-8 sequence of the fill character.
+    char fill[4] = {' '};
+    uint8_t fillSize = 1;
+    bool isKeyword = false, isAlternate = false, isZeroPadded = false, hasGrouping = false;
+    /// Tells if the width or the precision is taken from the arguments, as with "%*s".
+    bool isWidthFromArgument = false, isPrecisionFromArgument = false;
+  };
+
+  /// The template compiled into the literal text and the placeholders.
+  class FormatPlan {
+   public:
+    /// Parses the template, raising ValueError if it is malformed.
+    /// @param pattern The pointer to the valid UTF-8 text of the template.
+    /// @param sizeInBytes The size of the template.
+    /// @param syntax The language of the template.
+    /// @return False if the template is malformed, in which case the plan must not be rendered.
+    bool compile(const char* pattern, size_t sizeInBytes, FormatSyntax syntax) noexcept;
+
+    /// Substitutes the arguments into the placeholders.
+    /// @param arguments The values to substitute.
+    /// @return The formatted string, or the empty string if an exception was raised because an
+    /// argument is missing or cannot be presented as requested.
+    String render(const FormatArguments& arguments) const noexcept;
+
+   private:
+    /// The literal text of the template with the escapes such as "{{" and "%%" replaced.
+    std::string literals;
+    /// The keywords of the named fields, referenced by their offsets.
+    std::string names;
+    std::vector<FormatField> fields;
+    size_t literalGraphemes = 0;
+    /// The number of positional arguments the % operator expects exactly.
+    size_t expectedArgumentCount = 0;
+    FormatSyntax syntax = FormatSyntax::Braces;
+    bool isNamed = false;
+
+    bool compileBraces(const char* pattern, size_t sizeInBytes) noexcept;
+    bool compilePercent(const char* pattern, size_t sizeInBytes) noexcept;
+
+    /// Finds the argument of the placeholder.
+    /// @return The argument, or nullptr if it was not passed, in which case an exception is raised.
+    const String* resolveArgument(const FormatField& field, const FormatArguments& arguments) const noexcept;
+  };
+
+  /// Looks up the compiled plan of the template in the cache of the current thread, compiling the
+  /// template and replacing the plan in its slot of the cache if it is not there.
+  /// @param pattern The template.
+  /// @param syntax The language of the template.
+  /// @return The plan valid until the next call on the same thread, or nullptr if the template is
+  /// malformed, in which case ValueError is raised.
+  const FormatPlan* getFormatPlan(const String& pattern, FormatSyntax syntax) noexcept;
+}
@@ -0,0 +1,58 @@
+/*+================================================================================================
+  File:        hashing.hh
+
+  Summary:     The keyed hash function behind hash() of strings and the other hashable built-in
+               types, used to place the keys of dictionaries, sets and namespaces.
+
+  Notes:       Like in CPython, hashes are randomised with a secret generated once per process, so
+               that the hashes of the same value differ between runs and an attacker cannot craft a
+               batch of keys that collide in a dictionary in advance and degrade its lookups into
+               linear scans. CPython uses SipHash-1-3 for that purpose, which processes 8 bytes per
+               round in a single dependency chain. Mamba instead folds 128-bit products of the input
+               words mixed with the secret, the construction used by wyhash: the long input is consumed
+               48 bytes at a time in 3 independent lanes that the processor executes in parallel, and
+               short keys, which are by far the most common in dictionaries, are hashed with at most
+               4 loads and 2 multiplications without any loop or branch on their content. The function
+               is not a cryptographic PRF, but without knowledge of the 256-bit secret the collisions
+               cannot be computed offline.
+
+               The numbers are hashed like in CPython instead, by their values modulo the Mersenne
+               prime 2^61 - 1, so that the equal integers and floats, such as 1 and 1.0, share their
+               hashes and find each other in dictionaries. The residue of a rational number is cheap
+               to take, since 2^61 is 1 modulo the prime: the bits above the 61st are folded back by
+               a rotation, and the powers of 2 in the exponent of a float become rotations too.
+
+  Classes:     None
+
+  Functions:   hashBytes(), hashWord(), hashDouble()
+
+  Available under Apache Licence v2. Mamba Authors (2024)
+=================================================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mamba {
+  /// Hashes the array of bytes with the secret of the current process.
+  /// @param data The pointer to the first byte to hash.
+  /// @param sizeInBytes The number of bytes to hash.
+  /// @return The 64-bit hash, which is the same for equal arrays within the process, but differs
+  /// between processes.
+  uint64_t hashBytes(const void* data, size_t sizeInBytes) noexcept;
+
+  /// The prime the numbers are hashed modulo, as in sys.hash_info.modulus.
+  constexpr uint64_t NumericHashModulus = (uint64_t{1} << 61) - 1;
+
+  /// The hash of -1, which CPython reserves for errors, is replaced with the hash of -2.
+  constexpr uint64_t ReservedHash = UINT64_MAX;
+
+  /// Hashes the integer that fits into a machine word like hash(integer) in CPython.
+  /// @return The residue of the integer modulo NumericHashModulus, with the sign of the integer.
+  uint64_t hashWord(int64_t value) noexcept;
+
+  /// Hashes the float like hash(number) in CPython, so that the floats equal to integers hash like them.
+  /// @return The residue of the float modulo NumericHashModulus, with the sign of the float, or 314159 for
+  /// the infinities with their signs, or 0 for NaN.
+  uint64_t hashDouble(double value) noexcept;
+}
@@ -0,0 +1,78 @@
+/*+================================================================================================
+  File:        modular.hh
+
+  Summary:     Modular exponentiation on the magnitudes of integers, behind the three-argument
+               Integer::pow().
+
+  Notes:       Reducing every product with a division costs as much as the product itself. Montgomery
+               multiplication keeps the operands multiplied by R = 2^(64 n) for a modulus of n words
+               instead, and reduces a product by adding the multiple of the modulus that clears its
+               low n words, which are then dropped: a shift replaces the division. The multiplication
+               and the reduction are interleaved word by word (CIOS), so that the running product
+               never takes more than n + 2 words, and the final subtraction of the modulus selects the
+               result with a mask rather than a branch. Squarings, which make up most of the work,
+               compute every product of 2 different words once and double it before reducing the
+               square, which saves nearly half of their multiplications. The words are 64 bits wide with 128-bit
+               products, which quarters the multiplications of the 32-bit cells of Integer; the
+               moduli of 256, 512, 1024 and 2048 bits, the sizes of elliptic curves, RSA and
+               Diffie-Hellman, run on copies of the kernel with the number of words fixed at compile
+               time, so that the compiler unrolls the inner loops and keeps the running product in
+               registers or on the stack.
+
+               The exponent is scanned from its top bit with sliding windows of up to 6 bits that
+               start and end at set bits, so that a window of k bits costs a single multiplication by
+               one of the 2^(k - 1) odd powers of the base computed ahead; runs of zero bits cost
+               nothing but squarings. The window grows with the exponent, since the table of powers
+               pays off only over enough windows. The constant-time variant takes fixed windows of 4
+               bits over every cell of the exponent instead, multiplies even by the zero windows, and
+               reads the power it needs by scanning the whole table with masks, so that neither the
+               sequence of operations nor the memory accesses depend on the bits of the exponent,
+               only on its size.
+
+               Montgomery multiplication needs an odd modulus. The even moduli multiply the cells and
+               reduce the product with the division of arithmetic.hh, with the same windows; the time
+               of that division depends on the values, so the constant-time variant holds its promise
+               for the odd moduli of cryptography only.
+
+  Classes:     None
+
+  Functions:   powerWordModulo(), powerCellsModulo(), invertCellsModulo()
+
+  Available under Apache Licence v2. Mamba Authors (2024)
+=================================================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mamba {
+  /// Raises the base to the power of the exponent modulo the modulus that fits into a machine word.
+  /// @param base The base, below the modulus.
+  /// @param exponent The magnitude of the exponent, without leading zero cells.
+  /// @param modulus The modulus, above 1.
+  /// @param isConstantTime Whether the time must not depend on the bits of the exponent.
+  /// @return The power modulo the modulus.
+  [[nodiscard]] uint64_t powerWordModulo(uint64_t base, const uint32_t* exponent, size_t exponentSize,
+                                         uint64_t modulus, bool isConstantTime) noexcept;
+
+  /// Raises the base to the power of the exponent modulo the modulus.
+  /// @param base The magnitude of the base, below the modulus.
+  /// @param exponent The magnitude of the exponent, without leading zero cells.
+  /// @param modulus The magnitude of the modulus, above 1, whose most significant cell is not zero.
+  /// @param result The destination for modulusSize cells.
+  /// @param isConstantTime Whether the time must not depend on the bits of the exponent.
+  /// @return False if the pool ran out of memory, in which case MemoryError is raised.
+  bool powerCellsModulo(const uint32_t* base, size_t baseSize, const uint32_t* exponent, size_t exponentSize,
+                        const uint32_t* modulus, size_t modulusSize, uint32_t* result, bool isConstantTime) noexcept;
+
+  /// Finds the inverse of the value modulo the modulus with the extended algorithm of Euclid, for the
+  /// negative exponents of the three-argument pow().
+  /// @param value The magnitude of the value, below the modulus, without leading zero cells.
+  /// @param modulus The magnitude of the modulus, above 1, whose most significant cell is not zero.
+  /// @param inverse The destination for modulusSize cells.
+  /// @param isInvertible Output set to false if the value and the modulus share a factor, in which case there
+  /// is no inverse.
+  /// @return False if the pool ran out of memory, in which case MemoryError is raised.
+  bool invertCellsModulo(const uint32_t* value, size_t valueSize, const uint32_t* modulus, size_t modulusSize,
+                         uint32_t* inverse, bool& isInvertible) noexcept;
+}
@@ -0,0 +1,71 @@
+/*+================================================================================================
+  File:        radix.hh
+
+  Summary:     Conversion of the magnitudes of integers between the cells and decimal digits, behind
+               Integer::str() and the parsing constructor of Integer.
+
+  Notes:       Converting digit by digit, or even 9 digits by 9 with a division by 10^9, takes time
+               quadratic in the length of the number, which is why Python limits the conversion to a
+               few thousand digits. Both directions are split in halves instead: a number is divided
+               by a power of ten close to its square root, and the quotient and remainder are converted
+               on their own and written side by side; the digits are cut in halves, converted on their
+               own, and joined by multiplying the high half by the power of ten and adding the low
+               one. The powers are 10^(9 * 2^k), each one the square of the previous one, and they are
+               computed once per thread and kept for the later conversions. Joining the halves costs a
+               single multiplication, so parsing takes O(M(n) log n) with the multiplication of
+               arithmetic.hh, and formatting takes the same with its recursive division.
+
+               The halves below a few hundred digits are converted with the quadratic loop, which is
+               faster there. Parsing reads 18 digits at once, and any number of up to 19 digits, the
+               usual case of integers read from text files, is parsed without touching the cells at
+               all; on x86-64 the first 16 of those digits are combined with SSE2 multiply-add
+               instructions in 3 steps, pairs, quadruples and octets, instead of 16 dependent ones.
+
+               The temporary cells of every level live in their own frame of the pool, dropped when
+               the level returns, so that a conversion never holds more than a few times the size of
+               the number at once.
+
+  Classes:     None
+
+  Functions:   getDecimalDigitCapacity(), getDecimalCellCapacity(), formatDecimalCells(),
+               parseDecimalWord(), parseDecimalCells()
+
+  Available under Apache Licence v2. Mamba Authors (2024)
+=================================================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mamba {
+  /// The number of digits from which a conversion splits the number in halves.
+  constexpr size_t DecimalSplitThreshold = 360;
+
+  /// The largest number of digits parseDecimalWord() accepts.
+  constexpr size_t DecimalWordDigits = 19;
+
+  /// Tells how many decimal digits a magnitude of the given number of cells may have at most.
+  [[nodiscard]] size_t getDecimalDigitCapacity(size_t size) noexcept;
+
+  /// Tells how many cells a magnitude of the given number of decimal digits may need at most.
+  [[nodiscard]] size_t getDecimalCellCapacity(size_t count) noexcept;
+
+  /// Writes the decimal digits of the magnitude, without leading zeros.
+  /// @param cells The magnitude, not zero.
+  /// @param destination The destination for getDecimalDigitCapacity() characters.
+  /// @return The number of digits written, or 0 if the pool ran out of memory, in which case MemoryError
+  /// is raised.
+  size_t formatDecimalCells(const uint32_t* cells, size_t size, char* destination) noexcept;
+
+  /// Parses the decimal digits that fit into a machine word.
+  /// @param digits The ASCII digits, at most DecimalWordDigits of them.
+  /// @return The value of the digits.
+  [[nodiscard]] uint64_t parseDecimalWord(const char* digits, size_t count) noexcept;
+
+  /// Parses the decimal digits into a magnitude.
+  /// @param digits The ASCII digits.
+  /// @param cells The destination for getDecimalCellCapacity() cells.
+  /// @return The number of cells written, leading zero cells included, or 0 if the pool ran out of memory,
+  /// in which case MemoryError is raised.
+  size_t parseDecimalCells(const char* digits, size_t count, uint32_t* cells) noexcept;
+}
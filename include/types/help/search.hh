@@ -0,0 +1,96 @@
+/*+================================================================================================
+  File:        search.hh
+
+  Summary:     The substring search engine behind str.find(), str.rfind(), str.index(), str.count()
+               and the in operator. Searching operates on raw UTF-8 bytes: since UTF-8 is
+               self-synchronising, a byte-wise match of a valid needle in a valid haystack always
+               begins and ends at grapheme boundaries, so the string only needs to translate the
+               resulting byte offset into a grapheme index afterwards.
+
+  Notes:       The engine uses 2 algorithms. The primary one is a vectorised candidate filter that
+               compares the first and the last bytes of the needle against 16 (SSE2) or 32 (AVX2)
+               consecutive positions of the haystack at once and only verifies the positions where
+               both match. It is extremely fast on natural text, but degrades to O(n*m) on periodic
+               input such as searching "aaab" in "aaaa...", because every position is a candidate.
+               To keep the worst case linear, the filter tracks how many bytes it wasted on false
+               candidates, and once they exceed the budget proportional to the scanned distance, the
+               search continues with the Two-Way algorithm of Crochemore and Perrin, which runs in
+               O(n + m) time with constant extra space.
+
+  Classes:     TwoWayFactorisation, Needle
+
+  Functions:   None
+
+  Available under Apache Licence v2. Mamba Authors (2024)
+=================================================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <sys/types.h>
+
+namespace mamba {
+  class String;
+
+  /// The critical factorisation of a pattern used by the Two-Way algorithm. The pattern is split
+  /// at the critical position into the left and right halves, where the right half is matched
+  /// first and the left half is only checked once the right half matches fully.
+  struct TwoWayFactorisation {
+    size_t criticalPosition = 0, period = 1;
+    bool isPeriodic = false;
+  };
+
+  /// The precompiled substring that can be searched for repeatedly without analysing it again.
+  /// Compiling a needle computes the Two-Way factorisations for both search directions in O(m)
+  /// time, which is negligible for a single search but adds up when the same key is looked for
+  /// in many haystacks, such as when scanning logs line by line.
+  /// @note The needle does not copy the pattern, but references the buffer it was compiled from,
+  /// which must therefore stay alive for as long as the needle is used.
+  class Needle {
+   public:
+    Needle() = delete;
+    Needle(const Needle& other) = default;
+    Needle(Needle&& other) noexcept = default;
+
+    /// Compiles the needle from the raw UTF-8 bytes.
+    /// @param pattern The bytes of the substring to search for.
+    explicit Needle(const std::string_view& pattern) noexcept;
+
+    /// Compiles the needle from the zero-terminated array of characters, usually a literal.
+    /// @param pattern The pointer to the first character of the substring to search for.
+    explicit(false) Needle(const char* pattern) noexcept; //NOLINT
+
+    /// Compiles the needle from the string.
+    /// @param pattern The string to search for.
+    explicit(false) Needle(const String& pattern) noexcept; //NOLINT
+
+    Needle& operator=(const Needle& other) = default;
+    Needle& operator=(Needle&& other) noexcept = default;
+
+    /// Gives the number of bytes in the pattern.
+    /// @return The size of the needle in bytes.
+    [[nodiscard]] size_t size() const noexcept;
+
+    /// Gives the number of graphemes in the pattern.
+    /// @return The length of the needle as seen by len().
+    [[nodiscard]] size_t graphemes() const noexcept;
+
+    /// Searches for the first occurrence of the needle in the haystack.
+    /// @param haystack The pointer to the first byte of the text to search in.
+    /// @param sizeInBytes The number of bytes in the haystack.
+    /// @return The offset of the first byte of the match relative to the haystack, -1 if not found.
+    [[nodiscard]] ssize_t findIn(const char* haystack, size_t sizeInBytes) const noexcept;
+
+    /// Searches for the last occurrence of the needle in the haystack.
+    /// @param haystack The pointer to the first byte of the text to search in.
+    /// @param sizeInBytes The number of bytes in the haystack.
+    /// @return The offset of the first byte of the match relative to the haystack, -1 if not found.
+    [[nodiscard]] ssize_t rfindIn(const char* haystack, size_t sizeInBytes) const noexcept;
+
+    ~Needle() = default;
+   private:
+    const char* pattern;
+    size_t sizeInBytes, graphemeCount;
+    TwoWayFactorisation forward, backward;
+  };
+}
@@ -0,0 +1,69 @@
+/*+================================================================================================
+  File:        serialisation.hh
+
+  Summary:     Conversions between the magnitudes of integers and fixed-width byte strings in two's
+               complement, behind Integer::to_bytes() and Integer::from_bytes().
+
+  Notes:       The cells of a magnitude, read as bytes in memory order, are already the little-endian
+               encoding of its absolute value on every host Mamba targets, so the little-endian byte
+               strings are plain copies and the big-endian ones are the same bytes reversed. The
+               reversal runs on vector kernels picked at runtime: AVX2 reverses 32 bytes with one
+               shuffle inside each lane and one permutation across them, and SSE2, which has no byte
+               shuffle, swaps the bytes of every 16-bit word with shifts and reverses the words with
+               2 word shuffles and one doubleword shuffle.
+
+               Negative values are never negated in a buffer of their own. The two's complement of a
+               magnitude keeps its zero cells at the bottom, negates its lowest nonzero cell and
+               inverts every cell above it, so the copy of the cells above is made with an exclusive
+               or mask folded into the kernel, and only one cell is computed apart. Reading works the
+               other way round: the bytes of a negative value are copied inverted, which leaves the
+               magnitude minus one, and a single increment finishes it.
+
+               Values of up to 8 bytes take a word of their own and a single byte swap, which makes
+               the packed conversion of many small integers, the bulk of binary protocols, a loop of
+               loads and stores with no allocation.
+
+  Classes:     None
+
+  Functions:   getByteCellCapacity(), writeWordBytes(), readWordBytes(), writeCellBytes(), readCellBytes()
+
+  Available under Apache Licence v2. Mamba Authors (2024)
+=================================================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mamba {
+  /// Tells how many cells hold the magnitude read from the given number of bytes.
+  [[nodiscard]] constexpr size_t getByteCellCapacity(const size_t length) noexcept {
+    return (length + 3) / 4;
+  }
+
+  /// Writes the value held in two's complement in a machine word into the byte string, extending its sign
+  /// into the bytes above the word.
+  /// @param word The value in two's complement, whose bits above the length are copies of the sign.
+  /// @param isNegative Whether the value is negative, which picks the bytes above the word.
+  void writeWordBytes(uint64_t word, bool isNegative, std::byte* destination, size_t length,
+                      bool isBigEndian) noexcept;
+
+  /// Reads up to 8 bytes as a value in a machine word.
+  /// @param length The number of bytes, at most 8.
+  /// @param isSigned Whether the top bit of the bytes is a sign bit, which is then extended over the word.
+  /// @return The value in two's complement if it is signed, or the unsigned value otherwise.
+  [[nodiscard]] uint64_t readWordBytes(const std::byte* source, size_t length, bool isBigEndian,
+                                       bool isSigned) noexcept;
+
+  /// Writes the magnitude into the byte string in two's complement, negated if the sign asks so.
+  /// @param cells The magnitude, which must fit into the length with the sign.
+  /// @param destination The destination for length bytes.
+  void writeCellBytes(const uint32_t* cells, size_t size, bool isNegative, std::byte* destination, size_t length,
+                      bool isBigEndian) noexcept;
+
+  /// Reads the byte string as the magnitude and the sign of a value.
+  /// @param cells The destination for getByteCellCapacity(length) cells.
+  /// @param isSigned Whether the top bit of the bytes is a sign bit.
+  /// @return Whether the value is negative.
+  bool readCellBytes(const std::byte* source, size_t length, bool isBigEndian, bool isSigned,
+                     uint32_t* cells) noexcept;
+}
@@ -0,0 +1,134 @@
+/*+================================================================================================
+  File:        translation.hh
+
+  Summary:     Compiled tables behind str.translate() and str.maketrans(), and the automaton that
+               replaces many substrings at once in a single pass over the text.
+
+  Notes:       The translation table is compiled into the fastest form its rules allow. The tables
+               that only replace ASCII characters with other ASCII characters, the usual case of
+               sanitising identifiers or swapping separators, become a lookup table that is applied
+               to 32 bytes at once on AVX2 with 8 byte shuffles, one for every 16 entries of the
+               table, and to a byte at a time otherwise. The other tables keep a direct array for the
+               ASCII characters and a perfect hash table for the rest of the code points, built with
+               the hash-and-displace method: the keys are distributed into small buckets, and each
+               bucket gets the displacement that moves all of its keys into the free slots of the
+               table, so that every lookup takes 2 hashes and a single comparison.
+
+               The replacement automaton is the Aho-Corasick automaton over the bytes of the patterns,
+               whose transitions are resolved into a complete table indexed by byte classes, so that
+               the bytes absent from every pattern share the same column. The text is scanned once
+               for all patterns and the matches are replaced leftmost first and, among the matches
+               beginning at the same position, longest first, like the strtr() function of PHP. The
+               replaced text is never scanned again, and only the bytes read past the end of a match
+               while looking for a better one, never more than the longest pattern, are read twice.
+
+  Classes:     Translator, ReplacementAutomaton
+
+  Functions:   None
+
+  Available under Apache Licence v2. Mamba Authors (2024)
+=================================================================================================+*/
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mamba {
+  class String;
+
+  /// The replacement text stored in the compiled tables.
+  struct TranslationValue {
+    uint32_t offset = 0, sizeInBytes = 0;
+  };
+
+  /// The compiled translation table of str.translate(), as returned by str.maketrans().
+  class Translator {
+   public:
+    /// Creates the table that leaves every character intact.
+    Translator() noexcept = default;
+
+    /// Compiles the table from 2 strings of equal length, mapping each character of the first one to
+    /// the character at the same index of the second one, as in str.maketrans(x, y, z).
+    /// @param replacementSet The characters to replace.
+    /// @param replacementString The characters to replace them with. If the length differs from the first
+    /// argument, ValueError is raised and the table is left empty.
+    /// @param removeSet (optional) The characters to delete, which take precedence over the replacements.
+    Translator(const String& replacementSet, const String& replacementString, const String& removeSet) noexcept;
+
+    /// Compiles the table from the key-value pairs, as in str.maketrans(dictionary). Later pairs override
+    /// the earlier ones with the same key, and the empty value deletes the character.
+    /// @param keys The characters to replace. If any of them is not a single character, ValueError is
+    /// raised and the table is left empty.
+    /// @param values The strings to replace each key with, of any length.
+    /// @param count The number of pairs.
+    Translator(const String* keys, const String* values, size_t count) noexcept;
+
+    /// Applies the table to the string.
+    /// @param text The string to translate.
+    /// @return The translated string, or the string itself if no character of it is in the table.
+    String translate(const String& text) const noexcept;
+
+   private:
+    enum class TranslationKind : uint8_t {
+      Identity, AsciiBytes, General
+    };
+
+    TranslationKind kind = TranslationKind::Identity;
+    /// The bytes replacing the ASCII characters in the AsciiBytes tables.
+    std::array<uint8_t, 128> asciiBytes = {};
+    /// The indexes of the values replacing the ASCII characters in the General tables, or -1 to keep them.
+    std::array<int32_t, 128> asciiEntries = {};
+    /// The perfect hash table of the non-ASCII keys, with empty slots holding an invalid code point.
+    std::vector<uint32_t> hashedKeys;
+    std::vector<int32_t> hashedEntries;
+    std::vector<uint32_t> displacements;
+    std::string replacements;
+    std::vector<TranslationValue> values;
+
+    /// Chooses the form of the table and builds it from the rules, sorted by their code points.
+    void compile(std::vector<std::pair<uint32_t, TranslationValue>>& rules) noexcept;
+
+    /// Builds the perfect hash table of the non-ASCII keys.
+    /// @param entries The pairs of the non-ASCII keys and the indexes of their values.
+    void compilePerfectHash(const std::vector<std::pair<uint32_t, int32_t>>& entries) noexcept;
+
+    /// Looks up the value of the non-ASCII character.
+    /// @return The index of the value, or -1 if the character is kept.
+    [[nodiscard]] int32_t findHashedEntry(uint32_t codePoint) const noexcept;
+  };
+
+  /// Replaces many substrings at once, such as escaping all special characters of HTML in one pass.
+  class ReplacementAutomaton {
+   public:
+    /// Compiles the automaton. Later pairs override the earlier ones with the same pattern.
+    /// @param patterns The substrings to replace. If any of them is empty, ValueError is raised and
+    /// the automaton is left empty, replacing nothing.
+    /// @param replacements The strings to replace each pattern with.
+    /// @param count The number of pairs.
+    ReplacementAutomaton(const String* patterns, const String* replacements, size_t count) noexcept;
+
+    /// Replaces every non-overlapping occurrence of the patterns in the string.
+    /// @param text The string to search in.
+    /// @return The string with the occurrences replaced, or the string itself if there are none.
+    String replace(const String& text) const noexcept;
+
+   private:
+    /// The column of every byte in the transition table, 0 for the bytes absent from the patterns.
+    std::array<uint16_t, 256> byteClasses = {};
+    size_t classCount = 1;
+    /// The complete transition table, with a row of classCount states for every state.
+    std::vector<uint32_t> transitions;
+    /// The length of the pattern prefix every state represents.
+    std::vector<uint32_t> depths;
+    /// The longest pattern ending at every state, or -1 if there is none.
+    std::vector<int32_t> matches;
+    /// The sizes of the patterns in bytes.
+    std::vector<uint32_t> patternSizes;
+    std::string replacementText;
+    std::vector<TranslationValue> replacementValues;
+  };
+}
@@ -1,2 +1,4 @@
 #include "unicode/graphemes.hh"
-#include "unicode/conversions.hh"
\ No newline at end of file
+#include "unicode/conversions.hh"
+#include "unicode/cases.hh"
+#include "unicode/streaming.hh"
\ No newline at end of file
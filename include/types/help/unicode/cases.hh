@@ -0,0 +1,70 @@
+/*+================================================================================================
+  File:        cases.hh
+
+  Summary:     Provides the routines behind the case methods of strings: str.lower(), str.upper(),
+               str.casefold(), str.swapcase(), str.title() and str.capitalize(). The conversions
+               follow the full Unicode case mappings, so they may change the length of the string
+               (the German ß becomes SS in the upper case), and the final sigma rule of the Greek
+               alphabet, exactly like CPython does.
+
+  Notes:       Strings made of ASCII characters only are converted by a vectorised kernel that flips
+               the case bit (0x20) of the letters in 16 or 32 bytes at once, because their size never
+               changes. Other strings are converted in 2 passes: the first one measures the exact size
+               of the result, so that the second one can write it directly into a single allocation.
+
+  Classes:     CaseConversion, CaseConversionSummary
+
+  Functions:   findFirstAsciiCaseChange(const char*, size_t, CaseConversion),
+               convertAsciiCase(const char*, char*, size_t, CaseConversion),
+               measureCaseConversion(const char*, size_t, CaseConversion),
+               writeCaseConversion(const char*, size_t, char*, CaseConversion)
+
+  Available under Apache Licence v2. Mamba Authors (2024)
+=================================================================================================+*/
+#pragma once
+
+#include <cstddef>
+
+namespace mamba {
+  /// Represents the case conversions performed by the string methods of the same name.
+  enum class CaseConversion {
+    Lower, Upper, Fold, Swap, Title, Capitalize
+  };
+
+  /// Describes the string a case conversion produces, as found out by measureCaseConversion().
+  struct CaseConversionSummary {
+    size_t sizeInBytes = 0, graphemes = 0;
+    bool isOnlyAscii = true, isChanged = false;
+  };
+
+  /// Finds the first byte of ASCII text that the conversion would change. It allows case methods to
+  /// return the original string when nothing changes and to copy the unchanged prefix as is.
+  /// @param source The pointer to the ASCII text.
+  /// @param sizeInBytes The number of bytes in the text.
+  /// @param conversion The conversion to check for, one of Lower, Upper, Fold or Swap.
+  /// @return The offset of the first byte that changes, or the size of the text if none does.
+  size_t findFirstAsciiCaseChange(const char* source, size_t sizeInBytes, CaseConversion conversion) noexcept;
+
+  /// Converts the case of ASCII text. The source and destination may be the same buffer.
+  /// @param source The pointer to the ASCII text to convert.
+  /// @param destination The buffer of at least the same size receiving the converted text.
+  /// @param sizeInBytes The number of bytes in the text.
+  /// @param conversion The conversion to perform.
+  void convertAsciiCase(const char* source, char* destination, size_t sizeInBytes, CaseConversion conversion) noexcept;
+
+  /// Measures the result of converting the case of valid UTF-8 text without writing it.
+  /// @param source The pointer to the UTF-8 text.
+  /// @param sizeInBytes The number of bytes in the text.
+  /// @param conversion The conversion to perform.
+  /// @return The size, length and composition of the converted text.
+  CaseConversionSummary measureCaseConversion(const char* source, size_t sizeInBytes,
+                                              CaseConversion conversion) noexcept;
+
+  /// Converts the case of valid UTF-8 text.
+  /// @param source The pointer to the UTF-8 text.
+  /// @param sizeInBytes The number of bytes in the text.
+  /// @param destination The buffer large enough for the converted text as measured by measureCaseConversion().
+  /// @param conversion The conversion to perform.
+  void writeCaseConversion(const char* source, size_t sizeInBytes, char* destination,
+                           CaseConversion conversion) noexcept;
+}
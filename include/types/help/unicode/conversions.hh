@@ -5,20 +5,41 @@
                essentially implements the str.encode and bytes.decode methods.
 
   Notes:       In Python, both strings and byte arrays share an underlying similarity that they store
-               array of bytes. The str type in a lot of ways is similar to bytes but treats .
+               array of bytes. The str type in a lot of ways is similar to bytes but treats them as
+               UTF-8 text. Every routine transcodes in 2 passes over the input: the first one measures
+               the exact size of the output, so that the second one writes it into a single allocation
+               of the pool without ever growing it. Both passes process 16 (SSE2) or 32 (AVX2) code
+               units at once as long as they are ASCII or, when decoding, free of surrogates, and only
+               fall back to handling the remaining code units one by one. The UTF-16 and UTF-32
+               encoders prepend the byte order mark (BOM) and write little-endian code units, while
+               the decoders honour the BOM if present and assume little-endian code units otherwise,
+               which is what CPython does on little-endian hosts and what Windows produces.
 
-  Classes:     None
+  Classes:     StringEncodingPolicy
 
-  Functions:
+  Functions:   encodeStringIntoASCII(const char*, size_t, size_t, StringEncodingPolicy),
+               encodeStringIntoUTF16(const char*, size_t, size_t, StringEncodingPolicy),
+               encodeStringIntoUTF32(const char*, size_t, size_t, StringEncodingPolicy),
+               decodeUTF8IntoString(const char*, size_t, StringEncodingPolicy),
+               decodeUTF16IntoString(const char*, size_t, StringEncodingPolicy),
+               decodeUTF32IntoString(const char*, size_t, StringEncodingPolicy)
 
   Available under Apache Licence v2. Mamba Authors (2023)
 =================================================================================================+*/
 #pragma once
 
+#include <cstddef>
+
+#include "../../../givers/memory.hh"
+
 namespace mamba {
   /// Represents the policy to use during converting string to bytes in the str.encode() method.
   /// Despite its name, it is also used to decode bytes in the bytes.decode() method as the 2 share
   /// the vast majority of their options.
+  /// @note Since strings are always valid UTF-8, they can never hold lone surrogates: encoding never meets
+  /// them, and decoding treats them as errors under SurrogatePass the same way Strict does. Without the Unicode character
+  /// names at hand, NameReplace escapes characters the same way BackslashReplace does. Decoding only
+  /// supports Strict, Ignore, Replace and BackslashReplace, and treats the other policies as Strict.
   enum class StringEncodingPolicy {
     BackslashReplace, Ignore, NameReplace, Strict, Replace, SurrogatePass, XMLCharRefReplace
   };
@@ -26,26 +47,34 @@ namespace mamba {
   /// Casts the given string into ASCII. Note that UTF-8 is a wider type and attempting to convert it into
   /// ASCII is narrowing and may result into loss of information if the UTF-8 string contains non-ASCII
   /// graphemes. Use with caution.
-  /// @param string The string to encode.
+  /// @param string The valid UTF-8 string to encode.
+  /// @param sizeInBytes The number of bytes in the UTF-8 string.
   /// @param graphemes The number of graphemes in the UTF-8 string.
   /// @param policy String encoding policy that states how to handle errors.
-  /// @return Converted ASCII string allocated on the ActiveSetMemory pool.
-  GarbageCollected<char> encodeStringIntoASCII(const char* string, size_t graphemes, StringEncodingPolicy policy) noexcept;
+  /// @return Converted ASCII string allocated on the ActiveSetMemory pool, whose capacity is the exact size
+  /// of the output. Its destination is nullptr if the conversion failed.
+  GarbageCollected<char> encodeStringIntoASCII(const char* string, size_t sizeInBytes, size_t graphemes,
+                                               StringEncodingPolicy policy) noexcept;
 
   /// Casts the given string into its UTF-16 equivalent.
-  /// @param string The string to encode.
+  /// @param string The valid UTF-8 string to encode.
+  /// @param sizeInBytes The number of bytes in the UTF-8 string.
   /// @param graphemes The number of graphemes in the UTF-8 string.
   /// @param policy String encoding policy that states how to handle conversion errors.
-  /// @return Converted UTF-16 string allocated on the ActiveSetMemory pool.
-  GarbageCollected<char> encodeStringIntoUTF16(const char* string, size_t graphemes,
-                                                      StringEncodingPolicy policy) noexcept;
+  /// @return Converted UTF-16 string allocated on the ActiveSetMemory pool, whose capacity is the exact size
+  /// of the output including the BOM. Its destination is nullptr if the conversion failed.
+  GarbageCollected<char> encodeStringIntoUTF16(const char* string, size_t sizeInBytes, size_t graphemes,
+                                               StringEncodingPolicy policy) noexcept;
 
   /// Casts the given string into its UTF-32 equivalent.
-  /// @param string The string to encode.
+  /// @param string The valid UTF-8 string to encode.
+  /// @param sizeInBytes The number of bytes in the UTF-8 string.
   /// @param graphemes The number of graphemes in the UTF-8 string.
   /// @param policy String encoding policy that states how to handle conversion errors.
-  /// @return Converted UTF-32 string allocated on the ActiveSetMemory pool.
-  GarbageCollected<char> encodeStringIntoUTF32(const char* string, size_t graphemes, StringEncodingPolicy policy) noexcept;
+  /// @return Converted UTF-32 string allocated on the ActiveSetMemory pool, whose capacity is the exact size
+  /// of the output including the BOM. Its destination is nullptr if the conversion failed.
+  GarbageCollected<char> encodeStringIntoUTF32(const char* string, size_t sizeInBytes, size_t graphemes,
+                                               StringEncodingPolicy policy) noexcept;
 
   /// Decodes the supplied UTF-8 bytes back into a string. While this operation may seem to be trivial, it
   /// exists as a separate function because UTF-8 is the internal character encoding behind string in Mamba
@@ -56,22 +85,28 @@ namespace mamba {
   /// @param utf8Bytes The UTF-8 byte sequence to convert into a string.
   /// @param sizeInBytes The number of bytes the byte array holds.
   /// @param policy String encoding policy that states how to handle conversion errors.
-  /// @return Converted string allocated on the ActiveSetMemory pool.
-  GarbageCollected<char> decodeUTF8IntoString(const char* utf8Bytes, size_t sizeInBytes, StringEncodingPolicy policy) noexcept;
+  /// @return Converted string allocated on the ActiveSetMemory pool and followed by the zero terminator,
+  /// which the capacity includes. Its destination is nullptr if the conversion failed.
+  GarbageCollected<char> decodeUTF8IntoString(const char* utf8Bytes, size_t sizeInBytes,
+                                              StringEncodingPolicy policy) noexcept;
 
   /// Decodes the supplied UTF-16-encoded bytes and converts them into a valid string object. If
   /// the operation fails, the appropriate action is taken as stated by the conversion policy.
   /// @param utf16Bytes The UTF-16 byte sequence to convert into a string.
   /// @param sizeInBytes The number of bytes in the byte array.
   /// @param policy String encoding policy that states how to handle conversion errors.
-  /// @return Converted string allocated on the ActiveSetMemory pool.
-  GarbageCollected<char> decodeUTF16IntoString(const char* utf16Bytes, size_t sizeInBytes, StringEncodingPolicy policy) noexcept;
+  /// @return Converted string allocated on the ActiveSetMemory pool and followed by the zero terminator,
+  /// which the capacity includes. Its destination is nullptr if the conversion failed.
+  GarbageCollected<char> decodeUTF16IntoString(const char* utf16Bytes, size_t sizeInBytes,
+                                               StringEncodingPolicy policy) noexcept;
 
   /// Decodes the supplied UTF-32-encoded bytes and converts them into a valid string object. If
   /// the operation fails, the appropriate action is taken as stated by the conversion policy.
   /// @param utf32Bytes The UTF-32 byte sequence to convert into string.
   /// @param sizeInBytes The number of bytes in the byte array.
   /// @param policy String encoding policy that states how to handle conversion errors.
-  GarbageCollected<char> decodeUTF32IntoString(const char* utf32Bytes, size_t sizeInBytes, StringEncodingPolicy policy) noexcept;
-
-}
\ No newline at end of file
+  /// @return Converted string allocated on the ActiveSetMemory pool and followed by the zero terminator,
+  /// which the capacity includes. Its destination is nullptr if the conversion failed.
+  GarbageCollected<char> decodeUTF32IntoString(const char* utf32Bytes, size_t sizeInBytes,
+                                               StringEncodingPolicy policy) noexcept;
+}
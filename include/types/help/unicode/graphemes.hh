@@ -37,18 +37,26 @@
                getSizeOfUTF8Grapheme(uint32_t), getUnicodePointForUTF16(const char*),
                getUnicodePointForUTF16(const char*), getSizeOfUTF16Grapheme(const char*),
                getSizeOfUTf16Grapheme(uint32_t), getUnicodeCodePointForUTF32(const char*),
-               setBitmaskFlagsForCharacter(const char*, StringBitmask&)
+               setBitmaskFlagsForCharacter(const char*, StringBitmask&),
+               classifyUTF8Characters(const char*, size_t), countUTF8Graphemes(const char*, size_t)
 
   Available under Apache Licence v2. Mamba Authors (2023)
 ================================================================================================+*/
 #pragma once
 
 #include <bitset>
+#include <cstddef>
 #include <cstdint>
 namespace mamba {
+  /// The results of the str.is*() predicates for a whole string. Each predicate bit stays set as long as
+  /// every character seen so far satisfies it, except for LowerBit, UpperBit and TitleBit, which only
+  /// record that no character contradicts them yet and must be combined with CasedBit, because Python
+  /// requires at least one cased character for islower(), isupper() and istitle() to hold. The bit
+  /// PreviousCharacterIsSpaceBit tells if the last character was uncased and thus separates words for
+  /// istitle(), while InitialisedBit tells if any character has been classified at all.
   typedef std::bitset<15> StringBitmask;
   const auto AsciiBit = 0, AlphaBit = 1, AlphaNumericBit = 2, NumericBit = 3, DigitBit = 4, DecimalBit = 5,
-      IdentifierBit = 6, LowerBit = 7, UpperBit = 9, PrintableBit = 10, SpaceBit = 11, TitleBit = 12,
+      IdentifierBit = 6, LowerBit = 7, CasedBit = 8, UpperBit = 9, PrintableBit = 10, SpaceBit = 11, TitleBit = 12,
       PreviousCharacterIsSpaceBit = 13, InitialisedBit = 14;
 
   /// Analyses the code point for the given sequence of characters in the UTF-8 encoding.
@@ -105,7 +113,24 @@ namespace mamba {
   /// Evaluates a single character and determines its flags, such as if it is
   /// ASCII, alphabetic, numeric, alphanumeric, uppercase, lowercase, etc. This
   /// function must only run for a single character and be used in a loop.
-  /// @param character The pointer to the character to evaluate.
-  /// @param flags The output bitmask of the string.
+  /// @param character The pointer to the character to evaluate. It must be valid UTF-8.
+  /// @param flags The output bitmask of the string, empty before the first character.
   void setBitmaskFlagsForCharacter(const char* character, StringBitmask& flags);
+
+  /// Classifies all characters of the text at once, which is what strings cache to answer every
+  /// str.is*() predicate in constant time. Runs of ASCII characters are classified 16 (SSE2) or
+  /// 32 (AVX2) bytes at a time by range comparisons, and only the remaining characters are looked up
+  /// one by one in the Unicode database.
+  /// @param data The pointer to the first byte of valid UTF-8 text.
+  /// @param sizeInBytes The number of bytes in the text.
+  /// @return The bitmask of the whole text with InitialisedBit set, even if the text is empty.
+  StringBitmask classifyUTF8Characters(const char* data, size_t sizeInBytes) noexcept;
+
+  /// Counts the graphemes in a fragment of valid UTF-8 text. Since every grapheme has exactly one
+  /// leading byte, this amounts to counting the bytes that are not continuation bytes (10xxxxxx),
+  /// which is done a machine word at a time rather than by decoding each sequence.
+  /// @param data The pointer to the first byte of the fragment. It must begin at a grapheme boundary.
+  /// @param sizeInBytes The number of bytes in the fragment.
+  /// @return The number of graphemes that begin within the fragment.
+  size_t countUTF8Graphemes(const char* data, size_t sizeInBytes) noexcept;
 }
\ No newline at end of file
@@ -0,0 +1,58 @@
+/*+================================================================================================
+  File:        streaming.hh
+
+  Summary:     Decodes UTF-8 arriving in chunks of arbitrary size, such as when reading files and
+               pipes through fixed-size buffers, without first collecting the whole input in memory.
+
+  Notes:       A chunk may end in the middle of a multibyte sequence. The decoder holds the incomplete
+               sequence back, up to 3 bytes, and completes it with the beginning of the next chunk, so
+               that every piece it emits is valid UTF-8 on its own. Each chunk is validated exactly once
+               by the same vectorised decoder as decodeUTF8IntoString(), and the pieces are turned into
+               strings directly, without validating them again in the String constructor.
+
+  Classes:     IncrementalUTF8Decoder
+
+  Functions:   None
+
+  Available under Apache Licence v2. Mamba Authors (2024)
+=================================================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "conversions.hh"
+
+namespace mamba {
+  class String;
+
+  /// The resumable UTF-8 decoder, the equivalent of codecs.getincrementaldecoder("utf-8") in Python.
+  class IncrementalUTF8Decoder {
+   public:
+    /// Creates the decoder.
+    /// @param policy (optional) The policy to use if the input is invalid, default strict.
+    explicit IncrementalUTF8Decoder(StringEncodingPolicy policy = StringEncodingPolicy::Strict) noexcept;
+
+    /// Decodes the next chunk of the input.
+    /// @param chunk The pointer to the first byte of the chunk.
+    /// @param sizeInBytes The number of bytes in the chunk, which may be 0.
+    /// @param isFinal (optional) Tells if this is the last chunk, in which case the sequence left incomplete
+    /// at its end is an error rather than held back until the next chunk, default false.
+    /// @return The text decoded from the chunk, including the sequence completed from the previous one. If
+    /// the policy is strict and the chunk is invalid, UnicodeDecodeError is raised, the decoder is reset
+    /// and the empty string is returned.
+    String decode(const char* chunk, size_t sizeInBytes, bool isFinal = false) noexcept;
+
+    /// Tells how many bytes of an incomplete sequence the decoder holds back until the next chunk.
+    /// @return The number of bytes between 0 and 3.
+    [[nodiscard]] size_t getPendingSize() const noexcept;
+
+    /// Forgets the incomplete sequence held back, so that the decoder can start over with a new input.
+    void reset() noexcept;
+
+   private:
+    StringEncodingPolicy policy;
+    char pending[4] = {};
+    uint8_t pendingSize = 0;
+  };
+}
@@ -59,9 +59,22 @@ namespace mamba {
     topOfStack = frames.back();
     frames.pop_back();
     statistics.usedMemorySize -= reclaimedMemory;
+    for (size_t sizeClass = 0; sizeClass < RecycledClassCount; ++sizeClass) {
+      std::array<std::byte*, RecycledBlockLimit>& blocks = recycledBlocks[sizeClass];
+      size_t& count = recycledCounts[sizeClass];
+      for (size_t index = 0; index < count;) {
+        if (blocks[index] >= topOfStack) blocks[index] = blocks[--count];
+        else ++index;
+      }
+    }
   }
 
   std::byte* ActiveSetMemory::gather(const size_t bytesToAllocate) noexcept {
+    // The request takes the class of the words it spans, whose blocks all hold at least as many words.
+    const size_t sizeClass = (bytesToAllocate + WordSize - 1) / WordSize - 1;
+    if (sizeClass < RecycledClassCount && recycledCounts[sizeClass] > 0) {
+      return recycledBlocks[sizeClass][--recycledCounts[sizeClass]];
+    }
     if (topOfStack + bytesToAllocate > pool.get() + capacity) return nullptr;
     std::byte* destination = topOfStack;
     topOfStack += bytesToAllocate;
@@ -75,6 +88,16 @@ namespace mamba {
     return destination;
   }
 
+  void ActiveSetMemory::recycle(std::byte* const destination, const size_t size) noexcept {
+    // The block goes to the class of the whole words it holds, so that it fits every request of the class.
+    const size_t sizeClass = size / WordSize - 1;
+    if (sizeClass >= RecycledClassCount || recycledCounts[sizeClass] == RecycledBlockLimit) {
+      mark(destination, size);
+      return;
+    }
+    recycledBlocks[sizeClass][recycledCounts[sizeClass]++] = destination;
+  }
+
   void ActiveSetMemory::mark(const std::byte* destination, const size_t size) noexcept {
     const ptrdiff_t slabIndex = (destination - pool.get()) / SlabSize;
     const unsigned int pageIndex = std::ceil(slabIndex / PageSize);
@@ -129,6 +152,7 @@ namespace mamba {
       reclaimedGarbageSize += page.getGarbageSizeBefore(aliveSegment.destination);
     }
     topOfStack = resizedPool.get() + counter;
+    recycledCounts.fill(0);
     statistics.allocatedMemorySize = newSize;
     statistics.usedMemorySize = counter;
     pool = std::move(resizedPool);
@@ -150,6 +174,7 @@ namespace mamba {
     std::unique_ptr<std::byte[]> clearedSlots = std::make_unique<std::byte[]>(DefaultStackSize);
     pool = std::move(clearedSlots);
     topOfStack = pool.get();
+    recycledCounts.fill(0);
   }
 
 }
\ No newline at end of file
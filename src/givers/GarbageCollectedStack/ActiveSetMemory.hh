@@ -4,7 +4,8 @@
   Summary:     Exposes general-purpose GarbageCollectedStack pool used to store, manage, and collect
                application data in incremental garbage-collecting way utilising stack-based memory pool.
 
-  Constants:   DefaultStackSize, WordSize, InitialGrowthFactor, InitialPreservationFactor
+  Constants:   DefaultStackSize, WordSize, InitialGrowthFactor, InitialPreservationFactor,
+               RecycledClassCount, RecycledBlockLimit
 
   Classes:     SegmentStack, PreservationLifetime, ActiveMemoryAddress, MemoryUsageStatistics,
                ActiveSetMemory, Bookmark
@@ -15,6 +16,7 @@
 =================================================================================================+*/
 #pragma once
 
+#include <array>
 #include <memory>
 #include <vector>
 
@@ -25,6 +27,10 @@ namespace mamba {
   constexpr auto WordSize = sizeof(size_t);
   constexpr auto InitialGrowthFactor = 2;
   constexpr auto InitialPreservationFactor = 0;
+  /// The number of the size classes of the recycled blocks, one for each number of words up to 20 words.
+  constexpr size_t RecycledClassCount = 20;
+  /// The number of the recycled blocks a size class keeps, beyond which they are marked as garbage instead.
+  constexpr size_t RecycledBlockLimit = 32;
 
   /// Contains various data and fields denoting GarbageCollectedStack usage of the pool. It contains
   /// info about how much GarbageCollectedStack the pool holds (capacity), uses (sizeInBytes), and how many
@@ -162,6 +168,14 @@ namespace mamba {
     /// @return The destination to a new copied region.
     [[nodiscard]] std::byte* copy(const void* original, size_t size) noexcept;
 
+    /// Gives a small block back to the pool, whose next gather of a size fitting into it takes the block from
+    /// the freelist of its size class instead of the top of the stack. The blocks of the frame reclaimed by pop
+    /// are dropped from the freelists, as their memory goes back to the stack, and the blocks larger than the
+    /// size classes or beyond the limit of their class are marked as garbage instead.
+    /// @param destination The pointer to the beginning of the block, which nothing refers to any longer.
+    /// @param size The size of the block in bytes.
+    void recycle(std::byte* destination, size_t size) noexcept;
+
     /// Marks a memory sector as garbage. This step is necessary to inform the memory pool
     /// which frames are garbage and marks are primrarily used in the major GC phases whereas
     /// the pool resizes itself, in both growths and shrinks.
@@ -178,6 +192,9 @@ namespace mamba {
     MemoryUsageStatistics statistics = {0, 0, DefaultStackSize, 0, 0, 0};
     unsigned int growthFactor = InitialGrowthFactor, preservationFactor = InitialPreservationFactor;
     size_t capacity;
+    /// The freelists of the recycled blocks, the class of the blocks of n words at index n - 1.
+    std::array<std::array<std::byte*, RecycledBlockLimit>, RecycledClassCount> recycledBlocks;
+    std::array<size_t, RecycledClassCount> recycledCounts{};
 
     /// Generates a new memory pool and moves the alive sectors to there.
     /// @param newSize The size of the new memory pool in bytes, can be niether smaller or
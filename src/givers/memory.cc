@@ -64,6 +64,10 @@ namespace mamba {
     return generateGarbageCollectionSummary(previousStatistics, memory);
   }
 
+  void recycle(const GarbageCollected<>& target) noexcept {
+    select<ActiveSetMemory>().recycle(static_cast<std::byte*>(target.destination), target.capacity);
+  }
+
   void mark(const GarbageCollected<>& target) noexcept {
     select<ActiveSetMemory>().mark(static_cast<const std::byte*>(target.destination), target.capacity);
   }
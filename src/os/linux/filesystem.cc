@@ -1,4 +1,3 @@
-
 #include "os/filesystem.hh"
 
 namespace os {
@@ -10,4 +9,21 @@ namespace os {
   SyncFile::SyncFile(mamba::String& path, FileMode mode) {
     file = std::fstream(path.data());
   }
-}
\ No newline at end of file
+
+  void SyncFile::write(const mamba::Bytes& content) {
+    write(mamba::MemoryView(content));
+  }
+
+  void SyncFile::write(const mamba::MemoryView& content) {
+    (void)file.write(reinterpret_cast<const char*>(content.data()), static_cast<std::streamsize>(content.len()));
+  }
+
+  size_t SyncFile::readinto(const mamba::MemoryView& buffer) {
+    if (buffer.isReadOnly()) {
+      mamba::raise(mamba::Signal::TypeError, mamba::ExceptionReason::ReadOnlyBuffer);
+      return 0;
+    }
+    (void)file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.len()));
+    return static_cast<size_t>(file.gcount());
+  }
+}
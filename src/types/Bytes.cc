@@ -0,0 +1,306 @@
+#include "types/Bytes.hh"
+
+#include <algorithm>
+#include <cstring>
+
+#include "context.hh"
+#include "types/String.hh"
+#include "types/help/bytewise.hh"
+#include "types/help/unicode/utf8.hh"
+
+namespace mamba {
+  /// The capacity of the first block of a bytearray, which the small bytearrays never outgrow.
+  constexpr size_t SmallestBytearrayCapacity = 16;
+
+  /// Allocates the block of the number of bytes on the pool.
+  /// @return The block, whose destination is nullptr if the pool is exhausted, in which case MemoryError is raised.
+  static GarbageCollected<std::byte> gatherBytes(const size_t size) noexcept {
+    const GarbageCollected<std::byte> block = gather(size, GarbageCollectionGeneration::Eden);
+    if (block.destination == nullptr) raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+    return block;
+  }
+
+  /// Translates the index, counting from the end if it is negative, into the position in the bytes of the size,
+  /// and raises IndexError if it is out of range.
+  /// @return False if the index is out of range.
+  static bool locateByte(const ssize_t index, const size_t size, size_t& position) noexcept {
+    // The negative indexes beyond the start wrap around to positions far beyond the end.
+    position = static_cast<size_t>(index) + (index < 0 ? size : 0);
+    if (position < size) return true;
+    raise(Signal::IndexError, ExceptionReason::IndexOutOfRange);
+    return false;
+  }
+
+  /// Checks that the value is a byte, and raises ValueError if it is not in range(256).
+  static bool isByte(const int value) noexcept {
+    if (value >= 0 && value <= 255) return true;
+    raise(Signal::ValueError, ExceptionReason::ByteOutOfRange);
+    return false;
+  }
+
+  /// Gives the value of the hexadecimal digit, or -1 if the character is not one.
+  static int decodeHexadecimalDigit(const char character) noexcept {
+    if (character >= '0' && character <= '9') return character - '0';
+    if (character >= 'a' && character <= 'f') return character - 'a' + 10;
+    if (character >= 'A' && character <= 'F') return character - 'A' + 10;
+    return -1;
+  }
+
+  MemoryView::MemoryView(const Bytes& bytes) noexcept : start{bytes.buffer.destination}, size{bytes.size} { }
+
+  MemoryView::MemoryView(Bytearray& bytes) noexcept
+      : start{bytes.buffer.destination}, size{bytes.size}, readOnly{false} { }
+
+  MemoryView::MemoryView(std::byte* data, const size_t size, const bool isReadOnly) noexcept
+      : start{data}, size{size}, readOnly{isReadOnly} { }
+
+  Object MemoryView::operator[](const ssize_t index) const noexcept {
+    size_t position;
+    if (!locateByte(index, size, position)) return {};
+    return std::to_integer<int>(start[position]);
+  }
+
+  bool MemoryView::operator==(const MemoryView& other) const noexcept {
+    return size == other.size && (size == 0 || std::memcmp(start, other.start, size) == 0);
+  }
+
+  void MemoryView::set(const ssize_t index, const int value) const noexcept {
+    if (readOnly) {
+      raise(Signal::TypeError, ExceptionReason::ReadOnlyBuffer);
+      return;
+    }
+    size_t position;
+    if (!isByte(value) || !locateByte(index, size, position)) return;
+    start[position] = static_cast<std::byte>(value);
+  }
+
+  MemoryView MemoryView::slice(ssize_t first, ssize_t stop) const noexcept {
+    const auto length = static_cast<ssize_t>(size);
+    if (first < 0) first = std::max<ssize_t>(first + length, 0);
+    if (stop < 0) stop = std::max<ssize_t>(stop + length, 0);
+    first = std::min(first, length);
+    stop = std::clamp(stop, first, length);
+    return {start == nullptr ? nullptr : start + first, static_cast<size_t>(stop - first), readOnly};
+  }
+
+  ssize_t MemoryView::find(const Needle& needle) const noexcept {
+    if (needle.size() > size) return -1;
+    return needle.findIn(reinterpret_cast<const char*>(start), size);
+  }
+
+  size_t MemoryView::count(const Needle& needle) const noexcept {
+    if (needle.size() == 0) return size + 1;
+    if (needle.size() > size) return 0;
+    if (needle.size() == 1) {
+      // The first occurrence gives the byte of the needle, and the bytes before it need no counting.
+      const ssize_t offset = needle.findIn(reinterpret_cast<const char*>(start), size);
+      return offset < 0 ? 0 : countByte(start + offset, size - static_cast<size_t>(offset), start[offset]);
+    }
+    const auto* haystack = reinterpret_cast<const char*>(start);
+    size_t result = 0, offset = 0;
+    while (offset + needle.size() <= size) {
+      const ssize_t found = needle.findIn(haystack + offset, size - offset);
+      if (found < 0) break;
+      ++result;
+      offset += static_cast<size_t>(found) + needle.size();
+    }
+    return result;
+  }
+
+  String MemoryView::hex() const noexcept {
+    if (size == 0) return {};
+    const GarbageCollected<char> digits = gatherBytes(2 * size + 1);
+    if (digits.destination == nullptr) return {};
+    encodeHexadecimal(start, size, digits.destination);
+    digits.destination[2 * size] = '\0';
+    // The digits are ASCII, so the string needs no validation of their encoding.
+    return {digits, 2 * size, 2 * size, true};
+  }
+
+  Bytes MemoryView::tobytes() const noexcept {
+    return Bytes(*this);
+  }
+
+  size_t MemoryView::len() const noexcept {
+    return size;
+  }
+
+  bool MemoryView::isReadOnly() const noexcept {
+    return readOnly;
+  }
+
+  std::byte* MemoryView::data() const noexcept {
+    return start;
+  }
+
+  Bytes::Bytes(const std::string_view& bytes) noexcept
+      : Bytes(MemoryView(reinterpret_cast<std::byte*>(const_cast<char*>(bytes.data())), bytes.size(), true)) { }
+
+  Bytes::Bytes(const MemoryView& view) noexcept {
+    if (view.len() == 0) return;
+    buffer = gatherBytes(view.len());
+    if (buffer.destination == nullptr) return;
+    (void)std::memcpy(buffer.destination, view.data(), view.len());
+    size = view.len();
+  }
+
+  Bytes Bytes::fromhex(const String& text) noexcept {
+    const char* character = text.begin();
+    const char* const end = text.end();
+    // Every pair of digits decodes into a byte, so the block of half as many bytes as the text holds them all.
+    Bytes result;
+    if (end - character < 2) {
+      while (character != end && isAsciiWhitespace(*character)) ++character;
+      if (character != end) raise(Signal::ValueError, ExceptionReason::InvalidHexadecimalLiteral);
+      return result;
+    }
+    result.buffer = gatherBytes(static_cast<size_t>(end - character) / 2);
+    if (result.buffer.destination == nullptr) return {};
+    while (true) {
+      while (character != end && isAsciiWhitespace(*character)) ++character;
+      if (character == end) break;
+      const int high = decodeHexadecimalDigit(*character);
+      const int low = character + 1 == end ? -1 : decodeHexadecimalDigit(character[1]);
+      if (high < 0 || low < 0) {
+        mark(result.buffer);
+        raise(Signal::ValueError, ExceptionReason::InvalidHexadecimalLiteral);
+        return {};
+      }
+      result.buffer.destination[result.size++] = static_cast<std::byte>(high << 4 | low);
+      character += 2;
+    }
+    return result;
+  }
+
+  Object Bytes::operator[](const ssize_t index) const noexcept {
+    return MemoryView(*this)[index];
+  }
+
+  bool Bytes::operator==(const Bytes& other) const noexcept {
+    return MemoryView(*this) == MemoryView(other);
+  }
+
+  ssize_t Bytes::find(const Needle& needle) const noexcept {
+    return MemoryView(*this).find(needle);
+  }
+
+  size_t Bytes::count(const Needle& needle) const noexcept {
+    return MemoryView(*this).count(needle);
+  }
+
+  bool Bytes::contains(const Needle& needle) const noexcept {
+    return find(needle) >= 0;
+  }
+
+  String Bytes::hex() const noexcept {
+    return MemoryView(*this).hex();
+  }
+
+  size_t Bytes::len() const noexcept {
+    return size;
+  }
+
+  Bytearray::Bytearray(const size_t size) noexcept {
+    if (size == 0 || !ensureCapacity(size)) return;
+    (void)std::memset(buffer.destination, 0, size);
+    this->size = size;
+  }
+
+  Bytearray::Bytearray(const MemoryView& view) noexcept {
+    extend(view);
+  }
+
+  Bytearray::Bytearray(const Bytearray& other) noexcept {
+    extend(other.getView());
+  }
+
+  Bytearray::Bytearray(Bytearray&& other) noexcept
+      : buffer{other.buffer}, size{other.size}, capacity{other.capacity} {
+    other.buffer = GarbageCollected<std::byte>();
+    other.size = other.capacity = 0;
+  }
+
+  Bytearray& Bytearray::operator=(const Bytearray& other) noexcept {
+    if (this == &other) return *this;
+    clear();
+    extend(other.getView());
+    return *this;
+  }
+
+  Bytearray& Bytearray::operator=(Bytearray&& other) noexcept {
+    if (this == &other) return *this;
+    std::swap(buffer, other.buffer);
+    std::swap(size, other.size);
+    std::swap(capacity, other.capacity);
+    return *this;
+  }
+
+  Object Bytearray::operator[](const ssize_t index) const noexcept {
+    return getView()[index];
+  }
+
+  bool Bytearray::operator==(const Bytearray& other) const noexcept {
+    return getView() == other.getView();
+  }
+
+  void Bytearray::set(const ssize_t index, const int value) noexcept {
+    MemoryView(*this).set(index, value);
+  }
+
+  void Bytearray::append(const int value) noexcept {
+    if (!isByte(value) || !ensureCapacity(size + 1)) return;
+    buffer.destination[size++] = static_cast<std::byte>(value);
+  }
+
+  void Bytearray::extend(const MemoryView& view) noexcept {
+    const size_t count = view.len();
+    if (count == 0) return;
+    // The view of the bytearray itself moves with its bytes when they are reallocated.
+    const bool isSelf = view.data() >= buffer.destination && view.data() < buffer.destination + size;
+    const size_t offset = isSelf ? static_cast<size_t>(view.data() - buffer.destination) : 0;
+    if (!ensureCapacity(size + count)) return;
+    const std::byte* source = isSelf ? buffer.destination + offset : view.data();
+    (void)std::memcpy(buffer.destination + size, source, count);
+    size += count;
+  }
+
+  void Bytearray::clear() noexcept {
+    size = 0;
+  }
+
+  void Bytearray::reserve(const size_t required) noexcept {
+    if (required <= capacity) return;
+    const GarbageCollected<std::byte> replacement = gatherBytes(required);
+    if (replacement.destination == nullptr) return;
+    if (size > 0) (void)std::memcpy(replacement.destination, buffer.destination, size);
+    if (buffer.destination != nullptr) mark(buffer);
+    buffer = replacement;
+    capacity = required;
+  }
+
+  ssize_t Bytearray::find(const Needle& needle) const noexcept {
+    return getView().find(needle);
+  }
+
+  size_t Bytearray::count(const Needle& needle) const noexcept {
+    return getView().count(needle);
+  }
+
+  String Bytearray::hex() const noexcept {
+    return getView().hex();
+  }
+
+  size_t Bytearray::len() const noexcept {
+    return size;
+  }
+
+  MemoryView Bytearray::getView() const noexcept {
+    return {buffer.destination, size, false};
+  }
+
+  bool Bytearray::ensureCapacity(const size_t required) noexcept {
+    if (required <= capacity) return true;
+    reserve(std::max({required, capacity + capacity / 2, SmallestBytearrayCapacity}));
+    return capacity >= required;
+  }
+}
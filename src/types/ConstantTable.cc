@@ -0,0 +1,128 @@
+#include "types/ConstantTable.hh"
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "context.hh"
+#include "types/help/hashing.hh"
+#include "types/help/perfect-hash.hh"
+
+namespace mamba {
+  /// The number of displacements tried for a bucket before the table is given more slots than keys.
+  constexpr uint32_t LargestConstantDisplacement = 1U << 16;
+
+  /// The average number of keys in a bucket, which keeps the displacements of the last buckets, placed
+  /// into a nearly full table, short to find.
+  constexpr size_t KeysPerConstantBucket = 2;
+
+  /// Mixes the hash of the key with the seed into the well-distributed 64-bit hash, folding their product.
+  inline uint64_t mixConstantKey(const uint64_t hash, const uint32_t seed) noexcept {
+    __extension__ typedef unsigned __int128 MixedProduct;
+    const MixedProduct product = static_cast<MixedProduct>(hash ^ seed * 0xD6E8FEB86659FD93) * 0x9E3779B97F4A7C15;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+  }
+
+  /// Maps the mixed hash onto the range of the count with a multiplication rather than a division, as the
+  /// tables are not sized to powers of 2.
+  inline size_t reduceConstantKey(const uint64_t mixed, const size_t count) noexcept {
+    __extension__ typedef unsigned __int128 MixedProduct;
+    return static_cast<size_t>(static_cast<MixedProduct>(mixed) * count >> 64);
+  }
+
+  ConstantTable::ConstantTable(const Frozenset& elements) noexcept {
+    build(elements.elements(), {});
+  }
+
+  ConstantTable::ConstantTable(const Dictionary& items) noexcept {
+    build(items.keys(), items.values());
+  }
+
+  Object ConstantTable::operator[](const Object& key) const noexcept {
+    const Slot* slot = find(key);
+    if (slot != nullptr) return slot->value;
+    raise(Signal::KeyError, ExceptionReason::KeyNotFound);
+    return {};
+  }
+
+  bool ConstantTable::contains(const Object& key) const noexcept {
+    return find(key) != nullptr;
+  }
+
+  Object ConstantTable::get(const Object& key, const Object& fallback) const noexcept {
+    const Slot* slot = find(key);
+    return slot == nullptr ? fallback : slot->value;
+  }
+
+  size_t ConstantTable::len() const noexcept {
+    return size;
+  }
+
+  void ConstantTable::build(const List& keys, const List& values) noexcept {
+    const size_t count = keys.len();
+    if (count == 0) return;
+    std::vector<uint64_t> hashes(count);
+    for (size_t index = 0; index < count; ++index) hashes[index] = keys[static_cast<ssize_t>(index)].hash();
+    // The keys whose hashes equal the hashes of the keys before them are the twins, kept after the table.
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&hashes](const size_t left, const size_t right) {
+      return hashes[left] < hashes[right];
+    });
+    std::vector<size_t> entries, twins;
+    for (size_t position = 0; position < count; ++position) {
+      const bool isTwin = position > 0 && hashes[order[position]] == hashes[order[position - 1]];
+      (isTwin ? twins : entries).push_back(order[position]);
+    }
+
+    bucketCount = entries.size() / KeysPerConstantBucket + 1;
+    // The table starts with a slot per key, and only grows by an eighth if a bucket finds no displacement.
+    const PerfectHashPlacement placement = placePerfectHash(
+        entries.size(), bucketCount, entries.size(), LargestConstantDisplacement,
+        [&](const size_t entry) { return reduceConstantKey(mixConstantKey(hashes[entries[entry]], 0), bucketCount); },
+        [&](const size_t entry, const uint32_t displacement, const size_t tried) {
+          return reduceConstantKey(mixConstantKey(hashes[entries[entry]], displacement), tried);
+        },
+        [](const size_t tried) { return tried + tried / 8 + 1; });
+    slotCount = placement.slotKeys.size();
+
+    // The slots and the displacements share a block, aligned manually since the pool does not align it.
+    twinCount = twins.size();
+    const size_t slotBytes = (slotCount + twinCount) * sizeof(Slot);
+    const GarbageCollected<std::byte> block = gather(slotBytes + bucketCount * sizeof(uint32_t) + alignof(Slot) - 1,
+                                                     GarbageCollectionGeneration::Eden);
+    if (block.destination == nullptr) {
+      raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+      slotCount = bucketCount = twinCount = 0;
+      return;
+    }
+    size = count;
+    const auto address = reinterpret_cast<uintptr_t>(block.destination);
+    slots = reinterpret_cast<Slot*>((address + alignof(Slot) - 1) & ~(alignof(Slot) - 1));
+    displacements = reinterpret_cast<uint32_t*>(reinterpret_cast<std::byte*>(slots) + slotBytes);
+    std::copy(placement.displacements.begin(), placement.displacements.end(), displacements);
+    const auto fill = [&](Slot& slot, const size_t index) {
+      const auto position = static_cast<ssize_t>(index);
+      slot = {hashes[index], keys[position], values.len() == 0 ? Object() : values[position]};
+    };
+    for (size_t slot = 0; slot < slotCount; ++slot) {
+      // The slots left over when the table needs more slots than keys hold no key, and no key hashes to them.
+      if (placement.slotKeys[slot] == SIZE_MAX) slots[slot] = {ReservedHash, {}, {}};
+      else fill(slots[slot], entries[placement.slotKeys[slot]]);
+    }
+    for (size_t position = 0; position < twinCount; ++position) fill(slots[slotCount + position], twins[position]);
+  }
+
+  const ConstantTable::Slot* ConstantTable::find(const Object& key) const noexcept {
+    if (slotCount == 0) return nullptr;
+    const uint64_t hash = key.hash();
+    const uint32_t displacement = displacements[reduceConstantKey(mixConstantKey(hash, 0), bucketCount)];
+    const Slot& slot = slots[reduceConstantKey(mixConstantKey(hash, displacement), slotCount)];
+    if (slot.hash != hash) return nullptr;
+    if (slot.key == key) return &slot;
+    for (size_t position = slotCount; position < slotCount + twinCount; ++position) {
+      if (slots[position].hash == hash && slots[position].key == key) return &slots[position];
+    }
+    return nullptr;
+  }
+}
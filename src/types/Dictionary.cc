@@ -0,0 +1,351 @@
+#include "types/Dictionary.hh"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <utility>
+
+#include "context.hh"
+#include "types/help/probing.hh"
+namespace mamba {
+  bool Dictionary::isSameKey(const Entry& entry, const Object& key, const uint64_t hash) noexcept {
+    // The keys looked up with the objects they were stored with, such as the interned names, are the same
+    // inline value or boxed address, which spares comparing the values.
+    const Object& stored = entry.key;
+    if (stored.type == key.type && stored.isBoxed == key.isBoxed && stored.payload.integer == key.payload.integer) {
+      return true;
+    }
+    return entry.hash == hash && stored == key;
+  }
+
+  Dictionary::Dictionary(SharedKeys& keys) noexcept : sharedKeys{&keys} {}
+
+  Dictionary::Dictionary(const Dictionary& other) noexcept {
+    if (other.sharedKeys != nullptr) {
+      // The copy of an attribute dictionary shares the keys as well, copying only the values.
+      sharedKeys = other.sharedKeys;
+      if (other.size > 0 && ensureValueCapacity(other.size)) {
+        std::copy_n(other.sharedValues, other.size, sharedValues);
+        size = other.size;
+      }
+    } else if (other.size > 0) {
+      (void)rebuild(other.slotCount, other);
+    }
+  }
+
+  Dictionary::Dictionary(Dictionary&& other) noexcept
+      : table{other.table}, controls{other.controls}, slots{other.slots}, entries{other.entries},
+        slotCount{other.slotCount}, entryCount{other.entryCount}, size{other.size}, sharedKeys{other.sharedKeys},
+        sharedValues{other.sharedValues}, valueCapacity{other.valueCapacity} {
+    other.table = {};
+    other.controls = nullptr;
+    other.slots = nullptr;
+    other.entries = nullptr;
+    other.slotCount = other.entryCount = other.size = other.valueCapacity = 0;
+    other.sharedKeys = nullptr;
+    other.sharedValues = nullptr;
+  }
+
+  Dictionary& Dictionary::operator=(const Dictionary& other) noexcept {
+    if (this != &other) *this = Dictionary(other);
+    return *this;
+  }
+
+  Dictionary& Dictionary::operator=(Dictionary&& other) noexcept {
+    std::swap(table, other.table);
+    std::swap(controls, other.controls);
+    std::swap(slots, other.slots);
+    std::swap(entries, other.entries);
+    std::swap(slotCount, other.slotCount);
+    std::swap(entryCount, other.entryCount);
+    std::swap(size, other.size);
+    std::swap(sharedKeys, other.sharedKeys);
+    std::swap(sharedValues, other.sharedValues);
+    std::swap(valueCapacity, other.valueCapacity);
+    return *this;
+  }
+
+  Object Dictionary::operator[](const Object& key) const noexcept {
+    const Object* value = locate(key, key.hash());
+    if (value == nullptr) {
+      raise(Signal::KeyError, ExceptionReason::KeyNotFound);
+      return {};
+    }
+    return *value;
+  }
+
+  bool Dictionary::operator==(const Dictionary& other) const noexcept {
+    if (size != other.size) return false;
+    Entry item{};
+    for (size_t position = 0; position < getPositionCount(); ++position) {
+      if (!readItem(position, item)) continue;
+      const Object* value = other.locate(item.key, item.hash);
+      if (value == nullptr || !(*value == item.value)) return false;
+    }
+    return true;
+  }
+
+  Object Dictionary::get(const Object& key, const Object& fallback) const noexcept {
+    const Object* value = locate(key, key.hash());
+    return value == nullptr ? fallback : *value;
+  }
+
+  void Dictionary::set(const Object& key, const Object& value) noexcept {
+    insert(key, value, key.hash());
+  }
+
+  Object Dictionary::setdefault(const Object& key, const Object& fallback) noexcept {
+    const uint64_t hash = key.hash();
+    if (const Object* value = locate(key, hash); value != nullptr) return *value;
+    insert(key, fallback, hash);
+    return fallback;
+  }
+
+  Object Dictionary::pop(const Object& key) noexcept {
+    const uint64_t hash = key.hash();
+    const Object* found = locate(key, hash);
+    if (found == nullptr) {
+      raise(Signal::KeyError, ExceptionReason::KeyNotFound);
+      return {};
+    }
+    const Object value = *found;
+    // The values of a split dictionary follow the shared keys without gaps, so it cannot leave a vacant one.
+    if (sharedKeys != nullptr && !combine()) return {};
+    erase(find(key, hash));
+    return value;
+  }
+
+  void Dictionary::remove(const Object& key) noexcept {
+    (void)pop(key);
+  }
+
+  void Dictionary::update(const Dictionary& other) noexcept {
+    if (this == &other || other.size == 0) return;
+    // The keys of an empty dictionary cannot overlap, so the table is sized for all of them at once.
+    if (size == 0 && sharedKeys == nullptr && !ensureCapacity(other.size)) return;
+    Entry item{};
+    for (size_t position = 0; position < other.getPositionCount(); ++position) {
+      if (other.readItem(position, item)) insert(item.key, item.value, item.hash);
+    }
+  }
+
+  void Dictionary::clear() noexcept {
+    // The cleared attribute dictionary still shares the keys, since the instance usually sets them again.
+    if (table.destination != nullptr) mark(table);
+    *this = sharedKeys != nullptr ? Dictionary(*sharedKeys) : Dictionary();
+  }
+
+  bool Dictionary::contains(const Object& key) const noexcept {
+    return locate(key, key.hash()) != nullptr;
+  }
+
+  size_t Dictionary::len() const noexcept {
+    return size;
+  }
+
+  List Dictionary::keys() const noexcept {
+    List result;
+    result.reserve(size);
+    Entry item{};
+    for (size_t position = 0; position < getPositionCount(); ++position) {
+      if (readItem(position, item)) result.append(item.key);
+    }
+    return result;
+  }
+
+  List Dictionary::values() const noexcept {
+    List result;
+    result.reserve(size);
+    Entry item{};
+    for (size_t position = 0; position < getPositionCount(); ++position) {
+      if (readItem(position, item)) result.append(item.value);
+    }
+    return result;
+  }
+
+  void Dictionary::reserve(const size_t capacity) noexcept {
+    if (sharedKeys == nullptr && capacity > size) (void)ensureCapacity(capacity);
+  }
+
+  bool Dictionary::isSplit() const noexcept {
+    return sharedKeys != nullptr;
+  }
+
+  size_t Dictionary::getEntryCapacity(const size_t slotCount) noexcept {
+    return slotCount - slotCount / 8;
+  }
+
+  bool Dictionary::rebuild(const size_t newSlotCount, const Dictionary& source) noexcept {
+    // The entries follow the control bytes and the slots, which keeps them aligned as well.
+    const size_t newEntryCapacity = getEntryCapacity(newSlotCount);
+    GarbageCollected<std::byte> replacement;
+    auto* aligned = gatherTable(newSlotCount * (1 + sizeof(uint32_t)) + newEntryCapacity * sizeof(Entry), replacement);
+    if (aligned == nullptr) return false;
+    auto* newEntries = reinterpret_cast<Entry*>(aligned + newSlotCount * (1 + sizeof(uint32_t)));
+    size_t count = 0;
+    for (size_t position = 0; position < source.getPositionCount(); ++position) {
+      if (source.readItem(position, newEntries[count])) ++count;
+    }
+    if (this == &source && table.destination != nullptr) mark(table);
+    table = replacement;
+    controls = reinterpret_cast<uint8_t*>(aligned);
+    slots = reinterpret_cast<uint32_t*>(aligned + newSlotCount);
+    entries = newEntries;
+    slotCount = newSlotCount;
+    entryCount = size = count;
+    // The entries are placed by the hashes they cached, which are never computed again.
+    (void)std::memset(controls, EmptyControl, slotCount);
+    for (size_t position = 0; position < count; ++position) place(entries[position].hash, position);
+    return true;
+  }
+
+  bool Dictionary::ensureCapacity(const size_t required) noexcept {
+    // The vacant entries are not reused, so the appended entries take the room after the last one.
+    const size_t appended = required > size ? required - size : 0;
+    if (entryCount + appended <= getEntryCapacity(slotCount)) return true;
+    // The table is sized for twice the items it holds, so that rebuilding it takes amortised constant time
+    // per insertion, whether it grows or only drops the vacant entries.
+    size_t newSlotCount = SmallestSlotCount;
+    while (getEntryCapacity(newSlotCount) < std::max(required, 2 * size)) newSlotCount *= 2;
+    return rebuild(newSlotCount, *this);
+  }
+
+  size_t Dictionary::find(const Object& key, const uint64_t hash) const noexcept {
+    if (size == 0) return SIZE_MAX;
+    for (GroupProbe probe(hash, slotCount / GroupSize);; probe.next()) {
+      const uint8_t* group = controls + probe.getOffset();
+      for (uint32_t matches = matchTag(group, probe.getTag()); matches != 0; matches &= matches - 1) {
+        const size_t slot = probe.getOffset() + static_cast<size_t>(std::countr_zero(matches));
+        const Entry& entry = entries[slots[slot]];
+        if (isSameKey(entry, key, hash)) return slot;
+      }
+      if (matchEmpty(group) != 0) return SIZE_MAX;
+    }
+  }
+
+  Object* Dictionary::locate(const Object& key, const uint64_t hash) const noexcept {
+    if (sharedKeys != nullptr) {
+      // Only strings are shared, and no other key equals a string.
+      if (key.getType() != ObjectType::String) return nullptr;
+      const Dictionary& shared = sharedKeys->keys;
+      const size_t slot = shared.find(key, hash);
+      if (slot == SIZE_MAX) return nullptr;
+      // The dictionary holds the values of the first shared keys only, the others being set by other instances.
+      const size_t position = shared.slots[slot];
+      return position < size ? sharedValues + position : nullptr;
+    }
+    const size_t slot = find(key, hash);
+    return slot == SIZE_MAX ? nullptr : &entries[slots[slot]].value;
+  }
+
+  size_t Dictionary::getPositionCount() const noexcept {
+    return sharedKeys != nullptr ? size : entryCount;
+  }
+
+  bool Dictionary::readItem(const size_t position, Entry& item) const noexcept {
+    if (sharedKeys != nullptr) {
+      const Entry& shared = sharedKeys->keys.entries[position];
+      item = {shared.hash, shared.key, sharedValues[position]};
+      return true;
+    }
+    if (entries[position].key.isVacant()) return false;
+    item = entries[position];
+    return true;
+  }
+
+  void Dictionary::insert(const Object& key, const Object& value, const uint64_t hash) noexcept {
+    if (sharedKeys != nullptr && (insertShared(key, value, hash) || !combine())) return;
+    const size_t slot = find(key, hash);
+    if (slot != SIZE_MAX) {
+      entries[slots[slot]].value = value;
+      return;
+    }
+    if (!ensureCapacity(size + 1)) return;
+    entries[entryCount] = {hash, key, value};
+    place(hash, entryCount++);
+    ++size;
+  }
+
+  void Dictionary::place(const uint64_t hash, const size_t position) noexcept {
+    for (GroupProbe probe(hash, slotCount / GroupSize);; probe.next()) {
+      const uint32_t vacancies = matchVacancy(controls + probe.getOffset());
+      if (vacancies == 0) continue;
+      const size_t slot = probe.getOffset() + static_cast<size_t>(std::countr_zero(vacancies));
+      controls[slot] = probe.getTag();
+      slots[slot] = static_cast<uint32_t>(position);
+      return;
+    }
+  }
+
+  void Dictionary::erase(const size_t slot) noexcept {
+    Entry& entry = entries[slots[slot]];
+    entry.key = Object::makeVacant();
+    entry.value = {};
+    controls[slot] = DeletedControl;
+    --size;
+  }
+
+  bool Dictionary::insertShared(const Object& key, const Object& value, const uint64_t hash) noexcept {
+    // The keys of other types are never shared, since the keys equal to each other across types, such as 0
+    // and 0.0, would make the instances read the key another one set.
+    if (key.getType() != ObjectType::String) return false;
+    Dictionary& shared = sharedKeys->keys;
+    const size_t slot = shared.find(key, hash);
+    if (slot != SIZE_MAX) {
+      const size_t position = shared.slots[slot];
+      if (position < size) {
+        sharedValues[position] = value;
+        return true;
+      }
+      // The values cannot skip a shared key, so a key set out of order needs a table of its own.
+      if (position > size) return false;
+    } else if (size != shared.size || shared.size >= SharedKeys::MaximalCount) {
+      // Only the dictionary holding every shared key adds the next one, which keeps the keys in the order
+      // all the sharing dictionaries set them in.
+      return false;
+    }
+    if (!ensureValueCapacity(size + 1)) return true;
+    if (slot == SIZE_MAX) {
+      shared.insert(key, Object(), hash);
+      if (shared.size == size) return true;
+    }
+    sharedValues[size++] = value;
+    return true;
+  }
+
+  bool Dictionary::ensureValueCapacity(const size_t required) noexcept {
+    if (required <= valueCapacity) return true;
+    // The instances of a class mostly set all of its attributes, so the values are sized for the shared keys.
+    const size_t newCapacity =
+        std::min(std::max({required, sharedKeys->keys.size, 2 * valueCapacity}), SharedKeys::MaximalCount);
+    const GarbageCollected<std::byte> replacement =
+        gather(newCapacity * sizeof(Object) + alignof(Object) - 1, GarbageCollectionGeneration::Eden);
+    if (replacement.destination == nullptr) {
+      raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+      return false;
+    }
+    const auto address = reinterpret_cast<uintptr_t>(replacement.destination);
+    auto* newValues = reinterpret_cast<Object*>((address + alignof(Object) - 1) & ~(alignof(Object) - 1));
+    std::copy_n(sharedValues, size, newValues);
+    if (table.destination != nullptr) mark(table);
+    table = replacement;
+    sharedValues = newValues;
+    valueCapacity = newCapacity;
+    return true;
+  }
+
+  bool Dictionary::combine() noexcept {
+    // The table has room for the key whose insertion combines the dictionary, which is the usual reason.
+    size_t newSlotCount = SmallestSlotCount;
+    while (getEntryCapacity(newSlotCount) < size + 1) newSlotCount *= 2;
+    Dictionary combined;
+    if (!combined.rebuild(newSlotCount, *this)) return false;
+    if (table.destination != nullptr) mark(table);
+    *this = std::move(combined);
+    return true;
+  }
+
+  size_t SharedKeys::len() const noexcept {
+    return keys.len();
+  }
+}
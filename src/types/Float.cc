@@ -0,0 +1,101 @@
+#include "types/Float.hh"
+
+#include <cmath>
+
+#include "context.hh"
+#include "types/String.hh"
+#include "types/help/builder.hh"
+#include "types/help/floating.hh"
+#include "types/help/hashing.hh"
+#include "types/help/unicode/utf8.hh"
+namespace mamba {
+  Float::Float(const double primitiveFloat) noexcept : value{primitiveFloat} { }
+
+  Float::Float(const String& text) noexcept {
+    const char* first = text.begin();
+    const char* last = text.end();
+    while (first < last && isAsciiWhitespace(*first)) ++first;
+    while (last > first && isAsciiWhitespace(last[-1])) --last;
+    if (!parseFloat(first, last, value)) raise(Signal::ValueError, ExceptionReason::InvalidFloatLiteral);
+  }
+
+  Float Float::operator+(const Float& other) const noexcept {
+    return value + other.value;
+  }
+
+  Float Float::operator-(const Float& other) const noexcept {
+    return value - other.value;
+  }
+
+  Float Float::operator*(const Float& other) const noexcept {
+    return value * other.value;
+  }
+
+  Float Float::operator/(const Float& other) const noexcept {
+    if (other.value == 0.0) {
+      raise(Signal::ZeroDivisionError, ExceptionReason::DivisionByZero);
+      return {};
+    }
+    return value / other.value;
+  }
+
+  Float Float::operator-() const noexcept {
+    return -value;
+  }
+
+  Float& Float::operator+=(const Float& other) noexcept {
+    return *this = *this + other;
+  }
+
+  Float& Float::operator-=(const Float& other) noexcept {
+    return *this = *this - other;
+  }
+
+  Float& Float::operator*=(const Float& other) noexcept {
+    return *this = *this * other;
+  }
+
+  Float& Float::operator/=(const Float& other) noexcept {
+    return *this = *this / other;
+  }
+
+  bool Float::operator==(const Float& other) const noexcept {
+    return value == other.value;
+  }
+
+  bool Float::operator>(const Float& other) const noexcept {
+    return value > other.value;
+  }
+
+  bool Float::operator<(const Float& other) const noexcept {
+    return value < other.value;
+  }
+
+  bool Float::operator>=(const Float& other) const noexcept {
+    return value >= other.value;
+  }
+
+  bool Float::operator<=(const Float& other) const noexcept {
+    return value <= other.value;
+  }
+
+  Float::operator double() const noexcept {
+    return value;
+  }
+
+  String Float::repr() const noexcept {
+    return StringBuilder(MaximalFloatReprSize).appendFloat(value).build();
+  }
+
+  String Float::str() const noexcept {
+    return repr();
+  }
+
+  size_t Float::hash() const noexcept {
+    return hashDouble(value);
+  }
+
+  bool Float::is_integer() const noexcept {
+    return std::isfinite(value) && std::trunc(value) == value;
+  }
+}
@@ -0,0 +1,734 @@
+#include "types/Integer.hh"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+#include "context.hh"
+#include "types/String.hh"
+#include "types/help/arithmetic.hh"
+#include "types/help/builder.hh"
+#include "types/help/hashing.hh"
+#include "types/help/modular.hh"
+#include "types/help/radix.hh"
+#include "types/help/serialisation.hh"
+#include "types/help/unicode/utf8.hh"
+namespace mamba {
+  /// Allocates the cells of a new integer, raising MemoryError if the pool is exhausted.
+  GarbageCollected<uint32_t> gatherCells(const size_t count) noexcept {
+    GarbageCollected<uint32_t> buffer = gatherAlignedCells(count);
+    if (buffer.destination == nullptr) raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+    return buffer;
+  }
+
+  Integer::Integer() = default;
+
+  Integer::Integer(const int primitiveInteger) : value{primitiveInteger}, isNegative{primitiveInteger < 0} { }
+
+  Integer::Integer(const GarbageCollected<uint32_t>& address)
+      : Integer(address, address.capacity / sizeof(uint32_t), false) { }
+
+  Integer::Integer(const Integer& other) = default;
+
+  Integer::Integer(Integer&& other) noexcept = default;
+
+  /// Tells if the number of digits is above the limit of the conversions, which is lifted when it is 0.
+  bool isAboveConversionLimit(const size_t count) noexcept {
+    const size_t limit = getIntegerToStringConversionLimit();
+    return limit != 0 && count > limit;
+  }
+
+  Integer::Integer(const String& text) noexcept {
+    const char* first = text.begin();
+    const char* last = text.end();
+    while (first < last && isAsciiWhitespace(*first)) ++first;
+    while (last > first && isAsciiWhitespace(last[-1])) --last;
+    const bool isNegative = first < last && *first == '-';
+    if (first < last && (*first == '-' || *first == '+')) ++first;
+
+    // The underscores are only allowed between digits, and the digits are copied without them into the
+    // scratch block only if there are any.
+    bool hasUnderscores = false;
+    for (const char* character = first; character < last; ++character) {
+      if (*character >= '0' && *character <= '9') continue;
+      if (*character != '_' || character == first || character + 1 == last || character[1] == '_') {
+        raise(Signal::ValueError, ExceptionReason::InvalidIntegerLiteral);
+        return;
+      }
+      hasUnderscores = true;
+    }
+    if (hasUnderscores) {
+      const GarbageCollected<char> digits = gather(last - first, GarbageCollectionGeneration::Eden);
+      if (digits.destination == nullptr) {
+        raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+        return;
+      }
+      last = std::remove_copy(first, last, digits.destination, '_');
+      first = digits.destination;
+    }
+    const auto count = static_cast<size_t>(last - first);
+    if (count == 0) {
+      raise(Signal::ValueError, ExceptionReason::InvalidIntegerLiteral);
+      return;
+    }
+    if (isAboveConversionLimit(count)) {
+      raise(Signal::ValueError, ExceptionReason::IntegerToStringConversionLimitViolation);
+      return;
+    }
+
+    if (count <= DecimalWordDigits) {
+      *this = fromMagnitude(parseDecimalWord(first, count), isNegative);
+      return;
+    }
+    const GarbageCollected<uint32_t> buffer = gatherCells(getDecimalCellCapacity(count));
+    if (buffer.destination == nullptr) return;
+    *this = Integer(buffer, parseDecimalCells(first, count, buffer.destination), isNegative);
+  }
+
+  Integer::Integer(const GarbageCollected<uint32_t>& buffer, size_t size, const bool isNegative) noexcept {
+    while (size > 0 && buffer.destination[size - 1] == 0) --size;
+    if (size <= 2) {
+      const uint64_t magnitude = size == 0 ? 0 : buffer.destination[0] |
+                                                  (size == 2 ? static_cast<uint64_t>(buffer.destination[1]) << 32 : 0);
+      if (magnitude <= INT64_MAX || (isNegative && magnitude == uint64_t{1} << 63)) {
+        value = static_cast<int64_t>(isNegative ? 0 - magnitude : magnitude);
+        this->isNegative = value < 0;
+        return;
+      }
+    }
+    cells = buffer;
+    numberOfCells = size;
+    this->isNegative = isNegative;
+  }
+
+  Integer& Integer::operator=(const int primitiveInteger) noexcept {
+    return *this = Integer(primitiveInteger);
+  }
+
+  Integer& Integer::operator=(const size_t other) noexcept {
+    return *this = fromMagnitude(other, false);
+  }
+
+  Integer& Integer::operator=(Integer&& other) noexcept = default;
+
+  Integer Integer::operator+(const size_t other) const noexcept {
+    int64_t result;
+    if (isInline() && other <= INT64_MAX && !__builtin_add_overflow(value, static_cast<int64_t>(other), &result)) {
+      return fromValue(result);
+    }
+    return *this + fromMagnitude(other, false);
+  }
+
+  Integer Integer::operator*(const size_t other) const noexcept {
+    int64_t result;
+    if (isInline() && other <= INT64_MAX && !__builtin_mul_overflow(value, static_cast<int64_t>(other), &result)) {
+      return fromValue(result);
+    }
+    if (other > UINT32_MAX) return *this * fromMagnitude(other, false);
+    uint32_t storage[2];
+    const Magnitude magnitude = getMagnitude(storage);
+    const GarbageCollected<uint32_t> product = gatherCells(magnitude.size + 1);
+    if (product.destination == nullptr) return {};
+    product.destination[magnitude.size] = multiplyCellsByCell(magnitude.cells, magnitude.size,
+                                                              static_cast<uint32_t>(other), product.destination);
+    return {product, magnitude.size + 1, isNegative};
+  }
+
+  Integer& Integer::operator+=(const size_t other) noexcept {
+    return *this = *this + other;
+  }
+
+  Integer& Integer::operator-=(const size_t other) noexcept {
+    int64_t result;
+    if (isInline() && other <= INT64_MAX && !__builtin_sub_overflow(value, static_cast<int64_t>(other), &result)) {
+      return *this = fromValue(result);
+    }
+    return *this = *this - fromMagnitude(other, false);
+  }
+
+  Integer& Integer::operator*=(const size_t other) noexcept {
+    return *this = *this * other;
+  }
+
+  Integer Integer::operator/(const size_t other) const noexcept {
+    return divide(*this, fromMagnitude(other, false)).first;
+  }
+
+  Integer Integer::operator%(const size_t other) const noexcept {
+    return divide(*this, fromMagnitude(other, false)).second;
+  }
+
+  Integer& Integer::operator/=(const size_t other) noexcept {
+    return *this = *this / other;
+  }
+
+  Integer& Integer::operator%=(const size_t other) noexcept {
+    return *this = *this % other;
+  }
+
+  Integer Integer::operator+(const Integer& other) const noexcept {
+    int64_t result;
+    if (isInline() && other.isInline() && !__builtin_add_overflow(value, other.value, &result)) return fromValue(result);
+    if (isNegative == other.isNegative) return addMagnitudes(*this, other, isNegative);
+    return subtractMagnitudes(*this, other, isNegative);
+  }
+
+  Integer Integer::operator-(const Integer& other) const noexcept {
+    int64_t result;
+    if (isInline() && other.isInline() && !__builtin_sub_overflow(value, other.value, &result)) return fromValue(result);
+    if (isNegative != other.isNegative) return addMagnitudes(*this, other, isNegative);
+    return subtractMagnitudes(*this, other, isNegative);
+  }
+
+  Integer Integer::operator*(const Integer& other) const noexcept {
+    int64_t result;
+    if (isInline() && other.isInline() && !__builtin_mul_overflow(value, other.value, &result)) return fromValue(result);
+    uint32_t leftStorage[2], rightStorage[2];
+    const Magnitude left = getMagnitude(leftStorage), right = other.getMagnitude(rightStorage);
+    if (left.size == 0 || right.size == 0) return {};
+    const size_t size = left.size + right.size;
+    const GarbageCollected<uint32_t> product = gatherCells(size);
+    if (product.destination == nullptr) return {};
+    const size_t scratchSize = getMultiplicationScratchSize(left.size, right.size);
+    if (scratchSize == 0) multiplyCells(left.cells, left.size, right.cells, right.size, product.destination, nullptr);
+    else {
+      // The scratch lives in its own frame, which is dropped as a whole once the product is known. If the
+      // pool cannot fit it, multiplyCells() falls back to schoolbook multiplication.
+      split();
+      const GarbageCollected<uint32_t> scratch = gatherAlignedCells(scratchSize);
+      multiplyCells(left.cells, left.size, right.cells, right.size, product.destination, scratch.destination);
+      untie();
+    }
+    return {product, size, isNegative != other.isNegative};
+  }
+
+  Integer& Integer::operator+=(const Integer& other) noexcept {
+    return *this = *this + other;
+  }
+
+  Integer& Integer::operator-=(const Integer& other) noexcept {
+    return *this = *this - other;
+  }
+
+  Integer& Integer::operator*=(const Integer& other) noexcept {
+    return *this = *this * other;
+  }
+
+  Integer Integer::operator/(const Integer& other) const noexcept {
+    return divide(*this, other).first;
+  }
+
+  Integer Integer::operator%(const Integer& other) const noexcept {
+    return divide(*this, other).second;
+  }
+
+  Integer& Integer::operator/=(const Integer& other) noexcept {
+    return *this = *this / other;
+  }
+
+  Integer& Integer::operator%=(const Integer& other) noexcept {
+    return *this = *this % other;
+  }
+
+  Integer Integer::pow(const Integer& exponent) const noexcept {
+    if (exponent.isNegative) {
+      raise(Signal::ValueError, ExceptionReason::NegativeExponent);
+      return {};
+    }
+    // The bits of the exponent are taken from the top, squaring the power before every one of them.
+    uint32_t storage[2];
+    const Magnitude bits = exponent.getMagnitude(storage);
+    Integer power(1);
+    for (size_t index = bits.size * 32; index-- > 0;) {
+      power *= power;
+      if ((bits.cells[index / 32] >> (index % 32) & 1) != 0) power *= *this;
+    }
+    return power;
+  }
+
+  Integer Integer::pow(const Integer& exponent, const Integer& modulus) const noexcept {
+    return powModulo(*this, exponent, modulus, false);
+  }
+
+  Integer Integer::powConstantTime(const Integer& exponent, const Integer& modulus) const noexcept {
+    return powModulo(*this, exponent, modulus, true);
+  }
+
+  Integer Integer::operator&(const Integer& other) const noexcept {
+    if (isInline() && other.isInline()) return fromValue(value & other.value);
+    return combine(*this, other, CellOperation::And);
+  }
+
+  Integer Integer::operator|(const Integer& other) const noexcept {
+    if (isInline() && other.isInline()) return fromValue(value | other.value);
+    return combine(*this, other, CellOperation::Or);
+  }
+
+  Integer Integer::operator^(const Integer& other) const noexcept {
+    if (isInline() && other.isInline()) return fromValue(value ^ other.value);
+    return combine(*this, other, CellOperation::Xor);
+  }
+
+  Integer Integer::operator~() const noexcept {
+    if (isInline()) return fromValue(~value);
+    // The inversion is -x - 1 in two's complement, which only moves the magnitude by one.
+    Integer negation = *this;
+    negation.isNegative = !isNegative;
+    return negation - Integer(1);
+  }
+
+  Integer Integer::operator<<(const Integer& other) const noexcept {
+    uint64_t count;
+    if (!getShiftCount(other, count) || (isInline() && value == 0)) return {};
+    if (isInline() && count < 64) {
+      const auto shifted = static_cast<int64_t>(static_cast<uint64_t>(value) << count);
+      if (shifted >> count == value) return fromValue(shifted);
+    }
+    if (count == UINT64_MAX) {
+      raise(Signal::OverflowError, ExceptionReason::IntegerTooLarge);
+      return {};
+    }
+    uint32_t storage[2];
+    const Magnitude magnitude = getMagnitude(storage);
+    const size_t offset = count / 32, size = magnitude.size + offset + 1;
+    const GarbageCollected<uint32_t> result = gatherCells(size);
+    if (result.destination == nullptr) return {};
+    std::fill(result.destination, result.destination + offset, 0);
+    result.destination[size - 1] = shiftCellsLeft(magnitude.cells, magnitude.size, count % 32,
+                                                  result.destination + offset);
+    return {result, size, isNegative};
+  }
+
+  Integer Integer::operator>>(const Integer& other) const noexcept {
+    uint64_t count;
+    if (!getShiftCount(other, count)) return {};
+    if (isInline()) return fromValue(value >> std::min<uint64_t>(count, 63));
+    const uint64_t offset = count / 32;
+    if (offset >= numberOfCells) return isNegative ? fromValue(-1) : Integer();
+    const size_t size = numberOfCells - offset;
+    const GarbageCollected<uint32_t> result = gatherCells(size + 1);
+    if (result.destination == nullptr) return {};
+    const uint32_t remainder = shiftCellsRight(cells.destination + offset, size, count % 32, result.destination);
+    result.destination[size] = 0;
+    // Shifting a negative value rounds towards negative infinity, so the magnitude is rounded up if any of
+    // the bits shifted out was set.
+    if (isNegative && (remainder != 0 || std::any_of(cells.destination, cells.destination + offset,
+                                                     [](const uint32_t cell) { return cell != 0; }))) {
+      const uint32_t one = 1;
+      (void)accumulateCells(result.destination, size + 1, &one, 1);
+    }
+    return {result, size + 1, isNegative};
+  }
+
+  Integer& Integer::operator&=(const Integer& other) noexcept {
+    return *this = *this & other;
+  }
+
+  Integer& Integer::operator|=(const Integer& other) noexcept {
+    return *this = *this | other;
+  }
+
+  Integer& Integer::operator^=(const Integer& other) noexcept {
+    return *this = *this ^ other;
+  }
+
+  Integer& Integer::operator<<=(const Integer& other) noexcept {
+    return *this = *this << other;
+  }
+
+  Integer& Integer::operator>>=(const Integer& other) noexcept {
+    return *this = *this >> other;
+  }
+
+  bool Integer::operator==(const Integer& other) const noexcept {
+    // Every value has a single form, so the inline values never equal the ones in the cells.
+    if (isInline() || other.isInline()) return isInline() && other.isInline() && value == other.value;
+    return isNegative == other.isNegative &&
+           compareCells(cells.destination, numberOfCells, other.cells.destination, other.numberOfCells) == 0;
+  }
+
+  bool Integer::operator>(const Integer& other) const noexcept {
+    return other < *this;
+  }
+
+  bool Integer::operator<(const Integer& other) const noexcept {
+    if (isInline() && other.isInline()) return value < other.value;
+    if (isNegative != other.isNegative) return isNegative;
+    uint32_t leftStorage[2], rightStorage[2];
+    const Magnitude left = getMagnitude(leftStorage), right = other.getMagnitude(rightStorage);
+    const int comparison = compareCells(left.cells, left.size, right.cells, right.size);
+    return isNegative ? comparison > 0 : comparison < 0;
+  }
+
+  bool Integer::operator>=(const Integer& other) const noexcept {
+    return !(*this < other);
+  }
+
+  bool Integer::operator<=(const Integer& other) const noexcept {
+    return !(other < *this);
+  }
+
+  String Integer::str() const noexcept {
+    if (isInline()) return StringBuilder(20).appendInteger(value).build();
+    // The number of digits is at least the one of the lowest value with as many bits, which rejects the
+    // values far above the limit before spending any time on them.
+    const size_t bits = 32 * numberOfCells - std::countl_zero(cells.destination[numberOfCells - 1]);
+    if (isAboveConversionLimit((bits - 1) * 30102 / 100000 + 1)) {
+      raise(Signal::ValueError, ExceptionReason::IntegerToStringConversionLimitViolation);
+      return {};
+    }
+    const GarbageCollected<char> buffer = gather(getDecimalDigitCapacity(numberOfCells) + 2,
+                                                 GarbageCollectionGeneration::Eden);
+    if (buffer.destination == nullptr) {
+      raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+      return {};
+    }
+    const size_t count = formatDecimalCells(cells.destination, numberOfCells, buffer.destination + isNegative);
+    if (count == 0) return {};
+    if (isAboveConversionLimit(count)) {
+      raise(Signal::ValueError, ExceptionReason::IntegerToStringConversionLimitViolation);
+      return {};
+    }
+    if (isNegative) buffer.destination[0] = '-';
+    const size_t size = count + isNegative;
+    buffer.destination[size] = '\0';
+    return {buffer, size, size, true};
+  }
+
+  size_t Integer::bit_length() const noexcept {
+    uint32_t storage[2];
+    const Magnitude magnitude = getMagnitude(storage);
+    if (magnitude.size == 0) return 0;
+    return 32 * (magnitude.size - 1) + std::bit_width(magnitude.cells[magnitude.size - 1]);
+  }
+
+  size_t Integer::bit_count() const noexcept {
+    if (isInline()) return std::popcount(isNegative ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value));
+    return countCellBits(cells.destination, numberOfCells);
+  }
+
+  GarbageCollected<std::byte> Integer::to_bytes(const size_t length, const bool isBigEndian,
+                                                const bool isSigned) const noexcept {
+    if (!fitsIntoBytes(length, isSigned) || length == 0) return {};
+    const GarbageCollected<std::byte> bytes = gather(length, GarbageCollectionGeneration::Eden);
+    if (bytes.destination == nullptr) {
+      raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+      return {};
+    }
+    writeBytes(bytes.destination, length, isBigEndian);
+    return bytes;
+  }
+
+  GarbageCollected<std::byte> Integer::to_bytes(const Integer* integers, const size_t count, const size_t length,
+                                                const bool isBigEndian, const bool isSigned) noexcept {
+    // Every integer is checked before anything is allocated, so that the buffer is either whole or absent.
+    for (size_t index = 0; index < count; ++index) {
+      if (!integers[index].fitsIntoBytes(length, isSigned)) return {};
+    }
+    if (count * length == 0) return {};
+    const GarbageCollected<std::byte> bytes = gather(count * length, GarbageCollectionGeneration::Eden);
+    if (bytes.destination == nullptr) {
+      raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+      return {};
+    }
+    for (size_t index = 0; index < count; ++index) {
+      integers[index].writeBytes(bytes.destination + index * length, length, isBigEndian);
+    }
+    return bytes;
+  }
+
+  Integer Integer::from_bytes(const GarbageCollected<std::byte>& bytes, const bool isBigEndian,
+                              const bool isSigned) noexcept {
+    return readBytes(bytes.destination, bytes.capacity, isBigEndian, isSigned, {});
+  }
+
+  size_t Integer::from_bytes(const GarbageCollected<std::byte>& bytes, const size_t length, Integer* integers,
+                             const bool isBigEndian, const bool isSigned) noexcept {
+    if (length == 0) return 0;
+    const size_t count = bytes.capacity / length, size = getByteCellCapacity(length);
+    // The integers wider than a word read their cells from consecutive slices of one allocation.
+    GarbageCollected<uint32_t> cells;
+    if (length > sizeof(uint64_t) && count > 0) {
+      cells = gatherCells(count * size);
+      if (cells.destination == nullptr) return 0;
+      cells.capacity = size * sizeof(uint32_t);
+    }
+    for (size_t index = 0; index < count; ++index) {
+      integers[index] = readBytes(bytes.destination + index * length, length, isBigEndian, isSigned, cells);
+      if (cells.destination != nullptr) cells.destination += size;
+    }
+    return count;
+  }
+
+  bool Integer::is_integer() noexcept {
+    return true;
+  }
+
+  size_t Integer::hash() const noexcept {
+    if (isInline()) return hashWord(value);
+    // The cells are folded in from the most significant one, and each step multiplies the residue by 2^32,
+    // which is a rotation of its 61 bits.
+    uint64_t residue = 0;
+    for (size_t index = numberOfCells; index-- > 0;) {
+      residue = ((residue << 32) & NumericHashModulus) | (residue >> (61 - 32));
+      residue += cells.destination[index];
+      if (residue >= NumericHashModulus) residue -= NumericHashModulus;
+    }
+    const uint64_t hash = isNegative ? 0 - residue : residue;
+    return hash == ReservedHash ? ReservedHash - 1 : hash;
+  }
+
+  bool Integer::isInline() const noexcept {
+    return numberOfCells == 0;
+  }
+
+  Integer::Magnitude Integer::getMagnitude(uint32_t* storage) const noexcept {
+    if (!isInline()) return {cells.destination, numberOfCells};
+    const uint64_t magnitude = isNegative ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    storage[0] = static_cast<uint32_t>(magnitude);
+    storage[1] = static_cast<uint32_t>(magnitude >> 32);
+    return {storage, magnitude == 0 ? 0 : storage[1] != 0 ? size_t{2} : size_t{1}};
+  }
+
+  Integer Integer::fromValue(const int64_t value) noexcept {
+    Integer result;
+    result.value = value;
+    result.isNegative = value < 0;
+    return result;
+  }
+
+  Integer Integer::fromMagnitude(const uint64_t magnitude, const bool isNegative) noexcept {
+    if (magnitude <= INT64_MAX) return fromValue(isNegative ? -static_cast<int64_t>(magnitude) : static_cast<int64_t>(magnitude));
+    if (isNegative && magnitude == uint64_t{1} << 63) return fromValue(INT64_MIN);
+    const GarbageCollected<uint32_t> buffer = gatherCells(2);
+    if (buffer.destination == nullptr) return {};
+    buffer.destination[0] = static_cast<uint32_t>(magnitude);
+    buffer.destination[1] = static_cast<uint32_t>(magnitude >> 32);
+    return {buffer, 2, isNegative};
+  }
+
+  /// Writes the magnitude in two's complement of the given width, negated if the sign asks so.
+  void writeTwosComplement(const uint32_t* cells, const size_t size, const bool isNegative, uint32_t* destination,
+                           const size_t width) noexcept {
+    std::copy(cells, cells + size, destination);
+    std::fill(destination + size, destination + width, 0);
+    if (isNegative) negateCells(destination, width);
+  }
+
+  std::pair<Integer, Integer> Integer::divide(const Integer& left, const Integer& right) noexcept {
+    if (right.isInline() && right.value == 0) {
+      raise(Signal::ZeroDivisionError, ExceptionReason::DivisionByZero);
+      return {};
+    }
+    // The only inline quotient that overflows the word is INT64_MIN / -1.
+    if (left.isInline() && right.isInline() && (left.value != INT64_MIN || right.value != -1)) {
+      int64_t quotient = left.value / right.value, remainder = left.value % right.value;
+      if (remainder != 0 && (remainder < 0) != (right.value < 0)) {
+        --quotient;
+        remainder += right.value;
+      }
+      return {fromValue(quotient), fromValue(remainder)};
+    }
+
+    // The magnitudes are divided with the quotient truncated, and the remainder takes the sign of the dividend.
+    uint32_t leftStorage[2], rightStorage[2];
+    const Magnitude dividend = left.getMagnitude(leftStorage), divisor = right.getMagnitude(rightStorage);
+    Integer quotient, remainder = left;
+    if (dividend.size >= divisor.size) {
+      const size_t quotientSize = dividend.size - divisor.size + 1;
+      const GarbageCollected<uint32_t> quotientCells = gatherCells(quotientSize);
+      const GarbageCollected<uint32_t> remainderCells = gatherCells(divisor.size);
+      if (quotientCells.destination == nullptr || remainderCells.destination == nullptr) return {};
+      if (divisor.size == 1) {
+        remainderCells.destination[0] = divideCellsByCell(dividend.cells, dividend.size, divisor.cells[0],
+                                                          quotientCells.destination);
+      } else {
+        split();
+        const size_t scratchSize = getDivisionScratchSize(dividend.size, divisor.size);
+        const GarbageCollected<uint32_t> scratch = gatherAlignedCells(scratchSize);
+        if (scratch.destination == nullptr) {
+          untie();
+          raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+          return {};
+        }
+        divideCells(dividend.cells, dividend.size, divisor.cells, divisor.size, quotientCells.destination,
+                    remainderCells.destination, scratch.destination);
+        untie();
+      }
+      quotient = Integer(quotientCells, quotientSize, left.isNegative != right.isNegative);
+      remainder = Integer(remainderCells, divisor.size, left.isNegative);
+    }
+    // Flooring moves the quotients of the operands of different signs one down, unless the division is exact.
+    if (left.isNegative != right.isNegative && !(remainder == Integer())) {
+      quotient -= 1;
+      remainder += right;
+    }
+    return {quotient, remainder};
+  }
+
+  Integer Integer::powModulo(const Integer& base, const Integer& exponent, const Integer& modulus,
+                             const bool isConstantTime) noexcept {
+    if (modulus == Integer()) {
+      raise(Signal::ValueError, ExceptionReason::ZeroModulus);
+      return {};
+    }
+    // The power is computed modulo the magnitude of the modulus and moved to its sign at the end.
+    const Integer positive = modulus.isNegative ? Integer() - modulus : modulus;
+    if (positive == Integer(1)) return {};
+    Integer reduced = base % positive;
+    uint32_t baseStorage[2], exponentStorage[2], modulusStorage[2];
+    Magnitude magnitude = reduced.getMagnitude(baseStorage);
+    const Magnitude power = exponent.getMagnitude(exponentStorage), divisor = positive.getMagnitude(modulusStorage);
+    if (exponent.isNegative) {
+      // The negative powers raise the inverse of the base to the magnitude of the exponent.
+      const GarbageCollected<uint32_t> cells = gatherCells(divisor.size);
+      bool isInvertible = false;
+      if (cells.destination == nullptr || !invertCellsModulo(magnitude.cells, magnitude.size, divisor.cells,
+                                                             divisor.size, cells.destination, isInvertible)) {
+        return {};
+      }
+      if (!isInvertible) {
+        raise(Signal::ValueError, ExceptionReason::NonInvertibleBase);
+        return {};
+      }
+      reduced = Integer(cells, divisor.size, false);
+      magnitude = reduced.getMagnitude(baseStorage);
+    }
+    Integer result;
+    if (divisor.size <= 2) {
+      // The moduli that fit into a machine word never touch the pool.
+      const auto readWord = [](const Magnitude& cells) {
+        return cells.size == 0 ? 0 : cells.size == 1 ? uint64_t{cells.cells[0]}
+                                                     : cells.cells[0] | static_cast<uint64_t>(cells.cells[1]) << 32;
+      };
+      result = fromMagnitude(powerWordModulo(readWord(magnitude), power.cells, power.size, readWord(divisor),
+                                             isConstantTime), false);
+    } else {
+      const GarbageCollected<uint32_t> cells = gatherCells(divisor.size);
+      if (cells.destination == nullptr || !powerCellsModulo(magnitude.cells, magnitude.size, power.cells, power.size,
+                                                            divisor.cells, divisor.size, cells.destination,
+                                                            isConstantTime)) {
+        return {};
+      }
+      result = Integer(cells, divisor.size, false);
+    }
+    if (modulus.isNegative && !(result == Integer())) result += modulus;
+    return result;
+  }
+
+  Integer Integer::combine(const Integer& left, const Integer& right, const CellOperation operation) noexcept {
+    uint32_t leftStorage[2], rightStorage[2];
+    Magnitude longer = left.getMagnitude(leftStorage), shorter = right.getMagnitude(rightStorage);
+    bool isLongerNegative = left.isNegative, isShorterNegative = right.isNegative;
+    if (longer.size < shorter.size) {
+      std::swap(longer, shorter);
+      std::swap(isLongerNegative, isShorterNegative);
+    }
+    if (!isLongerNegative && !isShorterNegative) {
+      // The non-negative operands are combined as they are, and the cells of the longer one above the
+      // shorter one are either dropped or copied.
+      const size_t size = operation == CellOperation::And ? shorter.size : longer.size;
+      if (size == 0) return {};
+      const GarbageCollected<uint32_t> result = gatherCells(size);
+      if (result.destination == nullptr) return {};
+      combineCells(longer.cells, shorter.cells, shorter.size, result.destination, operation);
+      std::copy(longer.cells + shorter.size, longer.cells + size, result.destination + shorter.size);
+      return {result, size, false};
+    }
+
+    // Otherwise both operands are brought to two's complement one cell wider than the longer one, so that
+    // the top cell holds nothing but the sign.
+    const size_t width = longer.size + 1;
+    const GarbageCollected<uint32_t> result = gatherCells(width);
+    if (result.destination == nullptr) return {};
+    split();
+    const GarbageCollected<uint32_t> scratch = gatherAlignedCells(2 * width);
+    if (scratch.destination == nullptr) {
+      untie();
+      raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+      return {};
+    }
+    writeTwosComplement(longer.cells, longer.size, isLongerNegative, scratch.destination, width);
+    writeTwosComplement(shorter.cells, shorter.size, isShorterNegative, scratch.destination + width, width);
+    combineCells(scratch.destination, scratch.destination + width, width, result.destination, operation);
+    untie();
+    const bool isNegative = operation == CellOperation::And  ? isLongerNegative && isShorterNegative
+                            : operation == CellOperation::Or ? isLongerNegative || isShorterNegative
+                                                             : isLongerNegative != isShorterNegative;
+    if (isNegative) negateCells(result.destination, width);
+    return {result, width, isNegative};
+  }
+
+  bool Integer::fitsIntoBytes(const size_t length, const bool isSigned) const noexcept {
+    if (isNegative && !isSigned) {
+      raise(Signal::OverflowError, ExceptionReason::NegativeToUnsigned);
+      return false;
+    }
+    if (isInline() && length < sizeof(value)) {
+      // The inline values are compared with the bounds of the width instead.
+      const int64_t bound = length == 0 ? 0 : int64_t{1} << (8 * length - isSigned);
+      if (value == 0 || (value < bound && value >= (isSigned ? -bound : 0))) return true;
+      raise(Signal::OverflowError, ExceptionReason::IntegerTooLarge);
+      return false;
+    }
+    if (isInline() && isSigned) return true;
+    // A signed value leaves the top bit to the sign, except for the lowest value of the width, which is the
+    // negation of a power of 2.
+    const size_t bits = bit_length();
+    if (bits == 0 || bits + isSigned <= 8 * length || (isNegative && bits == 8 * length && bit_count() == 1)) {
+      return true;
+    }
+    raise(Signal::OverflowError, ExceptionReason::IntegerTooLarge);
+    return false;
+  }
+
+  void Integer::writeBytes(std::byte* destination, const size_t length, const bool isBigEndian) const noexcept {
+    if (isInline()) return writeWordBytes(static_cast<uint64_t>(value), isNegative, destination, length, isBigEndian);
+    writeCellBytes(cells.destination, numberOfCells, isNegative, destination, length, isBigEndian);
+  }
+
+  Integer Integer::readBytes(const std::byte* source, const size_t length, const bool isBigEndian,
+                             const bool isSigned, const GarbageCollected<uint32_t>& cells) noexcept {
+    if (length <= sizeof(uint64_t)) {
+      const uint64_t word = readWordBytes(source, length, isBigEndian, isSigned);
+      if (isSigned && static_cast<int64_t>(word) < 0) return fromValue(static_cast<int64_t>(word));
+      return fromMagnitude(word, false);
+    }
+    const size_t size = getByteCellCapacity(length);
+    const GarbageCollected<uint32_t> buffer = cells.destination != nullptr ? cells : gatherCells(size);
+    if (buffer.destination == nullptr) return {};
+    const bool isNegative = readCellBytes(source, length, isBigEndian, isSigned, buffer.destination);
+    return {buffer, size, isNegative};
+  }
+
+  bool Integer::getShiftCount(const Integer& other, uint64_t& count) noexcept {
+    if (other.isNegative) {
+      raise(Signal::ValueError, ExceptionReason::NegativeShiftCount);
+      return false;
+    }
+    count = other.isInline() ? static_cast<uint64_t>(other.value) : UINT64_MAX;
+    return true;
+  }
+
+  Integer Integer::addMagnitudes(const Integer& left, const Integer& right, const bool isNegative) noexcept {
+    uint32_t leftStorage[2], rightStorage[2];
+    Magnitude longer = left.getMagnitude(leftStorage), shorter = right.getMagnitude(rightStorage);
+    if (longer.size < shorter.size) std::swap(longer, shorter);
+    const GarbageCollected<uint32_t> sum = gatherCells(longer.size + 1);
+    if (sum.destination == nullptr) return {};
+    sum.destination[longer.size] = addCells(longer.cells, longer.size, shorter.cells, shorter.size, sum.destination);
+    return {sum, longer.size + 1, isNegative};
+  }
+
+  Integer Integer::subtractMagnitudes(const Integer& left, const Integer& right, const bool isNegative) noexcept {
+    uint32_t leftStorage[2], rightStorage[2];
+    Magnitude larger = left.getMagnitude(leftStorage), smaller = right.getMagnitude(rightStorage);
+    const int comparison = compareCells(larger.cells, larger.size, smaller.cells, smaller.size);
+    if (comparison == 0) return {};
+    if (comparison < 0) std::swap(larger, smaller);
+    const GarbageCollected<uint32_t> difference = gatherCells(larger.size);
+    if (difference.destination == nullptr) return {};
+    (void)subtractCells(larger.cells, larger.size, smaller.cells, smaller.size, difference.destination);
+    return {difference, larger.size, comparison > 0 ? isNegative : !isNegative};
+  }
+}
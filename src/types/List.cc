@@ -0,0 +1,441 @@
+#include "types/List.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <utility>
+
+#include "context.hh"
+#include "types/String.hh"
+#include "types/help/sorting.hh"
+namespace mamba {
+  /// The number of elements the first allocation of a list holds.
+  constexpr size_t SmallestListCapacity = 4;
+
+  /// Gives the integer the float equals, if there is one that fits into a machine word.
+  /// @return False if the float is not such an integer.
+  bool getIntegralValue(const double number, int64_t& value) noexcept {
+    if (!(number >= -0x1p63 && number < 0x1p63)) return false;
+    value = static_cast<int64_t>(number);
+    return static_cast<double>(value) == number;
+  }
+
+  /// Finds the first element matching the predicate, or counts all of them.
+  template<typename T, typename Predicate>
+  size_t scanItems(const T* items, const size_t size, const bool isCounting, Predicate isMatch) noexcept {
+    if (isCounting) {
+      // The loop has no branch, which lets the compiler vectorise it over the unboxed numbers.
+      size_t count = 0;
+      for (size_t index = 0; index < size; ++index) count += isMatch(items[index]);
+      return count;
+    }
+    for (size_t index = 0; index < size; ++index) {
+      if (isMatch(items[index])) return index;
+    }
+    return SIZE_MAX;
+  }
+
+  /// The number of unboxed numbers from which they are sorted by radix, which takes linear time but passes
+  /// over them several times, rather than merged.
+  constexpr size_t SmallestRadixSortedSize = 256;
+
+  /// The average length of the sorted runs from which the numbers are merged rather than sorted by radix.
+  constexpr size_t SmallestMergedRunSize = 32;
+
+  /// A string being sorted, with its first 8 bytes loaded as a big-endian word, so that most comparisons
+  /// are decided by comparing the words rather than reading the strings.
+  struct SortedString {
+    uint64_t prefix;
+    Object item;
+  };
+
+  /// Allocates the scratch space of a sort on the pool, aligned for the elements, and raises MemoryError
+  /// if the pool is exhausted.
+  /// @return The space for the number of elements, or nullptr if the pool is exhausted.
+  template<typename T> T* gatherScratch(GarbageCollected<std::byte>& buffer, const size_t count) noexcept {
+    buffer = gather(count * sizeof(T) + alignof(T) - 1, GarbageCollectionGeneration::Eden);
+    if (buffer.destination == nullptr) {
+      raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+      return nullptr;
+    }
+    const auto address = reinterpret_cast<uintptr_t>(buffer.destination);
+    return reinterpret_cast<T*>((address + alignof(T) - 1) & ~(alignof(T) - 1));
+  }
+
+  /// Sorts the elements stably with the merge sort, allocating its scratch space if they need merging.
+  /// @return False if the pool is exhausted, in which case the elements are left as they are.
+  template<typename T, typename Less> bool sortStably(T* items, const size_t count, Less isLess) noexcept {
+    GarbageCollected<std::byte> buffer;
+    T* scratch = nullptr;
+    if (count >= StableSort<T, Less>::SmallestMergedSize) {
+      scratch = gatherScratch<T>(buffer, count / 2);
+      if (scratch == nullptr) return false;
+    }
+    StableSort<T, Less>(items, count, scratch, isLess).run();
+    if (buffer.destination != nullptr) mark(buffer);
+    return true;
+  }
+
+  /// Tells if the numbers fall into long sorted runs, which the merge sort finds and merges faster than the
+  /// radix sort passes over them, judging by the number of the descents between the neighbours.
+  template<typename T> bool isMostlySorted(const T* numbers, const size_t count) noexcept {
+    size_t descents = 0;
+    for (size_t index = 1; index < count; ++index) descents += numbers[index] < numbers[index - 1];
+    return descents <= count / SmallestMergedRunSize;
+  }
+
+  /// Sorts the unboxed integers, which are indistinguishable when equal, so that they need no stable sort.
+  void sortIntegers(int64_t* integers, const size_t count) noexcept {
+    if (count < SmallestRadixSortedSize || isMostlySorted(integers, count)) {
+      (void)sortStably(integers, count, std::less<>());
+      return;
+    }
+    GarbageCollected<std::byte> buffer;
+    auto* scratch = gatherScratch<uint64_t>(buffer, count);
+    if (scratch == nullptr) return;
+    sortIntegersByRadix(integers, count, scratch);
+    mark(buffer);
+  }
+
+  /// Sorts the unboxed floats, stably if they hold negative zeros, which equal the positive ones, or NaN,
+  /// which the merge sort orders as Python does, by the comparisons it happens to make.
+  void sortFloats(double* floats, const size_t count) noexcept {
+    bool isRadixSortable = count >= SmallestRadixSortedSize;
+    for (size_t index = 0; isRadixSortable && index < count; ++index) {
+      isRadixSortable = !std::isnan(floats[index]) && !(floats[index] == 0 && std::signbit(floats[index]));
+    }
+    if (!isRadixSortable || isMostlySorted(floats, count)) {
+      (void)sortStably(floats, count, std::less<>());
+      return;
+    }
+    GarbageCollected<std::byte> buffer;
+    auto* scratch = gatherScratch<uint64_t>(buffer, count);
+    if (scratch == nullptr) return;
+    sortFloatsByRadix(floats, count, scratch);
+    mark(buffer);
+  }
+
+  /// Sorts the objects holding strings by the prefixes of their bytes, and then by their full contents.
+  void sortStrings(Object* objects, const size_t count) noexcept {
+    GarbageCollected<std::byte> buffer;
+    auto* strings = gatherScratch<SortedString>(buffer, count);
+    if (strings == nullptr) return;
+    for (size_t index = 0; index < count; ++index) {
+      const String& text = objects[index].asString();
+      uint64_t prefix = 0;
+      (void)std::memcpy(&prefix, text.begin(), std::min<size_t>(text.end() - text.begin(), sizeof(prefix)));
+      strings[index] = {__builtin_bswap64(prefix), objects[index]};
+    }
+    const bool isSorted = sortStably(strings, count, [](const SortedString& left, const SortedString& right) {
+      if (left.prefix != right.prefix) return left.prefix < right.prefix;
+      return left.item.asString() < right.item.asString();
+    });
+    if (isSorted) {
+      for (size_t index = 0; index < count; ++index) objects[index] = strings[index].item;
+    }
+    mark(buffer);
+  }
+
+  List::List(const List& other) noexcept : storage{other.storage} {
+    if (other.size == 0 || !reallocate(other.size, other.storage)) return;
+    (void)std::memcpy(items, other.items, other.size * getItemSize(storage));
+    size = other.size;
+  }
+
+  List::List(List&& other) noexcept
+      : buffer{other.buffer}, items{other.items}, size{other.size}, capacity{other.capacity}, storage{other.storage} {
+    other.buffer = {};
+    other.items = nullptr;
+    other.size = other.capacity = 0;
+  }
+
+  List& List::operator=(const List& other) noexcept {
+    if (this != &other) *this = List(other);
+    return *this;
+  }
+
+  List& List::operator=(List&& other) noexcept {
+    std::swap(buffer, other.buffer);
+    std::swap(items, other.items);
+    std::swap(size, other.size);
+    std::swap(capacity, other.capacity);
+    std::swap(storage, other.storage);
+    return *this;
+  }
+
+  Object List::operator[](const ssize_t index) const noexcept {
+    size_t position;
+    return locate(index, position) ? load(position) : Object();
+  }
+
+  bool List::operator==(const List& other) const noexcept {
+    if (size != other.size) return false;
+    if (storage == ListStorage::Integers && other.storage == ListStorage::Integers) {
+      return size == 0 || std::memcmp(items, other.items, size * sizeof(int64_t)) == 0;
+    }
+    for (size_t index = 0; index < size; ++index) {
+      if (!(load(index) == other.load(index))) return false;
+    }
+    return true;
+  }
+
+  void List::set(const ssize_t index, const Object& item) noexcept {
+    size_t position;
+    if (!locate(index, position) || !accept(item)) return;
+    store(position, item);
+  }
+
+  void List::append(const Object& item) noexcept {
+    if (!accept(item) || !ensureCapacity(size + 1)) return;
+    store(size++, item);
+  }
+
+  void List::extend(const List& other) noexcept {
+    const size_t count = other.size;
+    if (count == 0) return;
+    if (size == 0 && storage != other.storage) {
+      // The empty list adopts the storage of the other one, keeping the bytes of its buffer as accept() does.
+      capacity = capacity * getItemSize(storage) / getItemSize(other.storage);
+      storage = other.storage;
+    }
+    if (storage == other.storage) {
+      if (!ensureCapacity(size + count)) return;
+      const size_t itemSize = getItemSize(storage);
+      (void)std::memcpy(items + size * itemSize, other.items, count * itemSize);
+      size += count;
+      return;
+    }
+    // The lists of different storages meet as objects, which only this one may need to be converted to.
+    if (!ensureCapacity(size + count)) return;
+    if (storage != ListStorage::Objects && !reallocate(capacity, ListStorage::Objects)) return;
+    for (size_t index = 0; index < count; ++index) view<Object>()[size + index] = other.load(index);
+    size += count;
+  }
+
+  void List::insert(ssize_t index, const Object& item) noexcept {
+    if (index < 0) index = std::max<ssize_t>(index + static_cast<ssize_t>(size), 0);
+    const size_t position = std::min(static_cast<size_t>(index), size);
+    if (!accept(item) || !ensureCapacity(size + 1)) return;
+    const size_t itemSize = getItemSize(storage);
+    (void)std::memmove(items + (position + 1) * itemSize, items + position * itemSize, (size - position) * itemSize);
+    ++size;
+    store(position, item);
+  }
+
+  Object List::pop(const ssize_t index) noexcept {
+    if (size == 0) {
+      raise(Signal::IndexError, ExceptionReason::PopFromEmptyList);
+      return {};
+    }
+    size_t position;
+    if (!locate(index, position)) return {};
+    const Object item = load(position);
+    const size_t itemSize = getItemSize(storage);
+    (void)std::memmove(items + position * itemSize, items + (position + 1) * itemSize,
+                       (size - position - 1) * itemSize);
+    --size;
+    return item;
+  }
+
+  void List::remove(const Object& item) noexcept {
+    const size_t position = search(item, false);
+    if (position == SIZE_MAX) {
+      raise(Signal::ValueError, ExceptionReason::ItemNotFound);
+      return;
+    }
+    (void)pop(static_cast<ssize_t>(position));
+  }
+
+  void List::clear() noexcept {
+    size = 0;
+  }
+
+  void List::reverse() noexcept {
+    switch (storage) {
+      case ListStorage::Integers:
+        std::reverse(view<int64_t>(), view<int64_t>() + size);
+        break;
+      case ListStorage::Floats:
+        std::reverse(view<double>(), view<double>() + size);
+        break;
+      case ListStorage::Objects:
+        std::reverse(view<Object>(), view<Object>() + size);
+        break;
+    }
+  }
+
+  void List::sort(const bool isReversed) noexcept {
+    if (size < 2) return;
+    bool isHoldingStrings = false;
+    if (storage == ListStorage::Objects) {
+      // The types are checked before sorting, so that the unorderable elements leave the list unchanged.
+      size_t strings = 0, numbers = 0;
+      for (size_t index = 0; index < size; ++index) {
+        const ObjectType type = view<Object>()[index].getType();
+        strings += type == ObjectType::String;
+        numbers += type == ObjectType::Integer || type == ObjectType::Float;
+      }
+      if (strings != size && numbers != size) {
+        raise(Signal::TypeError, ExceptionReason::UnorderableTypes);
+        return;
+      }
+      isHoldingStrings = strings == size;
+    }
+    // The descending sort reverses the list around the ascending one, as in Python, so that the equal
+    // elements keep their order.
+    if (isReversed) reverse();
+    switch (storage) {
+      case ListStorage::Integers:
+        sortIntegers(view<int64_t>(), size);
+        break;
+      case ListStorage::Floats:
+        sortFloats(view<double>(), size);
+        break;
+      case ListStorage::Objects:
+        if (isHoldingStrings) sortStrings(view<Object>(), size);
+        else (void)sortStably(view<Object>(), size, std::less<>());
+        break;
+    }
+    if (isReversed) reverse();
+  }
+
+  size_t List::index(const Object& item) const noexcept {
+    const size_t position = search(item, false);
+    if (position == SIZE_MAX) raise(Signal::ValueError, ExceptionReason::ItemNotFound);
+    return position;
+  }
+
+  size_t List::count(const Object& item) const noexcept {
+    return search(item, true);
+  }
+
+  bool List::contains(const Object& item) const noexcept {
+    return search(item, false) != SIZE_MAX;
+  }
+
+  size_t List::len() const noexcept {
+    return size;
+  }
+
+  void List::reserve(const size_t newCapacity) noexcept {
+    if (newCapacity > capacity) (void)reallocate(newCapacity, storage);
+  }
+
+  ListStorage List::getStorage() const noexcept {
+    return storage;
+  }
+
+  size_t List::getItemSize(const ListStorage kind) noexcept {
+    return kind == ListStorage::Objects ? sizeof(Object) : sizeof(int64_t);
+  }
+
+  bool List::reallocate(const size_t newCapacity, const ListStorage newStorage) noexcept {
+    // The pool does not align its allocations, so the buffer has room to align the elements.
+    const GarbageCollected<std::byte> replacement = gather(newCapacity * getItemSize(newStorage) + alignof(Object) - 1,
+                                                           GarbageCollectionGeneration::Eden);
+    if (replacement.destination == nullptr) {
+      raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+      return false;
+    }
+    const auto address = reinterpret_cast<uintptr_t>(replacement.destination);
+    auto* aligned = reinterpret_cast<std::byte*>((address + alignof(Object) - 1) & ~(alignof(Object) - 1));
+    if (newStorage == storage) {
+      if (size > 0) (void)std::memcpy(aligned, items, size * getItemSize(storage));
+    } else {
+      auto* objects = reinterpret_cast<Object*>(aligned);
+      for (size_t index = 0; index < size; ++index) objects[index] = load(index);
+    }
+    if (buffer.destination != nullptr) mark(buffer);
+    buffer = replacement;
+    items = aligned;
+    capacity = newCapacity;
+    storage = newStorage;
+    return true;
+  }
+
+  bool List::ensureCapacity(const size_t required) noexcept {
+    if (required <= capacity) return true;
+    return reallocate(std::max({required, capacity + capacity / 2, SmallestListCapacity}), storage);
+  }
+
+  bool List::accept(const Object& item) noexcept {
+    if (storage == ListStorage::Objects) return true;
+    ListStorage kind = ListStorage::Objects;
+    if (item.isSmallInteger()) kind = ListStorage::Integers;
+    else if (item.getType() == ObjectType::Float) kind = ListStorage::Floats;
+    if (kind == storage) return true;
+    if (size == 0) {
+      // The empty list adopts the storage of its first element, keeping the bytes of its buffer.
+      capacity = capacity * getItemSize(storage) / getItemSize(kind);
+      storage = kind;
+      return true;
+    }
+    return reallocate(capacity, ListStorage::Objects);
+  }
+
+  Object List::load(const size_t index) const noexcept {
+    switch (storage) {
+      case ListStorage::Integers:
+        return Object::fromValue(view<int64_t>()[index]);
+      case ListStorage::Floats:
+        return view<double>()[index];
+      case ListStorage::Objects:
+        break;
+    }
+    return view<Object>()[index];
+  }
+
+  void List::store(const size_t index, const Object& item) noexcept {
+    switch (storage) {
+      case ListStorage::Integers:
+        view<int64_t>()[index] = item.payload.integer;
+        break;
+      case ListStorage::Floats:
+        view<double>()[index] = item.payload.number;
+        break;
+      case ListStorage::Objects:
+        view<Object>()[index] = item;
+        break;
+    }
+  }
+
+  bool List::locate(const ssize_t index, size_t& position) const noexcept {
+    // The negative indexes beyond the start wrap around to positions far beyond the end.
+    position = static_cast<size_t>(index) + (index < 0 ? size : 0);
+    if (position >= size) {
+      raise(Signal::IndexError, ExceptionReason::IndexOutOfRange);
+      return false;
+    }
+    return true;
+  }
+
+  size_t List::search(const Object& item, const bool isCounting) const noexcept {
+    const size_t none = isCounting ? 0 : SIZE_MAX;
+    switch (storage) {
+      case ListStorage::Integers: {
+        // Only the small integers and the floats equal to them can match the unboxed integers.
+        int64_t value;
+        if (item.isSmallInteger()) value = item.payload.integer;
+        else if (item.getType() != ObjectType::Float || !getIntegralValue(item.payload.number, value)) return none;
+        return scanItems(view<int64_t>(), size, isCounting, [value](const int64_t other) { return other == value; });
+      }
+      case ListStorage::Floats:
+        if (item.getType() == ObjectType::Float) {
+          const double value = item.payload.number;
+          return scanItems(view<double>(), size, isCounting, [value](const double other) { return other == value; });
+        }
+        if (item.isSmallInteger()) {
+          const int64_t value = item.payload.integer;
+          return scanItems(view<double>(), size, isCounting,
+                           [value](const double other) { return isNumericallyEqual(value, other); });
+        }
+        if (item.getType() != ObjectType::Integer) return none;
+        // The large integers can still equal the large floats, which the objects compare exactly.
+        return scanItems(view<double>(), size, isCounting, [&item](const double other) { return Object(other) == item; });
+      case ListStorage::Objects:
+        break;
+    }
+    return scanItems(view<Object>(), size, isCounting, [&item](const Object& other) { return other == item; });
+  }
+}
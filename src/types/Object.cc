@@ -0,0 +1,186 @@
+#include "types/Object.hh"
+
+#include <cmath>
+#include <memory>
+#include <new>
+
+#include "context.hh"
+#include "givers/memory.hh"
+#include "types/Float.hh"
+#include "types/Integer.hh"
+#include "types/String.hh"
+#include "types/help/hashing.hh"
+namespace mamba {
+  /// Copies the value onto the pool, aligned for its type, raising MemoryError if the pool is exhausted.
+  /// @return The address of the copy, or nullptr if the pool is exhausted.
+  template<typename T> const T* box(const T& value) noexcept {
+    const GarbageCollected<std::byte> buffer = gather(sizeof(T) + alignof(T) - 1, GarbageCollectionGeneration::Eden);
+    if (buffer.destination == nullptr) {
+      raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+      return nullptr;
+    }
+    void* address = buffer.destination;
+    size_t space = buffer.capacity;
+    return new (std::align(alignof(T), sizeof(T), address, space)) T(value);
+  }
+
+  Object::Object(const int number) noexcept : type{ObjectType::Integer} {
+    payload.integer = number;
+  }
+
+  Object::Object(const double number) noexcept : type{ObjectType::Float} {
+    payload.number = number;
+  }
+
+  Object::Object(const Integer& number) noexcept {
+    if (number.isInline()) {
+      *this = fromValue(number.value);
+      return;
+    }
+    payload.address = box(number);
+    if (payload.address == nullptr) return;
+    type = ObjectType::Integer;
+    isBoxed = true;
+  }
+
+  Object::Object(const Float& number) noexcept : Object(static_cast<double>(number)) { }
+
+  Object::Object(const String& text) noexcept {
+    payload.address = box(text);
+    if (payload.address == nullptr) return;
+    type = ObjectType::String;
+    isBoxed = true;
+  }
+
+  bool isNumericallyEqual(const int64_t integer, const double number) noexcept {
+    // The range is checked first, since converting the floats outside it into integers is undefined.
+    return number >= -0x1p63 && number < 0x1p63 && static_cast<int64_t>(number) == integer &&
+           static_cast<double>(integer) == number;
+  }
+
+  bool Object::operator==(const Object& other) const noexcept {
+    if (type == ObjectType::Float && other.type == ObjectType::Integer) return other == *this;
+    switch (type) {
+      case ObjectType::None:
+        return other.type == ObjectType::None;
+      case ObjectType::Integer:
+        // Every integer has a single form, so the boxed ones never equal the inline ones.
+        if (other.type == ObjectType::Integer) {
+          if (isBoxed || other.isBoxed) return isBoxed && other.isBoxed && asInteger() == other.asInteger();
+          return payload.integer == other.payload.integer;
+        }
+        if (other.type != ObjectType::Float) return false;
+        if (!isBoxed) return isNumericallyEqual(payload.integer, other.payload.number);
+        return isBoxedIntegerEqual(other.payload.number);
+      case ObjectType::Float:
+        return other.type == ObjectType::Float && payload.number == other.payload.number;
+      case ObjectType::String:
+        return other.type == ObjectType::String && asString() == other.asString();
+    }
+    return false;
+  }
+
+  bool Object::operator<(const Object& other) const noexcept {
+    switch (type) {
+      case ObjectType::Integer:
+        if (other.type == ObjectType::Float) return compareWithFloat(other.payload.number) < 0;
+        if (other.type != ObjectType::Integer) return false;
+        if (!isBoxed && !other.isBoxed) return payload.integer < other.payload.integer;
+        return asInteger() < other.asInteger();
+      case ObjectType::Float:
+        if (other.type == ObjectType::Integer) return other.compareWithFloat(payload.number) > 0;
+        return other.type == ObjectType::Float && payload.number < other.payload.number;
+      case ObjectType::String:
+        return other.type == ObjectType::String && asString() < other.asString();
+      case ObjectType::None:
+        break;
+    }
+    return false;
+  }
+
+  size_t Object::hash() const noexcept {
+    // The constant of None is the one CPython uses since 3.12, rather than its address.
+    constexpr size_t NoneHash = 0xFCA86420;
+    switch (type) {
+      case ObjectType::None:
+        return NoneHash;
+      case ObjectType::Integer:
+        return isBoxed ? static_cast<const Integer*>(payload.address)->hash() : hashWord(payload.integer);
+      case ObjectType::Float:
+        return hashDouble(payload.number);
+      case ObjectType::String:
+        return asString().hash();
+    }
+    return 0;
+  }
+
+  ObjectType Object::getType() const noexcept {
+    return type;
+  }
+
+  Integer Object::asInteger() const noexcept {
+    return isBoxed ? *static_cast<const Integer*>(payload.address) : Integer::fromValue(payload.integer);
+  }
+
+  Float Object::asFloat() const noexcept {
+    return payload.number;
+  }
+
+  const String& Object::asString() const noexcept {
+    return *static_cast<const String*>(payload.address);
+  }
+
+  Object Object::fromValue(const int64_t value) noexcept {
+    Object result;
+    result.type = ObjectType::Integer;
+    result.payload.integer = value;
+    return result;
+  }
+
+  Object Object::makeVacant() noexcept {
+    Object marker;
+    marker.isBoxed = true;
+    return marker;
+  }
+
+  bool Object::isVacant() const noexcept {
+    return type == ObjectType::None && isBoxed;
+  }
+
+  bool Object::isBoxedIntegerEqual(const double number) const noexcept {
+    // The boxed integers are beyond the range of machine words, and so are the floats that can equal them.
+    if (!std::isfinite(number) || std::fabs(number) < 0x1p63) return false;
+    // The float is its 53-bit significand shifted left, which the integer arithmetic does exactly.
+    int exponent;
+    const auto significand = static_cast<int64_t>(std::ldexp(std::frexp(number, &exponent), 53));
+    return (Integer::fromValue(significand) << Integer(exponent - 53)) == asInteger();
+  }
+
+  bool Object::isSmallInteger() const noexcept {
+    return type == ObjectType::Integer && !isBoxed;
+  }
+
+  int Object::compareWithFloat(const double number) const noexcept {
+    if (std::isnan(number)) return 0;
+    if (!isBoxed) {
+      // The floats beyond the range of machine words are beyond every inline integer.
+      if (number >= 0x1p63) return -1;
+      if (number < -0x1p63) return 1;
+      const int64_t integral = static_cast<int64_t>(number);
+      if (payload.integer != integral) return payload.integer < integral ? -1 : 1;
+      // The fraction is exact, and it decides between the integer and the float that truncates to it.
+      const double fraction = number - static_cast<double>(integral);
+      return fraction > 0 ? -1 : (fraction < 0 ? 1 : 0);
+    }
+    // The boxed integers are beyond the range of machine words, so the smaller floats are decided by the
+    // sign of the integer, and the larger ones are integers that the integer arithmetic compares exactly.
+    const bool isNegative = static_cast<const Integer*>(payload.address)->isNegative;
+    if (std::isinf(number)) return number > 0 ? -1 : 1;
+    if (std::fabs(number) < 0x1p63) return isNegative ? -1 : 1;
+    int exponent;
+    const auto significand = static_cast<int64_t>(std::ldexp(std::frexp(number, &exponent), 53));
+    const Integer converted = Integer::fromValue(significand) << Integer(exponent - 53);
+    const Integer integer = asInteger();
+    return integer < converted ? -1 : (converted < integer ? 1 : 0);
+  }
+}
@@ -0,0 +1,340 @@
+#include "types/Sets.hh"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <utility>
+
+#include "context.hh"
+#include "types/help/probing.hh"
+
+namespace mamba {
+  /// The control bytes of a group that hold elements, whose highest bit is clear.
+  constexpr uint32_t FullGroupMask = (uint32_t{1} << GroupSize) - 1;
+
+  /// Spreads the bits of the hash of an element before the hashes of a frozenset are combined by exclusive or,
+  /// so that the elements with nearby hashes, such as the small integers, do not cancel out each other, as in
+  /// CPython.
+  static uint64_t shuffleBits(const uint64_t hash) noexcept {
+    return ((hash ^ 89869747) ^ (hash << 16)) * 3644798167;
+  }
+
+  template<typename Visitor> bool Set::visit(Visitor&& visitor) const noexcept {
+    for (size_t offset = 0; offset < slotCount; offset += GroupSize) {
+      for (uint32_t full = ~matchVacancy(controls + offset) & FullGroupMask; full != 0; full &= full - 1) {
+        if (!visitor(slots[offset + static_cast<size_t>(std::countr_zero(full))])) return false;
+      }
+    }
+    return true;
+  }
+
+  bool Set::isSameElement(const Slot& slot, const Object& element, const uint64_t hash) noexcept {
+    // The elements looked up with the objects they were added with are the same inline value or boxed address.
+    const Object& stored = slot.element;
+    if (stored.type == element.type && stored.isBoxed == element.isBoxed &&
+        stored.payload.integer == element.payload.integer) {
+      return true;
+    }
+    return slot.hash == hash && stored == element;
+  }
+
+  Set::Set(const List& items) noexcept {
+    reserve(items.len());
+    for (size_t index = 0; index < items.len(); ++index) add(items[static_cast<ssize_t>(index)]);
+  }
+
+  Set::Set(const Set& other) noexcept {
+    if (other.size > 0) (void)rebuild(getSlotCount(other.size), other);
+  }
+
+  Set::Set(Set&& other) noexcept
+      : table{other.table}, controls{other.controls}, slots{other.slots}, slotCount{other.slotCount},
+        size{other.size}, deletedCount{other.deletedCount}, finger{other.finger} {
+    other.table = {};
+    other.controls = nullptr;
+    other.slots = nullptr;
+    other.slotCount = other.size = other.deletedCount = other.finger = 0;
+  }
+
+  Set& Set::operator=(const Set& other) noexcept {
+    if (this != &other) *this = Set(other);
+    return *this;
+  }
+
+  Set& Set::operator=(Set&& other) noexcept {
+    std::swap(table, other.table);
+    std::swap(controls, other.controls);
+    std::swap(slots, other.slots);
+    std::swap(slotCount, other.slotCount);
+    std::swap(size, other.size);
+    std::swap(deletedCount, other.deletedCount);
+    std::swap(finger, other.finger);
+    return *this;
+  }
+
+  bool Set::operator==(const Set& other) const noexcept {
+    return size == other.size && issubset(other);
+  }
+
+  Set Set::operator|(const Set& other) const noexcept {
+    // The larger set is copied by the hashes it cached, and only the elements of the smaller one are looked up.
+    const Set& larger = size >= other.size ? *this : other;
+    const Set& smaller = size >= other.size ? other : *this;
+    Set result;
+    if (larger.size == 0 || !result.rebuild(getSlotCount(size + other.size), larger)) return result;
+    (void)smaller.visit([&result](const Slot& slot) {
+      result.insert(slot.element, slot.hash);
+      return true;
+    });
+    return result;
+  }
+
+  Set Set::operator&(const Set& other) const noexcept {
+    // The elements in common are distinct and at most as many as the smaller set holds, so they are placed in
+    // a table of that size without looking them up there.
+    const Set& larger = size >= other.size ? *this : other;
+    const Set& smaller = size >= other.size ? other : *this;
+    Set result;
+    if (smaller.size == 0 || !result.ensureCapacity(smaller.size)) return result;
+    (void)smaller.visit([&result, &larger](const Slot& slot) {
+      if (larger.find(slot.element, slot.hash) != SIZE_MAX) {
+        result.place(slot.element, slot.hash);
+        ++result.size;
+      }
+      return true;
+    });
+    return result;
+  }
+
+  Set Set::operator-(const Set& other) const noexcept {
+    Set result;
+    if (size == 0) return result;
+    if (size <= other.size) {
+      if (!result.ensureCapacity(size)) return result;
+      (void)visit([&result, &other](const Slot& slot) {
+        if (other.find(slot.element, slot.hash) == SIZE_MAX) {
+          result.place(slot.element, slot.hash);
+          ++result.size;
+        }
+        return true;
+      });
+      return result;
+    }
+    // The smaller set to subtract is visited instead, removing its elements from the copy of this one.
+    if (!result.rebuild(getSlotCount(size), *this)) return result;
+    (void)other.visit([&result](const Slot& slot) {
+      const size_t found = result.find(slot.element, slot.hash);
+      if (found != SIZE_MAX) result.erase(found);
+      return true;
+    });
+    return result;
+  }
+
+  void Set::add(const Object& element) noexcept {
+    insert(element, element.hash());
+  }
+
+  void Set::remove(const Object& element) noexcept {
+    const size_t slot = find(element, element.hash());
+    if (slot == SIZE_MAX) {
+      raise(Signal::KeyError, ExceptionReason::KeyNotFound);
+      return;
+    }
+    erase(slot);
+  }
+
+  void Set::discard(const Object& element) noexcept {
+    const size_t slot = find(element, element.hash());
+    if (slot != SIZE_MAX) erase(slot);
+  }
+
+  Object Set::pop() noexcept {
+    if (size == 0) {
+      raise(Signal::KeyError, ExceptionReason::KeyNotFound);
+      return {};
+    }
+    for (;; finger = (finger + GroupSize) & (slotCount - 1)) {
+      const uint32_t full = ~matchVacancy(controls + finger) & FullGroupMask;
+      if (full == 0) continue;
+      const size_t slot = finger + static_cast<size_t>(std::countr_zero(full));
+      const Object element = slots[slot].element;
+      erase(slot);
+      return element;
+    }
+  }
+
+  void Set::update(const Set& other) noexcept {
+    if (this == &other || other.size == 0) return;
+    // The table is sized for the elements of both sets at once, as if they did not overlap.
+    if (!ensureCapacity(size + other.size)) return;
+    (void)other.visit([this](const Slot& slot) {
+      insert(slot.element, slot.hash);
+      return true;
+    });
+  }
+
+  void Set::clear() noexcept {
+    if (table.destination != nullptr) mark(table);
+    *this = Set();
+  }
+
+  bool Set::contains(const Object& element) const noexcept {
+    return find(element, element.hash()) != SIZE_MAX;
+  }
+
+  bool Set::issubset(const Set& other) const noexcept {
+    return size <= other.size &&
+           visit([&other](const Slot& slot) { return other.find(slot.element, slot.hash) != SIZE_MAX; });
+  }
+
+  size_t Set::len() const noexcept {
+    return size;
+  }
+
+  List Set::elements() const noexcept {
+    List result;
+    result.reserve(size);
+    (void)visit([&result](const Slot& slot) {
+      result.append(slot.element);
+      return true;
+    });
+    return result;
+  }
+
+  void Set::reserve(const size_t capacity) noexcept {
+    if (capacity > size) (void)ensureCapacity(capacity);
+  }
+
+  size_t Set::getCapacity(const size_t slotCount) noexcept {
+    return slotCount - slotCount / 8;
+  }
+
+  size_t Set::getSlotCount(const size_t required) noexcept {
+    size_t slotCount = SmallestSlotCount;
+    while (getCapacity(slotCount) < required) slotCount *= 2;
+    return slotCount;
+  }
+
+  bool Set::rebuild(const size_t newSlotCount, const Set& source) noexcept {
+    GarbageCollected<std::byte> replacement;
+    auto* aligned = gatherTable(newSlotCount * (1 + sizeof(Slot)), replacement);
+    if (aligned == nullptr) return false;
+    Set result;
+    result.table = replacement;
+    result.controls = reinterpret_cast<uint8_t*>(aligned);
+    result.slots = reinterpret_cast<Slot*>(aligned + newSlotCount);
+    result.slotCount = newSlotCount;
+    result.size = source.size;
+    // The elements are placed by the hashes they cached, which are never computed again.
+    (void)std::memset(result.controls, EmptyControl, newSlotCount);
+    (void)source.visit([&result](const Slot& slot) {
+      result.place(slot.element, slot.hash);
+      return true;
+    });
+    if (this == &source && table.destination != nullptr) mark(table);
+    *this = std::move(result);
+    return true;
+  }
+
+  bool Set::ensureCapacity(const size_t required) noexcept {
+    // The deleted slots take room until they are reused or dropped by a rebuild.
+    if (required + deletedCount <= getCapacity(slotCount)) return true;
+    // The table is sized for twice the elements it holds, so that rebuilding it takes amortised constant time
+    // per insertion, whether it grows or only drops the deleted slots.
+    return rebuild(getSlotCount(std::max(required, 2 * size)), *this);
+  }
+
+  size_t Set::find(const Object& element, const uint64_t hash) const noexcept {
+    if (size == 0) return SIZE_MAX;
+    for (GroupProbe probe(hash, slotCount / GroupSize);; probe.next()) {
+      const uint8_t* group = controls + probe.getOffset();
+      for (uint32_t matches = matchTag(group, probe.getTag()); matches != 0; matches &= matches - 1) {
+        const size_t slot = probe.getOffset() + static_cast<size_t>(std::countr_zero(matches));
+        if (isSameElement(slots[slot], element, hash)) return slot;
+      }
+      if (matchEmpty(group) != 0) return SIZE_MAX;
+    }
+  }
+
+  void Set::insert(const Object& element, const uint64_t hash) noexcept {
+    if (find(element, hash) != SIZE_MAX || !ensureCapacity(size + 1)) return;
+    place(element, hash);
+    ++size;
+  }
+
+  void Set::place(const Object& element, const uint64_t hash) noexcept {
+    for (GroupProbe probe(hash, slotCount / GroupSize);; probe.next()) {
+      const uint32_t vacancies = matchVacancy(controls + probe.getOffset());
+      if (vacancies == 0) continue;
+      const size_t slot = probe.getOffset() + static_cast<size_t>(std::countr_zero(vacancies));
+      if (controls[slot] == DeletedControl) --deletedCount;
+      controls[slot] = probe.getTag();
+      slots[slot] = {hash, element};
+      return;
+    }
+  }
+
+  void Set::erase(const size_t slot) noexcept {
+    controls[slot] = DeletedControl;
+    slots[slot].element = {};
+    --size;
+    ++deletedCount;
+  }
+
+  Frozenset::Frozenset(Set elements) noexcept : set{std::move(elements)} {}
+
+  Frozenset::Frozenset(const List& items) noexcept : set{items} {}
+
+  bool Frozenset::operator==(const Frozenset& other) const noexcept {
+    // The hashes the frozensets cached tell most of the unequal ones apart without visiting their elements.
+    if (cachedHash != ReservedHash && other.cachedHash != ReservedHash && cachedHash != other.cachedHash) {
+      return false;
+    }
+    return set == other.set;
+  }
+
+  Frozenset Frozenset::operator|(const Frozenset& other) const noexcept {
+    return Frozenset(set | other.set);
+  }
+
+  Frozenset Frozenset::operator&(const Frozenset& other) const noexcept {
+    return Frozenset(set & other.set);
+  }
+
+  Frozenset Frozenset::operator-(const Frozenset& other) const noexcept {
+    return Frozenset(set - other.set);
+  }
+
+  bool Frozenset::contains(const Object& element) const noexcept {
+    return set.contains(element);
+  }
+
+  bool Frozenset::issubset(const Frozenset& other) const noexcept {
+    return set.issubset(other.set);
+  }
+
+  size_t Frozenset::len() const noexcept {
+    return set.len();
+  }
+
+  List Frozenset::elements() const noexcept {
+    return set.elements();
+  }
+
+  size_t Frozenset::hash() const noexcept {
+    if (cachedHash != ReservedHash) return cachedHash;
+    // The hashes the elements cached are combined regardless of their order, then the size is mixed in and the
+    // bits are dispersed, so that the nested frozensets do not hash alike, with the constants of CPython.
+    uint64_t result = 0;
+    (void)set.visit([&result](const Set::Slot& slot) {
+      result ^= shuffleBits(slot.hash);
+      return true;
+    });
+    result ^= (set.size + 1) * 1927868237;
+    result ^= (result >> 11) ^ (result >> 25);
+    result = result * 69069 + 907133923;
+    if (result == ReservedHash) result = 590923713;
+    cachedHash = result;
+    return cachedHash;
+  }
+}
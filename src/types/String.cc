@@ -1,7 +1,513 @@
-
 #include "types/String.hh"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include "context.hh"
+#include "exceptions.hh"
+#include "types/help/builder.hh"
+#include "help/unicode/utf8.hh"
 namespace mamba {
-    char* String::data() const noexcept {
-        return stream.destination;
+  constexpr uint64_t AsciiWordMask = 0x8080808080808080;
+
+  /// Allocates the buffer for a string of the given size on the pool and terminates it.
+  /// @param sizeInBytes The number of bytes in the string, excluding the zero terminator.
+  /// @return The allocated buffer, whose destination is nullptr if the pool is exhausted.
+  GarbageCollected<char> gatherCharacters(const size_t sizeInBytes) noexcept {
+    GarbageCollected<char> buffer = gather(sizeInBytes + 1, GarbageCollectionGeneration::Eden);
+    if (buffer.destination == nullptr) raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+    else buffer.destination[sizeInBytes] = '\0';
+    return buffer;
+  }
+
+  Outpost::Outpost() : index{0}, destination{0} { }
+
+  Outpost::Outpost(const uint32_t inputIndex) : index{inputIndex}, destination{inputIndex} { }
+
+  Outpost& Outpost::operator=(const int base) noexcept {
+    index = destination = static_cast<uint32_t>(base);
+    return *this;
+  }
+
+  bool Outpost::operator==(const Outpost& other) const noexcept {
+    return index == other.index && destination == other.destination;
+  }
+
+  String::String() = default;
+
+  String::String(const String& other) = default;
+
+  String::String(String&& other) noexcept
+      : lastRecentlyUpdatedOutpost{other.lastRecentlyUpdatedOutpost}, isOnlyAscii{other.isOnlyAscii},
+        properties{other.properties}, stream{other.stream}, graphemes{other.graphemes}, sizeInBytes{other.sizeInBytes},
+        hashCode{other.hashCode}, outposts{other.outposts} {
+    other = String();
+  }
+
+  String::String(const char* character) noexcept : String(std::string_view(character)) { }
+
+  String::String(const std::string_view& slice) noexcept {
+    verifyEncodingAndConfigureString(slice);
+    if (sizeInBytes == 0) return;
+    stream = gatherCharacters(sizeInBytes);
+    if (stream.destination == nullptr) {
+      *this = String();
+      return;
+    }
+    (void)std::memcpy(stream.destination, slice.data(), sizeInBytes);
+  }
+
+  String::String(const GarbageCollected<char>& address) noexcept {
+    if (address.destination == nullptr) return;
+    const std::string_view slice(address.destination, strnlen(address.destination, address.capacity));
+    verifyEncodingAndConfigureString(slice);
+    if (sizeInBytes == slice.size()) stream = address;
+  }
+
+  String::String(const Integer& integer) : String(integer.str()) { }
+
+  String::String(const Float& number) : String(number.str()) { }
+
+  String::String(const GarbageCollected<char>& buffer, const size_t size, const size_t length,
+                 const bool isAscii) noexcept
+      : isOnlyAscii{isAscii}, stream{buffer}, graphemes{length}, sizeInBytes{size} { }
+
+  String& String::operator=(const char* character) noexcept {
+    return *this = String(character);
+  }
+
+  String& String::operator=(const std::string_view& other) noexcept {
+    return *this = String(other);
+  }
+
+  String& String::operator=(String&& other) noexcept {
+    if (this == &other) return *this;
+    lastRecentlyUpdatedOutpost = other.lastRecentlyUpdatedOutpost;
+    isOnlyAscii = other.isOnlyAscii;
+    properties = other.properties;
+    stream = other.stream;
+    graphemes = other.graphemes;
+    sizeInBytes = other.sizeInBytes;
+    hashCode = other.hashCode;
+    outposts = other.outposts;
+    other.stream = GarbageCollected<char>();
+    other.graphemes = other.sizeInBytes = other.hashCode = 0;
+    other.isOnlyAscii = true;
+    other.properties.reset();
+    return *this;
+  }
+
+  String String::operator+(const String& other) const noexcept {
+    if (other.sizeInBytes == 0) return *this;
+    if (sizeInBytes == 0) return other;
+    return StringBuilder(sizeInBytes + other.sizeInBytes).append(*this).append(other).build();
+  }
+
+  String& String::operator+=(const String& other) noexcept {
+    return *this = *this + other;
+  }
+
+  String String::operator*(const size_t times) const noexcept {
+    if (times == 1) return *this;
+    size_t size;
+    if (__builtin_mul_overflow(sizeInBytes, times, &size)) {
+      raise(Signal::MemoryError, ExceptionReason::AttemptToAllocateBeyondLargestSize);
+      return {};
     }
-}
\ No newline at end of file
+    if (size == 0) return {};
+    StringBuilder builder(size);
+    for (size_t index = 0; index < times; ++index) (void)builder.append(*this);
+    return builder.build();
+  }
+
+  bool String::operator==(const String& other) const noexcept {
+    if (sizeInBytes != other.sizeInBytes) return false;
+    // Keys hashed for a dictionary lookup usually differ in their cached hashes, which saves reading them.
+    if (hashCode != 0 && other.hashCode != 0 && hashCode != other.hashCode) return false;
+    return sizeInBytes == 0 || std::memcmp(data(), other.data(), sizeInBytes) == 0;
+  }
+
+  /// Orders the strings by their bytes and then by their sizes.
+  /// @return A negative number if the first string is less, zero if they are equal, or a positive number.
+  int compareStrings(const String& first, const String& second) noexcept {
+    const auto firstSize = static_cast<size_t>(first.end() - first.begin());
+    const auto secondSize = static_cast<size_t>(second.end() - second.begin());
+    const size_t commonSize = std::min(firstSize, secondSize);
+    const int order = commonSize == 0 ? 0 : std::memcmp(first.begin(), second.begin(), commonSize);
+    if (order != 0) return order;
+    return firstSize < secondSize ? -1 : (firstSize > secondSize ? 1 : 0);
+  }
+
+  bool String::operator>(const String& other) const noexcept {
+    return compareStrings(*this, other) > 0;
+  }
+
+  bool String::operator<(const String& other) const noexcept {
+    return compareStrings(*this, other) < 0;
+  }
+
+  bool String::operator<=(const String& other) const noexcept {
+    return compareStrings(*this, other) <= 0;
+  }
+
+  bool String::operator>=(const String& other) const noexcept {
+    return compareStrings(*this, other) >= 0;
+  }
+
+  String String::operator%(const FormatArguments& arguments) const noexcept {
+    const FormatPlan* plan = getFormatPlan(*this, FormatSyntax::Percent);
+    return plan == nullptr ? String() : plan->render(arguments);
+  }
+
+  String String::operator%(const String& argument) const noexcept {
+    return *this % FormatArguments{&argument, 1};
+  }
+
+  char* String::data() const noexcept {
+    return stream.destination;
+  }
+
+  const char* String::begin() const noexcept {
+    return stream.destination;
+  }
+
+  const char* String::end() const noexcept {
+    return stream.destination + sizeInBytes;
+  }
+
+  bool String::in(const String& haystack) const noexcept {
+    return Needle(*this).findIn(haystack.data(), haystack.sizeInBytes) >= 0;
+  }
+
+  size_t String::len() const {
+    return graphemes;
+  }
+
+  size_t String::hash() const noexcept {
+    // A non-empty string whose hash happens to be 0 is simply hashed again on every call.
+    if (hashCode == 0 && sizeInBytes > 0) hashCode = hashBytes(data(), sizeInBytes);
+    return hashCode;
+  }
+
+  String& String::reserve(const size_t size) noexcept {
+    if (size < stream.capacity) return *this;
+    const GarbageCollected<char> buffer = gatherCharacters(size);
+    if (buffer.destination == nullptr) return *this;
+    if (sizeInBytes > 0) (void)std::memcpy(buffer.destination, data(), sizeInBytes);
+    buffer.destination[sizeInBytes] = '\0';
+    stream = buffer;
+    return *this;
+  }
+
+  String String::capitalize() const noexcept {
+    return convertCase(CaseConversion::Capitalize);
+  }
+
+  String String::casefold() const noexcept {
+    return convertCase(CaseConversion::Fold);
+  }
+
+  String String::center(const size_t count, const String& padding) const noexcept {
+    return align(count, padding, '^');
+  }
+
+  size_t String::count(const Needle& value, const size_t start, const size_t end) const noexcept {
+    size_t beginning, ending, occurrences = 0;
+    if (!resolveSearchInterval(start, end, beginning, ending)) return 0;
+    if (value.size() == 0) return std::min(end, graphemes) - start + 1;
+    for (size_t offset = beginning; offset + value.size() <= ending; ++occurrences) {
+      const ssize_t match = value.findIn(data() + offset, ending - offset);
+      if (match < 0) break;
+      offset += match + value.size();
+    }
+    return occurrences;
+  }
+
+  ssize_t String::find(const Needle& needle, const size_t start, const size_t end) const noexcept {
+    size_t beginning, ending;
+    if (!resolveSearchInterval(start, end, beginning, ending)) return -1;
+    const ssize_t match = needle.findIn(data() + beginning, ending - beginning);
+    if (match < 0) return -1;
+    return static_cast<ssize_t>(getGraphemeIndex(beginning + match));
+  }
+
+  size_t String::index(const Needle& value, const size_t start, const size_t end) const noexcept {
+    const ssize_t match = find(value, start, end);
+    if (match < 0) raise(Signal::ValueError, ExceptionReason::SubstringNotFound);
+    return static_cast<size_t>(match);
+  }
+
+  String String::format(const FormatArguments& arguments) const noexcept {
+    const FormatPlan* plan = getFormatPlan(*this, FormatSyntax::Braces);
+    return plan == nullptr ? String() : plan->render(arguments);
+  }
+
+  bool String::isalnum() const noexcept {
+    return getCharacterProperties()[AlphaNumericBit];
+  }
+
+  bool String::isalpha() const noexcept {
+    return getCharacterProperties()[AlphaBit];
+  }
+
+  bool String::isascii() const noexcept {
+    return isOnlyAscii;
+  }
+
+  bool String::isdecimal() const noexcept {
+    return getCharacterProperties()[DecimalBit];
+  }
+
+  bool String::isdigit() const noexcept {
+    return getCharacterProperties()[DigitBit];
+  }
+
+  bool String::isidentifier() const noexcept {
+    return getCharacterProperties()[IdentifierBit];
+  }
+
+  bool String::islower() const noexcept {
+    const StringBitmask& bitmask = getCharacterProperties();
+    return bitmask[LowerBit] && bitmask[CasedBit];
+  }
+
+  bool String::isnumeric() const noexcept {
+    return getCharacterProperties()[NumericBit];
+  }
+
+  bool String::isprintable() const noexcept {
+    return getCharacterProperties()[PrintableBit];
+  }
+
+  bool String::isspace() const noexcept {
+    return getCharacterProperties()[SpaceBit];
+  }
+
+  bool String::istitle() const noexcept {
+    const StringBitmask& bitmask = getCharacterProperties();
+    return bitmask[TitleBit] && bitmask[CasedBit];
+  }
+
+  bool String::isupper() const noexcept {
+    const StringBitmask& bitmask = getCharacterProperties();
+    return bitmask[UpperBit] && bitmask[CasedBit];
+  }
+
+  String String::ljust(const size_t size, const String& padding) const noexcept {
+    return align(size, padding, '<');
+  }
+
+  String String::lower() const noexcept {
+    return convertCase(CaseConversion::Lower);
+  }
+
+  Translator String::maketrans(const String& replacementSet, const String& replacementString,
+                               const String& removeSet) {
+    return {replacementSet, replacementString, removeSet};
+  }
+
+  String String::replace(const String& target, const String& replacement, const size_t count) const noexcept {
+    if (count == 0) return *this;
+    StringBuilder builder;
+    if (target.sizeInBytes == 0) {
+      // The empty target matches before every grapheme and at the end.
+      const size_t insertions = std::min(count, graphemes + 1);
+      (void)builder.reserve(sizeInBytes + insertions * replacement.sizeInBytes);
+      for (size_t index = 0; index < insertions; ++index) (void)builder.append(replacement).append(*this, index, index + 1);
+      return builder.append(*this, insertions, SIZE_MAX).build();
+    }
+
+    const Needle needle(target);
+    size_t offset = 0, replaced = 0;
+    for (; replaced < count && offset + target.sizeInBytes <= sizeInBytes; ++replaced) {
+      const ssize_t match = needle.findIn(data() + offset, sizeInBytes - offset);
+      if (match < 0) break;
+      if (replaced == 0) (void)builder.reserve(sizeInBytes - target.sizeInBytes + replacement.sizeInBytes);
+      (void)builder.appendUTF8(data() + offset, match).append(replacement);
+      offset += match + target.sizeInBytes;
+    }
+    if (replaced == 0) return *this;
+    return builder.appendUTF8(data() + offset, sizeInBytes - offset).build();
+  }
+
+  String String::replace(const ReplacementAutomaton& automaton) const noexcept {
+    return automaton.replace(*this);
+  }
+
+  ssize_t String::rfind(const Needle& value, const size_t start, const size_t end) const noexcept {
+    size_t beginning, ending;
+    if (!resolveSearchInterval(start, end, beginning, ending)) return -1;
+    const ssize_t match = value.rfindIn(data() + beginning, ending - beginning);
+    if (match < 0) return -1;
+    return static_cast<ssize_t>(getGraphemeIndex(beginning + match));
+  }
+
+  size_t String::rindex(const Needle& value, const size_t start, const size_t end) const noexcept {
+    const ssize_t match = rfind(value, start, end);
+    if (match < 0) raise(Signal::ValueError, ExceptionReason::SubstringNotFound);
+    return static_cast<size_t>(match);
+  }
+
+  String String::rjust(const size_t size, const String& padding) const noexcept {
+    return align(size, padding, '>');
+  }
+
+  String String::swapcase() const noexcept {
+    return convertCase(CaseConversion::Swap);
+  }
+
+  String String::title() const noexcept {
+    return convertCase(CaseConversion::Title);
+  }
+
+  String String::translate(const Translator& table) const noexcept {
+    return table.translate(*this);
+  }
+
+  String String::upper() const noexcept {
+    return convertCase(CaseConversion::Upper);
+  }
+
+  String String::zfill(const size_t length) const noexcept {
+    if (length <= graphemes) return *this;
+    // The zeros go after the sign, so that "-42".zfill(5) gives "-0042".
+    const size_t signSize = sizeInBytes > 0 && (data()[0] == '+' || data()[0] == '-');
+    return StringBuilder(length - graphemes + sizeInBytes)
+        .appendUTF8(data(), signSize)
+        .appendCharacter('0', length - graphemes)
+        .append(*this, signSize, SIZE_MAX)
+        .build();
+  }
+
+  String String::convertCase(const CaseConversion conversion) const noexcept {
+    if (sizeInBytes == 0) return *this;
+    if (isOnlyAscii) {
+      // Only copy the prefix the conversion leaves intact, or share the whole string if nothing changes.
+      const bool isContextFree = conversion != CaseConversion::Title && conversion != CaseConversion::Capitalize;
+      const size_t firstChange = isContextFree ? findFirstAsciiCaseChange(data(), sizeInBytes, conversion) : 0;
+      if (firstChange == sizeInBytes) return *this;
+      const GarbageCollected<char> buffer = gatherCharacters(sizeInBytes);
+      if (buffer.destination == nullptr) return {};
+      (void)std::memcpy(buffer.destination, data(), firstChange);
+      convertAsciiCase(data() + firstChange, buffer.destination + firstChange, sizeInBytes - firstChange, conversion);
+      return {buffer, sizeInBytes, graphemes, true};
+    }
+
+    const CaseConversionSummary summary = measureCaseConversion(data(), sizeInBytes, conversion);
+    if (!summary.isChanged) return *this;
+    const GarbageCollected<char> buffer = gatherCharacters(summary.sizeInBytes);
+    if (buffer.destination == nullptr) return {};
+    writeCaseConversion(data(), sizeInBytes, buffer.destination, conversion);
+    return {buffer, summary.sizeInBytes, summary.graphemes, summary.isOnlyAscii};
+  }
+
+  String String::align(const size_t size, const String& padding, const char alignment) const noexcept {
+    if (padding.graphemes != 1) {
+      raise(Signal::TypeError, ExceptionReason::FillCharacterNotSingle);
+      return {};
+    }
+    if (size <= graphemes) return *this;
+    // The odd margin goes to the left of the centred string only if the size is odd too, as in CPython.
+    const size_t margin = size - graphemes;
+    const size_t left = alignment == '<' ? 0 : alignment == '>' ? margin : margin / 2 + (margin & size & 1);
+    int paddingSize;
+    const uint32_t fill = decodeTrustedUTF8(padding.data(), paddingSize);
+    return StringBuilder(sizeInBytes + margin * paddingSize)
+        .appendCharacter(fill, left)
+        .append(*this)
+        .appendCharacter(fill, margin - left)
+        .build();
+  }
+
+  void String::verifyEncodingAndConfigureString(const char* data) noexcept {
+    verifyEncodingAndConfigureString(std::string_view(data));
+  }
+
+  void String::verifyEncodingAndConfigureString(const std::string_view& slice) noexcept {
+    lastRecentlyUpdatedOutpost = 0;
+    outposts.fill(Outpost());
+    properties.reset();
+    graphemes = sizeInBytes = hashCode = 0;
+    isOnlyAscii = true;
+
+    size_t offset = 0;
+    for (; offset + sizeof(uint64_t) <= slice.size(); offset += sizeof(uint64_t)) {
+      uint64_t word;
+      (void)std::memcpy(&word, slice.data() + offset, sizeof(word));
+      if ((word & AsciiWordMask) != 0) break;
+    }
+    try {
+      while (offset < slice.size()) {
+        if (static_cast<unsigned char>(slice[offset]) < 0x80) {
+          ++offset;
+          continue;
+        }
+        isOnlyAscii = false;
+        const int size = getSizeOfUTF8Grapheme(slice.data() + offset);
+        if (offset + size > slice.size()) throw InvalidUTF8Composition("Truncated UTF-8 multibyte sequence");
+        (void)getUnicodePointForUTF8(slice.data() + offset);
+        offset += size;
+      }
+    } catch (const InvalidUTF8Composition&) {
+      raise(Signal::UnicodeDecodeError, ExceptionReason::UTF8ToUTF8ConversionFailure);
+      isOnlyAscii = true;
+      return;
+    }
+    sizeInBytes = slice.size();
+    graphemes = isOnlyAscii ? sizeInBytes : countUTF8Graphemes(slice.data(), sizeInBytes);
+  }
+
+  const StringBitmask& String::getCharacterProperties() const noexcept {
+    if (!properties[InitialisedBit]) properties = classifyUTF8Characters(data(), sizeInBytes);
+    return properties;
+  }
+
+  void String::updateOutpostCache(const size_t index, const size_t destination) const noexcept {
+    if (destination > UINT32_MAX) return;
+    Outpost& evicted = outposts[lastRecentlyUpdatedOutpost];
+    evicted.index = static_cast<uint32_t>(index);
+    evicted.destination = static_cast<uint32_t>(destination);
+    lastRecentlyUpdatedOutpost = (lastRecentlyUpdatedOutpost + 1) % NumberOfOutposts;
+  }
+
+  size_t String::getGrapheme(const size_t index) const noexcept {
+    if (isOnlyAscii) return std::min(index, sizeInBytes);
+    if (index >= graphemes) return sizeInBytes;
+    Outpost closest;
+    for (const Outpost& outpost : outposts)
+      if (outpost.index <= index && outpost.index >= closest.index) closest = outpost;
+    if (closest.index == index) return closest.destination;
+
+    size_t destination = closest.destination;
+    for (size_t walked = closest.index; walked < index; ++walked) {
+      const int leadingOnes = std::countl_one(static_cast<unsigned char>(stream.destination[destination]));
+      destination += leadingOnes == 0 ? 1 : leadingOnes;
+    }
+    updateOutpostCache(index, destination);
+    return destination;
+  }
+
+  size_t String::getGraphemeIndex(const size_t destination) const noexcept {
+    if (isOnlyAscii) return destination;
+    if (destination >= sizeInBytes) return graphemes;
+    Outpost closest;
+    for (const Outpost& outpost : outposts)
+      if (outpost.destination <= destination && outpost.destination >= closest.destination) closest = outpost;
+    if (closest.destination == destination) return closest.index;
+
+    const size_t index = closest.index +
+                         countUTF8Graphemes(stream.destination + closest.destination, destination - closest.destination);
+    updateOutpostCache(index, destination);
+    return index;
+  }
+
+  bool String::resolveSearchInterval(const size_t start, const size_t end, size_t& beginning,
+                                     size_t& ending) const noexcept {
+    const size_t last = std::min(end, graphemes);
+    if (start > graphemes || last < start) return false;
+    beginning = getGrapheme(start);
+    ending = getGrapheme(last);
+    return true;
+  }
+}
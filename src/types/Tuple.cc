@@ -0,0 +1,130 @@
+#include "types/Tuple.hh"
+
+#include <bit>
+
+#include "context.hh"
+#include "givers/GarbageCollectedStack/ActiveSetMemory.hh"
+#include "types/help/hashing.hh"
+
+namespace mamba {
+  /// The primes of xxHash, which CPython mixes the hashes of the elements of a tuple with.
+  constexpr uint64_t FirstTuplePrime = 11400714785074694791U;
+  constexpr uint64_t SecondTuplePrime = 14029467366897019727U;
+  constexpr uint64_t FifthTuplePrime = 2870177450012600261U;
+
+  /// The largest arity whose blocks the freelists of the pool recycle.
+  constexpr size_t MaximalRecycledArity = 8;
+
+  Tuple::Tuple(const std::initializer_list<Object> elements) noexcept {
+    if (elements.size() == 0 || !allocate(elements.size())) return;
+    Object* destination = getElements();
+    for (const Object& element : elements) *destination++ = element;
+  }
+
+  Tuple::Tuple(const List& items) noexcept {
+    if (items.len() == 0 || !allocate(items.len())) return;
+    Object* destination = getElements();
+    for (size_t index = 0; index < items.len(); ++index) destination[index] = items[static_cast<ssize_t>(index)];
+  }
+
+  Object Tuple::operator[](const ssize_t index) const noexcept {
+    // The negative indexes beyond the start wrap around to positions far beyond the end.
+    const size_t position = static_cast<size_t>(index) + (index < 0 ? len() : 0);
+    if (position >= len()) {
+      raise(Signal::IndexError, ExceptionReason::IndexOutOfRange);
+      return {};
+    }
+    return getElements()[position];
+  }
+
+  bool Tuple::operator==(const Tuple& other) const noexcept {
+    if (header == other.header) return true;
+    if (len() != other.len()) return false;
+    // The hashes the tuples cached tell most of the unequal ones apart without comparing their elements.
+    if (header->hash != ReservedHash && other.header->hash != ReservedHash && header->hash != other.header->hash) {
+      return false;
+    }
+    const Object* elements = getElements();
+    const Object* others = other.getElements();
+    for (size_t position = 0; position < header->size; ++position) {
+      if (!(elements[position] == others[position])) return false;
+    }
+    return true;
+  }
+
+  bool Tuple::contains(const Object& element) const noexcept {
+    const Object* elements = getElements();
+    for (size_t position = 0; position < len(); ++position) {
+      if (elements[position] == element) return true;
+    }
+    return false;
+  }
+
+  size_t Tuple::count(const Object& element) const noexcept {
+    const Object* elements = getElements();
+    size_t result = 0;
+    for (size_t position = 0; position < len(); ++position) result += elements[position] == element ? 1 : 0;
+    return result;
+  }
+
+  size_t Tuple::index(const Object& element) const noexcept {
+    const Object* elements = getElements();
+    for (size_t position = 0; position < len(); ++position) {
+      if (elements[position] == element) return position;
+    }
+    raise(Signal::ValueError, ExceptionReason::ItemNotFound);
+    return SIZE_MAX;
+  }
+
+  size_t Tuple::len() const noexcept {
+    return header == nullptr ? 0 : header->size;
+  }
+
+  size_t Tuple::hash() const noexcept {
+    if (header != nullptr && header->hash != ReservedHash) return header->hash;
+    uint64_t result = FifthTuplePrime;
+    const Object* elements = getElements();
+    for (size_t position = 0; position < len(); ++position) {
+      result += elements[position].hash() * SecondTuplePrime;
+      result = std::rotl(result, 31) * FirstTuplePrime;
+    }
+    result += len() ^ (FifthTuplePrime ^ 3527539);
+    if (result == ReservedHash) result = 1546275796;
+    if (header != nullptr) header->hash = result;
+    return result;
+  }
+
+  void Tuple::release() noexcept {
+    static_assert(sizeof(Header) + MaximalRecycledArity * sizeof(Object) + alignof(Header) - 1 <=
+                      RecycledClassCount * WordSize,
+                  "The freelists of the pool recycle the blocks of the tuples up to the largest recycled arity.");
+    if (header == nullptr) return;
+    GarbageCollected<> block;
+    block.destination = header->allocation;
+    block.capacity = getBlockSize(header->size);
+    recycle(block);
+    header = nullptr;
+  }
+
+  size_t Tuple::getBlockSize(const size_t size) noexcept {
+    // The block spans whole words, so that the pool recycles it into the size class its arity requests.
+    return (sizeof(Header) + size * sizeof(Object) + alignof(Header) - 1 + WordSize - 1) & ~(WordSize - 1);
+  }
+
+  bool Tuple::allocate(const size_t size) noexcept {
+    // The block of the tuple that was released last with the same arity is reused if the pool kept it.
+    const GarbageCollected<std::byte> block = gather(getBlockSize(size), GarbageCollectionGeneration::Eden);
+    if (block.destination == nullptr) {
+      raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+      return false;
+    }
+    const auto address = reinterpret_cast<uintptr_t>(block.destination);
+    header = reinterpret_cast<Header*>((address + alignof(Header) - 1) & ~(alignof(Header) - 1));
+    *header = {block.destination, ReservedHash, size};
+    return true;
+  }
+
+  Object* Tuple::getElements() const noexcept {
+    return header == nullptr ? nullptr : reinterpret_cast<Object*>(header + 1);
+  }
+}
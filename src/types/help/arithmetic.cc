@@ -0,0 +1,943 @@
+#include "types/help/arithmetic.hh"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include "vectorisation.hh"
+namespace mamba {
+  /// The modular inverse of 3 modulo 2^32, which turns the exact division by 3 into a multiplication.
+  constexpr uint32_t InverseOfThree = 0xAAAAAAABU;
+
+  /// Tells how many cells remain after the leading zero cells are dropped.
+  inline size_t trimCells(const uint32_t* cells, size_t size) noexcept {
+    while (size > 0 && cells[size - 1] == 0) --size;
+    return size;
+  }
+
+  GarbageCollected<uint32_t> gatherAlignedCells(const size_t count) noexcept {
+    GarbageCollected<uint32_t> cells = gather(count * sizeof(uint32_t) + alignof(uint32_t) - 1,
+                                              GarbageCollectionGeneration::Eden);
+    if (cells.destination == nullptr) return cells;
+    const auto address = reinterpret_cast<uintptr_t>(cells.destination);
+    cells.destination = reinterpret_cast<uint32_t*>((address + alignof(uint32_t) - 1) & ~(alignof(uint32_t) - 1));
+    cells.capacity = count * sizeof(uint32_t);
+    return cells;
+  }
+
+  int compareCells(const uint32_t* left, size_t leftSize, const uint32_t* right, size_t rightSize) noexcept {
+    leftSize = trimCells(left, leftSize);
+    rightSize = trimCells(right, rightSize);
+    if (leftSize != rightSize) return leftSize < rightSize ? -1 : 1;
+    for (size_t index = leftSize; index-- > 0;) {
+      if (left[index] != right[index]) return left[index] < right[index] ? -1 : 1;
+    }
+    return 0;
+  }
+
+  /// Adds or subtracts the first size cells of 2 magnitudes, starting with the incoming carry or borrow.
+  /// @return The carry or borrow out of the last cell.
+  typedef uint32_t (*CellCarryKernel)(const uint32_t* left, const uint32_t* right, size_t size, uint32_t* result,
+                                      uint32_t carry);
+
+  /// Combines 2 arrays of cells bit by bit.
+  typedef void (*CellCombinationKernel)(const uint32_t* left, const uint32_t* right, size_t size, uint32_t* result,
+                                        CellOperation operation);
+
+  /// Shifts the cells by fewer than 32 bits, into the cells of the result at the same indexes.
+  /// @return The bits shifted out of the array.
+  typedef uint32_t (*CellShiftKernel)(const uint32_t* cells, size_t size, unsigned shift, uint32_t* result);
+
+  /// Counts the set bits in the cells.
+  typedef size_t (*CellCountKernel)(const uint32_t* cells, size_t size);
+
+  /// The kernels of the linear operations on cells, resolved once for the host.
+  struct CellKernels {
+    CellCarryKernel add, subtract;
+    CellCombinationKernel combine;
+    CellShiftKernel shiftLeft, shiftRight;
+    CellCountKernel count;
+  };
+
+  /// The number of cells below which the scalar loops are called directly, skipping the dispatch.
+  constexpr size_t CellKernelThreshold = 16;
+
+  uint32_t addCellsScalar(const uint32_t* left, const uint32_t* right, const size_t size, uint32_t* sum,
+                          const uint32_t carry) {
+    uint64_t accumulator = carry;
+    for (size_t index = 0; index < size; ++index) {
+      accumulator += static_cast<uint64_t>(left[index]) + right[index];
+      sum[index] = static_cast<uint32_t>(accumulator);
+      accumulator >>= 32;
+    }
+    return static_cast<uint32_t>(accumulator);
+  }
+
+  uint32_t subtractCellsScalar(const uint32_t* left, const uint32_t* right, const size_t size,
+                               uint32_t* difference, uint32_t borrow) {
+    for (size_t index = 0; index < size; ++index) {
+      const uint64_t cell = static_cast<uint64_t>(left[index]) - right[index] - borrow;
+      difference[index] = static_cast<uint32_t>(cell);
+      borrow = static_cast<uint32_t>(cell >> 63);
+    }
+    return borrow;
+  }
+
+  template<CellOperation Operation> inline uint32_t combineCell(const uint32_t left, const uint32_t right) noexcept {
+    if constexpr (Operation == CellOperation::And) return left & right;
+    else if constexpr (Operation == CellOperation::Or) return left | right;
+    else return left ^ right;
+  }
+
+  template<CellOperation Operation>
+  void combineCellsScalar(const uint32_t* left, const uint32_t* right, const size_t size, uint32_t* result) noexcept {
+    for (size_t index = 0; index < size; ++index) result[index] = combineCell<Operation>(left[index], right[index]);
+  }
+
+  void combineCellsScalar(const uint32_t* left, const uint32_t* right, const size_t size, uint32_t* result,
+                          const CellOperation operation) {
+    switch (operation) {
+      case CellOperation::And: return combineCellsScalar<CellOperation::And>(left, right, size, result);
+      case CellOperation::Or: return combineCellsScalar<CellOperation::Or>(left, right, size, result);
+      case CellOperation::Xor: return combineCellsScalar<CellOperation::Xor>(left, right, size, result);
+    }
+  }
+
+  /// Shifts the cells from the given index on to the left, each one taking the top bits of the one below.
+  inline uint32_t shiftCellsLeftFrom(const uint32_t* cells, const size_t size, const unsigned shift, uint32_t* result,
+                                     size_t index) noexcept {
+    if (index == 0 && size > 0) result[index++] = cells[0] << shift;
+    for (; index < size; ++index) result[index] = (cells[index] << shift) | (cells[index - 1] >> (32 - shift));
+    return size == 0 ? 0 : cells[size - 1] >> (32 - shift);
+  }
+
+  /// Shifts the cells from the given index on to the right, each one taking the low bits of the one above.
+  inline uint32_t shiftCellsRightFrom(const uint32_t* cells, const size_t size, const unsigned shift,
+                                      uint32_t* result, size_t index) noexcept {
+    for (; index + 1 < size; ++index) result[index] = (cells[index] >> shift) | (cells[index + 1] << (32 - shift));
+    if (index < size) result[index] = cells[index] >> shift;
+    return size == 0 ? 0 : cells[0] << (32 - shift);
+  }
+
+  uint32_t shiftCellsLeftScalar(const uint32_t* cells, const size_t size, const unsigned shift, uint32_t* result) {
+    return shiftCellsLeftFrom(cells, size, shift, result, 0);
+  }
+
+  uint32_t shiftCellsRightScalar(const uint32_t* cells, const size_t size, const unsigned shift, uint32_t* result) {
+    return shiftCellsRightFrom(cells, size, shift, result, 0);
+  }
+
+  size_t countCellBitsScalar(const uint32_t* cells, const size_t size) {
+    size_t count = 0;
+    for (size_t index = 0; index < size; ++index) count += std::popcount(cells[index]);
+    return count;
+  }
+
+  /// Resolves the carries between the lanes of a vector of sums at once. The lanes that generate a carry
+  /// and the ones that propagate the incoming carry, being all ones, are given as bit masks, and adding
+  /// the generated carries, moved to the lanes above, to the propagating lanes ripples every carry
+  /// through the runs of propagating lanes in a single addition of general purpose registers.
+  /// @param carry The carry into the lowest lane, updated with the carry out of the highest one.
+  /// @return The mask of the lanes that receive a carry.
+  template<unsigned Lanes> inline unsigned resolveLaneCarries(const unsigned generated, const unsigned propagated,
+                                                              uint32_t& carry) noexcept {
+    const unsigned carries = (((generated << 1) | carry) + propagated) ^ propagated;
+    carry = carries >> Lanes;
+    return carries & ((1U << Lanes) - 1);
+  }
+
+#if defined(MAMBA_X86_64)
+  uint32_t addCellsSSE2(const uint32_t* left, const uint32_t* right, const size_t size, uint32_t* sum,
+                        uint32_t carry) {
+    // SSE2 has no unsigned comparison, so the operands are compared with their sign bits flipped.
+    const __m128i bias = _mm_set1_epi32(INT32_MIN), ones = _mm_set1_epi32(-1), lanes = _mm_setr_epi32(1, 2, 4, 8);
+    size_t index = 0;
+    for (; index + 4 <= size; index += 4) {
+      const __m128i addend = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + index));
+      __m128i cells = _mm_add_epi32(addend, _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + index)));
+      const auto generated = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(
+          _mm_cmpgt_epi32(_mm_xor_si128(addend, bias), _mm_xor_si128(cells, bias)))));
+      const auto propagated = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(cells, ones))));
+      const unsigned carries = resolveLaneCarries<4>(generated, propagated, carry);
+      const __m128i increments = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(static_cast<int>(carries)), lanes), lanes);
+      cells = _mm_sub_epi32(cells, increments);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(sum + index), cells);
+    }
+    return addCellsScalar(left + index, right + index, size - index, sum + index, carry);
+  }
+
+  uint32_t subtractCellsSSE2(const uint32_t* left, const uint32_t* right, const size_t size, uint32_t* difference,
+                             uint32_t borrow) {
+    const __m128i bias = _mm_set1_epi32(INT32_MIN), lanes = _mm_setr_epi32(1, 2, 4, 8);
+    size_t index = 0;
+    for (; index + 4 <= size; index += 4) {
+      const __m128i minuend = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + index));
+      const __m128i subtrahend = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + index));
+      __m128i cells = _mm_sub_epi32(minuend, subtrahend);
+      const auto generated = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(
+          _mm_cmpgt_epi32(_mm_xor_si128(subtrahend, bias), _mm_xor_si128(minuend, bias)))));
+      const auto propagated = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(
+          _mm_cmpeq_epi32(cells, _mm_setzero_si128()))));
+      const unsigned borrows = resolveLaneCarries<4>(generated, propagated, borrow);
+      const __m128i decrements = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(static_cast<int>(borrows)), lanes), lanes);
+      cells = _mm_add_epi32(cells, decrements);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(difference + index), cells);
+    }
+    return subtractCellsScalar(left + index, right + index, size - index, difference + index, borrow);
+  }
+
+  template<CellOperation Operation> inline __m128i combineVectorsSSE2(const __m128i left, const __m128i right) noexcept {
+    if constexpr (Operation == CellOperation::And) return _mm_and_si128(left, right);
+    else if constexpr (Operation == CellOperation::Or) return _mm_or_si128(left, right);
+    else return _mm_xor_si128(left, right);
+  }
+
+  template<CellOperation Operation>
+  void combineCellsSSE2(const uint32_t* left, const uint32_t* right, const size_t size, uint32_t* result) noexcept {
+    size_t index = 0;
+    for (; index + 4 <= size; index += 4) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(result + index), combineVectorsSSE2<Operation>(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + index)),
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + index))));
+    }
+    combineCellsScalar<Operation>(left + index, right + index, size - index, result + index);
+  }
+
+  void combineCellsSSE2(const uint32_t* left, const uint32_t* right, const size_t size, uint32_t* result,
+                        const CellOperation operation) {
+    switch (operation) {
+      case CellOperation::And: return combineCellsSSE2<CellOperation::And>(left, right, size, result);
+      case CellOperation::Or: return combineCellsSSE2<CellOperation::Or>(left, right, size, result);
+      case CellOperation::Xor: return combineCellsSSE2<CellOperation::Xor>(left, right, size, result);
+    }
+  }
+
+  uint32_t shiftCellsLeftSSE2(const uint32_t* cells, const size_t size, const unsigned shift, uint32_t* result) {
+    const __m128i count = _mm_cvtsi32_si128(static_cast<int>(shift));
+    const __m128i complement = _mm_cvtsi32_si128(static_cast<int>(32 - shift));
+    size_t index = 1;
+    for (; index + 4 <= size; index += 4) {
+      const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cells + index));
+      const __m128i previous = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cells + index - 1));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(result + index),
+                       _mm_or_si128(_mm_sll_epi32(current, count), _mm_srl_epi32(previous, complement)));
+    }
+    if (size > 0) result[0] = cells[0] << shift;
+    return shiftCellsLeftFrom(cells, size, shift, result, index);
+  }
+
+  uint32_t shiftCellsRightSSE2(const uint32_t* cells, const size_t size, const unsigned shift, uint32_t* result) {
+    const __m128i count = _mm_cvtsi32_si128(static_cast<int>(shift));
+    const __m128i complement = _mm_cvtsi32_si128(static_cast<int>(32 - shift));
+    size_t index = 0;
+    for (; index + 5 <= size; index += 4) {
+      const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cells + index));
+      const __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cells + index + 1));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(result + index),
+                       _mm_or_si128(_mm_srl_epi32(current, count), _mm_sll_epi32(next, complement)));
+    }
+    return shiftCellsRightFrom(cells, size, shift, result, index);
+  }
+#endif
+
+#if defined(MAMBA_AVX2_KERNELS)
+  MAMBA_TARGET_AVX2 uint32_t addCellsAVX2(const uint32_t* left, const uint32_t* right, const size_t size,
+                                          uint32_t* sum, uint32_t carry) {
+    const __m256i ones = _mm256_set1_epi32(-1), lanes = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    size_t index = 0;
+    for (; index + 8 <= size; index += 8) {
+      const __m256i addend = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(left + index));
+      __m256i cells = _mm256_add_epi32(addend, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(right + index)));
+      // The sum wrapped around where it is below the addend, that is where the larger of both is not the sum.
+      const auto generated = ~static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(
+          _mm256_cmpeq_epi32(_mm256_max_epu32(cells, addend), cells)))) & 0xFF;
+      const auto propagated = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(
+          _mm256_cmpeq_epi32(cells, ones))));
+      const unsigned carries = resolveLaneCarries<8>(generated, propagated, carry);
+      const __m256i increments = _mm256_cmpeq_epi32(
+          _mm256_and_si256(_mm256_set1_epi32(static_cast<int>(carries)), lanes), lanes);
+      cells = _mm256_sub_epi32(cells, increments);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(sum + index), cells);
+    }
+    return addCellsScalar(left + index, right + index, size - index, sum + index, carry);
+  }
+
+  MAMBA_TARGET_AVX2 uint32_t subtractCellsAVX2(const uint32_t* left, const uint32_t* right, const size_t size,
+                                               uint32_t* difference, uint32_t borrow) {
+    const __m256i lanes = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    size_t index = 0;
+    for (; index + 8 <= size; index += 8) {
+      const __m256i minuend = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(left + index));
+      const __m256i subtrahend = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(right + index));
+      __m256i cells = _mm256_sub_epi32(minuend, subtrahend);
+      const auto generated = ~static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(
+          _mm256_cmpeq_epi32(_mm256_max_epu32(minuend, subtrahend), minuend)))) & 0xFF;
+      const auto propagated = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(
+          _mm256_cmpeq_epi32(cells, _mm256_setzero_si256()))));
+      const unsigned borrows = resolveLaneCarries<8>(generated, propagated, borrow);
+      const __m256i decrements = _mm256_cmpeq_epi32(
+          _mm256_and_si256(_mm256_set1_epi32(static_cast<int>(borrows)), lanes), lanes);
+      cells = _mm256_add_epi32(cells, decrements);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(difference + index), cells);
+    }
+    return subtractCellsScalar(left + index, right + index, size - index, difference + index, borrow);
+  }
+
+  template<CellOperation Operation>
+  MAMBA_TARGET_AVX2 inline __m256i combineVectorsAVX2(const __m256i left, const __m256i right) noexcept {
+    if constexpr (Operation == CellOperation::And) return _mm256_and_si256(left, right);
+    else if constexpr (Operation == CellOperation::Or) return _mm256_or_si256(left, right);
+    else return _mm256_xor_si256(left, right);
+  }
+
+  template<CellOperation Operation> MAMBA_TARGET_AVX2
+  void combineCellsAVX2(const uint32_t* left, const uint32_t* right, const size_t size, uint32_t* result) noexcept {
+    size_t index = 0;
+    for (; index + 8 <= size; index += 8) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(result + index), combineVectorsAVX2<Operation>(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(left + index)),
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(right + index))));
+    }
+    combineCellsScalar<Operation>(left + index, right + index, size - index, result + index);
+  }
+
+  MAMBA_TARGET_AVX2 void combineCellsAVX2(const uint32_t* left, const uint32_t* right, const size_t size,
+                                          uint32_t* result, const CellOperation operation) {
+    switch (operation) {
+      case CellOperation::And: return combineCellsAVX2<CellOperation::And>(left, right, size, result);
+      case CellOperation::Or: return combineCellsAVX2<CellOperation::Or>(left, right, size, result);
+      case CellOperation::Xor: return combineCellsAVX2<CellOperation::Xor>(left, right, size, result);
+    }
+  }
+
+  MAMBA_TARGET_AVX2 uint32_t shiftCellsLeftAVX2(const uint32_t* cells, const size_t size, const unsigned shift,
+                                                uint32_t* result) {
+    const __m128i count = _mm_cvtsi32_si128(static_cast<int>(shift));
+    const __m128i complement = _mm_cvtsi32_si128(static_cast<int>(32 - shift));
+    size_t index = 1;
+    for (; index + 8 <= size; index += 8) {
+      const __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cells + index));
+      const __m256i previous = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cells + index - 1));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(result + index),
+                          _mm256_or_si256(_mm256_sll_epi32(current, count), _mm256_srl_epi32(previous, complement)));
+    }
+    if (size > 0) result[0] = cells[0] << shift;
+    return shiftCellsLeftFrom(cells, size, shift, result, index);
+  }
+
+  MAMBA_TARGET_AVX2 uint32_t shiftCellsRightAVX2(const uint32_t* cells, const size_t size, const unsigned shift,
+                                                 uint32_t* result) {
+    const __m128i count = _mm_cvtsi32_si128(static_cast<int>(shift));
+    const __m128i complement = _mm_cvtsi32_si128(static_cast<int>(32 - shift));
+    size_t index = 0;
+    for (; index + 9 <= size; index += 8) {
+      const __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cells + index));
+      const __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cells + index + 1));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(result + index),
+                          _mm256_or_si256(_mm256_srl_epi32(current, count), _mm256_sll_epi32(next, complement)));
+    }
+    return shiftCellsRightFrom(cells, size, shift, result, index);
+  }
+
+  /// Counts the set bits with the population count instruction, which comes with every AVX2 processor and
+  /// counts 64 bits at a time, faster than nibble lookups in vector registers on the integer sizes in use.
+  MAMBA_TARGET_AVX2 size_t countCellBitsPOPCNT(const uint32_t* cells, const size_t size) {
+    size_t count = 0, index = 0;
+    for (; index + 2 <= size; index += 2) {
+      uint64_t pair;
+      std::memcpy(&pair, cells + index, sizeof(pair));
+      count += static_cast<size_t>(__builtin_popcountll(pair));
+    }
+    if (index < size) count += static_cast<size_t>(__builtin_popcount(cells[index]));
+    return count;
+  }
+#endif
+
+  /// Picks the widest kernels supported by the host.
+  CellKernels selectCellKernels() noexcept {
+    [[maybe_unused]] const InstructionSet instructionSet = getSupportedInstructionSet();
+#if defined(MAMBA_AVX2_KERNELS)
+    if (instructionSet == InstructionSet::AVX2) {
+      return {addCellsAVX2, subtractCellsAVX2, combineCellsAVX2, shiftCellsLeftAVX2, shiftCellsRightAVX2,
+              countCellBitsPOPCNT};
+    }
+#endif
+#if defined(MAMBA_X86_64)
+    if (instructionSet >= InstructionSet::SSE2) {
+      return {addCellsSSE2, subtractCellsSSE2, combineCellsSSE2, shiftCellsLeftSSE2, shiftCellsRightSSE2,
+              countCellBitsScalar};
+    }
+#endif
+    return {addCellsScalar, subtractCellsScalar, combineCellsScalar, shiftCellsLeftScalar, shiftCellsRightScalar,
+            countCellBitsScalar};
+  }
+
+  const CellKernels& getCellKernels() noexcept {
+    static const CellKernels kernels = selectCellKernels();
+    return kernels;
+  }
+
+  uint32_t addCells(const uint32_t* left, const size_t leftSize, const uint32_t* right, const size_t rightSize,
+                    uint32_t* sum) noexcept {
+    uint64_t carry = rightSize < CellKernelThreshold ? addCellsScalar(left, right, rightSize, sum, 0)
+                                                     : getCellKernels().add(left, right, rightSize, sum, 0);
+    for (size_t index = rightSize; index < leftSize; ++index) {
+      carry += left[index];
+      sum[index] = static_cast<uint32_t>(carry);
+      carry >>= 32;
+    }
+    return static_cast<uint32_t>(carry);
+  }
+
+  uint32_t subtractCells(const uint32_t* left, const size_t leftSize, const uint32_t* right,
+                         const size_t rightSize, uint32_t* difference) noexcept {
+    uint32_t borrow = rightSize < CellKernelThreshold
+                      ? subtractCellsScalar(left, right, rightSize, difference, 0)
+                      : getCellKernels().subtract(left, right, rightSize, difference, 0);
+    for (size_t index = rightSize; index < leftSize; ++index) {
+      difference[index] = left[index] - borrow;
+      borrow = borrow && left[index] == 0;
+    }
+    return borrow;
+  }
+
+  uint32_t accumulateCells(uint32_t* target, const size_t targetSize, const uint32_t* addend,
+                           const size_t addendSize) noexcept {
+    uint64_t carry = 0;
+    size_t index = 0;
+    for (; index < addendSize; ++index) {
+      carry += static_cast<uint64_t>(target[index]) + addend[index];
+      target[index] = static_cast<uint32_t>(carry);
+      carry >>= 32;
+    }
+    for (; carry != 0 && index < targetSize; ++index) carry = ++target[index] == 0;
+    return static_cast<uint32_t>(carry);
+  }
+
+  uint32_t deductCells(uint32_t* target, const size_t targetSize, const uint32_t* subtrahend,
+                       const size_t subtrahendSize) noexcept {
+    uint32_t borrow = 0;
+    size_t index = 0;
+    for (; index < subtrahendSize; ++index) {
+      const uint64_t cell = static_cast<uint64_t>(target[index]) - subtrahend[index] - borrow;
+      target[index] = static_cast<uint32_t>(cell);
+      borrow = static_cast<uint32_t>(cell >> 63);
+    }
+    for (; borrow != 0 && index < targetSize; ++index) borrow = target[index]-- == 0;
+    return borrow;
+  }
+
+  uint32_t multiplyCellsByCell(const uint32_t* cells, const size_t size, const uint32_t factor,
+                               uint32_t* product) noexcept {
+    uint64_t carry = 0;
+    for (size_t index = 0; index < size; ++index) {
+      carry += static_cast<uint64_t>(cells[index]) * factor;
+      product[index] = static_cast<uint32_t>(carry);
+      carry >>= 32;
+    }
+    return static_cast<uint32_t>(carry);
+  }
+
+  /// Replaces the target with the absolute difference between itself and the other magnitude.
+  /// @param size The size of the target, which must not be shorter than the other magnitude.
+  /// @return True if the other magnitude was larger, so that the difference is negative.
+  bool subtractCellsAbsolute(uint32_t* target, const size_t size, const uint32_t* other,
+                             const size_t otherSize) noexcept {
+    if (compareCells(target, size, other, otherSize) >= 0) {
+      (void)deductCells(target, size, other, otherSize);
+      return false;
+    }
+    uint32_t borrow = 0;
+    for (size_t index = 0; index < size; ++index) {
+      const uint64_t cell = static_cast<uint64_t>(index < otherSize ? other[index] : 0) - target[index] - borrow;
+      target[index] = static_cast<uint32_t>(cell);
+      borrow = static_cast<uint32_t>(cell >> 63);
+    }
+    return true;
+  }
+
+  void negateCells(uint32_t* cells, const size_t size) noexcept {
+    // The trailing zero cells stay zero, the lowest non-zero cell is negated and the cells above it, which
+    // the carry of the increment never reaches, are inverted in a loop free of dependencies.
+    size_t index = 0;
+    while (index < size && cells[index] == 0) ++index;
+    if (index < size) {
+      cells[index] = 0 - cells[index];
+      ++index;
+    }
+    for (; index < size; ++index) cells[index] = ~cells[index];
+  }
+
+  /// Divides the value held in two's complement by 2, which must divide it exactly.
+  inline void halveCells(uint32_t* cells, const size_t size) noexcept {
+    for (size_t index = 0; index + 1 < size; ++index) cells[index] = (cells[index] >> 1) | (cells[index + 1] << 31);
+    cells[size - 1] = static_cast<uint32_t>(static_cast<int32_t>(cells[size - 1]) >> 1);
+  }
+
+  /// Divides the value held in two's complement by 3, which must divide it exactly. Every cell of the
+  /// quotient is the cell of the dividend, less the borrow from the cells below, times the inverse of 3.
+  inline void divideCellsExactlyByThree(uint32_t* cells, const size_t size) noexcept {
+    uint32_t borrow = 0;
+    for (size_t index = 0; index < size; ++index) {
+      const uint32_t cell = cells[index] - borrow;
+      const uint32_t quotient = cell * InverseOfThree;
+      borrow = (cells[index] < borrow) + static_cast<uint32_t>((static_cast<uint64_t>(quotient) * 3) >> 32);
+      cells[index] = quotient;
+    }
+  }
+
+  void multiplyCellsSchoolbook(const uint32_t* left, const size_t leftSize, const uint32_t* right,
+                               const size_t rightSize, uint32_t* product) noexcept {
+    product[leftSize] = multiplyCellsByCell(left, leftSize, right[0], product);
+    for (size_t row = 1; row < rightSize; ++row) {
+      uint64_t carry = 0;
+      const uint64_t factor = right[row];
+      for (size_t index = 0; index < leftSize; ++index) {
+        carry += left[index] * factor + product[row + index];
+        product[row + index] = static_cast<uint32_t>(carry);
+        carry >>= 32;
+      }
+      product[row + leftSize] = static_cast<uint32_t>(carry);
+    }
+  }
+
+  /// Multiplies the long operand by the short one a piece of the short one's size at a time.
+  void multiplyCellsUnbalanced(const uint32_t* left, const size_t leftSize, const uint32_t* right,
+                               const size_t rightSize, uint32_t* product, uint32_t* scratch) noexcept {
+    uint32_t* piece = scratch;
+    multiplyCells(left, rightSize, right, rightSize, product, scratch + 2 * rightSize);
+    std::fill(product + 2 * rightSize, product + leftSize + rightSize, 0);
+    for (size_t offset = rightSize; offset < leftSize; offset += rightSize) {
+      const size_t pieceSize = std::min(rightSize, leftSize - offset);
+      multiplyCells(left + offset, pieceSize, right, rightSize, piece, scratch + 2 * rightSize);
+      (void)accumulateCells(product + offset, leftSize + rightSize - offset, piece, pieceSize + rightSize);
+    }
+  }
+
+  /// Multiplies the operands split in halves at h cells with 3 half-sized products:
+  /// (a1 h + a0)(b1 h + b0) = a1 b1 h^2 + (a0 b0 + a1 b1 - (a0 - a1)(b0 - b1)) h + a0 b0.
+  void multiplyCellsKaratsuba(const uint32_t* left, const size_t leftSize, const uint32_t* right,
+                              const size_t rightSize, uint32_t* product, uint32_t* scratch) noexcept {
+    const size_t half = (leftSize + 1) / 2, size = leftSize + rightSize;
+    uint32_t* leftDifference = scratch;
+    uint32_t* rightDifference = leftDifference + half;
+    uint32_t* differenceProduct = rightDifference + half;
+    uint32_t* middle = differenceProduct + 2 * half;
+    uint32_t* next = middle + 2 * half + 1;
+
+    multiplyCells(left, half, right, half, product, next);
+    multiplyCells(left + half, leftSize - half, right + half, rightSize - half, product + 2 * half, next);
+
+    std::copy(left, left + half, leftDifference);
+    std::copy(right, right + half, rightDifference);
+    const bool isLeftNegative = subtractCellsAbsolute(leftDifference, half, left + half, leftSize - half);
+    const bool isRightNegative = subtractCellsAbsolute(rightDifference, half, right + half, rightSize - half);
+    multiplyCells(leftDifference, half, rightDifference, half, differenceProduct, next);
+
+    std::copy(product, product + 2 * half, middle);
+    middle[2 * half] = 0;
+    (void)accumulateCells(middle, 2 * half + 1, product + 2 * half, size - 2 * half);
+    if (isLeftNegative == isRightNegative) (void)deductCells(middle, 2 * half + 1, differenceProduct, 2 * half);
+    else (void)accumulateCells(middle, 2 * half + 1, differenceProduct, 2 * half);
+    (void)accumulateCells(product + half, size - half, middle, trimCells(middle, 2 * half + 1));
+  }
+
+  /// Evaluates the operand split in thirds at 1 and -1, that is a0 + a1 + a2 and a0 - a1 + a2, into
+  /// third + 1 cells each.
+  /// @return True if the value at -1 is negative, in which case its absolute value is written.
+  bool evaluateCellsAtOnes(const uint32_t* cells, const size_t size, const size_t third, uint32_t* atOne,
+                           uint32_t* atMinusOne) noexcept {
+    for (size_t index = 0; index < third; ++index) atMinusOne[index] = cells[index];
+    atMinusOne[third] = 0;
+    (void)accumulateCells(atMinusOne, third + 1, cells + 2 * third, size - 2 * third);
+    for (size_t index = 0; index <= third; ++index) atOne[index] = atMinusOne[index];
+    (void)accumulateCells(atOne, third + 1, cells + third, third);
+    return subtractCellsAbsolute(atMinusOne, third + 1, cells + third, third);
+  }
+
+  /// Evaluates the operand split in thirds at -2, that is a0 - 2 a1 + 4 a2, into third + 1 cells.
+  /// @return True if the value is negative, in which case its absolute value is written.
+  bool evaluateCellsAtMinusTwo(const uint32_t* cells, const size_t size, const size_t third, uint32_t* value,
+                               uint32_t* doubled) noexcept {
+    const size_t highSize = size - 2 * third;
+    std::fill(value, value + third + 1, 0);
+    value[highSize] = multiplyCellsByCell(cells + 2 * third, highSize, 4, value);
+    (void)accumulateCells(value, third + 1, cells, third);
+    doubled[third] = multiplyCellsByCell(cells + third, third, 2, doubled);
+    return subtractCellsAbsolute(value, third + 1, doubled, third + 1);
+  }
+
+  /// Multiplies the operands split in thirds at k cells with 5 third-sized products, evaluated at
+  /// 0, 1, -1, -2 and infinity and interpolated with the sequence of Bodrato.
+  void multiplyCellsToomCook(const uint32_t* left, const size_t leftSize, const uint32_t* right,
+                             const size_t rightSize, uint32_t* product, uint32_t* scratch) noexcept {
+    const size_t third = (leftSize + 2) / 3, size = leftSize + rightSize;
+    const size_t leftHighSize = leftSize - 2 * third, rightHighSize = rightSize - 2 * third;
+    // The products of the evaluated operands and the interpolated coefficients all fit in width cells.
+    const size_t width = 2 * third + 2;
+    uint32_t* leftAtOne = scratch;
+    uint32_t* rightAtOne = leftAtOne + third + 1;
+    uint32_t* leftAtMinusOne = rightAtOne + third + 1;
+    uint32_t* rightAtMinusOne = leftAtMinusOne + third + 1;
+    uint32_t* leftAtMinusTwo = rightAtMinusOne + third + 1;
+    uint32_t* rightAtMinusTwo = leftAtMinusTwo + third + 1;
+    uint32_t* doubled = rightAtMinusTwo + third + 1;
+    uint32_t* productAtOne = doubled + third + 1;
+    uint32_t* productAtMinusOne = productAtOne + width;
+    uint32_t* productAtMinusTwo = productAtMinusOne + width;
+    uint32_t* next = productAtMinusTwo + width;
+
+    const bool isLeftAtMinusOneNegative = evaluateCellsAtOnes(left, leftSize, third, leftAtOne, leftAtMinusOne);
+    const bool isRightAtMinusOneNegative = evaluateCellsAtOnes(right, rightSize, third, rightAtOne, rightAtMinusOne);
+    const bool isLeftAtMinusTwoNegative = evaluateCellsAtMinusTwo(left, leftSize, third, leftAtMinusTwo, doubled);
+    const bool isRightAtMinusTwoNegative = evaluateCellsAtMinusTwo(right, rightSize, third, rightAtMinusTwo, doubled);
+
+    multiplyCells(leftAtOne, third + 1, rightAtOne, third + 1, productAtOne, next);
+    multiplyCells(leftAtMinusOne, third + 1, rightAtMinusOne, third + 1, productAtMinusOne, next);
+    if (isLeftAtMinusOneNegative != isRightAtMinusOneNegative) negateCells(productAtMinusOne, width);
+    multiplyCells(leftAtMinusTwo, third + 1, rightAtMinusTwo, third + 1, productAtMinusTwo, next);
+    if (isLeftAtMinusTwoNegative != isRightAtMinusTwoNegative) negateCells(productAtMinusTwo, width);
+    // The coefficients at 0 and infinity go straight to their places in the product.
+    const uint32_t* lowest = product;
+    const uint32_t* highest = product + 4 * third;
+    const size_t highestSize = size - 4 * third;
+    multiplyCells(left, third, right, third, product, next);
+    multiplyCells(left + 2 * third, leftHighSize, right + 2 * third, rightHighSize, product + 4 * third, next);
+    std::fill(product + 2 * third, product + 4 * third, 0);
+
+    // The interpolation works modulo 2^(32 width), where the negative values are in two's complement.
+    uint32_t* coefficient3 = productAtMinusTwo;
+    uint32_t* coefficient1 = productAtOne;
+    uint32_t* coefficient2 = productAtMinusOne;
+    (void)deductCells(coefficient3, width, productAtOne, width);
+    divideCellsExactlyByThree(coefficient3, width);
+    (void)deductCells(coefficient1, width, productAtMinusOne, width);
+    halveCells(coefficient1, width);
+    (void)deductCells(coefficient2, width, lowest, 2 * third);
+    negateCells(coefficient3, width);
+    (void)accumulateCells(coefficient3, width, coefficient2, width);
+    halveCells(coefficient3, width);
+    (void)accumulateCells(coefficient3, width, highest, highestSize);
+    (void)accumulateCells(coefficient3, width, highest, highestSize);
+    (void)accumulateCells(coefficient2, width, coefficient1, width);
+    (void)deductCells(coefficient2, width, highest, highestSize);
+    (void)deductCells(coefficient1, width, coefficient3, width);
+
+    (void)accumulateCells(product + third, size - third, coefficient1, trimCells(coefficient1, width));
+    (void)accumulateCells(product + 2 * third, size - 2 * third, coefficient2, trimCells(coefficient2, width));
+    (void)accumulateCells(product + 3 * third, size - 3 * third, coefficient3, trimCells(coefficient3, width));
+  }
+
+  /// Tells if the operands, the left one being longer, are balanced enough to be split in thirds.
+  inline bool isToomCookApplicable(const size_t leftSize, const size_t rightSize) noexcept {
+    return rightSize >= ToomCookThreshold && rightSize > 2 * ((leftSize + 2) / 3);
+  }
+
+  size_t getMultiplicationScratchSize(const size_t leftSize, const size_t rightSize) noexcept {
+    const size_t longer = std::max(leftSize, rightSize), shorter = std::min(leftSize, rightSize);
+    if (shorter < KaratsubaThreshold) return 0;
+    // Every level takes at most 13 cells for every 3 cells of the longer operand and a few more, and the
+    // levels below work on operands at most half as long, so the sum of the levels stays below 7 n.
+    return 7 * longer + 16 * std::bit_width(longer) + 16;
+  }
+
+  void multiplyCells(const uint32_t* left, size_t leftSize, const uint32_t* right, size_t rightSize,
+                     uint32_t* product, uint32_t* scratch) noexcept {
+    if (leftSize < rightSize) {
+      std::swap(left, right);
+      std::swap(leftSize, rightSize);
+    }
+    if (rightSize == 0) return std::fill(product, product + leftSize, 0);
+    if (rightSize < KaratsubaThreshold || scratch == nullptr) {
+      return multiplyCellsSchoolbook(left, leftSize, right, rightSize, product);
+    }
+    // Karatsuba needs the high half of the shorter operand to be non-empty.
+    if (2 * rightSize <= leftSize + 1) return multiplyCellsUnbalanced(left, leftSize, right, rightSize, product, scratch);
+    if (isToomCookApplicable(leftSize, rightSize)) {
+      return multiplyCellsToomCook(left, leftSize, right, rightSize, product, scratch);
+    }
+    multiplyCellsKaratsuba(left, leftSize, right, rightSize, product, scratch);
+  }
+
+  /// Computes the reciprocal of the normalised divisor of Möller and Granlund, floor((2^64 - 1) / d) - 2^32,
+  /// which replaces the hardware division of 2 cells by a cell with 2 multiplications.
+  inline uint32_t getCellReciprocal(const uint32_t divisor) noexcept {
+    return static_cast<uint32_t>(UINT64_MAX / divisor - (uint64_t{1} << 32));
+  }
+
+  /// Divides the 2 cells high:low by the normalised divisor with its reciprocal, with high < divisor.
+  /// @param remainder Output set to the remainder.
+  /// @return The quotient, which fits into a cell.
+  inline uint32_t divideCellPair(const uint32_t high, const uint32_t low, const uint32_t divisor,
+                                 const uint32_t reciprocal, uint32_t& remainder) noexcept {
+    // The estimate is computed modulo 2^64, and it is at most 1 below or 1 above the true quotient.
+    const uint64_t estimate = static_cast<uint64_t>(reciprocal) * high + ((static_cast<uint64_t>(high) << 32) | low);
+    auto quotient = static_cast<uint32_t>((estimate >> 32) + 1);
+    uint32_t rest = low - quotient * divisor;
+    if (rest > static_cast<uint32_t>(estimate)) {
+      --quotient;
+      rest += divisor;
+    }
+    if (rest >= divisor) [[unlikely]] {
+      ++quotient;
+      rest -= divisor;
+    }
+    remainder = rest;
+    return quotient;
+  }
+
+  uint32_t divideCellsByCell(const uint32_t* cells, const size_t size, const uint32_t divisor,
+                             uint32_t* quotient) noexcept {
+    if (size == 0) return 0;
+    // The dividend is shifted on the fly by the bits that normalise the divisor, and the remainder back.
+    const int shift = std::countl_zero(divisor);
+    const uint32_t normalised = divisor << shift, reciprocal = getCellReciprocal(normalised);
+    uint32_t remainder = shift == 0 ? 0 : cells[size - 1] >> (32 - shift);
+    for (size_t index = size - 1; index > 0; --index) {
+      const uint32_t cell = shift == 0 ? cells[index] : (cells[index] << shift) | (cells[index - 1] >> (32 - shift));
+      quotient[index] = divideCellPair(remainder, cell, normalised, reciprocal, remainder);
+    }
+    quotient[0] = divideCellPair(remainder, cells[0] << shift, normalised, reciprocal, remainder);
+    return remainder >> shift;
+  }
+
+  /// Divides the magnitudes with Algorithm D of Knuth, in time proportional to the product of the size of
+  /// the divisor and the size of the quotient.
+  /// @param scratch The temporary cells for dividendSize + divisorSize + 1 cells.
+  void divideCellsSchoolbook(const uint32_t* dividend, const size_t dividendSize, const uint32_t* divisor,
+                             const size_t divisorSize, uint32_t* quotient, uint32_t* remainder,
+                             uint32_t* scratch) noexcept {
+    // The normalised operands, shifted so that the top bit of the divisor is set.
+    const int shift = std::countl_zero(divisor[divisorSize - 1]);
+    uint32_t* numerator = scratch;
+    uint32_t* denominator = scratch + dividendSize + 1;
+    if (shift == 0) {
+      std::copy(divisor, divisor + divisorSize, denominator);
+      std::copy(dividend, dividend + dividendSize, numerator);
+      numerator[dividendSize] = 0;
+    } else {
+      for (size_t index = divisorSize - 1; index > 0; --index) {
+        denominator[index] = (divisor[index] << shift) | (divisor[index - 1] >> (32 - shift));
+      }
+      denominator[0] = divisor[0] << shift;
+      numerator[dividendSize] = dividend[dividendSize - 1] >> (32 - shift);
+      for (size_t index = dividendSize - 1; index > 0; --index) {
+        numerator[index] = (dividend[index] << shift) | (dividend[index - 1] >> (32 - shift));
+      }
+      numerator[0] = dividend[0] << shift;
+    }
+
+    const uint32_t top = denominator[divisorSize - 1], reciprocal = getCellReciprocal(top);
+    const uint64_t second = denominator[divisorSize - 2];
+    for (size_t position = dividendSize - divisorSize + 1; position-- > 0;) {
+      // The estimate from the 2 top cells of the remainder is corrected with the second cell of the divisor.
+      // The top cell of the remainder never exceeds the one of the divisor, and when they are equal the
+      // estimate is the largest cell.
+      const uint32_t high = numerator[position + divisorSize], low = numerator[position + divisorSize - 1];
+      uint64_t estimate = UINT32_MAX, rest = static_cast<uint64_t>(low) + top;
+      if (high < top) {
+        uint32_t cellRest;
+        estimate = divideCellPair(high, low, top, reciprocal, cellRest);
+        rest = cellRest;
+      }
+      while (rest <= UINT32_MAX && estimate * second > ((rest << 32) | numerator[position + divisorSize - 2])) {
+        --estimate;
+        rest += top;
+      }
+
+      int64_t borrow = 0;
+      for (size_t index = 0; index < divisorSize; ++index) {
+        const uint64_t product = estimate * denominator[index];
+        const int64_t cell = static_cast<int64_t>(numerator[position + index]) - borrow -
+                             static_cast<int64_t>(product & UINT32_MAX);
+        numerator[position + index] = static_cast<uint32_t>(cell);
+        borrow = static_cast<int64_t>(product >> 32) - (cell >> 32);
+      }
+      const int64_t last = static_cast<int64_t>(numerator[position + divisorSize]) - borrow;
+      numerator[position + divisorSize] = static_cast<uint32_t>(last);
+      // The estimate was one too large, which happens rarely, so the divisor is added back once.
+      if (last < 0) {
+        --estimate;
+        numerator[position + divisorSize] += accumulateCells(numerator + position, divisorSize, denominator, divisorSize);
+      }
+      quotient[position] = static_cast<uint32_t>(estimate);
+    }
+
+    for (size_t index = 0; index < divisorSize; ++index) {
+      remainder[index] = shift == 0 ? numerator[index] : (numerator[index] >> shift) |
+                                                         (numerator[index + 1] << (32 - shift));
+    }
+  }
+
+  /// Tells how many cells of scratch divideCellsTwoByOne() needs for a divisor of the given size.
+  size_t getRecursiveDivisionScratchSize(const size_t size) noexcept {
+    if (size % 2 != 0 || size <= BurnikelZieglerThreshold) return 4 * size + 2;
+    // The level keeps the joined dividend of its second half and the remainder of its first half, and the
+    // halves keep their remainder and product while the level below or the multiplication runs.
+    const size_t half = size / 2;
+    return 5 * half + 4 * half + 1 + std::max(getRecursiveDivisionScratchSize(half),
+                                              getMultiplicationScratchSize(half, half));
+  }
+
+  void divideCellsTwoByOne(const uint32_t* dividend, const uint32_t* divisor, size_t size, uint32_t* quotient,
+                           uint32_t* remainder, uint32_t* scratch) noexcept;
+
+  /// Divides 3 half-sized blocks of the dividend by the normalised divisor of 2 half-sized blocks, with the
+  /// top 2 blocks of the dividend below the divisor, so that the quotient fits into a block.
+  /// @param quotient The destination for half cells.
+  /// @param remainder The destination for 2 half cells.
+  void divideCellsThreeByTwo(const uint32_t* dividend, const uint32_t* divisor, const size_t half,
+                             uint32_t* quotient, uint32_t* remainder, uint32_t* scratch) noexcept {
+    // The remainder runs one cell wider, so that it goes negative in two's complement before its correction.
+    uint32_t* estimate = scratch;
+    uint32_t* product = estimate + 2 * half + 1;
+    uint32_t* next = product + 2 * half;
+    const uint32_t* divisorHigh = divisor + half;
+    std::copy(dividend, dividend + half, estimate);
+    if (compareCells(dividend + 2 * half, half, divisorHigh, half) < 0) {
+      divideCellsTwoByOne(dividend + half, divisorHigh, half, quotient, estimate + half, next);
+      estimate[2 * half] = 0;
+    } else {
+      // The top blocks of the dividend and the divisor are equal, so the quotient is estimated to the largest
+      // block, and the remainder of the top blocks is the middle block plus the top block of the divisor.
+      std::fill(quotient, quotient + half, UINT32_MAX);
+      estimate[2 * half] = addCells(dividend + half, half, divisorHigh, half, estimate + half);
+    }
+    multiplyCells(quotient, half, divisor, half, product, next);
+    bool isNegative = deductCells(estimate, 2 * half + 1, product, 2 * half) != 0;
+    // The estimated quotient is at most 2 above the true one.
+    const uint32_t one = 1;
+    while (isNegative) {
+      (void)deductCells(quotient, half, &one, 1);
+      isNegative = accumulateCells(estimate, 2 * half + 1, divisor, 2 * half) == 0;
+    }
+    std::copy(estimate, estimate + 2 * half, remainder);
+  }
+
+  /// Divides the dividend of 2 blocks by the normalised divisor of a block with Burnikel-Ziegler recursion,
+  /// with the top block of the dividend below the divisor, so that the quotient fits into a block.
+  /// @param quotient The destination for size cells.
+  /// @param remainder The destination for size cells.
+  /// @param scratch The temporary cells sized by getRecursiveDivisionScratchSize().
+  void divideCellsTwoByOne(const uint32_t* dividend, const uint32_t* divisor, const size_t size, uint32_t* quotient,
+                           uint32_t* remainder, uint32_t* scratch) noexcept {
+    // The leading zero cells of the dividend are skipped, which leaves a short quotient to Algorithm D when
+    // the top block of the dividend is nearly empty, as the first one of a division often is.
+    const size_t dividendSize = std::max(size, trimCells(dividend, 2 * size));
+    if (size % 2 != 0 || size <= BurnikelZieglerThreshold || dividendSize - size < BurnikelZieglerThreshold) {
+      // The top cell of the quotient of Algorithm D is 0 when the dividend fills both blocks.
+      const size_t quotientSize = std::min(dividendSize - size + 1, size);
+      uint32_t* wideQuotient = scratch;
+      divideCellsSchoolbook(dividend, dividendSize, divisor, size, wideQuotient, remainder, wideQuotient + size + 1);
+      std::copy(wideQuotient, wideQuotient + quotientSize, quotient);
+      std::fill(quotient + quotientSize, quotient + size, 0);
+      return;
+    }
+    const size_t half = size / 2;
+    uint32_t* joined = scratch;
+    uint32_t* rest = joined + 3 * half;
+    uint32_t* next = rest + size;
+    divideCellsThreeByTwo(dividend + half, divisor, half, quotient + half, rest, next);
+    std::copy(dividend, dividend + half, joined);
+    std::copy(rest, rest + size, joined + half);
+    divideCellsThreeByTwo(joined, divisor, half, quotient, remainder, next);
+  }
+
+  /// Chooses the size of the blocks of Burnikel-Ziegler division for the divisor of the given size, the
+  /// smallest one of the form j * 2^k, with j below the threshold, that holds the divisor, so that the
+  /// blocks can be halved k times before they reach Algorithm D.
+  size_t getDivisionBlockSize(const size_t divisorSize) noexcept {
+    size_t levels = 0;
+    while (BurnikelZieglerThreshold << levels < divisorSize) ++levels;
+    return ((divisorSize + (size_t{1} << levels) - 1) >> levels) << levels;
+  }
+
+  /// Tells if the operands are large enough for the recursive division to outrun Algorithm D.
+  inline bool isBurnikelZieglerApplicable(const size_t dividendSize, const size_t divisorSize) noexcept {
+    return divisorSize >= BurnikelZieglerThreshold && dividendSize - divisorSize >= BurnikelZieglerThreshold;
+  }
+
+  size_t getDivisionScratchSize(const size_t dividendSize, const size_t divisorSize) noexcept {
+    if (!isBurnikelZieglerApplicable(dividendSize, divisorSize)) return dividendSize + divisorSize + 1;
+    // The normalised divisor, the blocks of the normalised dividend, the 2 blocks being divided, the quotient
+    // and the remainder of every step.
+    const size_t size = getDivisionBlockSize(divisorSize);
+    const size_t blocks = (dividendSize + size - divisorSize + 1) / size + 1;
+    return size + blocks * size + 2 * size + (blocks - 1) * size + size + getRecursiveDivisionScratchSize(size);
+  }
+
+  void divideCells(const uint32_t* dividend, const size_t dividendSize, const uint32_t* divisor,
+                   const size_t divisorSize, uint32_t* quotient, uint32_t* remainder, uint32_t* scratch) noexcept {
+    if (divisorSize == 1) {
+      remainder[0] = divideCellsByCell(dividend, dividendSize, divisor[0], quotient);
+      return;
+    }
+    if (!isBurnikelZieglerApplicable(dividendSize, divisorSize)) {
+      return divideCellsSchoolbook(dividend, dividendSize, divisor, divisorSize, quotient, remainder, scratch);
+    }
+    // Both operands are shifted by whole cells and bits until the divisor fills a block with its top bit set.
+    const size_t size = getDivisionBlockSize(divisorSize), padding = size - divisorSize;
+    const auto shift = static_cast<unsigned>(std::countl_zero(divisor[divisorSize - 1]));
+    const size_t numeratorSize = dividendSize + padding + 1;
+    // The scratch has room for one more block than the dividend fills, which keeps the top block below the
+    // divisor, but the block is skipped when the dividend leaves room at its top anyway.
+    const size_t capacity = numeratorSize / size + 1;
+    uint32_t* denominator = scratch;
+    uint32_t* numerator = denominator + size;
+    uint32_t* current = numerator + capacity * size;
+    uint32_t* wideQuotient = current + 2 * size;
+    uint32_t* rest = wideQuotient + (capacity - 1) * size;
+    uint32_t* next = rest + size;
+    std::fill(denominator, denominator + padding, 0);
+    (void)shiftCellsLeft(divisor, divisorSize, shift, denominator + padding);
+    std::fill(numerator, numerator + padding, 0);
+    numerator[numeratorSize - 1] = shiftCellsLeft(dividend, dividendSize, shift, numerator + padding);
+    std::fill(numerator + numeratorSize, numerator + capacity * size, 0);
+    size_t blocks = std::max<size_t>((trimCells(numerator, numeratorSize) + size - 1) / size, 2);
+    if (compareCells(numerator + (blocks - 1) * size, size, denominator, size) >= 0) ++blocks;
+
+    // Every step divides the remainder of the previous one joined with the next block of the dividend.
+    std::copy(numerator + (blocks - 2) * size, numerator + blocks * size, current);
+    for (size_t block = blocks - 1; block-- > 0;) {
+      divideCellsTwoByOne(current, denominator, size, wideQuotient + block * size, rest, next);
+      if (block > 0) {
+        std::copy(numerator + (block - 1) * size, numerator + block * size, current);
+        std::copy(rest, rest + size, current + size);
+      }
+    }
+    // The quotient fits into the blocks, which may be fewer than its destination holds.
+    const size_t quotientSize = dividendSize - divisorSize + 1, written = std::min(quotientSize, (blocks - 1) * size);
+    std::copy(wideQuotient, wideQuotient + written, quotient);
+    std::fill(quotient + written, quotient + quotientSize, 0);
+    (void)shiftCellsRight(rest + padding, divisorSize, shift, remainder);
+  }
+
+  void combineCells(const uint32_t* left, const uint32_t* right, const size_t size, uint32_t* result,
+                    const CellOperation operation) noexcept {
+    if (size < CellKernelThreshold) return combineCellsScalar(left, right, size, result, operation);
+    getCellKernels().combine(left, right, size, result, operation);
+  }
+
+  uint32_t shiftCellsLeft(const uint32_t* cells, const size_t size, const unsigned shift, uint32_t* result) noexcept {
+    if (shift == 0) {
+      std::copy(cells, cells + size, result);
+      return 0;
+    }
+    if (size < CellKernelThreshold) return shiftCellsLeftScalar(cells, size, shift, result);
+    return getCellKernels().shiftLeft(cells, size, shift, result);
+  }
+
+  uint32_t shiftCellsRight(const uint32_t* cells, const size_t size, const unsigned shift, uint32_t* result) noexcept {
+    if (shift == 0) {
+      std::copy(cells, cells + size, result);
+      return 0;
+    }
+    if (size < CellKernelThreshold) return shiftCellsRightScalar(cells, size, shift, result);
+    return getCellKernels().shiftRight(cells, size, shift, result);
+  }
+
+  size_t countCellBits(const uint32_t* cells, const size_t size) noexcept {
+    if (size < CellKernelThreshold) return countCellBitsScalar(cells, size);
+    return getCellKernels().count(cells, size);
+  }
+}
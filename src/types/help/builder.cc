@@ -0,0 +1,130 @@
+#include "types/help/builder.hh"
+
+#include <algorithm>
+#include <cstring>
+
+#include "context.hh"
+#include "types/help/floating.hh"
+#include "unicode/utf8.hh"
+namespace mamba {
+  /// The smallest buffer the builder allocates, so that short results do not reallocate on every append.
+  constexpr size_t SmallestBuilderCapacity = 32;
+
+  StringBuilder::StringBuilder(const size_t sizeInBytes) noexcept {
+    (void)reserve(sizeInBytes);
+  }
+
+  StringBuilder& StringBuilder::reserve(const size_t sizeInBytes) noexcept {
+    if (isExhausted || sizeInBytes < text.stream.capacity) return *this;
+    const GarbageCollected<char> previous = text.stream;
+    (void)text.reserve(sizeInBytes);
+    if (text.stream.destination == previous.destination) isExhausted = true;
+    // The builder is the only owner of its buffer, so the abandoned one is garbage right away.
+    else if (previous.destination != nullptr) mark(previous);
+    return *this;
+  }
+
+  StringBuilder& StringBuilder::append(const String& other) noexcept {
+    char* destination = prepare(other.sizeInBytes);
+    if (destination == nullptr || other.sizeInBytes == 0) return *this;
+    (void)std::memcpy(destination, other.data(), other.sizeInBytes);
+    commit(other.sizeInBytes, other.graphemes, other.isOnlyAscii);
+    return *this;
+  }
+
+  StringBuilder& StringBuilder::append(const String& other, const size_t start, const size_t end) noexcept {
+    const size_t last = std::min(end, other.graphemes);
+    if (start >= last) return *this;
+    const size_t beginning = other.getGrapheme(start), ending = other.getGrapheme(last);
+    char* destination = prepare(ending - beginning);
+    if (destination == nullptr) return *this;
+    (void)std::memcpy(destination, other.data() + beginning, ending - beginning);
+    commit(ending - beginning, last - start, other.isOnlyAscii || ending - beginning == last - start);
+    return *this;
+  }
+
+  StringBuilder& StringBuilder::appendUTF8(const char* data, const size_t sizeInBytes) noexcept {
+    char* destination = prepare(sizeInBytes);
+    if (destination == nullptr || sizeInBytes == 0) return *this;
+    (void)std::memcpy(destination, data, sizeInBytes);
+    const size_t graphemes = countUTF8Graphemes(data, sizeInBytes);
+    commit(sizeInBytes, graphemes, graphemes == sizeInBytes);
+    return *this;
+  }
+
+  StringBuilder& StringBuilder::appendCharacter(const uint32_t codePoint, const size_t count) noexcept {
+    if (codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+      raise(Signal::ValueError, ExceptionReason::CodePointOutOfRange);
+      return *this;
+    }
+    char sequence[4];
+    const int size = encodeUTF8(codePoint, sequence);
+    // The huge counts would wrap the size of the repetition around into a small reservation.
+    if (count > SIZE_MAX / size) {
+      raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+      isExhausted = true;
+      return *this;
+    }
+    char* destination = prepare(count * size);
+    if (destination == nullptr || count == 0) return *this;
+    if (size == 1) (void)std::memset(destination, sequence[0], count);
+    else for (size_t index = 0; index < count; ++index) (void)std::memcpy(destination + index * size, sequence, size);
+    commit(count * size, count, size == 1);
+    return *this;
+  }
+
+  StringBuilder& StringBuilder::appendInteger(const int64_t value) noexcept {
+    char digits[20];
+    char* first = digits + sizeof(digits);
+    // The magnitude is taken in unsigned arithmetic, which also covers the smallest 64-bit integer.
+    uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    do *--first = static_cast<char>('0' + magnitude % 10);
+    while ((magnitude /= 10) > 0);
+    const size_t size = digits + sizeof(digits) - first + (value < 0);
+    char* destination = prepare(size);
+    if (destination == nullptr) return *this;
+    if (value < 0) *destination++ = '-';
+    (void)std::memcpy(destination, first, digits + sizeof(digits) - first);
+    commit(size, size, true);
+    return *this;
+  }
+
+  StringBuilder& StringBuilder::appendFloat(const double value) noexcept {
+    char* destination = prepare(MaximalFloatReprSize);
+    if (destination == nullptr) return *this;
+    const size_t size = formatShortestFloat(value, destination);
+    commit(size, size, true);
+    return *this;
+  }
+
+  size_t StringBuilder::len() const noexcept {
+    return text.graphemes;
+  }
+
+  String StringBuilder::build() noexcept {
+    String result;
+    if (!isExhausted && text.sizeInBytes > 0) {
+      text.stream.destination[text.sizeInBytes] = '\0';
+      result = {text.stream, text.sizeInBytes, text.graphemes, text.isOnlyAscii};
+    }
+    text = String();
+    isExhausted = false;
+    return result;
+  }
+
+  char* StringBuilder::prepare(const size_t moreBytes) noexcept {
+    if (isExhausted) return nullptr;
+    const size_t required = text.sizeInBytes + moreBytes;
+    if (required >= text.stream.capacity) {
+      (void)reserve(std::max({required, text.stream.capacity * 2, SmallestBuilderCapacity}));
+      if (isExhausted) return nullptr;
+    }
+    return text.stream.destination + text.sizeInBytes;
+  }
+
+  void StringBuilder::commit(const size_t sizeInBytes, const size_t graphemes, const bool isAscii) noexcept {
+    text.sizeInBytes += sizeInBytes;
+    text.graphemes += graphemes;
+    text.isOnlyAscii = text.isOnlyAscii && isAscii;
+  }
+}
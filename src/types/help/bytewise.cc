@@ -0,0 +1,114 @@
+#include "bytewise.hh"
+
+#include <algorithm>
+
+#include "vectorisation.hh"
+
+namespace mamba {
+  /// The lowercase hexadecimal digits, by their values.
+  constexpr char HexadecimalDigits[] = "0123456789abcdef";
+
+  /// The number of blocks whose matches the 8-bit counters of the lanes hold before they overflow.
+  constexpr size_t BlocksPerCounterFlush = 255;
+
+  typedef size_t (*ByteCounter)(const std::byte* data, size_t size, std::byte value);
+  typedef void (*HexadecimalEncoder)(const std::byte* data, size_t size, char* digits);
+
+  size_t countByteScalar(const std::byte* data, const size_t size, const std::byte value) {
+    size_t count = 0;
+    for (size_t index = 0; index < size; ++index) count += data[index] == value ? 1 : 0;
+    return count;
+  }
+
+  void encodeHexadecimalScalar(const std::byte* data, const size_t size, char* digits) {
+    for (size_t index = 0; index < size; ++index) {
+      const auto byte = std::to_integer<uint8_t>(data[index]);
+      digits[2 * index] = HexadecimalDigits[byte >> 4];
+      digits[2 * index + 1] = HexadecimalDigits[byte & 0x0F];
+    }
+  }
+
+#if defined(MAMBA_X86_64)
+  size_t countByteSSE2(const std::byte* data, const size_t size, const std::byte value) {
+    const __m128i needle = _mm_set1_epi8(static_cast<char>(value));
+    size_t count = 0, offset = 0;
+    while (offset + 16 <= size) {
+      __m128i counters = _mm_setzero_si128();
+      const size_t blocks = std::min((size - offset) / 16, BlocksPerCounterFlush);
+      for (size_t block = 0; block < blocks; ++block, offset += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+        counters = _mm_sub_epi8(counters, _mm_cmpeq_epi8(bytes, needle));
+      }
+      const __m128i sums = _mm_sad_epu8(counters, _mm_setzero_si128());
+      count += static_cast<size_t>(_mm_cvtsi128_si64(sums) + _mm_extract_epi16(sums, 4));
+    }
+    return count + countByteScalar(data + offset, size - offset, value);
+  }
+
+  void encodeHexadecimalSSE2(const std::byte* data, const size_t size, char* digits) {
+    const __m128i nibbleMask = _mm_set1_epi8(0x0F), nine = _mm_set1_epi8(9);
+    // The digits of the values above 9 are the letters, which follow the digit characters by 39 positions.
+    const __m128i zero = _mm_set1_epi8('0'), letterOffset = _mm_set1_epi8('a' - '0' - 10);
+    size_t offset = 0;
+    for (; offset + 16 <= size; offset += 16) {
+      const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+      const __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibbleMask);
+      const __m128i low = _mm_and_si128(bytes, nibbleMask);
+      const __m128i highDigits = _mm_add_epi8(_mm_add_epi8(high, zero),
+                                              _mm_and_si128(_mm_cmpgt_epi8(high, nine), letterOffset));
+      const __m128i lowDigits = _mm_add_epi8(_mm_add_epi8(low, zero),
+                                             _mm_and_si128(_mm_cmpgt_epi8(low, nine), letterOffset));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(digits + 2 * offset), _mm_unpacklo_epi8(highDigits, lowDigits));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(digits + 2 * offset + 16),
+                       _mm_unpackhi_epi8(highDigits, lowDigits));
+    }
+    encodeHexadecimalScalar(data + offset, size - offset, digits + 2 * offset);
+  }
+#endif
+
+#if defined(MAMBA_AVX2_KERNELS)
+  MAMBA_TARGET_AVX2 size_t countByteAVX2(const std::byte* data, const size_t size, const std::byte value) {
+    const __m256i needle = _mm256_set1_epi8(static_cast<char>(value));
+    size_t count = 0, offset = 0;
+    while (offset + 32 <= size) {
+      __m256i counters = _mm256_setzero_si256();
+      const size_t blocks = std::min((size - offset) / 32, BlocksPerCounterFlush);
+      for (size_t block = 0; block < blocks; ++block, offset += 32) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset));
+        counters = _mm256_sub_epi8(counters, _mm256_cmpeq_epi8(bytes, needle));
+      }
+      const __m256i sums = _mm256_sad_epu8(counters, _mm256_setzero_si256());
+      count += static_cast<size_t>(_mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1) +
+                                   _mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3));
+    }
+    return count + countByteSSE2(data + offset, size - offset, value);
+  }
+#endif
+
+  /// Picks the widest byte counter supported by the host. Resolved once on the first count.
+  ByteCounter selectByteCounter() noexcept {
+    [[maybe_unused]] const InstructionSet instructionSet = getSupportedInstructionSet();
+#if defined(MAMBA_AVX2_KERNELS)
+    if (instructionSet == InstructionSet::AVX2) return countByteAVX2;
+#endif
+#if defined(MAMBA_X86_64)
+    if (instructionSet >= InstructionSet::SSE2) return countByteSSE2;
+#endif
+    return countByteScalar;
+  }
+
+  size_t countByte(const std::byte* data, const size_t size, const std::byte value) noexcept {
+    static const ByteCounter counter = selectByteCounter();
+    return counter(data, size, value);
+  }
+
+  void encodeHexadecimal(const std::byte* data, const size_t size, char* digits) noexcept {
+    // SSE2 is part of the x86-64 baseline, and the digits are written twice as fast as the bytes are read,
+    // so the wider registers of AVX2 would mostly wait for the stores.
+#if defined(MAMBA_X86_64)
+    encodeHexadecimalSSE2(data, size, digits);
+#else
+    encodeHexadecimalScalar(data, size, digits);
+#endif
+  }
+}
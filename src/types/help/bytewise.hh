@@ -0,0 +1,40 @@
+/*+================================================================================================
+  File:        bytewise.hh
+
+  Summary:     Internal SIMD kernels over the raw buffers of bytes, bytearrays and memoryviews,
+               behind bytes.count() of a single byte and bytes.hex().
+
+  Notes:       Counting a byte compares 16 (SSE2) or 32 (AVX2) bytes of the buffer at once and
+               subtracts the all-ones masks of the matches from 8-bit counters in the lanes, so
+               that the loop does no horizontal work; the counters are summed with the sum of
+               absolute differences every 255 blocks, before they can overflow. Converting bytes
+               into hexadecimal digits splits 16 bytes into their high and low nibbles, turns the
+               nibbles into their digits with a comparison instead of a table lookup, which SSE2
+               lacks, and interleaves the digits of each byte. The kernels are selected once, by
+               the instruction set of the host, like the filters of search.hh.
+
+  Classes:     None
+
+  Functions:   countByte(), encodeHexadecimal()
+
+  Available under Apache Licence v2. Mamba Authors (2024)
+=================================================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mamba {
+  /// Counts the occurrences of the byte in the buffer, as in bytes.count(value) of a single byte.
+  /// @param data The pointer to the first byte of the buffer.
+  /// @param size The number of bytes in the buffer.
+  /// @param value The byte to count.
+  /// @return The number of the bytes of the buffer equal to the value.
+  size_t countByte(const std::byte* data, size_t size, std::byte value) noexcept;
+
+  /// Writes the 2 lowercase hexadecimal digits of every byte of the buffer, as in bytes.hex().
+  /// @param data The pointer to the first byte of the buffer.
+  /// @param size The number of bytes in the buffer.
+  /// @param digits The destination of the 2 * size digits, which must not overlap the buffer.
+  void encodeHexadecimal(const std::byte* data, size_t size, char* digits) noexcept;
+}
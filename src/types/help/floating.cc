@@ -0,0 +1,456 @@
+#include "types/help/floating.hh"
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <utility>
+
+#include "context.hh"
+#include "givers/memory.hh"
+#include "powers.hh"
+namespace mamba {
+  /// The product of 2 words.
+  __extension__ typedef unsigned __int128 DoubleWord;
+
+  constexpr uint64_t SignificandMask = (uint64_t{1} << 52) - 1, HiddenBit = uint64_t{1} << 52;
+  constexpr uint64_t InfinityBits = uint64_t{0x7FF} << 52, SignBit = uint64_t{1} << 63;
+
+  /// The bias of the exponent of the doubles, counting the significand as an integer.
+  constexpr int32_t ExponentBias = 1075;
+
+  /// The largest number of significant digits kept in the significand of a literal.
+  constexpr size_t MaximalSignificandDigits = 19;
+
+  /// The largest exponent of the powers of 5 that fit into 128 bits, and so are stored exactly.
+  constexpr int32_t LargestExactPowerOfFive = 55;
+
+  /// The decimal digits of the numbers from 0 to 99, 2 characters each.
+  constexpr std::array<char, 200> DigitPairs = [] {
+    std::array<char, 200> pairs{};
+    for (size_t number = 0; number < 100; ++number) {
+      pairs[2 * number] = static_cast<char>('0' + number / 10);
+      pairs[2 * number + 1] = static_cast<char>('0' + number % 10);
+    }
+    return pairs;
+  }();
+
+  /// The powers of ten that doubles hold exactly.
+  constexpr double ExactPowersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                         1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+  /// The value significand * 10^exponent.
+  struct DecimalFloat {
+    uint64_t significand;
+    int32_t exponent;
+  };
+
+  inline int32_t floorLog2Pow10(const int32_t exponent) noexcept {
+    return (exponent * 1741647) >> 19;
+  }
+
+  inline int32_t floorLog10Pow2(const int32_t exponent) noexcept {
+    return (exponent * 1262611) >> 22;
+  }
+
+  inline int32_t floorLog10ThreeQuartersPow2(const int32_t exponent) noexcept {
+    return (exponent * 1262611 - 524031) >> 22;
+  }
+
+  /// Multiplies the value by the 128-bit power and keeps the top 64 bits of the 192-bit product, with
+  /// the lowest bit set if any of the bits dropped is, so that a truncated tie cannot pass for an exact one.
+  inline uint64_t multiplyRoundingToOdd(const PowerOfFive& power, const uint64_t value) noexcept {
+    const DoubleWord low = static_cast<DoubleWord>(power.low) * value;
+    const DoubleWord high = static_cast<DoubleWord>(power.high) * value + static_cast<uint64_t>(low >> 64);
+    return static_cast<uint64_t>(high >> 64) | (static_cast<uint64_t>(high) > 1);
+  }
+
+  /// Finds the shortest decimal between the midpoints to the neighbours of the positive finite double,
+  /// the one closest to the double if there are several.
+  /// @return The decimal, whose significand may still end with zeros.
+  inline DecimalFloat getShortestDecimal(const uint64_t bits) noexcept {
+    const uint64_t fraction = bits & SignificandMask;
+    const auto biasedExponent = static_cast<int32_t>(bits >> 52);
+    uint64_t significand;
+    int32_t exponent;
+    if (biasedExponent != 0) {
+      significand = HiddenBit | fraction;
+      exponent = biasedExponent - ExponentBias;
+      // The integers are printed as they are.
+      if (exponent <= 0 && exponent > -53 && (significand & ((uint64_t{1} << -exponent) - 1)) == 0) {
+        return {significand >> -exponent, 0};
+      }
+    } else {
+      significand = fraction;
+      exponent = 1 - ExponentBias;
+    }
+
+    // The neighbours are equally far away except above the powers of 2, where the lower one is closer.
+    const bool isEven = significand % 2 == 0;
+    const bool isLowerCloser = fraction == 0 && biasedExponent > 1;
+    const uint64_t lowerBound = 4 * significand - 2 + isLowerCloser, centre = 4 * significand;
+    const uint64_t upperBound = 4 * significand + 2;
+    const int32_t scale = isLowerCloser ? floorLog10ThreeQuartersPow2(exponent) : floorLog10Pow2(exponent);
+    const int32_t shift = exponent + floorLog2Pow10(-scale) + 1;
+    // Schubfach needs the power rounded up, which only 5^0 to 5^55 hold exactly.
+    PowerOfFive power = getPowerOfFive(-scale);
+    if (-scale < 0 || -scale > LargestExactPowerOfFive) power.high += ++power.low == 0;
+    const uint64_t scaledLower = multiplyRoundingToOdd(power, lowerBound << shift);
+    const uint64_t scaledCentre = multiplyRoundingToOdd(power, centre << shift);
+    const uint64_t scaledUpper = multiplyRoundingToOdd(power, upperBound << shift);
+    const uint64_t lower = scaledLower + !isEven, upper = scaledUpper - !isEven;
+
+    // Either a decimal with one digit less falls between the bounds, or the shortest one has as many
+    // digits as the scaled value.
+    const uint64_t truncated = scaledCentre / 4;
+    if (truncated >= 10) {
+      const uint64_t shorter = truncated / 10;
+      const bool isBelowInside = lower <= 40 * shorter, isAboveInside = 40 * shorter + 40 <= upper;
+      if (isBelowInside != isAboveInside) return {shorter + isAboveInside, scale + 1};
+    }
+    const bool isBelowInside = lower <= 4 * truncated, isAboveInside = 4 * truncated + 4 <= upper;
+    if (isBelowInside != isAboveInside) return {truncated + isAboveInside, scale};
+    const uint64_t middle = 4 * truncated + 2;
+    const bool isRoundedUp = scaledCentre > middle || (scaledCentre == middle && truncated % 2 != 0);
+    return {truncated + isRoundedUp, scale};
+  }
+
+  /// Tells how many decimal digits the positive number has, from the number of its bits.
+  inline size_t countDigits(const uint64_t number) noexcept {
+    constexpr uint64_t PowersOfTen[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+                                        1000000000, 10000000000, 100000000000, 1000000000000, 10000000000000,
+                                        100000000000000, 1000000000000000, 10000000000000000,
+                                        100000000000000000, 1000000000000000000, 10000000000000000000U};
+    const size_t estimate = (std::bit_width(number) * 1233) >> 12;
+    return estimate + 1 - (number < PowersOfTen[estimate]);
+  }
+
+  /// Writes the 8 decimal digits of the number below 10^8 as 4 pairs, which are computed independently.
+  inline void writeEightDigits(const uint32_t number, char* destination) noexcept {
+    const uint32_t high = number / 10000, low = number % 10000;
+    (void)std::memcpy(destination, &DigitPairs[2 * (high / 100)], 2);
+    (void)std::memcpy(destination + 2, &DigitPairs[2 * (high % 100)], 2);
+    (void)std::memcpy(destination + 4, &DigitPairs[2 * (low / 100)], 2);
+    (void)std::memcpy(destination + 6, &DigitPairs[2 * (low % 100)], 2);
+  }
+
+  /// Writes the last count decimal digits of the number, 8 at a time from the right and then in pairs.
+  inline void writeDigits(uint64_t number, char* destination, size_t count) noexcept {
+    for (; count > 8; number /= 100000000) {
+      count -= 8;
+      writeEightDigits(static_cast<uint32_t>(number % 100000000), destination + count);
+    }
+    auto rest = static_cast<uint32_t>(number);
+    for (; count >= 2; count -= 2, rest /= 100) (void)std::memcpy(destination + count - 2, &DigitPairs[2 * (rest % 100)], 2);
+    if (count == 1) destination[0] = static_cast<char>('0' + rest);
+  }
+
+  size_t formatShortestFloat(const double value, char* destination) noexcept {
+    const auto bits = std::bit_cast<uint64_t>(value);
+    const uint64_t magnitude = bits & ~SignBit;
+    // Like CPython, the sign of a NaN is never shown.
+    if (magnitude > InfinityBits) {
+      (void)std::memcpy(destination, "nan", 3);
+      return 3;
+    }
+    char* position = destination;
+    if ((bits & SignBit) != 0) *position++ = '-';
+    if (magnitude >= InfinityBits || magnitude == 0) {
+      (void)std::memcpy(position, magnitude == 0 ? "0.0" : "inf", 3);
+      return position + 3 - destination;
+    }
+
+    DecimalFloat decimal = getShortestDecimal(magnitude);
+    // The shorter candidate of Schubfach keeps the length of the longer one, so short decimals come out
+    // with up to 16 trailing zeros, which are stripped in halving steps.
+    if (decimal.significand % 10 == 0) {
+      while (decimal.significand % 100000000 == 0) {
+        decimal.significand /= 100000000;
+        decimal.exponent += 8;
+      }
+      for (const auto& [divisor, digits] : {std::pair<uint64_t, int32_t>{10000, 4}, {100, 2}, {10, 1}}) {
+        if (decimal.significand % divisor == 0) {
+          decimal.significand /= divisor;
+          decimal.exponent += digits;
+        }
+      }
+    }
+    const size_t count = countDigits(decimal.significand);
+    // The decimal point follows the given number of digits, as in the value 0.digits * 10^point.
+    const int32_t point = decimal.exponent + static_cast<int32_t>(count);
+    if (point <= -4 || point > 16) {
+      // The digits are written one place to the right, and the first one is moved back over the point.
+      writeDigits(decimal.significand, position + 1, count);
+      position[0] = position[1];
+      position[1] = '.';
+      position += count == 1 ? 1 : count + 1;
+      int32_t exponent = point - 1;
+      *position++ = 'e';
+      *position++ = exponent < 0 ? '-' : '+';
+      if (exponent < 0) exponent = -exponent;
+      if (exponent >= 100) {
+        *position++ = static_cast<char>('0' + exponent / 100);
+        exponent %= 100;
+      }
+      (void)std::memcpy(position, &DigitPairs[2 * exponent], 2);
+      position += 2;
+    } else if (point <= 0) {
+      (void)std::memcpy(position, "0.000", 5);
+      position += 2 - point;
+      writeDigits(decimal.significand, position, count);
+      position += count;
+    } else if (static_cast<size_t>(point) >= count) {
+      writeDigits(decimal.significand, position, count);
+      for (position += count; position < destination + point + (bits >> 63); ++position) *position = '0';
+      (void)std::memcpy(position, ".0", 2);
+      position += 2;
+    } else {
+      // The integer digits are moved back over the point like the first digit of the scientific notation.
+      writeDigits(decimal.significand, position + 1, count);
+      for (int32_t index = 0; index < point; ++index) position[index] = position[index + 1];
+      position[point] = '.';
+      position += count + 1;
+    }
+    return position - destination;
+  }
+
+  inline bool isDigit(const char character) noexcept {
+    return static_cast<unsigned char>(character - '0') < 10;
+  }
+
+  /// Tells if the 8 characters loaded into the word, the first one in the lowest byte, are all digits.
+  inline bool isEightDigits(const uint64_t characters) noexcept {
+    return ((characters & 0xF0F0F0F0F0F0F0F0) |
+            (((characters + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+  }
+
+  /// Combines the 8 digits loaded into the word in 3 multiplications, pairs, quadruples and the whole.
+  inline uint32_t parseEightDigits(uint64_t characters) noexcept {
+    characters -= 0x3030303030303030;
+    characters = characters * 10 + (characters >> 8);
+    characters = ((characters & 0x000000FF000000FF) * (100 + (1000000ULL << 32)) +
+                  ((characters >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32))) >> 32;
+    return static_cast<uint32_t>(characters);
+  }
+
+  /// The significand of a literal read so far.
+  struct DecimalLiteral {
+    /// The first MaximalSignificandDigits significant digits.
+    uint64_t significand = 0;
+    /// The power of ten the significand is scaled by.
+    int64_t exponent = 0;
+    /// The number of digits in the significand.
+    size_t digits = 0;
+    /// Tells if any nonzero digit was dropped beyond the significand.
+    bool isTruncated = false;
+  };
+
+  /// Reads the run of digits and single underscores between them into the literal.
+  /// @param isFraction Tells if the digits follow the decimal point, so that they scale the significand down.
+  /// @return The position after the run, or nullptr if an underscore is misplaced.
+  inline const char* readDigits(const char* position, const char* last, DecimalLiteral& literal,
+                         const bool isFraction) noexcept {
+    // The literal is updated in a copy, which stays in registers, since the stores through the reference
+    // could alias the characters as far as the compiler knows.
+    DecimalLiteral current = literal;
+    const char* first = position;
+    while (true) {
+      if constexpr (std::endian::native == std::endian::little) {
+        while (current.significand != 0 && current.digits + 8 <= MaximalSignificandDigits && last - position >= 8) {
+          uint64_t characters;
+          (void)std::memcpy(&characters, position, sizeof(characters));
+          if (!isEightDigits(characters)) break;
+          current.significand = current.significand * 100000000 + parseEightDigits(characters);
+          current.digits += 8;
+          current.exponent -= 8 * isFraction;
+          position += 8;
+        }
+      }
+      // The leading zeros leave the significand zero and only move the decimal point.
+      for (; position < last && isDigit(*position); ++position) {
+        const auto digit = static_cast<unsigned>(*position - '0');
+        if (current.digits < MaximalSignificandDigits) {
+          current.significand = current.significand * 10 + digit;
+          current.digits += current.significand != 0;
+          current.exponent -= isFraction;
+        } else {
+          current.isTruncated |= digit != 0;
+          current.exponent += !isFraction;
+        }
+      }
+      if (position == last || *position != '_') break;
+      if (position == first || position + 1 == last || !isDigit(position[-1]) || !isDigit(position[1])) {
+        return nullptr;
+      }
+      ++position;
+    }
+    literal = current;
+    return position;
+  }
+
+  /// Tells if the text is the word, ignoring the case of its ASCII letters.
+  bool isWord(const char* first, const char* last, const std::string_view word) noexcept {
+    if (static_cast<size_t>(last - first) != word.size()) return false;
+    for (size_t index = 0; index < word.size(); ++index) {
+      if ((first[index] | 0x20) != word[index]) return false;
+    }
+    return true;
+  }
+
+  /// Rounds significand * 10^exponent to the nearest double with the algorithm of Eisel and Lemire.
+  /// @param bits Output set to the bits of the double.
+  /// @return False if the product of the truncated powers is too close to a tie to tell the rounding.
+  inline bool convertDecimal(uint64_t significand, const int64_t exponent, uint64_t& bits) noexcept {
+    if (significand == 0 || exponent < SmallestPowerOfFive) {
+      bits = 0;
+      return true;
+    }
+    if (exponent > 308) {
+      bits = InfinityBits;
+      return true;
+    }
+    const auto scale = static_cast<int32_t>(exponent);
+    const int leadingZeros = std::countl_zero(significand);
+    significand <<= leadingZeros;
+    // The reciprocals of 5^1 to 5^27 are the ones rounded up in the original tables of the algorithm.
+    PowerOfFive power = getPowerOfFive(scale);
+    if (scale >= -27 && scale < 0) power.high += ++power.low == 0;
+
+    // The 55 top bits of the product decide unless the 9 bits below them are all ones, in which case the
+    // product with the low word of the power may carry into them.
+    const DoubleWord first = static_cast<DoubleWord>(significand) * power.high;
+    uint64_t high = static_cast<uint64_t>(first >> 64), low = static_cast<uint64_t>(first);
+    if ((high & 0x1FF) == 0x1FF) {
+      const auto carry = static_cast<uint64_t>((static_cast<DoubleWord>(significand) * power.low) >> 64);
+      low += carry;
+      high += carry > low;
+    }
+    if (low == UINT64_MAX && (scale < -27 || scale > LargestExactPowerOfFive)) return false;
+
+    const auto upperBit = static_cast<int>(high >> 63);
+    uint64_t mantissa = high >> (upperBit + 9);
+    int32_t power2 = ((217706 * scale) >> 16) + 63 + upperBit - leadingZeros + 1023;
+    if (power2 <= 0) {
+      // The subnormals lose the bits below the smallest exponent, and the rounding may lift them back into
+      // the normal range.
+      if (1 - power2 >= 64) {
+        bits = 0;
+        return true;
+      }
+      mantissa >>= 1 - power2;
+      mantissa += mantissa & 1;
+      mantissa >>= 1;
+      bits = mantissa;
+      return true;
+    }
+    // The exact ties, which can only come from the small powers, round to even rather than up.
+    if (low <= 1 && scale >= -4 && scale <= 23 && (mantissa & 3) == 1 && (mantissa << (upperBit + 9)) == high) {
+      mantissa &= ~uint64_t{1};
+    }
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >= uint64_t{2} << 52) {
+      mantissa = uint64_t{1} << 52;
+      ++power2;
+    }
+    bits = power2 >= 0x7FF ? InfinityBits : static_cast<uint64_t>(power2) << 52 | (mantissa & SignificandMask);
+    return true;
+  }
+
+  /// Converts the unsigned literal without underscores exactly with the standard library.
+  /// @param exponent The decimal exponent of the truncated significand, which tells an overflow from an
+  /// underflow when the library reports either.
+  bool readFloatExactly(const char* first, const char* last, const int64_t exponent, double& value) noexcept {
+    const auto [end, error] = std::from_chars(first, last, value);
+    if (error == std::errc::result_out_of_range) value = exponent > 0 ? std::numeric_limits<double>::infinity() : 0.0;
+    else if (error != std::errc() || end != last) return false;
+    return true;
+  }
+
+  /// Converts the unsigned literal exactly with the standard library, without the underscores it accepts.
+  /// @param exponent The decimal exponent of the truncated significand, which tells an overflow from an
+  /// underflow when the library reports either.
+  bool parseFloatExactly(const char* first, const char* last, const int64_t exponent, double& value) noexcept {
+    const auto size = static_cast<size_t>(last - first);
+    if (std::memchr(first, '_', size) == nullptr) return readFloatExactly(first, last, exponent, value);
+    const GarbageCollected<char> buffer = gather(size, GarbageCollectionGeneration::Eden);
+    if (buffer.destination == nullptr) {
+      raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+      return false;
+    }
+    char* destination = buffer.destination;
+    for (const char* character = first; character < last; ++character) {
+      if (*character != '_') *destination++ = *character;
+    }
+    const bool isValid = readFloatExactly(buffer.destination, destination, exponent, value);
+    mark(buffer);
+    return isValid;
+  }
+
+  bool parseFloat(const char* first, const char* last, double& value) noexcept {
+    const bool isNegative = first < last && *first == '-';
+    if (first < last && (*first == '-' || *first == '+')) ++first;
+    double result;
+    if (first < last && !isDigit(*first) && *first != '.') {
+      if (isWord(first, last, "inf") || isWord(first, last, "infinity")) result = std::numeric_limits<double>::infinity();
+      else if (isWord(first, last, "nan")) result = std::numeric_limits<double>::quiet_NaN();
+      else return false;
+      value = isNegative ? -result : result;
+      return true;
+    }
+
+    DecimalLiteral literal;
+    const char* position = readDigits(first, last, literal, false);
+    if (position == nullptr) return false;
+    bool hasDigits = position > first;
+    if (position < last && *position == '.') {
+      const char* fraction = position + 1;
+      position = readDigits(fraction, last, literal, true);
+      if (position == nullptr) return false;
+      hasDigits |= position > fraction;
+    }
+    if (!hasDigits) return false;
+    if (position < last && (*position == 'e' || *position == 'E')) {
+      const bool isExponentNegative = ++position < last && *position == '-';
+      if (position < last && (*position == '-' || *position == '+')) ++position;
+      // The exponent saturates far beyond the range of doubles, where it no longer changes the result.
+      const char* digits = position;
+      int64_t exponent = 0;
+      for (; position < last; ++position) {
+        if (*position == '_') {
+          if (position == digits || position + 1 == last || !isDigit(position[-1]) || !isDigit(position[1])) {
+            return false;
+          }
+          continue;
+        }
+        if (!isDigit(*position)) break;
+        if (exponent < 100000000) exponent = exponent * 10 + (*position - '0');
+      }
+      if (position == digits) return false;
+      literal.exponent += isExponentNegative ? -exponent : exponent;
+    }
+    if (position != last) return false;
+
+    if (!literal.isTruncated && literal.significand <= uint64_t{1} << 53 && literal.exponent >= -22 &&
+        literal.exponent <= 22) {
+      // Both the significand and the power are exact, so the single operation rounds correctly.
+      const auto significand = static_cast<double>(literal.significand);
+      result = literal.exponent < 0 ? significand / ExactPowersOfTen[-literal.exponent]
+                                    : significand * ExactPowersOfTen[literal.exponent];
+    } else {
+      // The digits dropped place the literal between the significand and the next one, which settle it
+      // only if both round to the same double.
+      uint64_t bits, upperBits;
+      const bool isSettled = convertDecimal(literal.significand, literal.exponent, bits) &&
+                             (!literal.isTruncated ||
+                              (convertDecimal(literal.significand + 1, literal.exponent, upperBits) && upperBits == bits));
+      if (isSettled) result = std::bit_cast<double>(bits);
+      else if (!parseFloatExactly(first, last, literal.exponent, result)) return false;
+    }
+    value = isNegative ? -result : result;
+    return true;
+  }
+}
@@ -0,0 +1,477 @@
+#include "types/help/formatting.hh"
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <string_view>
+
+#include "context.hh"
+#include "types/String.hh"
+#include "unicode/database.hh"
+namespace mamba {
+  /// The number of plans cached per thread. Templates are assigned to slots by their hashes, and
+  /// the template compiled last wins the slot.
+  constexpr size_t FormatPlanCacheSize = 64;
+
+  /// The largest width or precision accepted in the templates, as in CPython.
+  constexpr uint32_t LargestFormatNumber = INT32_MAX;
+
+  /// The slot of the per-thread cache of the compiled templates.
+  struct FormatPlanCacheEntry {
+    size_t hash = 0;
+    FormatSyntax syntax = FormatSyntax::Braces;
+    bool isCompiled = false;
+    std::string pattern;
+    FormatPlan plan;
+  };
+
+  /// The size of the argument after the conversion and the precision are applied, excluding the padding.
+  struct FormattedExtent {
+    size_t sizeInBytes = 0, graphemes = 0;
+  };
+
+  /// Tells how many bytes the UTF-8 sequence beginning with the lead byte takes.
+  inline size_t getFormattedSequenceSize(const unsigned char lead) noexcept {
+    return lead < 0x80 ? 1 : std::countl_one(lead);
+  }
+
+  /// Parses the decimal number in the template.
+  /// @param pattern The pointer to the template.
+  /// @param sizeInBytes The size of the template.
+  /// @param offset The offset of the first digit, advanced past the last one.
+  /// @param number Output set to the parsed number, left intact if there are no digits.
+  /// @return False if the number is too large, in which case ValueError is raised.
+  bool parseFormatNumber(const char* pattern, const size_t sizeInBytes, size_t& offset, uint32_t& number) noexcept {
+    if (offset >= sizeInBytes || pattern[offset] < '0' || pattern[offset] > '9') return true;
+    uint64_t value = 0;
+    for (; offset < sizeInBytes && pattern[offset] >= '0' && pattern[offset] <= '9'; ++offset) {
+      value = value * 10 + (pattern[offset] - '0');
+      if (value > LargestFormatNumber) {
+        raise(Signal::ValueError, ExceptionReason::InvalidFormatString);
+        return false;
+      }
+    }
+    number = static_cast<uint32_t>(value);
+    return true;
+  }
+
+  inline bool isFormatAlignment(const char character) noexcept {
+    return character == '<' || character == '>' || character == '^' || character == '=';
+  }
+
+  /// Parses the format specifier of the replacement field, the part after the colon in "{0:*^10.3}".
+  /// @param specifier The pointer to the specifier.
+  /// @param sizeInBytes The size of the specifier.
+  /// @param field The field receiving the parsed options.
+  /// @return False if the specifier is malformed, in which case ValueError is raised.
+  bool parseFormatSpecifier(const char* specifier, const size_t sizeInBytes, FormatField& field) noexcept {
+    size_t offset = 0;
+    bool hasFill = false;
+    if (sizeInBytes > 0) {
+      const size_t fillSize = getFormattedSequenceSize(static_cast<unsigned char>(specifier[0]));
+      if (fillSize < sizeInBytes && isFormatAlignment(specifier[fillSize])) {
+        (void)std::memcpy(field.fill, specifier, fillSize);
+        field.fillSize = static_cast<uint8_t>(fillSize);
+        field.align = specifier[fillSize];
+        offset = fillSize + 1;
+        hasFill = true;
+      } else if (isFormatAlignment(specifier[0])) {
+        field.align = specifier[0];
+        offset = 1;
+      }
+    }
+    if (offset < sizeInBytes && (specifier[offset] == '+' || specifier[offset] == '-' || specifier[offset] == ' ')) {
+      field.sign = specifier[offset++];
+    }
+    if (offset < sizeInBytes && specifier[offset] == '#') {
+      field.isAlternate = true;
+      ++offset;
+    }
+    if (offset < sizeInBytes && specifier[offset] == '0') {
+      // Like in CPython 3.10 and newer, zero padding only replaces the default fill character.
+      field.isZeroPadded = true;
+      if (!hasFill) field.fill[0] = '0';
+      ++offset;
+    }
+    if (!parseFormatNumber(specifier, sizeInBytes, offset, field.width)) return false;
+    if (offset < sizeInBytes && (specifier[offset] == ',' || specifier[offset] == '_')) {
+      field.hasGrouping = true;
+      ++offset;
+    }
+    if (offset < sizeInBytes && specifier[offset] == '.') {
+      uint32_t precision = UINT32_MAX;
+      if (!parseFormatNumber(specifier, sizeInBytes, ++offset, precision)) return false;
+      if (precision == UINT32_MAX) {
+        raise(Signal::ValueError, ExceptionReason::InvalidFormatString);
+        return false;
+      }
+      field.precision = static_cast<int32_t>(precision);
+    }
+    if (offset < sizeInBytes) field.type = specifier[offset++];
+    if (offset == sizeInBytes) return true;
+    raise(Signal::ValueError, ExceptionReason::InvalidFormatString);
+    return false;
+  }
+
+  bool FormatPlan::compile(const char* pattern, const size_t sizeInBytes, const FormatSyntax language) noexcept {
+    // Plans are recompiled in the slots of the cache, so the buffers keep their capacity.
+    literals.clear();
+    names.clear();
+    fields.clear();
+    expectedArgumentCount = 0;
+    isNamed = false;
+    syntax = language;
+    if (sizeInBytes > UINT32_MAX) {
+      raise(Signal::ValueError, ExceptionReason::InvalidFormatString);
+      return false;
+    }
+    const bool isCompiled = syntax == FormatSyntax::Braces ? compileBraces(pattern, sizeInBytes)
+                                                           : compilePercent(pattern, sizeInBytes);
+    literalGraphemes = countUTF8Graphemes(literals.data(), literals.size());
+    return isCompiled;
+  }
+
+  bool FormatPlan::compileBraces(const char* pattern, const size_t sizeInBytes) noexcept {
+    enum class Numbering { Unknown, Automatic, Manual } numbering = Numbering::Unknown;
+    uint32_t nextArgument = 0;
+    size_t literalStart = 0, offset = 0;
+    while (offset < sizeInBytes) {
+      const char character = pattern[offset];
+      if (character != '{' && character != '}') {
+        const size_t next = std::string_view(pattern, sizeInBytes).find_first_of("{}", offset);
+        const size_t ending = next == std::string_view::npos ? sizeInBytes : next;
+        literals.append(pattern + offset, ending - offset);
+        offset = ending;
+        continue;
+      }
+      if (offset + 1 < sizeInBytes && pattern[offset + 1] == character) {
+        literals += character;
+        offset += 2;
+        continue;
+      }
+      if (character == '}') {
+        raise(Signal::ValueError, ExceptionReason::InvalidFormatString);
+        return false;
+      }
+
+      // The replacement field ends at the first closing brace, since nested fields are not supported.
+      const size_t closing = std::string_view(pattern, sizeInBytes).find_first_of("{}", offset + 1);
+      if (closing == std::string_view::npos || pattern[closing] == '{') {
+        raise(Signal::ValueError, ExceptionReason::InvalidFormatString);
+        return false;
+      }
+      FormatField field;
+      field.literalSize = static_cast<uint32_t>(literals.size() - literalStart);
+      literalStart = literals.size();
+
+      size_t cursor = offset + 1;
+      while (cursor < closing && pattern[cursor] != '!' && pattern[cursor] != ':') ++cursor;
+      const std::string_view name(pattern + offset + 1, cursor - offset - 1);
+      if (name.find_first_of(".[") != std::string_view::npos) {
+        raise(Signal::ValueError, ExceptionReason::InvalidFormatString);
+        return false;
+      }
+      const bool isNumbered = !name.empty() && name.find_first_not_of("0123456789") == std::string_view::npos;
+      if (name.empty() || isNumbered) {
+        const Numbering expected = name.empty() ? Numbering::Automatic : Numbering::Manual;
+        if (numbering != Numbering::Unknown && numbering != expected) {
+          raise(Signal::ValueError, ExceptionReason::InvalidFormatString);
+          return false;
+        }
+        numbering = expected;
+        size_t digit = 0;
+        if (isNumbered && !parseFormatNumber(name.data(), name.size(), digit, field.argumentIndex)) return false;
+        if (!isNumbered) field.argumentIndex = nextArgument++;
+      } else {
+        field.isKeyword = true;
+        field.nameOffset = static_cast<uint32_t>(names.size());
+        field.nameSize = static_cast<uint32_t>(name.size());
+        field.nameHash = hashBytes(name.data(), name.size());
+        names.append(name);
+      }
+
+      if (cursor < closing && pattern[cursor] == '!') {
+        const char conversion = cursor + 1 < closing ? pattern[cursor + 1] : '\0';
+        if ((conversion != 's' && conversion != 'r' && conversion != 'a') ||
+            (cursor + 2 < closing && pattern[cursor + 2] != ':')) {
+          raise(Signal::ValueError, ExceptionReason::InvalidFormatString);
+          return false;
+        }
+        field.conversion = conversion;
+        cursor += 2;
+      }
+      if (cursor < closing && !parseFormatSpecifier(pattern + cursor + 1, closing - cursor - 1, field)) return false;
+      fields.push_back(field);
+      offset = closing + 1;
+    }
+    return true;
+  }
+
+  bool FormatPlan::compilePercent(const char* pattern, const size_t sizeInBytes) noexcept {
+    size_t literalStart = 0, offset = 0;
+    while (offset < sizeInBytes) {
+      if (pattern[offset] != '%') {
+        const auto* next = static_cast<const char*>(std::memchr(pattern + offset, '%', sizeInBytes - offset));
+        const size_t ending = next == nullptr ? sizeInBytes : next - pattern;
+        literals.append(pattern + offset, ending - offset);
+        offset = ending;
+        continue;
+      }
+
+      FormatField field;
+      size_t cursor = offset + 1;
+      if (cursor < sizeInBytes && pattern[cursor] == '(') {
+        // The key may contain balanced parentheses, as in "%(f(x))s".
+        size_t depth = 1, beginning = ++cursor;
+        for (; cursor < sizeInBytes && depth > 0; ++cursor) {
+          if (pattern[cursor] == '(') ++depth;
+          else if (pattern[cursor] == ')') --depth;
+        }
+        if (depth > 0) {
+          raise(Signal::ValueError, ExceptionReason::InvalidFormatString);
+          return false;
+        }
+        const std::string_view name(pattern + beginning, cursor - beginning - 1);
+        field.isKeyword = isNamed = true;
+        field.nameOffset = static_cast<uint32_t>(names.size());
+        field.nameSize = static_cast<uint32_t>(name.size());
+        field.nameHash = hashBytes(name.data(), name.size());
+        names.append(name);
+      }
+      for (; cursor < sizeInBytes; ++cursor) {
+        const char flag = pattern[cursor];
+        if (flag == '-') field.align = '<';
+        else if (flag == '+') field.sign = '+';
+        else if (flag == ' ') field.sign = field.sign == '+' ? '+' : ' ';
+        else if (flag == '#') field.isAlternate = true;
+        else if (flag == '0') field.isZeroPadded = true;
+        else break;
+      }
+      if (cursor < sizeInBytes && pattern[cursor] == '*') {
+        field.isWidthFromArgument = true;
+        ++cursor;
+        ++expectedArgumentCount;
+      } else if (!parseFormatNumber(pattern, sizeInBytes, cursor, field.width)) return false;
+      if (cursor < sizeInBytes && pattern[cursor] == '.') {
+        uint32_t precision = 0;
+        if (++cursor < sizeInBytes && pattern[cursor] == '*') {
+          field.isPrecisionFromArgument = true;
+          ++cursor;
+          ++expectedArgumentCount;
+        } else if (!parseFormatNumber(pattern, sizeInBytes, cursor, precision)) return false;
+        field.precision = static_cast<int32_t>(precision);
+      }
+      while (cursor < sizeInBytes && (pattern[cursor] == 'h' || pattern[cursor] == 'l' || pattern[cursor] == 'L')) {
+        ++cursor;
+      }
+      if (cursor == sizeInBytes) {
+        raise(Signal::ValueError, ExceptionReason::InvalidFormatString);
+        return false;
+      }
+
+      const char type = pattern[cursor];
+      offset = cursor + 1;
+      if (type == '%') {
+        literals += '%';
+        continue;
+      }
+      if (std::string_view("sracdiouxXeEfFgG").find(type) == std::string_view::npos) {
+        raise(Signal::ValueError, ExceptionReason::InvalidFormatString);
+        return false;
+      }
+      field.type = type;
+      field.conversion = type == 'r' || type == 'a' ? type : 's';
+      if (field.align == 0) field.align = '>';
+      if (!field.isKeyword) field.argumentIndex = static_cast<uint32_t>(expectedArgumentCount++);
+      field.literalSize = static_cast<uint32_t>(literals.size() - literalStart);
+      literalStart = literals.size();
+      fields.push_back(field);
+    }
+    return true;
+  }
+
+  const String* FormatPlan::resolveArgument(const FormatField& field, const FormatArguments& arguments) const noexcept {
+    if (field.isKeyword) {
+      const std::string_view name(names.data() + field.nameOffset, field.nameSize);
+      for (size_t index = 0; index < arguments.keywordCount; ++index) {
+        const String& keyword = arguments.keywordNames[index];
+        const size_t keywordSize = keyword.end() - keyword.begin();
+        if (keywordSize != name.size() || (keywordSize > 0 && keyword.hash() != field.nameHash)) continue;
+        if (name == std::string_view(keyword.begin(), keywordSize)) return &arguments.keywordValues[index];
+      }
+      raise(Signal::KeyError, ExceptionReason::FormatArgumentNotFound);
+      return nullptr;
+    }
+    if (field.argumentIndex < arguments.positionalCount) return &arguments.positional[field.argumentIndex];
+    if (syntax == FormatSyntax::Braces) raise(Signal::IndexError, ExceptionReason::FormatArgumentNotFound);
+    else raise(Signal::TypeError, ExceptionReason::FormatArgumentCountMismatch);
+    return nullptr;
+  }
+
+  /// Checks if the string argument can be presented as the field requests, such as rejecting "{:d}".
+  /// @return False if the field is not applicable to strings, in which case an exception is raised.
+  bool isPresentableAsString(const FormatField& field, const String& value, const FormatSyntax syntax) noexcept {
+    if (syntax == FormatSyntax::Percent) {
+      const bool isText = field.type == 's' || field.type == 'r' || field.type == 'a';
+      if (field.isWidthFromArgument || field.isPrecisionFromArgument || (!isText && field.type != 'c') ||
+          (field.type == 'c' && value.len() != 1)) {
+        raise(Signal::TypeError, ExceptionReason::FormatArgumentTypeMismatch);
+        return false;
+      }
+      return true;
+    }
+    if ((field.type != 0 && field.type != 's') || field.sign != 0 || field.isAlternate || field.hasGrouping ||
+        field.align == '=') {
+      raise(Signal::ValueError, ExceptionReason::FormatSpecifierMismatch);
+      return false;
+    }
+    return true;
+  }
+
+  /// Writes the argument after the conversion, truncated to the precision, or only measures it.
+  /// @param value The argument.
+  /// @param conversion The conversion of the field: 's', 'r' or 'a'.
+  /// @param precision The largest number of graphemes to write, or NoFormatPrecision.
+  /// @param destination The buffer to write into, or nullptr to measure the result only.
+  /// @return The size of the result.
+  FormattedExtent emitFormattedValue(const String& value, const char conversion, const int32_t precision,
+                                     char* destination) noexcept {
+    const size_t limit = precision == NoFormatPrecision ? SIZE_MAX : static_cast<size_t>(precision);
+    const size_t valueSize = value.end() - value.begin();
+    FormattedExtent extent;
+    if (conversion == 's') {
+      if (limit >= value.len()) extent = {valueSize, value.len()};
+      else if (value.isascii()) extent = {limit, limit};
+      else {
+        for (; extent.graphemes < limit; ++extent.graphemes) {
+          extent.sizeInBytes += getFormattedSequenceSize(static_cast<unsigned char>(value.begin()[extent.sizeInBytes]));
+        }
+      }
+      if (destination != nullptr && extent.sizeInBytes > 0) (void)std::memcpy(destination, value.begin(), extent.sizeInBytes);
+      return extent;
+    }
+
+    // Escape sequences are ASCII and can be cut by the precision, while other characters are kept whole.
+    bool isTruncated = false;
+    const auto append = [&](const char* piece, const size_t pieceSize, const size_t pieceGraphemes) {
+      size_t size = pieceSize;
+      if (extent.graphemes + pieceGraphemes > limit) {
+        size = pieceGraphemes == pieceSize ? limit - extent.graphemes : 0;
+        isTruncated = true;
+      }
+      if (destination != nullptr) (void)std::memcpy(destination + extent.sizeInBytes, piece, size);
+      extent.sizeInBytes += size;
+      extent.graphemes += pieceGraphemes == pieceSize ? size : size > 0;
+    };
+
+    // Like repr() in CPython, prefer single quotes unless only double quotes avoid escaping.
+    const char* text = value.begin();
+    const bool hasApostrophe = valueSize > 0 && std::memchr(text, '\'', valueSize) != nullptr;
+    const bool hasQuote = valueSize > 0 && std::memchr(text, '"', valueSize) != nullptr;
+    const char quote = hasApostrophe && !hasQuote ? '"' : '\'';
+    constexpr char HexadecimalDigits[] = "0123456789abcdef";
+    append(&quote, 1, 1);
+    for (size_t offset = 0; offset < valueSize && !isTruncated;) {
+      const auto lead = static_cast<unsigned char>(text[offset]);
+      const size_t size = getFormattedSequenceSize(lead);
+      uint32_t codePoint = size == 1 ? lead : lead & (0x7F >> size);
+      for (size_t index = 1; index < size; ++index) codePoint = (codePoint << 6) | (text[offset + index] & 0x3F);
+
+      char escape[10] = {'\\'};
+      size_t escapeSize = 0;
+      if (codePoint == static_cast<unsigned char>(quote) || codePoint == '\\') {
+        escape[1] = static_cast<char>(codePoint);
+        escapeSize = 2;
+      } else if (codePoint == '\t' || codePoint == '\n' || codePoint == '\r') {
+        escape[1] = codePoint == '\t' ? 't' : codePoint == '\n' ? 'n' : 'r';
+        escapeSize = 2;
+      } else if (codePoint < 0x20 || codePoint == 0x7F ||
+                 (codePoint >= 0x80 && (conversion == 'a' || !(getCharacterRecord(codePoint).flags & PrintableFlag)))) {
+        const size_t digits = codePoint < 0x100 ? 2 : codePoint < 0x10000 ? 4 : 8;
+        escape[1] = digits == 2 ? 'x' : digits == 4 ? 'u' : 'U';
+        for (size_t index = 0; index < digits; ++index) {
+          escape[2 + index] = HexadecimalDigits[(codePoint >> (4 * (digits - 1 - index))) & 0xF];
+        }
+        escapeSize = 2 + digits;
+      }
+      if (escapeSize > 0) append(escape, escapeSize, escapeSize);
+      else append(text + offset, size, 1);
+      offset += size;
+    }
+    if (!isTruncated) append(&quote, 1, 1);
+    return extent;
+  }
+
+  /// Writes the fill character of the field repeatedly.
+  /// @return The pointer past the written padding.
+  char* writeFormatPadding(char* destination, const FormatField& field, const size_t count) noexcept {
+    if (field.fillSize == 1) {
+      (void)std::memset(destination, field.fill[0], count);
+      return destination + count;
+    }
+    for (size_t index = 0; index < count; ++index, destination += field.fillSize) {
+      (void)std::memcpy(destination, field.fill, field.fillSize);
+    }
+    return destination;
+  }
+
+  String FormatPlan::render(const FormatArguments& arguments) const noexcept {
+    if (syntax == FormatSyntax::Percent && !isNamed && arguments.positionalCount != expectedArgumentCount) {
+      raise(Signal::TypeError, ExceptionReason::FormatArgumentCountMismatch);
+      return {};
+    }
+
+    size_t sizeInBytes = literals.size(), graphemes = literalGraphemes;
+    for (const FormatField& field : fields) {
+      const String* value = resolveArgument(field, arguments);
+      if (value == nullptr || !isPresentableAsString(field, *value, syntax)) return {};
+      const FormattedExtent extent = emitFormattedValue(*value, field.conversion, field.precision, nullptr);
+      const size_t padding = field.width > extent.graphemes ? field.width - extent.graphemes : 0;
+      sizeInBytes += extent.sizeInBytes + padding * field.fillSize;
+      graphemes += extent.graphemes + padding;
+    }
+    const GarbageCollected<char> buffer = gather(sizeInBytes + 1, GarbageCollectionGeneration::Eden);
+    if (buffer.destination == nullptr) {
+      raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+      return {};
+    }
+
+    char* cursor = buffer.destination;
+    const char* literal = literals.data();
+    for (const FormatField& field : fields) {
+      (void)std::memcpy(cursor, literal, field.literalSize);
+      cursor += field.literalSize;
+      literal += field.literalSize;
+
+      // The value is written first and moved past the leading padding, to avoid measuring it again.
+      const String& value = *resolveArgument(field, arguments);
+      const FormattedExtent extent = emitFormattedValue(value, field.conversion, field.precision, cursor);
+      const size_t padding = field.width > extent.graphemes ? field.width - extent.graphemes : 0;
+      const size_t leading = field.align == '>' ? padding : field.align == '^' ? padding / 2 : 0;
+      if (leading > 0) {
+        (void)std::memmove(cursor + leading * field.fillSize, cursor, extent.sizeInBytes);
+        (void)writeFormatPadding(cursor, field, leading);
+      }
+      cursor = writeFormatPadding(cursor + leading * field.fillSize + extent.sizeInBytes, field, padding - leading);
+    }
+    (void)std::memcpy(cursor, literal, literals.data() + literals.size() - literal);
+    buffer.destination[sizeInBytes] = '\0';
+    return {buffer, sizeInBytes, graphemes, sizeInBytes == graphemes};
+  }
+
+  const FormatPlan* getFormatPlan(const String& pattern, const FormatSyntax syntax) noexcept {
+    thread_local std::array<FormatPlanCacheEntry, FormatPlanCacheSize> cache;
+    const size_t hash = pattern.hash();
+    const std::string_view text(pattern.begin(), pattern.end() - pattern.begin());
+    FormatPlanCacheEntry& entry = cache[(hash ^ static_cast<size_t>(syntax)) % FormatPlanCacheSize];
+    if (entry.isCompiled && entry.hash == hash && entry.syntax == syntax && entry.pattern == text) return &entry.plan;
+
+    entry.isCompiled = false;
+    if (!entry.plan.compile(text.data(), text.size(), syntax)) return nullptr;
+    entry.hash = hash;
+    entry.syntax = syntax;
+    entry.pattern.assign(text);
+    entry.isCompiled = true;
+    return &entry.plan;
+  }
+}
@@ -0,0 +1,123 @@
+#include "types/help/hashing.hh"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+namespace mamba {
+  /// The secret words mixed into every hash, generated once per process.
+  typedef std::array<uint64_t, 4> HashSecret;
+
+  __extension__ typedef unsigned __int128 HashProduct;
+
+  /// Generates the secret on the first call from the entropy source of the operating system.
+  /// @return The secret of the current process.
+  const HashSecret& getHashSecret() noexcept {
+    static const HashSecret secret = []() {
+      HashSecret words;
+      std::random_device entropy;
+      // Odd words never zero out the products in which they take part.
+      for (uint64_t& word : words) word = ((static_cast<uint64_t>(entropy()) << 32) ^ entropy()) | 1;
+      return words;
+    }();
+    return secret;
+  }
+
+  /// Loads 8 bytes from the possibly unaligned address.
+  inline uint64_t readHashWord(const unsigned char* bytes) noexcept {
+    uint64_t word;
+    (void)std::memcpy(&word, bytes, sizeof(word));
+    return word;
+  }
+
+  /// Loads 4 bytes from the possibly unaligned address.
+  inline uint64_t readHashHalfWord(const unsigned char* bytes) noexcept {
+    uint32_t word;
+    (void)std::memcpy(&word, bytes, sizeof(word));
+    return word;
+  }
+
+  /// Multiplies 2 words into the 128-bit product and folds its halves together, so that every bit
+  /// of the result depends on every bit of both inputs.
+  inline uint64_t foldMultiply(const uint64_t left, const uint64_t right) noexcept {
+    const HashProduct product = static_cast<HashProduct>(left) * right;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+  }
+
+  uint64_t hashBytes(const void* data, const size_t sizeInBytes) noexcept {
+    const HashSecret& secret = getHashSecret();
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    uint64_t seed = secret[0] ^ foldMultiply(secret[0] ^ sizeInBytes, secret[1]), first, second;
+
+    if (sizeInBytes <= 16) {
+      if (sizeInBytes >= 4) {
+        // Two pairs of possibly overlapping 4-byte loads cover every size from 4 to 16.
+        const size_t shift = (sizeInBytes >> 3) << 2;
+        const unsigned char* last = bytes + sizeInBytes - 4;
+        first = (readHashHalfWord(bytes) << 32) | readHashHalfWord(bytes + shift);
+        second = (readHashHalfWord(last) << 32) | readHashHalfWord(last - shift);
+      } else if (sizeInBytes > 0) {
+        first = (uint64_t{bytes[0]} << 16) | (uint64_t{bytes[sizeInBytes >> 1]} << 8) | bytes[sizeInBytes - 1];
+        second = 0;
+      } else first = second = 0;
+    } else {
+      size_t remaining = sizeInBytes;
+      if (remaining > 48) {
+        uint64_t secondLane = seed, thirdLane = seed;
+        do {
+          seed = foldMultiply(readHashWord(bytes) ^ secret[1], readHashWord(bytes + 8) ^ seed);
+          secondLane = foldMultiply(readHashWord(bytes + 16) ^ secret[2], readHashWord(bytes + 24) ^ secondLane);
+          thirdLane = foldMultiply(readHashWord(bytes + 32) ^ secret[3], readHashWord(bytes + 40) ^ thirdLane);
+          bytes += 48;
+          remaining -= 48;
+        } while (remaining > 48);
+        seed ^= secondLane ^ thirdLane;
+      }
+      for (; remaining > 16; bytes += 16, remaining -= 16) {
+        seed = foldMultiply(readHashWord(bytes) ^ secret[1], readHashWord(bytes + 8) ^ seed);
+      }
+      // The last 16 bytes may overlap with the ones already consumed, which is harmless.
+      first = readHashWord(bytes + remaining - 16);
+      second = readHashWord(bytes + remaining - 8);
+    }
+
+    const HashProduct product = static_cast<HashProduct>(first ^ secret[1]) * (second ^ seed);
+    first = static_cast<uint64_t>(product);
+    second = static_cast<uint64_t>(product >> 64);
+    return foldMultiply(first ^ secret[0] ^ sizeInBytes, second ^ secret[1]);
+  }
+
+  uint64_t hashWord(const int64_t value) noexcept {
+    const uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    // The bits above the 61st are worth 1 each modulo the prime, which spares a division.
+    uint64_t residue = (magnitude & NumericHashModulus) + (magnitude >> 61);
+    if (residue >= NumericHashModulus) residue -= NumericHashModulus;
+    const uint64_t hash = value < 0 ? 0 - residue : residue;
+    return hash == ReservedHash ? ReservedHash - 1 : hash;
+  }
+
+  uint64_t hashDouble(const double value) noexcept {
+    constexpr uint64_t InfinityHash = 314159;
+    if (std::isnan(value)) return 0;
+    if (std::isinf(value)) return value > 0 ? InfinityHash : 0 - InfinityHash;
+    int exponent;
+    double significand = std::frexp(std::fabs(value), &exponent);
+    // The significand is taken 28 bits at a time, rotating the residue by as many bits before each step.
+    uint64_t residue = 0;
+    while (significand != 0) {
+      residue = ((residue << 28) & NumericHashModulus) | (residue >> (61 - 28));
+      significand *= 0x1p28;
+      exponent -= 28;
+      const auto digits = static_cast<uint64_t>(significand);
+      significand -= static_cast<double>(digits);
+      residue += digits;
+      if (residue >= NumericHashModulus) residue -= NumericHashModulus;
+    }
+    // The power of 2 left in the exponent is a rotation by the exponent modulo 61.
+    exponent = exponent >= 0 ? exponent % 61 : 61 - 1 - ((-1 - exponent) % 61);
+    residue = ((residue << exponent) & NumericHashModulus) | (residue >> (61 - exponent));
+    const uint64_t hash = value < 0 ? 0 - residue : residue;
+    return hash == ReservedHash ? ReservedHash - 1 : hash;
+  }
+}
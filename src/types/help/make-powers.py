@@ -0,0 +1,39 @@
+#!/usr/bin/env python3
+"""Generates powers.cc, the 128-bit approximations of the powers of five behind the float conversions.
+
+Every entry holds the power 5^q shifted so that its most significant bit is bit 127 of the 128 bits,
+truncated to those bits. The same mantissa is the one of 10^q, since the two only differ by a power of
+two. Run it from the repository root:
+
+    python3 src/types/help/make-powers.py > src/types/help/powers.cc
+"""
+SmallestPower, LargestPower = -342, 326
+
+
+def normalise(q):
+    """Returns the floor of 5^q scaled into [2^127, 2^128)."""
+    if q >= 0:
+        power = 5 ** q
+        shift = power.bit_length() - 128
+        return power >> shift if shift >= 0 else power << -shift
+    divisor = 5 ** -q
+    shift = 127 + divisor.bit_length()
+    value = (1 << shift) // divisor
+    while value >= 1 << 128:
+        shift -= 1
+        value = (1 << shift) // divisor
+    while value < 1 << 127:
+        shift += 1
+        value = (1 << shift) // divisor
+    return value
+
+
+print("// Generated by make-powers.py. Do not edit.")
+print('#include "powers.hh"')
+print("namespace mamba {")
+print("  const PowerOfFive PowersOfFive[] = {")
+for q in range(SmallestPower, LargestPower + 1):
+    value = normalise(q)
+    print(f"    {{0x{value >> 64:016X}, 0x{value & (1 << 64) - 1:016X}}},")
+print("  };")
+print("}")
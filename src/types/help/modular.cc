@@ -0,0 +1,493 @@
+#include "types/help/modular.hh"
+
+#include <algorithm>
+#include <bit>
+#include <memory>
+
+#include "context.hh"
+#include "givers/memory.hh"
+#include "types/help/arithmetic.hh"
+namespace mamba {
+  /// The product of 2 words.
+  __extension__ typedef unsigned __int128 DoubleWord;
+
+  /// The widest sliding window, taken by the exponents of more than 672 bits.
+  constexpr size_t MaximumWindowWidth = 6;
+
+  /// The width of the windows of the constant-time exponentiation, and the number of powers they pick from.
+  constexpr size_t FixedWindowWidth = 4;
+  constexpr size_t FixedWindowPowers = size_t{1} << FixedWindowWidth;
+
+  /// Tells the bit of the exponent at the index, counted from the least significant one.
+  inline uint32_t getExponentBit(const uint32_t* exponent, const size_t index) noexcept {
+    return (exponent[index / 32] >> (index % 32)) & 1;
+  }
+
+  /// Tells how many bits the exponent has, without its leading zeros.
+  inline size_t getExponentBitLength(const uint32_t* exponent, const size_t exponentSize) noexcept {
+    return (exponentSize - 1) * 32 + std::bit_width(exponent[exponentSize - 1]);
+  }
+
+  /// Picks the width of the sliding windows for the exponent of the given number of bits, trading the odd
+  /// powers computed ahead for the multiplications they save.
+  size_t getWindowWidth(const size_t bits) noexcept {
+    return bits <= 24 ? 1 : bits <= 80 ? 3 : bits <= 240 ? 4 : bits <= 672 ? 5 : MaximumWindowWidth;
+  }
+
+  /// Tells how many powers of the base the exponentiation keeps in its table.
+  size_t getPowerTableSize(const uint32_t* exponent, const size_t exponentSize, const bool isConstantTime) noexcept {
+    if (isConstantTime) return FixedWindowPowers;
+    return size_t{1} << (getWindowWidth(getExponentBitLength(exponent, exponentSize)) - 1);
+  }
+
+  /// Raises the base with sliding windows. The multiplication takes operands of width words, and it may
+  /// write the product over either of them.
+  /// @param table The destination for the 2^(window - 1) odd powers of the base.
+  /// @param accumulator The destination for the power.
+  template<typename Word, typename Multiplication>
+  void raiseWithSlidingWindows(const Word* base, const uint32_t* exponent, const size_t exponentSize,
+                               const size_t width, Word* table, Word* accumulator,
+                               const Multiplication& multiply) noexcept {
+    const size_t bits = getExponentBitLength(exponent, exponentSize), window = getWindowWidth(bits);
+    // The table holds base^1, base^3, base^5 and so on, stepping by the square of the base.
+    std::copy(base, base + width, table);
+    if (window > 1) {
+      multiply(base, base, accumulator);
+      for (size_t index = 1; index < size_t{1} << (window - 1); ++index) {
+        multiply(table + (index - 1) * width, accumulator, table + index * width);
+      }
+    }
+    // The top bit is set, so the first window starts the accumulator off with its power.
+    bool isStarted = false;
+    for (size_t position = bits; position > 0;) {
+      if (getExponentBit(exponent, position - 1) == 0) {
+        multiply(accumulator, accumulator, accumulator);
+        --position;
+        continue;
+      }
+      // The window ends at its lowest set bit, so that its value is odd.
+      size_t low = position > window ? position - window : 0;
+      while (getExponentBit(exponent, low) == 0) ++low;
+      size_t value = 0;
+      for (size_t index = position; index-- > low;) value = (value << 1) | getExponentBit(exponent, index);
+      const Word* power = table + (value >> 1) * width;
+      if (isStarted) {
+        for (size_t step = low; step < position; ++step) multiply(accumulator, accumulator, accumulator);
+        multiply(accumulator, power, accumulator);
+      } else {
+        std::copy(power, power + width, accumulator);
+        isStarted = true;
+      }
+      position = low;
+    }
+  }
+
+  /// Copies the power at the index out of the table, reading every entry so that the memory accesses do not
+  /// reveal the index.
+  template<typename Word>
+  void selectPower(const Word* table, const size_t width, const size_t index, Word* destination) noexcept {
+    std::fill(destination, destination + width, 0);
+    for (size_t entry = 0; entry < FixedWindowPowers; ++entry) {
+      const Word mask = Word{0} - static_cast<Word>(entry == index);
+      for (size_t position = 0; position < width; ++position) {
+        destination[position] |= table[entry * width + position] & mask;
+      }
+    }
+  }
+
+  /// Raises the base with fixed windows over every cell of the exponent, in a sequence of operations that
+  /// depends on the size of the exponent alone.
+  /// @param table The destination for the powers of the base from 0 to 15.
+  /// @param selected The destination for the power picked by every window.
+  template<typename Word, typename Multiplication>
+  void raiseWithFixedWindows(const Word* base, const Word* one, const uint32_t* exponent, const size_t exponentSize,
+                             const size_t width, Word* table, Word* accumulator, Word* selected,
+                             const Multiplication& multiply) noexcept {
+    std::copy(one, one + width, table);
+    std::copy(base, base + width, table + width);
+    for (size_t index = 2; index < FixedWindowPowers; ++index) {
+      multiply(table + (index - 1) * width, base, table + index * width);
+    }
+    const auto getWindow = [exponent](const size_t index) {
+      return (exponent[index * FixedWindowWidth / 32] >> (index * FixedWindowWidth % 32)) & (FixedWindowPowers - 1);
+    };
+    const size_t windows = exponentSize * 32 / FixedWindowWidth;
+    selectPower(table, width, getWindow(windows - 1), accumulator);
+    for (size_t index = windows - 1; index-- > 0;) {
+      for (size_t step = 0; step < FixedWindowWidth; ++step) multiply(accumulator, accumulator, accumulator);
+      selectPower(table, width, getWindow(index), selected);
+      multiply(accumulator, selected, accumulator);
+    }
+  }
+
+  /// Raises the base with the windows the variant asks for.
+  /// @param one The neutral element of the multiplication.
+  /// @param table The destination for getPowerTableSize() powers of width words.
+  template<typename Word, typename Multiplication>
+  void raisePower(const Word* base, const Word* one, const uint32_t* exponent, const size_t exponentSize,
+                  const size_t width, const bool isConstantTime, Word* table, Word* accumulator, Word* selected,
+                  const Multiplication& multiply) noexcept {
+    if (isConstantTime) {
+      return raiseWithFixedWindows(base, one, exponent, exponentSize, width, table, accumulator, selected, multiply);
+    }
+    raiseWithSlidingWindows(base, exponent, exponentSize, width, table, accumulator, multiply);
+  }
+
+  /// The odd modulus of Montgomery multiplication, in words.
+  struct MontgomeryModulus {
+    const uint64_t* words;
+    size_t size;
+    /// The negated inverse of the modulus modulo 2^64.
+    uint64_t inverse;
+    /// The 2 n + 1 words of the running product, used when the size is not fixed at compile time.
+    uint64_t* scratch;
+  };
+
+  /// Computes -1 / word modulo 2^64 for the odd word with Newton iterations, each of which doubles the
+  /// number of correct bits, starting from the 3 bits the word is its own inverse to.
+  uint64_t getNegatedInverse(const uint64_t word) noexcept {
+    uint64_t inverse = word;
+    for (int step = 0; step < 5; ++step) inverse *= 2 - word * inverse;
+    return 0 - inverse;
+  }
+
+  /// Writes the value of size words and the top bit, which is below twice the modulus, reduced below the
+  /// modulus: the modulus is subtracted unless that borrows, and the result is picked with a mask.
+  inline void reduceOnce(const uint64_t* value, const uint64_t top, const uint64_t* words, const size_t size,
+                         uint64_t* result) noexcept {
+    uint64_t borrow = 0;
+    for (size_t index = 0; index < size; ++index) {
+      const DoubleWord difference = static_cast<DoubleWord>(value[index]) - words[index] - borrow;
+      result[index] = static_cast<uint64_t>(difference);
+      borrow = static_cast<uint64_t>(difference >> 64) & 1;
+    }
+    const uint64_t mask = 0 - ((top | (borrow ^ 1)) & 1);
+    for (size_t index = 0; index < size; ++index) result[index] = (result[index] & mask) | (value[index] & ~mask);
+  }
+
+  /// Computes left * right / R modulo the modulus for the operands below the modulus. The product may be
+  /// written over either operand.
+  /// @tparam FixedSize The number of words of the modulus, or 0 if it is known only at runtime.
+  template<size_t FixedSize>
+  void multiplyMontgomery(const MontgomeryModulus& modulus, const uint64_t* left, const uint64_t* right,
+                          uint64_t* result) noexcept {
+    const size_t size = FixedSize != 0 ? FixedSize : modulus.size;
+    uint64_t fixed[FixedSize + 2];
+    uint64_t* running = FixedSize != 0 ? fixed : modulus.scratch;
+    std::fill(running, running + size + 2, 0);
+    const uint64_t* words = modulus.words;
+    for (size_t outer = 0; outer < size; ++outer) {
+      DoubleWord carry = 0;
+      for (size_t inner = 0; inner < size; ++inner) {
+        carry += static_cast<DoubleWord>(left[inner]) * right[outer] + running[inner];
+        running[inner] = static_cast<uint64_t>(carry);
+        carry >>= 64;
+      }
+      carry += running[size];
+      running[size] = static_cast<uint64_t>(carry);
+      running[size + 1] = static_cast<uint64_t>(carry >> 64);
+      // The multiple of the modulus that clears the lowest word is added, and the word is shifted out.
+      const uint64_t factor = running[0] * modulus.inverse;
+      carry = (static_cast<DoubleWord>(factor) * words[0] + running[0]) >> 64;
+      for (size_t inner = 1; inner < size; ++inner) {
+        carry += static_cast<DoubleWord>(factor) * words[inner] + running[inner];
+        running[inner - 1] = static_cast<uint64_t>(carry);
+        carry >>= 64;
+      }
+      carry += running[size];
+      running[size - 1] = static_cast<uint64_t>(carry);
+      running[size] = running[size + 1] + static_cast<uint64_t>(carry >> 64);
+    }
+    reduceOnce(running, running[size], words, size, result);
+  }
+
+  /// Computes value * value / R modulo the modulus for the value below the modulus, which the square may
+  /// be written over. The square is computed in full first, with every product of 2 different words taken
+  /// once and doubled, which saves nearly half of the multiplications of the square and a quarter of the
+  /// whole, and it is then reduced word by word.
+  template<size_t FixedSize>
+  void squareMontgomery(const MontgomeryModulus& modulus, const uint64_t* value, uint64_t* result) noexcept {
+    const size_t size = FixedSize != 0 ? FixedSize : modulus.size;
+    uint64_t fixed[2 * FixedSize + 1];
+    uint64_t* square = FixedSize != 0 ? fixed : modulus.scratch;
+    std::fill(square, square + 2 * size, 0);
+    for (size_t outer = 0; outer + 1 < size; ++outer) {
+      DoubleWord carry = 0;
+      for (size_t inner = outer + 1; inner < size; ++inner) {
+        carry += static_cast<DoubleWord>(value[outer]) * value[inner] + square[outer + inner];
+        square[outer + inner] = static_cast<uint64_t>(carry);
+        carry >>= 64;
+      }
+      square[outer + size] = static_cast<uint64_t>(carry);
+    }
+    // The cross products are doubled and the squares of the words added on the diagonal.
+    uint64_t shifted = 0;
+    DoubleWord carry = 0;
+    for (size_t index = 0; index < size; ++index) {
+      const DoubleWord diagonal = static_cast<DoubleWord>(value[index]) * value[index];
+      const uint64_t low = square[2 * index], high = square[2 * index + 1];
+      carry += static_cast<DoubleWord>((low << 1) | shifted) + static_cast<uint64_t>(diagonal);
+      square[2 * index] = static_cast<uint64_t>(carry);
+      carry >>= 64;
+      carry += static_cast<DoubleWord>((high << 1) | (low >> 63)) + static_cast<uint64_t>(diagonal >> 64);
+      square[2 * index + 1] = static_cast<uint64_t>(carry);
+      carry >>= 64;
+      shifted = high >> 63;
+    }
+    // Every step clears the lowest word left with a multiple of the modulus, and the carries out of the top
+    // word of the step are passed on to the next one.
+    const uint64_t* words = modulus.words;
+    uint64_t top = 0;
+    for (size_t outer = 0; outer < size; ++outer) {
+      const uint64_t factor = square[outer] * modulus.inverse;
+      carry = 0;
+      for (size_t inner = 0; inner < size; ++inner) {
+        carry += static_cast<DoubleWord>(factor) * words[inner] + square[outer + inner];
+        square[outer + inner] = static_cast<uint64_t>(carry);
+        carry >>= 64;
+      }
+      carry += static_cast<DoubleWord>(square[outer + size]) + top;
+      square[outer + size] = static_cast<uint64_t>(carry);
+      top = static_cast<uint64_t>(carry >> 64);
+    }
+    reduceOnce(square + size, top, words, size, result);
+  }
+
+  /// Raises the base in Montgomery form and brings the power back.
+  /// @param square R^2 modulo the modulus, which moves the operands into Montgomery form.
+  /// @param base The base, overwritten with its Montgomery form.
+  /// @param unit The words of 1.
+  template<size_t FixedSize>
+  void raiseMontgomery(const MontgomeryModulus& modulus, const uint64_t* square, uint64_t* base, uint64_t* one,
+                       const uint64_t* unit, const uint32_t* exponent, const size_t exponentSize,
+                       const bool isConstantTime, uint64_t* table, uint64_t* accumulator, uint64_t* selected) noexcept {
+    // The windows square the accumulator in place, which is the only time both operands are the same.
+    const auto multiply = [&modulus](const uint64_t* left, const uint64_t* right, uint64_t* product) {
+      if (left == right) return squareMontgomery<FixedSize>(modulus, left, product);
+      multiplyMontgomery<FixedSize>(modulus, left, right, product);
+    };
+    multiply(base, square, base);
+    multiply(unit, square, one);
+    raisePower(base, one, exponent, exponentSize, modulus.size, isConstantTime, table, accumulator, selected, multiply);
+    multiply(accumulator, unit, accumulator);
+  }
+
+  uint64_t powerWordModulo(const uint64_t base, const uint32_t* exponent, const size_t exponentSize,
+                           const uint64_t modulus, const bool isConstantTime) noexcept {
+    if (exponentSize == 0) return 1;
+    uint64_t table[std::max(size_t{1} << (MaximumWindowWidth - 1), FixedWindowPowers)];
+    uint64_t accumulator, selected;
+    if (modulus % 2 != 0) {
+      // R is 2^64, so the Montgomery forms are computed with a single division each.
+      const MontgomeryModulus montgomery{&modulus, 1, getNegatedInverse(modulus), nullptr};
+      const auto multiply = [&montgomery](const uint64_t* left, const uint64_t* right, uint64_t* product) {
+        multiplyMontgomery<1>(montgomery, left, right, product);
+      };
+      const auto converted = static_cast<uint64_t>((static_cast<DoubleWord>(base) << 64) % modulus);
+      const auto one = static_cast<uint64_t>((DoubleWord{1} << 64) % modulus);
+      const uint64_t unit = 1;
+      raisePower(&converted, &one, exponent, exponentSize, 1, isConstantTime, table, &accumulator, &selected, multiply);
+      multiply(&accumulator, &unit, &accumulator);
+      return accumulator;
+    }
+    const auto multiply = [modulus](const uint64_t* left, const uint64_t* right, uint64_t* product) {
+      *product = static_cast<uint64_t>(static_cast<DoubleWord>(*left) * *right % modulus);
+    };
+    const uint64_t one = 1;
+    raisePower(&base, &one, exponent, exponentSize, 1, isConstantTime, table, &accumulator, &selected, multiply);
+    return accumulator;
+  }
+
+  /// Gathers the words from the pool aligned to their size, which the pool does not guarantee on its own.
+  uint64_t* gatherWords(const size_t count) noexcept {
+    size_t space = (count + 1) * sizeof(uint64_t);
+    void* destination = gather(space, GarbageCollectionGeneration::Eden).destination;
+    if (destination == nullptr) return nullptr;
+    return static_cast<uint64_t*>(std::align(alignof(uint64_t), count * sizeof(uint64_t), destination, space));
+  }
+
+  /// Packs the cells into words, padded with zero words up to the given count.
+  void packWords(const uint32_t* cells, const size_t size, uint64_t* words, const size_t count) noexcept {
+    std::fill(words, words + count, 0);
+    for (size_t index = 0; index < size; ++index) {
+      words[index / 2] |= static_cast<uint64_t>(cells[index]) << (index % 2 * 32);
+    }
+  }
+
+  /// Unpacks the given number of cells from the words.
+  void unpackWords(const uint64_t* words, uint32_t* cells, const size_t size) noexcept {
+    for (size_t index = 0; index < size; ++index) cells[index] = static_cast<uint32_t>(words[index / 2] >> (index % 2 * 32));
+  }
+
+  /// Raises the base modulo the odd modulus with Montgomery multiplication, in the current frame of the pool.
+  /// @return False if the pool ran out of memory.
+  bool powerCellsMontgomery(const uint32_t* base, const size_t baseSize, const uint32_t* exponent,
+                            const size_t exponentSize, const uint32_t* modulus, const size_t modulusSize,
+                            uint32_t* result, const bool isConstantTime) noexcept {
+    const size_t size = (modulusSize + 1) / 2, entries = getPowerTableSize(exponent, exponentSize, isConstantTime);
+    // R^2 modulo the modulus moves the operands into Montgomery form with a single multiplication each.
+    const size_t squareSize = 4 * size + 1, quotientSize = squareSize - modulusSize + 1;
+    const GarbageCollected<uint32_t> cells = gatherAlignedCells(squareSize + quotientSize + modulusSize +
+                                                                getDivisionScratchSize(squareSize, modulusSize));
+    uint64_t* words = gatherWords((entries + 9) * size + 1);
+    if (cells.destination == nullptr || words == nullptr) return false;
+    uint32_t* square = cells.destination;
+    uint32_t* quotient = square + squareSize;
+    uint32_t* remainder = quotient + quotientSize;
+    std::fill(square, square + squareSize - 1, 0);
+    square[squareSize - 1] = 1;
+    divideCells(square, squareSize, modulus, modulusSize, quotient, remainder, remainder + modulusSize);
+
+    uint64_t* modulusWords = words;
+    uint64_t* squareWords = modulusWords + size;
+    uint64_t* baseWords = squareWords + size;
+    uint64_t* one = baseWords + size;
+    uint64_t* unit = one + size;
+    uint64_t* accumulator = unit + size;
+    uint64_t* selected = accumulator + size;
+    uint64_t* running = selected + size;
+    uint64_t* table = running + 2 * size + 1;
+    packWords(modulus, modulusSize, modulusWords, size);
+    packWords(remainder, modulusSize, squareWords, size);
+    packWords(base, baseSize, baseWords, size);
+    std::fill(unit, unit + size, 0);
+    unit[0] = 1;
+    const MontgomeryModulus montgomery{modulusWords, size, getNegatedInverse(modulusWords[0]), running};
+    // The moduli of 256, 512, 1024 and 2048 bits run on the kernels unrolled for their size.
+    switch (size) {
+      case 4:
+        raiseMontgomery<4>(montgomery, squareWords, baseWords, one, unit, exponent, exponentSize, isConstantTime,
+                           table, accumulator, selected);
+        break;
+      case 8:
+        raiseMontgomery<8>(montgomery, squareWords, baseWords, one, unit, exponent, exponentSize, isConstantTime,
+                           table, accumulator, selected);
+        break;
+      case 16:
+        raiseMontgomery<16>(montgomery, squareWords, baseWords, one, unit, exponent, exponentSize, isConstantTime,
+                            table, accumulator, selected);
+        break;
+      case 32:
+        raiseMontgomery<32>(montgomery, squareWords, baseWords, one, unit, exponent, exponentSize, isConstantTime,
+                            table, accumulator, selected);
+        break;
+      default:
+        raiseMontgomery<0>(montgomery, squareWords, baseWords, one, unit, exponent, exponentSize, isConstantTime,
+                           table, accumulator, selected);
+    }
+    unpackWords(accumulator, result, modulusSize);
+    return true;
+  }
+
+  /// Raises the base modulo the even modulus, reducing every product with a division, in the current frame
+  /// of the pool.
+  /// @return False if the pool ran out of memory.
+  bool powerCellsByDivision(const uint32_t* base, const size_t baseSize, const uint32_t* exponent,
+                            const size_t exponentSize, const uint32_t* modulus, const size_t size,
+                            uint32_t* result, const bool isConstantTime) noexcept {
+    const size_t entries = getPowerTableSize(exponent, exponentSize, isConstantTime);
+    const size_t multiplicationScratchSize = getMultiplicationScratchSize(size, size);
+    const size_t divisionScratchSize = getDivisionScratchSize(2 * size, size);
+    const GarbageCollected<uint32_t> cells = gatherAlignedCells(3 * size + 1 + multiplicationScratchSize +
+                                                                divisionScratchSize + (entries + 4) * size);
+    if (cells.destination == nullptr) return false;
+    uint32_t* product = cells.destination;
+    uint32_t* quotient = product + 2 * size;
+    uint32_t* multiplicationScratch = quotient + size + 1;
+    uint32_t* divisionScratch = multiplicationScratch + multiplicationScratchSize;
+    uint32_t* paddedBase = divisionScratch + divisionScratchSize;
+    uint32_t* one = paddedBase + size;
+    uint32_t* accumulator = one + size;
+    uint32_t* selected = accumulator + size;
+    uint32_t* table = selected + size;
+    std::copy(base, base + baseSize, paddedBase);
+    std::fill(paddedBase + baseSize, paddedBase + size, 0);
+    std::fill(one, one + size, 0);
+    one[0] = 1;
+    const auto multiply = [&](const uint32_t* left, const uint32_t* right, uint32_t* remainder) {
+      multiplyCells(left, size, right, size, product, multiplicationScratchSize == 0 ? nullptr : multiplicationScratch);
+      divideCells(product, 2 * size, modulus, size, quotient, remainder, divisionScratch);
+    };
+    raisePower(paddedBase, one, exponent, exponentSize, size, isConstantTime, table, accumulator, selected, multiply);
+    std::copy(accumulator, accumulator + size, result);
+    return true;
+  }
+
+  bool powerCellsModulo(const uint32_t* base, const size_t baseSize, const uint32_t* exponent,
+                        const size_t exponentSize, const uint32_t* modulus, const size_t modulusSize,
+                        uint32_t* result, const bool isConstantTime) noexcept {
+    std::fill(result, result + modulusSize, 0);
+    if (exponentSize == 0) {
+      result[0] = 1;
+      return true;
+    }
+    // The temporary cells and words live in their own frame, dropped as a whole once the power is known.
+    split();
+    const bool isRaised = modulus[0] % 2 != 0
+                              ? powerCellsMontgomery(base, baseSize, exponent, exponentSize, modulus, modulusSize,
+                                                     result, isConstantTime)
+                              : powerCellsByDivision(base, baseSize, exponent, exponentSize, modulus, modulusSize,
+                                                     result, isConstantTime);
+    untie();
+    if (!isRaised) raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+    return isRaised;
+  }
+
+  bool invertCellsModulo(const uint32_t* value, const size_t valueSize, const uint32_t* modulus,
+                         const size_t modulusSize, uint32_t* inverse, bool& isInvertible) noexcept {
+    const size_t size = modulusSize;
+    size_t scratchSize = 0;
+    for (size_t divisorSize = 1; divisorSize <= size; ++divisorSize) {
+      scratchSize = std::max(scratchSize, getDivisionScratchSize(size, divisorSize));
+    }
+    // The remainders and the magnitudes of the coefficients rotate through 3 buffers each in their own frame,
+    // so that the memory stays linear in the modulus however many steps the algorithm takes.
+    split();
+    const GarbageCollected<uint32_t> cells = gatherAlignedCells(9 * size + scratchSize);
+    if (cells.destination == nullptr) {
+      untie();
+      raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+      return false;
+    }
+    uint32_t* remainders[3] = {cells.destination, cells.destination + size, cells.destination + 2 * size};
+    uint32_t* coefficients[3] = {cells.destination + 3 * size, cells.destination + 4 * size,
+                                 cells.destination + 5 * size};
+    uint32_t *quotient = cells.destination + 6 * size, *product = quotient + size, *scratch = product + 2 * size;
+    std::copy(modulus, modulus + size, remainders[0]);
+    std::copy(value, value + valueSize, remainders[1]);
+    coefficients[1][0] = 1;
+    size_t remainderSize = size, nextSize = valueSize, coefficientSize = 0, nextCoefficientSize = 1;
+    // The coefficients of the value alternate in sign, so only their magnitudes are kept, and the next one
+    // adds the product of the quotient and the current one to the previous one instead of subtracting it.
+    bool isPositive = false;
+    const auto trimCells = [](const uint32_t* cells, size_t count) {
+      while (count > 0 && cells[count - 1] == 0) --count;
+      return count;
+    };
+    while (nextSize > 0) {
+      divideCells(remainders[0], remainderSize, remainders[1], nextSize, quotient, remainders[2], scratch);
+      const size_t quotientSize = trimCells(quotient, remainderSize - nextSize + 1);
+      multiplyCells(quotient, quotientSize, coefficients[1], nextCoefficientSize, product, nullptr);
+      const size_t productSize = trimCells(product, quotientSize + nextCoefficientSize);
+      // The coefficients never exceed the modulus, so their sums fit into its cells.
+      size_t sumSize = std::max(productSize, coefficientSize);
+      const uint32_t carry = productSize >= coefficientSize
+                                 ? addCells(product, productSize, coefficients[0], coefficientSize, coefficients[2])
+                                 : addCells(coefficients[0], coefficientSize, product, productSize, coefficients[2]);
+      if (carry != 0) coefficients[2][sumSize++] = carry;
+      std::rotate(remainders, remainders + 1, remainders + 3);
+      std::rotate(coefficients, coefficients + 1, coefficients + 3);
+      remainderSize = nextSize;
+      nextSize = trimCells(remainders[1], nextSize);
+      coefficientSize = nextCoefficientSize;
+      nextCoefficientSize = sumSize;
+      isPositive = !isPositive;
+    }
+    isInvertible = remainderSize == 1 && remainders[0][0] == 1;
+    std::fill(inverse, inverse + size, 0);
+    if (isInvertible && isPositive) std::copy(coefficients[0], coefficients[0] + coefficientSize, inverse);
+    else if (isInvertible) subtractCells(modulus, size, coefficients[0], coefficientSize, inverse);
+    untie();
+    return true;
+  }
+}
@@ -0,0 +1,88 @@
+/*+================================================================================================
+  File:        perfect-hash.hh
+
+  Summary:     Internal search for the perfect hash tables of the str.translate() tables and of the
+               constant set and dict literals.
+
+  Notes:       The keys are built into the table with the hash-and-displace method: their hashes are
+               distributed into buckets of a few keys, and the buckets, the largest first while the
+               table is still mostly empty, get the displacements that move all of their keys into
+               free slots at once. A lookup then hashes the key, reads the displacement of its bucket
+               and finds the key in the only slot it may be in. The tables differ in how they map the
+               hashes onto the buckets and the slots and in how they grow when a bucket finds no
+               displacement, which the callers supply.
+
+  Classes:     PerfectHashPlacement
+
+  Functions:   placePerfectHash()
+
+  Available under Apache Licence v2. Mamba Authors (2024)
+=================================================================================================+*/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace mamba {
+  /// The outcome of the search: the displacement of every bucket and the key placed into every slot.
+  struct PerfectHashPlacement {
+    std::vector<uint32_t> displacements;
+    /// The index of the key in every slot, or SIZE_MAX for the slots no key hashes to.
+    std::vector<size_t> slotKeys;
+  };
+
+  /// Finds the displacements of the buckets that place every key into a slot of its own.
+  /// @param keyCount The number of keys, all with distinct hashes.
+  /// @param slotCount The number of slots tried first.
+  /// @param largestDisplacement The number of displacements tried for a bucket before the table grows.
+  /// @param getBucket Gives the bucket of the key at the index.
+  /// @param getSlot Gives the slot of the key at the index, for the displacement and the number of slots.
+  /// @param grow Gives the number of slots tried after the given one failed.
+  template <typename BucketFunction, typename SlotFunction, typename GrowthFunction>
+  PerfectHashPlacement placePerfectHash(const size_t keyCount, const size_t bucketCount, size_t slotCount,
+                                        const uint32_t largestDisplacement, const BucketFunction& getBucket,
+                                        const SlotFunction& getSlot, const GrowthFunction& grow) noexcept {
+    std::vector<std::vector<size_t>> buckets(bucketCount);
+    for (size_t index = 0; index < keyCount; ++index) buckets[getBucket(index)].push_back(index);
+    // The largest buckets are placed first, while the table is still mostly empty.
+    std::vector<size_t> order(bucketCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&buckets](const size_t left, const size_t right) {
+      return buckets[left].size() > buckets[right].size();
+    });
+
+    PerfectHashPlacement placement;
+    std::vector<size_t> slots;
+    for (;; slotCount = grow(slotCount)) {
+      placement.slotKeys.assign(slotCount, SIZE_MAX);
+      placement.displacements.assign(bucketCount, 0);
+      bool isPlaced = true;
+      for (const size_t bucket : order) {
+        if (buckets[bucket].empty()) break;
+        isPlaced = false;
+        for (uint32_t displacement = 1; displacement <= largestDisplacement && !isPlaced; ++displacement) {
+          slots.clear();
+          isPlaced = true;
+          for (const size_t index : buckets[bucket]) {
+            const size_t slot = getSlot(index, displacement, slotCount);
+            if (placement.slotKeys[slot] != SIZE_MAX || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+              isPlaced = false;
+              break;
+            }
+            slots.push_back(slot);
+          }
+          if (!isPlaced) continue;
+          placement.displacements[bucket] = displacement;
+          for (size_t position = 0; position < slots.size(); ++position) {
+            placement.slotKeys[slots[position]] = buckets[bucket][position];
+          }
+        }
+        if (!isPlaced) break;
+      }
+      if (isPlaced) return placement;
+    }
+  }
+}
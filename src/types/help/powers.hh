@@ -0,0 +1,40 @@
+/*+================================================================================================
+  File:        powers.hh
+
+  Summary:     Internal access to the 128-bit approximations of the powers of ten used by the
+               conversions between floats and decimal text. The power 10^q is 5^q times a power
+               of two, so only the mantissa of 5^q is stored, scaled so that its top bit is set
+               and truncated to 128 bits, and the binary exponent is recomputed on the fly.
+
+  Notes:       The table is generated by make-powers.py into powers.cc, which must never be
+               edited by hand. It covers 10^-342, below which every decimal rounds to zero, up
+               to 10^326, the largest power the shortest formatting of doubles needs.
+
+  Constants:   SmallestPowerOfFive, LargestPowerOfFive
+
+  Classes:     PowerOfFive
+
+  Functions:   getPowerOfFive()
+
+  Available under Apache Licence v2. Mamba Authors (2024)
+=================================================================================================+*/
+#pragma once
+
+#include <cstdint>
+
+namespace mamba {
+  constexpr int32_t SmallestPowerOfFive = -342, LargestPowerOfFive = 326;
+
+  /// The 128 bits of the scaled power, the high word first.
+  struct PowerOfFive {
+    uint64_t high, low;
+  };
+
+  extern const PowerOfFive PowersOfFive[];
+
+  /// Looks up the truncated mantissa of 5^q.
+  /// @param exponent The exponent q, between SmallestPowerOfFive and LargestPowerOfFive.
+  inline const PowerOfFive& getPowerOfFive(const int32_t exponent) noexcept {
+    return PowersOfFive[exponent - SmallestPowerOfFive];
+  }
+}
@@ -0,0 +1,133 @@
+/*+================================================================================================
+  File:        probing.hh
+
+  Summary:     Internal helpers for the open-addressing hash tables behind dictionaries and sets,
+               laid out like the Swiss tables of Abseil.
+
+  Notes:       Every slot of a table has a control byte: 0x80 if it is empty, 0xFE if its element was
+               removed, or else the 7 bits of the hash of its element, its tag. The control bytes are
+               kept apart from the slots in groups of 16, which a single SSE2 comparison matches against
+               the tag of the searched hash, so that a lookup reads one cache line of control bytes and
+               then, nearly always, only the single slot whose tag matches. The groups are probed in a
+               triangular sequence, which visits every group of a power-of-2 table once, and a lookup
+               stops at the first group with an empty slot, since an insertion would have used it.
+
+               The hashes of Python values are poorly distributed, the integers hashing to themselves,
+               so they are mixed by a 128-bit multiplication before they pick the group and the tag.
+               SSE2 is part of the x86-64 baseline, so the groups need no dispatch, and the other
+               architectures scan the bytes of a group one by one.
+
+  Classes:     GroupProbe
+
+  Functions:   gatherTable(), matchTag(), matchEmpty(), matchVacancy()
+
+  Available under Apache Licence v2. Mamba Authors (2024)
+=================================================================================================+*/
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "context.hh"
+#include "givers/memory.hh"
+#include "vectorisation.hh"
+
+namespace mamba {
+  /// The number of slots whose control bytes are matched at once.
+  constexpr size_t GroupSize = 16;
+
+  /// The number of slots of the smallest table, a single group.
+  constexpr size_t SmallestSlotCount = GroupSize;
+
+  /// The control byte of the slots that never held an element.
+  constexpr uint8_t EmptyControl = 0x80;
+
+  /// The control byte of the slots whose element was removed, which the lookups probe past.
+  constexpr uint8_t DeletedControl = 0xFE;
+
+  /// Walks the groups of a table in the order the elements of the hash are placed in.
+  class GroupProbe {
+   public:
+    /// Starts the probe at the group the hash picks and gives the tag of the hash.
+    /// @param groupCount The number of groups of the table, a power of 2.
+    GroupProbe(const uint64_t hash, const size_t groupCount) noexcept : mask{groupCount - 1} {
+      __extension__ typedef unsigned __int128 MixedProduct;
+      const MixedProduct product = static_cast<MixedProduct>(hash) * 0x9E3779B97F4A7C15;
+      const auto mixed = static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+      tag = static_cast<uint8_t>(mixed & 0x7F);
+      group = static_cast<size_t>(mixed >> 7) & mask;
+    }
+
+    /// Gives the index of the first slot of the current group.
+    [[nodiscard]] size_t getOffset() const noexcept {
+      return group * GroupSize;
+    }
+
+    [[nodiscard]] uint8_t getTag() const noexcept {
+      return tag;
+    }
+
+    /// Moves on to the next group of the sequence.
+    void next() noexcept {
+      group = (group + ++step) & mask;
+    }
+
+   private:
+    size_t mask, group = 0, step = 0;
+    uint8_t tag = 0;
+  };
+
+  /// Allocates the block of a table, whose control bytes come first. The pool does not align its allocations,
+  /// so the block has room to align the control bytes to a group, which aligns the slots after them as well,
+  /// as the slot count is a multiple of the group size.
+  /// @param size The number of bytes of the table.
+  /// @param block Output set to the allocation, which the table marks once it is replaced.
+  /// @return The aligned start of the table, or nullptr if the pool is exhausted, in which case MemoryError is
+  /// raised.
+  inline std::byte* gatherTable(const size_t size, GarbageCollected<std::byte>& block) noexcept {
+    block = gather(size + GroupSize - 1, GarbageCollectionGeneration::Eden);
+    if (block.destination == nullptr) {
+      raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+      return nullptr;
+    }
+    const auto address = reinterpret_cast<uintptr_t>(block.destination);
+    return reinterpret_cast<std::byte*>((address + GroupSize - 1) & ~(GroupSize - 1));
+  }
+
+  /// Finds the slots of the group whose control bytes equal the byte.
+  /// @param controls The 16 control bytes of the group, aligned to 16 bytes.
+  /// @return The mask with a bit set for every matching slot, the first slot in the lowest bit.
+  inline uint32_t matchControl(const uint8_t* controls, const uint8_t control) noexcept {
+#if defined(MAMBA_X86_64)
+    const __m128i group = _mm_load_si128(reinterpret_cast<const __m128i*>(controls));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(control)))));
+#else
+    uint32_t matches = 0;
+    for (size_t index = 0; index < GroupSize; ++index) matches |= uint32_t{controls[index] == control} << index;
+    return matches;
+#endif
+  }
+
+  /// Finds the slots of the group holding elements with the tag.
+  inline uint32_t matchTag(const uint8_t* controls, const uint8_t tag) noexcept {
+    return matchControl(controls, tag);
+  }
+
+  /// Finds the empty slots of the group, whose presence ends a lookup.
+  inline uint32_t matchEmpty(const uint8_t* controls) noexcept {
+    return matchControl(controls, EmptyControl);
+  }
+
+  /// Finds the slots of the group an insertion can take, the empty and the deleted ones, which are the only
+  /// control bytes with the highest bit set.
+  inline uint32_t matchVacancy(const uint8_t* controls) noexcept {
+#if defined(MAMBA_X86_64)
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(controls))));
+#else
+    uint32_t matches = 0;
+    for (size_t index = 0; index < GroupSize; ++index) matches |= uint32_t{controls[index] >= EmptyControl} << index;
+    return matches;
+#endif
+  }
+}
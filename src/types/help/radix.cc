@@ -0,0 +1,252 @@
+#include "types/help/radix.hh"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <vector>
+
+#include "context.hh"
+#include "givers/memory.hh"
+#include "types/help/arithmetic.hh"
+#include "vectorisation.hh"
+namespace mamba {
+  /// The largest power of ten that fits into a cell, the base of the quadratic conversions.
+  constexpr uint32_t DecimalCellBase = 1000000000;
+  constexpr size_t DecimalCellDigits = 9;
+
+  /// The number of digits parsed at once by the quadratic loop, 2 cells of the base.
+  constexpr size_t DecimalChunkDigits = 2 * DecimalCellDigits;
+
+  /// The cached power of ten 10^(9 * 2^level).
+  struct DecimalPower {
+    const uint32_t* cells;
+    size_t size;
+  };
+
+  /// The powers of ten of the conversions made on this thread, each one the square of the previous one.
+  thread_local std::vector<std::vector<uint32_t>> decimalPowers;
+
+  /// Gives 10^(9 * 2^level), squaring the largest cached power until it is reached.
+  DecimalPower getDecimalPower(const size_t level) noexcept {
+    if (decimalPowers.empty()) decimalPowers.push_back({DecimalCellBase});
+    while (decimalPowers.size() <= level) {
+      const size_t size = decimalPowers.back().size();
+      std::vector<uint32_t> square(2 * size), scratch(getMultiplicationScratchSize(size, size));
+      multiplyCells(decimalPowers.back().data(), size, decimalPowers.back().data(), size, square.data(),
+                    scratch.empty() ? nullptr : scratch.data());
+      while (square.back() == 0) square.pop_back();
+      decimalPowers.push_back(std::move(square));
+    }
+    return {decimalPowers[level].data(), decimalPowers[level].size()};
+  }
+
+  /// Chooses the power of ten that splits the given number of digits in halves.
+  /// @return The level of the largest power 10^(9 * 2^level) with fewer digits than the number.
+  size_t getDecimalSplitLevel(const size_t count) noexcept {
+    size_t level = 0;
+    while (DecimalCellDigits << (level + 1) < count) ++level;
+    return level;
+  }
+
+  size_t getDecimalDigitCapacity(const size_t size) noexcept {
+    // Each cell holds 32 * log10(2) = 9.633 digits, rounded up to 617 / 64.
+    return size * 617 / 64 + 1;
+  }
+
+  size_t getDecimalCellCapacity(const size_t count) noexcept {
+    // Each digit takes log2(10) = 3.3219 bits, rounded up to 1701 / 512.
+    return count * 1701 / 512 / 32 + 2;
+  }
+
+  /// Writes exactly width digits of the magnitude with the quadratic loop, peeling 9 digits at a time.
+  bool writeDecimalChunks(const uint32_t* cells, size_t size, char* destination, const size_t width) noexcept {
+    if (size == 0) {
+      std::memset(destination, '0', width);
+      return true;
+    }
+    split();
+    const GarbageCollected<uint32_t> copy = gatherAlignedCells(size);
+    if (copy.destination == nullptr) {
+      untie();
+      return false;
+    }
+    std::copy(cells, cells + size, copy.destination);
+    char* end = destination + width;
+    while (end > destination) {
+      uint32_t chunk = 0;
+      if (size > 0) {
+        chunk = divideCellsByCell(copy.destination, size, DecimalCellBase, copy.destination);
+        if (copy.destination[size - 1] == 0) --size;
+      }
+      for (size_t index = 0; index < DecimalCellDigits && end > destination; ++index) {
+        *--end = static_cast<char>('0' + chunk % 10);
+        chunk /= 10;
+      }
+    }
+    untie();
+    return true;
+  }
+
+  /// Writes exactly width digits of the magnitude, which is below 10^width, padded with leading zeros.
+  /// @return False if the pool ran out of memory.
+  bool writeDecimalDigits(const uint32_t* cells, size_t size, char* destination, const size_t width) noexcept {
+    while (size > 0 && cells[size - 1] == 0) --size;
+    if (width <= DecimalSplitThreshold || size == 0) return writeDecimalChunks(cells, size, destination, width);
+
+    const size_t lowWidth = DecimalCellDigits << getDecimalSplitLevel(width);
+    const DecimalPower power = getDecimalPower(getDecimalSplitLevel(width));
+    if (size < power.size) {
+      std::memset(destination, '0', width - lowWidth);
+      return writeDecimalDigits(cells, size, destination + width - lowWidth, lowWidth);
+    }
+    // The quotient, the remainder and the scratch of the division share the frame of this level.
+    const size_t quotientSize = size - power.size + 1;
+    const size_t total = quotientSize + power.size + getDivisionScratchSize(size, power.size);
+    split();
+    const GarbageCollected<uint32_t> buffer = gatherAlignedCells(total);
+    bool isWritten = buffer.destination != nullptr;
+    if (isWritten) {
+      uint32_t* quotient = buffer.destination;
+      uint32_t* remainder = quotient + quotientSize;
+      divideCells(cells, size, power.cells, power.size, quotient, remainder, remainder + power.size);
+      isWritten = writeDecimalDigits(quotient, quotientSize, destination, width - lowWidth) &&
+                  writeDecimalDigits(remainder, power.size, destination + width - lowWidth, lowWidth);
+    }
+    untie();
+    return isWritten;
+  }
+
+  size_t formatDecimalCells(const uint32_t* cells, const size_t size, char* destination) noexcept {
+    const size_t width = getDecimalDigitCapacity(size);
+    if (!writeDecimalDigits(cells, size, destination, width)) {
+      raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+      return 0;
+    }
+    size_t leading = 0;
+    while (leading + 1 < width && destination[leading] == '0') ++leading;
+    std::memmove(destination, destination + leading, width - leading);
+    return width - leading;
+  }
+
+#if defined(MAMBA_X86_64)
+  /// Parses 16 digits with SSE2, which every x86-64 processor has, combining the pairs, quadruples and
+  /// octets of digits with multiply-add instructions.
+  uint64_t parseSixteenDigitsSSE2(const char* digits) noexcept {
+    const __m128i values = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(digits)),
+                                        _mm_set1_epi8('0'));
+    // The first digit of every pair is in the low byte of its 16-bit lane.
+    const __m128i pairs = _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(values, _mm_set1_epi16(0xFF)),
+                                                        _mm_set1_epi16(10)), _mm_srli_epi16(values, 8));
+    const __m128i quadruples = _mm_madd_epi16(pairs, _mm_set_epi16(1, 100, 1, 100, 1, 100, 1, 100));
+    const __m128i octets = _mm_madd_epi16(_mm_packs_epi32(quadruples, quadruples),
+                                          _mm_set_epi16(1, 10000, 1, 10000, 1, 10000, 1, 10000));
+    const auto high = static_cast<uint32_t>(_mm_cvtsi128_si32(octets));
+    const auto low = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(octets, 4)));
+    return static_cast<uint64_t>(high) * 100000000 + low;
+  }
+#endif
+
+  /// Parses 8 digits in a general purpose register, combining the pairs, quadruples and octets of digits
+  /// with a multiplication each.
+  uint32_t parseEightDigits(const char* digits) noexcept {
+    uint64_t values;
+    std::memcpy(&values, digits, sizeof(values));
+    if constexpr (std::endian::native == std::endian::big) values = __builtin_bswap64(values);
+    values = (values & 0x0F0F0F0F0F0F0F0F) * 2561 >> 8;
+    values = (values & 0x00FF00FF00FF00FF) * 6553601 >> 16;
+    return static_cast<uint32_t>((values & 0x0000FFFF0000FFFF) * 42949672960001 >> 32);
+  }
+
+  uint64_t parseDecimalWord(const char* digits, const size_t count) noexcept {
+    uint64_t value = 0;
+    size_t index = 0;
+#if defined(MAMBA_X86_64)
+    if (count >= 16) {
+      value = parseSixteenDigitsSSE2(digits);
+      index = 16;
+    }
+#endif
+    for (; index + 8 <= count; index += 8) value = value * 100000000 + parseEightDigits(digits + index);
+    for (; index < count; ++index) value = value * 10 + static_cast<uint64_t>(digits[index] - '0');
+    return value;
+  }
+
+  /// Multiplies the magnitude by the factor and adds the addend in place.
+  /// @return The new size of the magnitude.
+  size_t multiplyAddCell(uint32_t* cells, size_t size, const uint32_t factor, const uint32_t addend) noexcept {
+    uint64_t carry = addend;
+    for (size_t index = 0; index < size; ++index) {
+      carry += static_cast<uint64_t>(cells[index]) * factor;
+      cells[index] = static_cast<uint32_t>(carry);
+      carry >>= 32;
+    }
+    if (carry != 0) cells[size++] = static_cast<uint32_t>(carry);
+    return size;
+  }
+
+  /// Parses the digits with the quadratic loop, 18 digits at a time.
+  /// @return The number of cells written.
+  size_t readDecimalChunks(const char* digits, const size_t count, uint32_t* cells) noexcept {
+    if (count == 0) return 0;
+    // The leading chunk takes the digits left over by the full ones.
+    const size_t head = count - (count - 1) / DecimalChunkDigits * DecimalChunkDigits;
+    const uint64_t first = parseDecimalWord(digits, head);
+    cells[0] = static_cast<uint32_t>(first);
+    cells[1] = static_cast<uint32_t>(first >> 32);
+    size_t size = cells[1] != 0 ? 2 : cells[0] != 0 ? 1 : 0;
+    for (size_t position = head; position < count; position += DecimalChunkDigits) {
+      const uint64_t chunk = parseDecimalWord(digits + position, DecimalChunkDigits);
+      size = multiplyAddCell(cells, size, DecimalCellBase, static_cast<uint32_t>(chunk / DecimalCellBase));
+      size = multiplyAddCell(cells, size, DecimalCellBase, static_cast<uint32_t>(chunk % DecimalCellBase));
+    }
+    return size;
+  }
+
+  /// Parses the digits into the cells, joining the halves of the digits parsed on their own.
+  /// @param size Output set to the number of cells written, without leading zero cells.
+  /// @return False if the pool ran out of memory.
+  bool readDecimalDigits(const char* digits, const size_t count, uint32_t* cells, size_t& size) noexcept {
+    if (count <= DecimalSplitThreshold) {
+      size = readDecimalChunks(digits, count, cells);
+      return true;
+    }
+    const size_t level = getDecimalSplitLevel(count);
+    const size_t lowCount = DecimalCellDigits << level, highCount = count - lowCount;
+    const DecimalPower power = getDecimalPower(level);
+    const size_t highCapacity = getDecimalCellCapacity(highCount);
+    split();
+    const GarbageCollected<uint32_t> halves = gatherAlignedCells(highCapacity + getDecimalCellCapacity(lowCount));
+    size_t highSize = 0, lowSize = 0;
+    bool isRead = halves.destination != nullptr &&
+                  readDecimalDigits(digits, highCount, halves.destination, highSize) &&
+                  readDecimalDigits(digits + highCount, lowCount, halves.destination + highCapacity, lowSize);
+    if (isRead && highSize == 0) {
+      std::copy(halves.destination + highCapacity, halves.destination + highCapacity + lowSize, cells);
+      size = lowSize;
+    } else if (isRead) {
+      size = highSize + power.size;
+      const size_t scratchSize = getMultiplicationScratchSize(highSize, power.size);
+      const GarbageCollected<uint32_t> product = gatherAlignedCells(size + scratchSize);
+      isRead = product.destination != nullptr;
+      if (isRead) {
+        multiplyCells(halves.destination, highSize, power.cells, power.size, product.destination,
+                      scratchSize == 0 ? nullptr : product.destination + size);
+        // The low half is below the power of ten, so it never outgrows the product.
+        (void)accumulateCells(product.destination, size, halves.destination + highCapacity, lowSize);
+        while (size > 0 && product.destination[size - 1] == 0) --size;
+        std::copy(product.destination, product.destination + size, cells);
+      }
+    }
+    untie();
+    return isRead;
+  }
+
+  size_t parseDecimalCells(const char* digits, const size_t count, uint32_t* cells) noexcept {
+    size_t size = 0;
+    if (!readDecimalDigits(digits, count, cells, size)) {
+      raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+      return 0;
+    }
+    return size;
+  }
+}
@@ -0,0 +1,368 @@
+#include "types/help/search.hh"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include "types/String.hh"
+#include "types/help/unicode/graphemes.hh"
+#include "vectorisation.hh"
+namespace mamba {
+  /// How many bytes the candidate filter may waste verifying false candidates per byte it scanned
+  /// before giving up in favour of Two-Way, and the flat allowance on top of that for short scans.
+  constexpr size_t FilterWasteFactor = 4, FilterWasteAllowance = 1024;
+
+  /// Scans the haystack from the start for the candidates of the needle and verifies them.
+  /// @param haystack The pointer to the text to search in.
+  /// @param sizeInBytes The size of the haystack, at least as large as the needle.
+  /// @param pattern The pointer to the needle bytes.
+  /// @param patternSize The size of the needle, at least 1.
+  /// @param resumeAt Output set to the first position that was not checked if the filter gave up.
+  /// @return The position of the first match, or -1 if there is none or the filter gave up.
+  typedef ssize_t (*ForwardFilter)(const char* haystack, size_t sizeInBytes, const char* pattern,
+                                   size_t patternSize, size_t& resumeAt);
+
+  /// Scans the haystack from the end for the candidates of the needle and verifies them.
+  /// @param resumeAt Output set to the number of leading positions left unchecked if the filter gave up.
+  /// @return The position of the last match, or -1 if there is none or the filter gave up.
+  typedef ssize_t (*BackwardFilter)(const char* haystack, size_t sizeInBytes, const char* pattern,
+                                    size_t patternSize, size_t& resumeAt);
+
+  /// Presents a byte array either as is or reversed, so Two-Way can be written once for both directions.
+  template<bool IsReversed> struct ByteView {
+    const unsigned char* bytes;
+    ptrdiff_t size;
+
+    ByteView(const char* data, const size_t sizeInBytes)
+        : bytes{reinterpret_cast<const unsigned char*>(data)}, size{static_cast<ptrdiff_t>(sizeInBytes)} { }
+
+    unsigned char operator[](const ptrdiff_t index) const noexcept {
+      return IsReversed ? bytes[size - 1 - index] : bytes[index];
+    }
+  };
+
+  /// Verifies the candidate whose first and last bytes are known to match the needle.
+  /// @param candidate The pointer to the position in the haystack where the match may begin.
+  /// @param pattern The pointer to the needle bytes.
+  /// @param patternSize The size of the needle.
+  /// @return True if the whole needle matches at the candidate position.
+  inline bool isMiddleMatching(const char* candidate, const char* pattern, const size_t patternSize) noexcept {
+    return patternSize <= 2 || std::memcmp(candidate + 1, pattern + 1, patternSize - 2) == 0;
+  }
+
+  /// Tells if the filter has wasted enough work on false candidates to hand the search over to Two-Way.
+  inline bool isFilterOverBudget(const size_t wastedBytes, const size_t scannedBytes) noexcept {
+    return wastedBytes > scannedBytes * FilterWasteFactor + FilterWasteAllowance;
+  }
+
+  /// The scalar forward filter, used for the tails of the vectorised scans and on hosts without SIMD.
+  /// It relies on memchr() to skip to the occurrences of the first byte.
+  ssize_t filterForwardFrom(const char* haystack, const size_t sizeInBytes, const char* pattern,
+                            const size_t patternSize, size_t start, size_t wastedBytes, size_t& resumeAt) {
+    const size_t lastStart = sizeInBytes - patternSize;
+    while (start <= lastStart) {
+      const void* first = std::memchr(haystack + start, pattern[0], lastStart - start + 1);
+      if (first == nullptr) break;
+      const size_t candidate = static_cast<const char*>(first) - haystack;
+      if (haystack[candidate + patternSize - 1] == pattern[patternSize - 1] &&
+          isMiddleMatching(haystack + candidate, pattern, patternSize)) return static_cast<ssize_t>(candidate);
+      wastedBytes += patternSize;
+      start = candidate + 1;
+      if (isFilterOverBudget(wastedBytes, start)) {
+        resumeAt = start;
+        return -1;
+      }
+    }
+    resumeAt = lastStart + 1;
+    return -1;
+  }
+
+  /// The scalar backward filter, checking the positions below the given bound from the highest.
+  ssize_t filterBackwardFrom(const char* haystack, const size_t sizeInBytes, const char* pattern,
+                             const size_t patternSize, size_t remaining, size_t wastedBytes, size_t& resumeAt) {
+    const size_t positions = sizeInBytes - patternSize + 1;
+    while (remaining > 0) {
+      const size_t candidate = --remaining;
+      if (haystack[candidate] != pattern[0] || haystack[candidate + patternSize - 1] != pattern[patternSize - 1])
+        continue;
+      if (isMiddleMatching(haystack + candidate, pattern, patternSize)) return static_cast<ssize_t>(candidate);
+      wastedBytes += patternSize;
+      if (isFilterOverBudget(wastedBytes, positions - remaining)) {
+        resumeAt = remaining;
+        return -1;
+      }
+    }
+    resumeAt = 0;
+    return -1;
+  }
+
+  ssize_t filterForwardScalar(const char* haystack, const size_t sizeInBytes, const char* pattern,
+                              const size_t patternSize, size_t& resumeAt) {
+    return filterForwardFrom(haystack, sizeInBytes, pattern, patternSize, 0, 0, resumeAt);
+  }
+
+  ssize_t filterBackwardScalar(const char* haystack, const size_t sizeInBytes, const char* pattern,
+                               const size_t patternSize, size_t& resumeAt) {
+    return filterBackwardFrom(haystack, sizeInBytes, pattern, patternSize, sizeInBytes - patternSize + 1, 0,
+                              resumeAt);
+  }
+
+#if defined(MAMBA_X86_64)
+  ssize_t filterForwardSSE2(const char* haystack, const size_t sizeInBytes, const char* pattern,
+                            const size_t patternSize, size_t& resumeAt) {
+    const size_t positions = sizeInBytes - patternSize + 1;
+    const __m128i first = _mm_set1_epi8(pattern[0]), last = _mm_set1_epi8(pattern[patternSize - 1]);
+    size_t start = 0, wastedBytes = 0;
+    for (; start + 16 <= positions; start += 16) {
+      const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + start));
+      const __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + start + patternSize - 1));
+      const __m128i matches = _mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast));
+      auto mask = static_cast<uint32_t>(_mm_movemask_epi8(matches));
+      for (; mask != 0; mask &= mask - 1) {
+        const size_t candidate = start + std::countr_zero(mask);
+        if (isMiddleMatching(haystack + candidate, pattern, patternSize)) return static_cast<ssize_t>(candidate);
+        wastedBytes += patternSize;
+      }
+      if (isFilterOverBudget(wastedBytes, start + 16)) {
+        resumeAt = start + 16;
+        return -1;
+      }
+    }
+    return filterForwardFrom(haystack, sizeInBytes, pattern, patternSize, start, wastedBytes, resumeAt);
+  }
+
+  ssize_t filterBackwardSSE2(const char* haystack, const size_t sizeInBytes, const char* pattern,
+                             const size_t patternSize, size_t& resumeAt) {
+    const size_t positions = sizeInBytes - patternSize + 1;
+    const __m128i first = _mm_set1_epi8(pattern[0]), last = _mm_set1_epi8(pattern[patternSize - 1]);
+    size_t remaining = positions, wastedBytes = 0;
+    for (; remaining >= 16; remaining -= 16) {
+      const size_t base = remaining - 16;
+      const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + base));
+      const __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + base + patternSize - 1));
+      const __m128i matches = _mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast));
+      auto mask = static_cast<uint32_t>(_mm_movemask_epi8(matches));
+      while (mask != 0) {
+        const int lane = 31 - std::countl_zero(mask);
+        const size_t candidate = base + lane;
+        if (isMiddleMatching(haystack + candidate, pattern, patternSize)) return static_cast<ssize_t>(candidate);
+        wastedBytes += patternSize;
+        mask &= ~(1u << lane);
+      }
+      if (isFilterOverBudget(wastedBytes, positions - base)) {
+        resumeAt = base;
+        return -1;
+      }
+    }
+    return filterBackwardFrom(haystack, sizeInBytes, pattern, patternSize, remaining, wastedBytes, resumeAt);
+  }
+#endif
+
+#if defined(MAMBA_AVX2_KERNELS)
+  MAMBA_TARGET_AVX2 ssize_t filterForwardAVX2(const char* haystack, const size_t sizeInBytes, const char* pattern,
+                                              const size_t patternSize, size_t& resumeAt) {
+    const size_t positions = sizeInBytes - patternSize + 1;
+    const __m256i first = _mm256_set1_epi8(pattern[0]), last = _mm256_set1_epi8(pattern[patternSize - 1]);
+    size_t start = 0, wastedBytes = 0;
+    for (; start + 32 <= positions; start += 32) {
+      const __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + start));
+      const __m256i blockLast =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + start + patternSize - 1));
+      const __m256i matches =
+          _mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst), _mm256_cmpeq_epi8(last, blockLast));
+      auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(matches));
+      for (; mask != 0; mask = _blsr_u32(mask)) {
+        const size_t candidate = start + _tzcnt_u32(mask);
+        if (isMiddleMatching(haystack + candidate, pattern, patternSize)) return static_cast<ssize_t>(candidate);
+        wastedBytes += patternSize;
+      }
+      if (isFilterOverBudget(wastedBytes, start + 32)) {
+        resumeAt = start + 32;
+        return -1;
+      }
+    }
+    return filterForwardFrom(haystack, sizeInBytes, pattern, patternSize, start, wastedBytes, resumeAt);
+  }
+
+  MAMBA_TARGET_AVX2 ssize_t filterBackwardAVX2(const char* haystack, const size_t sizeInBytes, const char* pattern,
+                                               const size_t patternSize, size_t& resumeAt) {
+    const size_t positions = sizeInBytes - patternSize + 1;
+    const __m256i first = _mm256_set1_epi8(pattern[0]), last = _mm256_set1_epi8(pattern[patternSize - 1]);
+    size_t remaining = positions, wastedBytes = 0;
+    for (; remaining >= 32; remaining -= 32) {
+      const size_t base = remaining - 32;
+      const __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + base));
+      const __m256i blockLast =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + base + patternSize - 1));
+      const __m256i matches =
+          _mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst), _mm256_cmpeq_epi8(last, blockLast));
+      auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(matches));
+      while (mask != 0) {
+        const unsigned int lane = 31 - _lzcnt_u32(mask);
+        const size_t candidate = base + lane;
+        if (isMiddleMatching(haystack + candidate, pattern, patternSize)) return static_cast<ssize_t>(candidate);
+        wastedBytes += patternSize;
+        mask &= ~(1u << lane);
+      }
+      if (isFilterOverBudget(wastedBytes, positions - base)) {
+        resumeAt = base;
+        return -1;
+      }
+    }
+    return filterBackwardFrom(haystack, sizeInBytes, pattern, patternSize, remaining, wastedBytes, resumeAt);
+  }
+#endif
+
+  /// Picks the widest candidate filter supported by the host. Resolved once on the first search.
+  /// @return The pair of forward and backward filters.
+  std::pair<ForwardFilter, BackwardFilter> selectFilters() noexcept {
+    [[maybe_unused]] const InstructionSet instructionSet = getSupportedInstructionSet();
+#if defined(MAMBA_AVX2_KERNELS)
+    if (instructionSet == InstructionSet::AVX2) return {filterForwardAVX2, filterBackwardAVX2};
+#endif
+#if defined(MAMBA_X86_64)
+    if (instructionSet >= InstructionSet::SSE2) return {filterForwardSSE2, filterBackwardSSE2};
+#endif
+    return {filterForwardScalar, filterBackwardScalar};
+  }
+
+  const std::pair<ForwardFilter, BackwardFilter>& getFilters() noexcept {
+    static const std::pair<ForwardFilter, BackwardFilter> filters = selectFilters();
+    return filters;
+  }
+
+  /// Computes the maximal suffix of the pattern with respect to the byte order, or its inverse.
+  /// @param pattern The pattern to analyse.
+  /// @param isOrderInverted Tells if the inverted order must be used to compare bytes.
+  /// @param period Output set to the period of the maximal suffix.
+  /// @return The index of the last byte before the maximal suffix, -1 if it is the whole pattern.
+  template<bool IsReversed> ptrdiff_t computeMaximalSuffix(const ByteView<IsReversed>& pattern,
+                                                           const bool isOrderInverted, ptrdiff_t& period) {
+    ptrdiff_t suffix = -1, candidate = 0, offset = 1;
+    period = 1;
+    while (candidate + offset < pattern.size) {
+      const unsigned char next = pattern[candidate + offset], current = pattern[suffix + offset];
+      if (next == current) {
+        if (offset != period) ++offset;
+        else {
+          candidate += period;
+          offset = 1;
+        }
+      } else if ((next < current) != isOrderInverted) {
+        candidate += offset;
+        offset = 1;
+        period = candidate - suffix;
+      } else {
+        suffix = candidate;
+        candidate = suffix + 1;
+        offset = period = 1;
+      }
+    }
+    return suffix;
+  }
+
+  template<bool IsReversed> TwoWayFactorisation factorise(const ByteView<IsReversed>& pattern) {
+    ptrdiff_t period, invertedPeriod;
+    const ptrdiff_t suffix = computeMaximalSuffix(pattern, false, period);
+    const ptrdiff_t invertedSuffix = computeMaximalSuffix(pattern, true, invertedPeriod);
+    const ptrdiff_t last = std::max(suffix, invertedSuffix);
+    TwoWayFactorisation factorisation;
+    const ptrdiff_t selectedPeriod = suffix > invertedSuffix ? period : invertedPeriod;
+    factorisation.criticalPosition = last + 1;
+    factorisation.period = selectedPeriod;
+    // The pattern is periodic when its left half reoccurs one period later.
+    factorisation.isPeriodic = last + 1 + selectedPeriod <= pattern.size;
+    for (ptrdiff_t index = 0; factorisation.isPeriodic && index <= last; ++index)
+      factorisation.isPeriodic = pattern[index] == pattern[index + selectedPeriod];
+    return factorisation;
+  }
+
+  /// Searches for the pattern with the Two-Way algorithm, in O(n + m) time and constant space.
+  /// @param text The haystack.
+  /// @param pattern The needle.
+  /// @param factorisation The critical factorisation of the needle for the direction of the views.
+  /// @param from The first position of the view to check.
+  /// @return The position in the view where the match begins, -1 if the pattern is not found.
+  template<bool IsReversed> ssize_t searchTwoWay(const ByteView<IsReversed>& text, const ByteView<IsReversed>& pattern,
+                                                 const TwoWayFactorisation& factorisation, const size_t from) {
+    const ptrdiff_t size = pattern.size, last = static_cast<ptrdiff_t>(factorisation.criticalPosition) - 1;
+    ptrdiff_t position = static_cast<ptrdiff_t>(from);
+    if (factorisation.isPeriodic) {
+      const auto period = static_cast<ptrdiff_t>(factorisation.period);
+      ptrdiff_t memory = -1;
+      while (position + size <= text.size) {
+        ptrdiff_t index = std::max(last, memory) + 1;
+        while (index < size && pattern[index] == text[index + position]) ++index;
+        if (index < size) {
+          position += index - last;
+          memory = -1;
+          continue;
+        }
+        index = last;
+        while (index > memory && pattern[index] == text[index + position]) --index;
+        if (index <= memory) return position;
+        position += period;
+        memory = size - period - 1;
+      }
+    } else {
+      const ptrdiff_t shift = std::max(last + 1, size - last - 1) + 1;
+      while (position + size <= text.size) {
+        ptrdiff_t index = last + 1;
+        while (index < size && pattern[index] == text[index + position]) ++index;
+        if (index < size) {
+          position += index - last;
+          continue;
+        }
+        index = last;
+        while (index >= 0 && pattern[index] == text[index + position]) --index;
+        if (index < 0) return position;
+        position += shift;
+      }
+    }
+    return -1;
+  }
+
+  Needle::Needle(const std::string_view& pattern) noexcept
+      : pattern{pattern.data()}, sizeInBytes{pattern.size()},
+        graphemeCount{countUTF8Graphemes(pattern.data(), pattern.size())} {
+    if (sizeInBytes == 0) return;
+    forward = factorise(ByteView<false>(this->pattern, sizeInBytes));
+    backward = factorise(ByteView<true>(this->pattern, sizeInBytes));
+  }
+
+  Needle::Needle(const char* pattern) noexcept : Needle(std::string_view(pattern)) { }
+
+  Needle::Needle(const String& pattern) noexcept
+      : Needle(std::string_view(pattern.begin(), pattern.end() - pattern.begin())) { }
+
+  size_t Needle::size() const noexcept {
+    return sizeInBytes;
+  }
+
+  size_t Needle::graphemes() const noexcept {
+    return graphemeCount;
+  }
+
+  ssize_t Needle::findIn(const char* haystack, const size_t haystackSize) const noexcept {
+    if (sizeInBytes == 0) return 0;
+    if (sizeInBytes > haystackSize) return -1;
+    size_t resumeAt = 0;
+    const ssize_t match = getFilters().first(haystack, haystackSize, pattern, sizeInBytes, resumeAt);
+    if (match >= 0 || resumeAt > haystackSize - sizeInBytes) return match;
+    return searchTwoWay(ByteView<false>(haystack, haystackSize), ByteView<false>(pattern, sizeInBytes), forward,
+                        resumeAt);
+  }
+
+  ssize_t Needle::rfindIn(const char* haystack, const size_t haystackSize) const noexcept {
+    if (sizeInBytes == 0) return static_cast<ssize_t>(haystackSize);
+    if (sizeInBytes > haystackSize) return -1;
+    size_t resumeAt = 0;
+    const ssize_t match = getFilters().second(haystack, haystackSize, pattern, sizeInBytes, resumeAt);
+    if (match >= 0 || resumeAt == 0) return match;
+    // The reversed views turn the leading unchecked positions into the trailing ones.
+    const size_t lastStart = haystackSize - sizeInBytes;
+    const ssize_t reversedMatch = searchTwoWay(ByteView<true>(haystack, haystackSize),
+                                               ByteView<true>(pattern, sizeInBytes), backward, lastStart + 1 - resumeAt);
+    return reversedMatch < 0 ? -1 : static_cast<ssize_t>(lastStart) - reversedMatch;
+  }
+}
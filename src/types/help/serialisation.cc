@@ -0,0 +1,191 @@
+#include "types/help/serialisation.hh"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include "types/help/arithmetic.hh"
+#include "vectorisation.hh"
+namespace mamba {
+  static_assert(std::endian::native == std::endian::little, "The cells are read as little-endian bytes.");
+
+  /// Copies the bytes in reverse order, combined with the mask by exclusive or, so that the first byte of
+  /// the source lands on the last byte of the destination. The arrays must not overlap.
+  typedef void (*ByteReversalKernel)(const std::byte* source, size_t count, std::byte* destination, uint8_t mask);
+
+  /// The number of bytes below which the scalar loop is called directly, skipping the dispatch.
+  constexpr size_t ByteKernelThreshold = 16;
+
+  void reverseBytesScalar(const std::byte* source, const size_t count, std::byte* destination, const uint8_t mask) {
+    const uint64_t wideMask = 0x0101010101010101ULL * mask;
+    size_t index = 0;
+    for (; index + 8 <= count; index += 8) {
+      uint64_t word;
+      (void)std::memcpy(&word, source + index, sizeof(word));
+      word = __builtin_bswap64(word) ^ wideMask;
+      (void)std::memcpy(destination + count - index - 8, &word, sizeof(word));
+    }
+    for (; index < count; ++index) destination[count - 1 - index] = source[index] ^ std::byte{mask};
+  }
+
+#if defined(MAMBA_X86_64)
+  /// Reverses the 16 bytes of the vector with the instructions of SSE2, which has no byte shuffle.
+  inline __m128i reverseVectorSSE2(__m128i vector) noexcept {
+    vector = _mm_or_si128(_mm_slli_epi16(vector, 8), _mm_srli_epi16(vector, 8));
+    vector = _mm_shufflehi_epi16(_mm_shufflelo_epi16(vector, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+    return _mm_shuffle_epi32(vector, _MM_SHUFFLE(1, 0, 3, 2));
+  }
+
+  void reverseBytesSSE2(const std::byte* source, const size_t count, std::byte* destination, const uint8_t mask) {
+    const __m128i wideMask = _mm_set1_epi8(static_cast<char>(mask));
+    size_t index = 0;
+    for (; index + 16 <= count; index += 16) {
+      const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + index));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + count - index - 16),
+                       _mm_xor_si128(reverseVectorSSE2(bytes), wideMask));
+    }
+    reverseBytesScalar(source + index, count - index, destination, mask);
+  }
+#endif
+
+#if defined(MAMBA_AVX2_KERNELS)
+  MAMBA_TARGET_AVX2 void reverseBytesAVX2(const std::byte* source, const size_t count, std::byte* destination,
+                                          const uint8_t mask) {
+    // The shuffle reverses the bytes inside each 128-bit lane, and the permutation swaps the lanes.
+    const __m256i order = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                           15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    const __m256i wideMask = _mm256_set1_epi8(static_cast<char>(mask));
+    size_t index = 0;
+    for (; index + 32 <= count; index += 32) {
+      const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + index));
+      const __m256i reversed = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(bytes, order), _MM_SHUFFLE(1, 0, 3, 2));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + count - index - 32),
+                          _mm256_xor_si256(reversed, wideMask));
+    }
+    reverseBytesScalar(source + index, count - index, destination, mask);
+  }
+#endif
+
+  /// Picks the widest byte reversal kernel supported by the host.
+  ByteReversalKernel selectByteReversalKernel() noexcept {
+    [[maybe_unused]] const InstructionSet instructionSet = getSupportedInstructionSet();
+#if defined(MAMBA_AVX2_KERNELS)
+    if (instructionSet == InstructionSet::AVX2) return reverseBytesAVX2;
+#endif
+#if defined(MAMBA_X86_64)
+    if (instructionSet >= InstructionSet::SSE2) return reverseBytesSSE2;
+#endif
+    return reverseBytesScalar;
+  }
+
+  void reverseBytes(const std::byte* source, const size_t count, std::byte* destination, const uint8_t mask) noexcept {
+    if (count < ByteKernelThreshold) return reverseBytesScalar(source, count, destination, mask);
+    static const ByteReversalKernel kernel = selectByteReversalKernel();
+    kernel(source, count, destination, mask);
+  }
+
+  /// Copies the bytes in order, combined with the mask by exclusive or. The loop is simple enough for the
+  /// compiler to vectorise it on its own.
+  void copyBytes(const std::byte* source, const size_t count, std::byte* destination, const uint8_t mask) noexcept {
+    if (mask == 0) {
+      if (count > 0) (void)std::memcpy(destination, source, count);
+      return;
+    }
+    for (size_t index = 0; index < count; ++index) destination[index] = source[index] ^ std::byte{mask};
+  }
+
+  /// The byte string being written, addressed by the significance of its bytes rather than their position.
+  struct ByteString {
+    std::byte* bytes;
+    size_t length;
+    bool isBigEndian;
+
+    /// Finds the run of count bytes whose least significant byte is the given one.
+    [[nodiscard]] std::byte* locate(const size_t offset, const size_t count) const noexcept {
+      return isBigEndian ? bytes + length - offset - count : bytes + offset;
+    }
+
+    /// Writes the little-endian bytes from the given significance on, combined with the mask.
+    void place(const size_t offset, const std::byte* source, const size_t count, const uint8_t mask) const noexcept {
+      if (isBigEndian) reverseBytes(source, count, locate(offset, count), mask);
+      else copyBytes(source, count, locate(offset, count), mask);
+    }
+
+    /// Sets the count bytes from the given significance on to the value.
+    void fill(const size_t offset, const size_t count, const uint8_t value) const noexcept {
+      if (count > 0) (void)std::memset(locate(offset, count), value, count);
+    }
+  };
+
+  void writeWordBytes(const uint64_t word, const bool isNegative, std::byte* destination, const size_t length,
+                      const bool isBigEndian) noexcept {
+    const ByteString target{destination, length, isBigEndian};
+    const size_t count = std::min<size_t>(length, sizeof(word));
+    target.fill(count, length - count, isNegative ? 0xFF : 0);
+    if (count == 0) return;
+    // The low bytes are moved to the top of the word, so that the byte swap brings them down in reverse.
+    const uint64_t ordered = isBigEndian ? __builtin_bswap64(word << (64 - 8 * count)) : word;
+    std::byte* bytes = target.locate(0, count);
+    if (count == sizeof(ordered)) {
+      (void)std::memcpy(bytes, &ordered, sizeof(ordered));
+      return;
+    }
+    for (size_t index = 0; index < count; ++index) bytes[index] = static_cast<std::byte>(ordered >> 8 * index);
+  }
+
+  uint64_t readWordBytes(const std::byte* source, const size_t length, const bool isBigEndian,
+                         const bool isSigned) noexcept {
+    if (length == 0) return 0;
+    uint64_t word = 0;
+    if (length == sizeof(word)) {
+      (void)std::memcpy(&word, source, sizeof(word));
+    } else {
+      for (size_t index = 0; index < length; ++index) word |= static_cast<uint64_t>(source[index]) << 8 * index;
+    }
+    if (isBigEndian) word = __builtin_bswap64(word) >> (64 - 8 * length);
+    if (isSigned && length < sizeof(word)) {
+      const unsigned shift = 64 - 8 * length;
+      word = static_cast<uint64_t>(static_cast<int64_t>(word << shift) >> shift);
+    }
+    return word;
+  }
+
+  void writeCellBytes(const uint32_t* cells, const size_t size, const bool isNegative, std::byte* destination,
+                      const size_t length, const bool isBigEndian) noexcept {
+    const ByteString target{destination, length, isBigEndian};
+    const auto* source = reinterpret_cast<const std::byte*>(cells);
+    const size_t count = std::min(size * sizeof(uint32_t), length);
+    target.fill(count, length - count, isNegative ? 0xFF : 0);
+    if (!isNegative) return target.place(0, source, count, 0);
+    // The zero cells at the bottom stay zero, the lowest nonzero cell is negated, and the cells above it
+    // are inverted.
+    size_t lowest = 0;
+    while (cells[lowest] == 0) ++lowest;
+    const size_t offset = lowest * sizeof(uint32_t);
+    target.fill(0, offset, 0);
+    const uint32_t negation = 0 - cells[lowest];
+    const size_t part = std::min(sizeof(negation), count - offset);
+    target.place(offset, reinterpret_cast<const std::byte*>(&negation), part, 0);
+    target.place(offset + part, source + offset + part, count - offset - part, 0xFF);
+  }
+
+  bool readCellBytes(const std::byte* source, const size_t length, const bool isBigEndian, const bool isSigned,
+                     uint32_t* cells) noexcept {
+    const size_t size = getByteCellCapacity(length);
+    if (size == 0) return false;
+    const auto top = static_cast<uint8_t>(source[isBigEndian ? 0 : length - 1]);
+    const bool isNegative = isSigned && (top & 0x80) != 0;
+    // The inverted bytes of a negative value hold its magnitude minus one, and the padding above them
+    // stays zero in both cases.
+    cells[size - 1] = 0;
+    auto* bytes = reinterpret_cast<std::byte*>(cells);
+    const uint8_t mask = isNegative ? 0xFF : 0;
+    if (isBigEndian) reverseBytes(source, length, bytes, mask);
+    else copyBytes(source, length, bytes, mask);
+    if (isNegative) {
+      const uint32_t one = 1;
+      (void)accumulateCells(cells, size, &one, 1);
+    }
+    return isNegative;
+  }
+}
@@ -0,0 +1,65 @@
+#include "sorting.hh"
+
+#include <cstring>
+namespace mamba {
+  /// The number of bytes of a key, each sorted by one counting pass.
+  constexpr size_t KeyBytes = sizeof(uint64_t);
+
+  /// Sorts the keys by their bytes from the lowest in, skipping the bytes every key shares.
+  /// @param scratch The space for count keys, which the passes alternate with.
+  void sortKeysByBytes(uint64_t* keys, const size_t count, uint64_t* scratch) noexcept {
+    // The histograms of all the bytes are taken at once, so the keys are read once more than the passes.
+    size_t histograms[KeyBytes][256] = {};
+    for (size_t index = 0; index < count; ++index) {
+      const uint64_t key = keys[index];
+      for (size_t byte = 0; byte < KeyBytes; ++byte) ++histograms[byte][(key >> (8 * byte)) & 0xFF];
+    }
+    uint64_t* source = keys;
+    uint64_t* destination = scratch;
+    for (size_t byte = 0; byte < KeyBytes; ++byte) {
+      size_t* histogram = histograms[byte];
+      const size_t shift = 8 * byte;
+      if (histogram[(source[0] >> shift) & 0xFF] == count) continue;
+      size_t offset = 0;
+      for (size_t digit = 0; digit < 256; ++digit) {
+        const size_t digitCount = histogram[digit];
+        histogram[digit] = offset;
+        offset += digitCount;
+      }
+      for (size_t index = 0; index < count; ++index) {
+        const uint64_t key = source[index];
+        destination[histogram[(key >> shift) & 0xFF]++] = key;
+      }
+      std::swap(source, destination);
+    }
+    if (source != keys) (void)std::memcpy(keys, source, count * sizeof(uint64_t));
+  }
+
+  void sortIntegersByRadix(int64_t* integers, const size_t count, uint64_t* scratch) noexcept {
+    // Flipping the sign bit orders the two's complement integers as unsigned keys.
+    constexpr uint64_t SignBit = uint64_t{1} << 63;
+    auto* keys = reinterpret_cast<uint64_t*>(integers);
+    for (size_t index = 0; index < count; ++index) keys[index] ^= SignBit;
+    sortKeysByBytes(keys, count, scratch);
+    for (size_t index = 0; index < count; ++index) keys[index] ^= SignBit;
+  }
+
+  void sortFloatsByRadix(double* floats, const size_t count, uint64_t* scratch) noexcept {
+    // The positive floats order like their bits above the negative ones, whose order is reversed by
+    // flipping all of their bits.
+    constexpr uint64_t SignBit = uint64_t{1} << 63;
+    // The bits are copied rather than accessed through pointers of both types, which may not alias.
+    for (size_t index = 0; index < count; ++index) {
+      uint64_t bits;
+      (void)std::memcpy(&bits, floats + index, sizeof(bits));
+      scratch[index] = bits ^ ((0 - (bits >> 63)) | SignBit);
+    }
+    auto* keys = scratch;
+    sortKeysByBytes(keys, count, reinterpret_cast<uint64_t*>(floats));
+    for (size_t index = 0; index < count; ++index) {
+      const uint64_t key = keys[index];
+      const uint64_t bits = key ^ (((key >> 63) - 1) | SignBit);
+      (void)std::memcpy(floats + index, &bits, sizeof(bits));
+    }
+  }
+}
@@ -0,0 +1,378 @@
+/*+================================================================================================
+  File:        sorting.hh
+
+  Summary:     Internal sorting algorithms behind List.sort(): the stable adaptive merge sort of
+               Tim Peters for any ordering, and the radix sorts of the unboxed numbers.
+
+  Notes:       The merge sort finds the runs already in order, reversing the strictly descending
+               ones, extends the short runs to a minimal length with binary insertion, and merges
+               them in the order that keeps the stack of pending runs balanced. When one run keeps
+               winning a merge, it switches to galloping: the next element of the other run is
+               searched for with exponentially growing steps and the whole stretch before it is
+               copied at once, so merging runs that barely interleave takes a logarithmic number
+               of comparisons. Sorted and reversed input, and concatenations of sorted pieces, take
+               linear time. Only the less-than predicate is used, and the elements are moved as
+               trivially copyable values.
+
+               The unboxed integers and floats are mapped to unsigned keys in the same order,
+               flipping the sign bit of the integers and every bit of the negative floats, and
+               sorted by their bytes from the lowest in up to 8 counting passes. The histograms of
+               all the bytes are taken in a single pass, and the bytes every key shares, such as
+               the top ones of small values, are skipped, so a list of 32-bit values takes 4 passes.
+
+  Classes:     StableSort
+
+  Functions:   sortIntegersByRadix(), sortFloatsByRadix()
+
+  Available under Apache Licence v2. Mamba Authors (2024)
+=================================================================================================+*/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace mamba {
+  /// Sorts the integers in ascending order.
+  /// @param scratch The space for count integers.
+  void sortIntegersByRadix(int64_t* integers, size_t count, uint64_t* scratch) noexcept;
+
+  /// Sorts the floats in ascending order, which must be neither NaN nor negative zeros, since the keys
+  /// order them apart from the values they are unordered with or equal to.
+  /// @param scratch The space for count floats.
+  void sortFloatsByRadix(double* floats, size_t count, uint64_t* scratch) noexcept;
+
+  /// Sorts the elements stably by the predicate with the adaptive merge sort.
+  template<typename T, typename Less> class StableSort {
+    static_assert(std::is_trivially_copyable_v<T>, "The elements are moved as plain values.");
+
+   public:
+    /// The number of elements below which the whole array is sorted with binary insertion.
+    static constexpr size_t SmallestMergedSize = 64;
+
+    /// Prepares the sort.
+    /// @param items The elements to sort.
+    /// @param count The number of the elements.
+    /// @param scratch The space for count / 2 elements, or nullptr if there are fewer than
+    /// SmallestMergedSize of them, which are never merged.
+    /// @param isLess The strict weak ordering of the elements.
+    StableSort(T* items, const size_t count, T* scratch, Less isLess) noexcept
+        : items{items}, count{static_cast<ptrdiff_t>(count)}, scratch{scratch}, isLess{isLess} { }
+
+    /// Sorts the elements.
+    void run() noexcept {
+      if (count < 2) return;
+      if (count < static_cast<ptrdiff_t>(SmallestMergedSize)) {
+        insertSorted(0, count, findRun(0, count));
+        return;
+      }
+      const ptrdiff_t minimalRun = getMinimalRun(count);
+      for (ptrdiff_t low = 0; low < count;) {
+        ptrdiff_t length = findRun(low, count);
+        if (length < minimalRun) {
+          const ptrdiff_t extended = std::min(minimalRun, count - low);
+          insertSorted(low, low + extended, low + length);
+          length = extended;
+        }
+        runs[runCount++] = {low, length};
+        collapseRuns();
+        low += length;
+      }
+      while (runCount > 1) {
+        ptrdiff_t index = runCount - 2;
+        if (index > 0 && runs[index - 1].length < runs[index + 1].length) --index;
+        mergeAt(index);
+      }
+    }
+
+   private:
+    /// The number of consecutive wins of a run after which the merge starts galloping.
+    static constexpr ptrdiff_t GallopThreshold = 7;
+
+    /// A sorted run waiting to be merged.
+    struct Run {
+      ptrdiff_t base, length;
+    };
+
+    T* items;
+    ptrdiff_t count;
+    T* scratch;
+    Less isLess;
+    /// The threshold of galloping, which rises when galloping does not pay off and falls when it does.
+    ptrdiff_t minimalGallop = GallopThreshold;
+    /// The pending runs, whose lengths grow at least like the Fibonacci numbers from the top of the
+    /// stack down, so that 85 of them cover any array.
+    Run runs[85];
+    ptrdiff_t runCount = 0;
+
+    /// Picks the length of the runs between 32 and 64 that splits the array into a power of 2 of them, or
+    /// slightly fewer, so that the merges stay balanced.
+    static ptrdiff_t getMinimalRun(ptrdiff_t length) noexcept {
+      ptrdiff_t remainder = 0;
+      for (; length >= static_cast<ptrdiff_t>(SmallestMergedSize); length >>= 1) remainder |= length & 1;
+      return length + remainder;
+    }
+
+    /// Finds the length of the run starting at the position, reversing it if it is strictly descending.
+    ptrdiff_t findRun(const ptrdiff_t low, const ptrdiff_t high) noexcept {
+      ptrdiff_t end = low + 1;
+      if (end == high) return 1;
+      if (isLess(items[end], items[low])) {
+        // The descending runs are strict, so that reversing them keeps the equal elements in order.
+        while (++end < high && isLess(items[end], items[end - 1])) { }
+        std::reverse(items + low, items + end);
+      } else {
+        while (++end < high && !isLess(items[end], items[end - 1])) { }
+      }
+      return end - low;
+    }
+
+    /// Extends the sorted elements from the low to the start position up to the high one, inserting each
+    /// element after the ones equal to it, which are found by binary search.
+    void insertSorted(const ptrdiff_t low, const ptrdiff_t high, ptrdiff_t start) noexcept {
+      for (start = std::max(start, low + 1); start < high; ++start) {
+        const T pivot = items[start];
+        const T* position = std::upper_bound(items + low, items + start, pivot, isLess);
+        std::move_backward(position, static_cast<const T*>(items + start), items + start + 1);
+        items[position - items] = pivot;
+      }
+    }
+
+    /// Merges the runs at the top of the stack until their lengths decrease fast enough, checking the
+    /// top 4 runs rather than 3, which the original formulation missed.
+    void collapseRuns() noexcept {
+      while (runCount > 1) {
+        ptrdiff_t index = runCount - 2;
+        const bool isUnbalanced =
+            (index > 0 && runs[index - 1].length <= runs[index].length + runs[index + 1].length) ||
+            (index > 1 && runs[index - 2].length <= runs[index - 1].length + runs[index].length);
+        if (isUnbalanced) {
+          if (runs[index - 1].length < runs[index + 1].length) --index;
+        } else if (runs[index].length > runs[index + 1].length) {
+          return;
+        }
+        mergeAt(index);
+      }
+    }
+
+    /// Merges the run at the index of the stack with the next one.
+    void mergeAt(const ptrdiff_t index) noexcept {
+      ptrdiff_t firstBase = runs[index].base, firstLength = runs[index].length;
+      const ptrdiff_t secondBase = runs[index + 1].base;
+      ptrdiff_t secondLength = runs[index + 1].length;
+      runs[index].length = firstLength + secondLength;
+      if (index == runCount - 3) runs[index + 1] = runs[index + 2];
+      --runCount;
+
+      // The elements of the first run below the start of the second one, and the elements of the second
+      // run above the end of the first one, are in place already.
+      const ptrdiff_t skipped = gallopRight(items[secondBase], items + firstBase, firstLength, 0);
+      firstBase += skipped;
+      firstLength -= skipped;
+      if (firstLength == 0) return;
+      secondLength = gallopLeft(items[firstBase + firstLength - 1], items + secondBase, secondLength,
+                                secondLength - 1);
+      if (secondLength == 0) return;
+      if (firstLength <= secondLength) mergeLow(firstBase, firstLength, secondBase, secondLength);
+      else mergeHigh(firstBase, firstLength, secondBase, secondLength);
+    }
+
+    /// Finds where the key goes into the sorted elements, before the ones equal to it, searching from the
+    /// hint with exponentially growing steps and then by bisection.
+    ptrdiff_t gallopLeft(const T& key, const T* sorted, const ptrdiff_t length, const ptrdiff_t hint) noexcept {
+      ptrdiff_t lastOffset = 0, offset = 1;
+      if (isLess(sorted[hint], key)) {
+        const ptrdiff_t maximalOffset = length - hint;
+        while (offset < maximalOffset && isLess(sorted[hint + offset], key)) {
+          lastOffset = offset;
+          offset = 2 * offset + 1;
+        }
+        offset = std::min(offset, maximalOffset);
+        lastOffset += hint;
+        offset += hint;
+      } else {
+        const ptrdiff_t maximalOffset = hint + 1;
+        while (offset < maximalOffset && !isLess(sorted[hint - offset], key)) {
+          lastOffset = offset;
+          offset = 2 * offset + 1;
+        }
+        offset = std::min(offset, maximalOffset);
+        const ptrdiff_t previous = lastOffset;
+        lastOffset = hint - offset;
+        offset = hint - previous;
+      }
+      // The key is above the element at the last offset and at most the one at the offset.
+      for (++lastOffset; lastOffset < offset;) {
+        const ptrdiff_t middle = lastOffset + (offset - lastOffset) / 2;
+        if (isLess(sorted[middle], key)) lastOffset = middle + 1;
+        else offset = middle;
+      }
+      return offset;
+    }
+
+    /// Finds where the key goes into the sorted elements, after the ones equal to it, like gallopLeft().
+    ptrdiff_t gallopRight(const T& key, const T* sorted, const ptrdiff_t length, const ptrdiff_t hint) noexcept {
+      ptrdiff_t lastOffset = 0, offset = 1;
+      if (isLess(key, sorted[hint])) {
+        const ptrdiff_t maximalOffset = hint + 1;
+        while (offset < maximalOffset && isLess(key, sorted[hint - offset])) {
+          lastOffset = offset;
+          offset = 2 * offset + 1;
+        }
+        offset = std::min(offset, maximalOffset);
+        const ptrdiff_t previous = lastOffset;
+        lastOffset = hint - offset;
+        offset = hint - previous;
+      } else {
+        const ptrdiff_t maximalOffset = length - hint;
+        while (offset < maximalOffset && !isLess(key, sorted[hint + offset])) {
+          lastOffset = offset;
+          offset = 2 * offset + 1;
+        }
+        offset = std::min(offset, maximalOffset);
+        lastOffset += hint;
+        offset += hint;
+      }
+      for (++lastOffset; lastOffset < offset;) {
+        const ptrdiff_t middle = lastOffset + (offset - lastOffset) / 2;
+        if (isLess(key, sorted[middle])) offset = middle;
+        else lastOffset = middle + 1;
+      }
+      return offset;
+    }
+
+    /// Merges the adjacent runs from the lowest elements up, with the shorter first run copied aside.
+    void mergeLow(const ptrdiff_t firstBase, ptrdiff_t firstLength, ptrdiff_t second, ptrdiff_t secondLength) noexcept {
+      std::copy(items + firstBase, items + firstBase + firstLength, scratch);
+      ptrdiff_t first = 0, destination = firstBase;
+      items[destination++] = items[second++];
+      if (--secondLength == 0 || firstLength == 1) return finishLow(first, firstLength, second, secondLength, destination);
+      ptrdiff_t gallop = minimalGallop;
+      while (true) {
+        ptrdiff_t firstWins = 0, secondWins = 0;
+        // The runs are merged one element at a time until one of them wins often enough to gallop.
+        do {
+          if (isLess(items[second], scratch[first])) {
+            items[destination++] = items[second++];
+            ++secondWins;
+            firstWins = 0;
+            if (--secondLength == 0) goto finished;
+          } else {
+            items[destination++] = scratch[first++];
+            ++firstWins;
+            secondWins = 0;
+            if (--firstLength == 1) goto finished;
+          }
+        } while ((firstWins | secondWins) < gallop);
+        do {
+          firstWins = gallopRight(items[second], scratch + first, firstLength, 0);
+          if (firstWins != 0) {
+            std::copy(scratch + first, scratch + first + firstWins, items + destination);
+            destination += firstWins;
+            first += firstWins;
+            firstLength -= firstWins;
+            if (firstLength <= 1) goto finished;
+          }
+          items[destination++] = items[second++];
+          if (--secondLength == 0) goto finished;
+          secondWins = gallopLeft(scratch[first], items + second, secondLength, 0);
+          if (secondWins != 0) {
+            std::copy(items + second, items + second + secondWins, items + destination);
+            destination += secondWins;
+            second += secondWins;
+            secondLength -= secondWins;
+            if (secondLength == 0) goto finished;
+          }
+          items[destination++] = scratch[first++];
+          if (--firstLength == 1) goto finished;
+          --gallop;
+        } while (firstWins >= GallopThreshold || secondWins >= GallopThreshold);
+        gallop = std::max<ptrdiff_t>(gallop, 0) + 2;
+      }
+    finished:
+      minimalGallop = std::max<ptrdiff_t>(gallop, 1);
+      finishLow(first, firstLength, second, secondLength, destination);
+    }
+
+    /// Places the elements left over by mergeLow(): the last element of the first run goes after the rest
+    /// of the second one, and any other leftover of the first run fills the end.
+    void finishLow(const ptrdiff_t first, const ptrdiff_t firstLength, const ptrdiff_t second,
+                   const ptrdiff_t secondLength, const ptrdiff_t destination) noexcept {
+      if (firstLength == 1) {
+        std::copy(items + second, items + second + secondLength, items + destination);
+        items[destination + secondLength] = scratch[first];
+      } else {
+        std::copy(scratch + first, scratch + first + firstLength, items + destination);
+      }
+    }
+
+    /// Merges the adjacent runs from the highest elements down, with the shorter second run copied aside.
+    void mergeHigh(const ptrdiff_t firstBase, ptrdiff_t firstLength, const ptrdiff_t secondBase,
+                   ptrdiff_t secondLength) noexcept {
+      std::copy(items + secondBase, items + secondBase + secondLength, scratch);
+      ptrdiff_t first = firstBase + firstLength - 1, second = secondLength - 1;
+      ptrdiff_t destination = secondBase + secondLength - 1;
+      items[destination--] = items[first--];
+      if (--firstLength == 0 || secondLength == 1) {
+        return finishHigh(first, firstLength, second, secondLength, destination);
+      }
+      ptrdiff_t gallop = minimalGallop;
+      while (true) {
+        ptrdiff_t firstWins = 0, secondWins = 0;
+        do {
+          if (isLess(scratch[second], items[first])) {
+            items[destination--] = items[first--];
+            ++firstWins;
+            secondWins = 0;
+            if (--firstLength == 0) goto finished;
+          } else {
+            items[destination--] = scratch[second--];
+            ++secondWins;
+            firstWins = 0;
+            if (--secondLength == 1) goto finished;
+          }
+        } while ((firstWins | secondWins) < gallop);
+        do {
+          firstWins = firstLength - gallopRight(scratch[second], items + firstBase, firstLength, firstLength - 1);
+          if (firstWins != 0) {
+            destination -= firstWins;
+            first -= firstWins;
+            firstLength -= firstWins;
+            std::move_backward(items + first + 1, items + first + 1 + firstWins, items + destination + 1 + firstWins);
+            if (firstLength == 0) goto finished;
+          }
+          items[destination--] = scratch[second--];
+          if (--secondLength == 1) goto finished;
+          secondWins = secondLength - gallopLeft(items[first], scratch, secondLength, secondLength - 1);
+          if (secondWins != 0) {
+            destination -= secondWins;
+            second -= secondWins;
+            secondLength -= secondWins;
+            std::copy(scratch + second + 1, scratch + second + 1 + secondWins, items + destination + 1);
+            if (secondLength <= 1) goto finished;
+          }
+          items[destination--] = items[first--];
+          if (--firstLength == 0) goto finished;
+          --gallop;
+        } while (firstWins >= GallopThreshold || secondWins >= GallopThreshold);
+        gallop = std::max<ptrdiff_t>(gallop, 0) + 2;
+      }
+    finished:
+      minimalGallop = std::max<ptrdiff_t>(gallop, 1);
+      finishHigh(first, firstLength, second, secondLength, destination);
+    }
+
+    /// Places the elements left over by mergeHigh(): the first element of the second run goes before the
+    /// rest of the first one, and any other leftover of the second run fills the start.
+    void finishHigh(const ptrdiff_t first, const ptrdiff_t firstLength, const ptrdiff_t second,
+                    const ptrdiff_t secondLength, const ptrdiff_t destination) noexcept {
+      if (secondLength == 1) {
+        std::move_backward(items + first + 1 - firstLength, items + first + 1, items + destination + 1);
+        items[destination - firstLength] = scratch[second];
+      } else {
+        std::copy(scratch, scratch + secondLength, items + destination + 1 - secondLength);
+      }
+    }
+  };
+}
@@ -0,0 +1,373 @@
+#include "types/help/translation.hh"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include "context.hh"
+#include "types/String.hh"
+#include "types/help/builder.hh"
+#include "types/help/perfect-hash.hh"
+#include "unicode/utf8.hh"
+#include "vectorisation.hh"
+namespace mamba {
+  /// The key of the empty slots of the perfect hash table, which is not a valid code point.
+  constexpr uint32_t NoTranslationKey = UINT32_MAX;
+
+  /// The number of displacements tried for a bucket before the table is doubled.
+  constexpr uint32_t LargestTranslationDisplacement = 1U << 12;
+
+  /// Replaces the ASCII bytes of the text with the bytes of the table, copying the other bytes as is.
+  typedef void (*AsciiTranslationKernel)(const char* source, char* destination, size_t sizeInBytes,
+                                         const uint8_t* table);
+
+  /// Mixes the code point with the seed into the well-distributed 32-bit hash.
+  inline uint32_t hashTranslationKey(const uint32_t key, const uint32_t seed) noexcept {
+    uint32_t hash = key * 0x9E3779B1U ^ seed * 0x85EBCA6BU;
+    hash ^= hash >> 16;
+    hash *= 0x7FEB352DU;
+    hash ^= hash >> 15;
+    hash *= 0x846CA68BU;
+    return hash ^ (hash >> 16);
+  }
+
+  void translateAsciiBytesScalar(const char* source, char* destination, const size_t sizeInBytes,
+                                 const uint8_t* table) noexcept {
+    for (size_t offset = 0; offset < sizeInBytes; ++offset) {
+      const auto byte = static_cast<uint8_t>(source[offset]);
+      destination[offset] = static_cast<char>(byte < 0x80 ? table[byte] : byte);
+    }
+  }
+
+#if defined(MAMBA_AVX2_KERNELS)
+  /// Looks up 32 bytes at once: the low nibble of every byte selects the entry in each of the 8 rows
+  /// of 16 entries, and the high nibble selects the row. The bytes beyond ASCII match no row and stay.
+  MAMBA_TARGET_AVX2 void translateAsciiBytesAVX2(const char* source, char* destination, const size_t sizeInBytes,
+                                                 const uint8_t* table) noexcept {
+    __m256i rows[8];
+    for (int row = 0; row < 8; ++row) {
+      rows[row] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table + 16 * row)));
+    }
+    const __m256i nibbleMask = _mm256_set1_epi8(0x0F);
+    size_t offset = 0;
+    for (; offset + 32 <= sizeInBytes; offset += 32) {
+      const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + offset));
+      const __m256i low = _mm256_and_si256(block, nibbleMask);
+      const __m256i high = _mm256_and_si256(_mm256_srli_epi16(block, 4), nibbleMask);
+      __m256i result = block;
+      for (int row = 0; row < 8; ++row) {
+        const __m256i isInRow = _mm256_cmpeq_epi8(high, _mm256_set1_epi8(static_cast<char>(row)));
+        result = _mm256_blendv_epi8(result, _mm256_shuffle_epi8(rows[row], low), isInRow);
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + offset), result);
+    }
+    translateAsciiBytesScalar(source + offset, destination + offset, sizeInBytes - offset, table);
+  }
+#endif
+
+  /// Picks the widest translation kernel supported by the host. SSE2 has no byte shuffle, so the hosts
+  /// without AVX2 use the scalar lookup table.
+  AsciiTranslationKernel selectAsciiTranslationKernel() noexcept {
+    [[maybe_unused]] const InstructionSet instructionSet = getSupportedInstructionSet();
+#if defined(MAMBA_AVX2_KERNELS)
+    if (instructionSet == InstructionSet::AVX2) return translateAsciiBytesAVX2;
+#endif
+    return translateAsciiBytesScalar;
+  }
+
+  AsciiTranslationKernel getAsciiTranslationKernel() noexcept {
+    static const AsciiTranslationKernel kernel = selectAsciiTranslationKernel();
+    return kernel;
+  }
+
+  Translator::Translator(const String& replacementSet, const String& replacementString,
+                         const String& removeSet) noexcept {
+    if (replacementSet.len() != replacementString.len()) {
+      raise(Signal::ValueError, ExceptionReason::InvalidTranslationTable);
+      return;
+    }
+    std::vector<std::pair<uint32_t, TranslationValue>> rules;
+    const char* key = replacementSet.begin();
+    const char* value = replacementString.begin();
+    // The characters are paired by code points, which matches the graphemes whenever the lengths do.
+    while (key < replacementSet.end() && value < replacementString.end()) {
+      int keySize, valueSize;
+      const uint32_t codePoint = decodeTrustedUTF8(key, keySize);
+      (void)decodeTrustedUTF8(value, valueSize);
+      rules.emplace_back(codePoint, TranslationValue{static_cast<uint32_t>(replacements.size()),
+                                                     static_cast<uint32_t>(valueSize)});
+      replacements.append(value, valueSize);
+      key += keySize;
+      value += valueSize;
+    }
+    for (const char* removed = removeSet.begin(); removed < removeSet.end();) {
+      int size;
+      rules.emplace_back(decodeTrustedUTF8(removed, size), TranslationValue{});
+      removed += size;
+    }
+    compile(rules);
+  }
+
+  Translator::Translator(const String* keys, const String* values, const size_t count) noexcept {
+    std::vector<std::pair<uint32_t, TranslationValue>> rules;
+    rules.reserve(count);
+    for (size_t index = 0; index < count; ++index) {
+      int size = 0;
+      const uint32_t codePoint = keys[index].len() == 1 ? decodeTrustedUTF8(keys[index].begin(), size) : 0;
+      if (keys[index].begin() + size != keys[index].end()) {
+        raise(Signal::ValueError, ExceptionReason::InvalidTranslationTable);
+        replacements.clear();
+        return;
+      }
+      const size_t valueSize = values[index].end() - values[index].begin();
+      rules.emplace_back(codePoint, TranslationValue{static_cast<uint32_t>(replacements.size()),
+                                                     static_cast<uint32_t>(valueSize)});
+      replacements.append(values[index].begin(), valueSize);
+    }
+    compile(rules);
+  }
+
+  void Translator::compile(std::vector<std::pair<uint32_t, TranslationValue>>& rules) noexcept {
+    std::stable_sort(rules.begin(), rules.end(), [](const auto& left, const auto& right) {
+      return left.first < right.first;
+    });
+    // Only the last rule of every character counts, as with the repeated keys of a dictionary.
+    size_t unique = 0;
+    for (size_t index = 0; index < rules.size(); ++index) {
+      if (index + 1 < rules.size() && rules[index + 1].first == rules[index].first) continue;
+      rules[unique++] = rules[index];
+    }
+    rules.resize(unique);
+    if (rules.empty()) return;
+
+    const bool isAsciiOnly = std::all_of(rules.begin(), rules.end(), [this](const auto& rule) {
+      return rule.first < 0x80 && rule.second.sizeInBytes == 1 &&
+             static_cast<uint8_t>(replacements[rule.second.offset]) < 0x80;
+    });
+    if (isAsciiOnly) {
+      kind = TranslationKind::AsciiBytes;
+      for (size_t byte = 0; byte < asciiBytes.size(); ++byte) asciiBytes[byte] = static_cast<uint8_t>(byte);
+      for (const auto& [key, value] : rules) asciiBytes[key] = static_cast<uint8_t>(replacements[value.offset]);
+      return;
+    }
+
+    kind = TranslationKind::General;
+    asciiEntries.fill(-1);
+    std::vector<std::pair<uint32_t, int32_t>> hashedRules;
+    values.reserve(rules.size());
+    for (const auto& [key, value] : rules) {
+      const auto entry = static_cast<int32_t>(values.size());
+      values.push_back(value);
+      if (key < 0x80) asciiEntries[key] = entry;
+      else hashedRules.emplace_back(key, entry);
+    }
+    compilePerfectHash(hashedRules);
+  }
+
+  void Translator::compilePerfectHash(const std::vector<std::pair<uint32_t, int32_t>>& entries) noexcept {
+    if (entries.empty()) return;
+    // About 4 keys per bucket and a load factor below 80% keep the search for displacements short.
+    const size_t bucketCount = std::bit_ceil(std::max<size_t>(entries.size() / 4, 1));
+    PerfectHashPlacement placement = placePerfectHash(
+        entries.size(), bucketCount, std::bit_ceil(entries.size() + entries.size() / 4 + 1),
+        LargestTranslationDisplacement,
+        [&entries, bucketCount](const size_t index) {
+          return hashTranslationKey(entries[index].first, 0) & (bucketCount - 1);
+        },
+        [&entries](const size_t index, const uint32_t displacement, const size_t slotCount) {
+          return hashTranslationKey(entries[index].first, displacement) & (slotCount - 1);
+        },
+        [](const size_t slotCount) { return slotCount * 2; });
+    displacements = std::move(placement.displacements);
+    hashedKeys.assign(placement.slotKeys.size(), NoTranslationKey);
+    hashedEntries.assign(placement.slotKeys.size(), -1);
+    for (size_t slot = 0; slot < placement.slotKeys.size(); ++slot) {
+      if (placement.slotKeys[slot] == SIZE_MAX) continue;
+      hashedKeys[slot] = entries[placement.slotKeys[slot]].first;
+      hashedEntries[slot] = entries[placement.slotKeys[slot]].second;
+    }
+  }
+
+  int32_t Translator::findHashedEntry(const uint32_t codePoint) const noexcept {
+    if (hashedKeys.empty()) return -1;
+    const uint32_t displacement = displacements[hashTranslationKey(codePoint, 0) & (displacements.size() - 1)];
+    const size_t slot = hashTranslationKey(codePoint, displacement) & (hashedKeys.size() - 1);
+    return hashedKeys[slot] == codePoint ? hashedEntries[slot] : -1;
+  }
+
+  String Translator::translate(const String& text) const noexcept {
+    const char* source = text.begin();
+    const size_t sizeInBytes = text.end() - source;
+    if (kind == TranslationKind::Identity || sizeInBytes == 0) return text;
+
+    if (kind == TranslationKind::AsciiBytes) {
+      const GarbageCollected<char> buffer = gather(sizeInBytes + 1, GarbageCollectionGeneration::Eden);
+      if (buffer.destination == nullptr) {
+        raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+        return {};
+      }
+      getAsciiTranslationKernel()(source, buffer.destination, sizeInBytes, asciiBytes.data());
+      buffer.destination[sizeInBytes] = '\0';
+      // The ASCII bytes only swap for ASCII bytes, each counted once in the length, so the length stays.
+      return {buffer, sizeInBytes, text.graphemes, text.isOnlyAscii};
+    }
+
+    StringBuilder builder;
+    size_t offset = 0, kept = 0;
+    bool isChanged = false;
+    while (offset < sizeInBytes) {
+      const auto byte = static_cast<uint8_t>(source[offset]);
+      int32_t entry;
+      int size = 1;
+      if (byte < 0x80) entry = asciiEntries[byte];
+      else entry = findHashedEntry(decodeTrustedUTF8(source + offset, size));
+      if (entry < 0) {
+        offset += size;
+        continue;
+      }
+      if (!isChanged) {
+        (void)builder.reserve(sizeInBytes);
+        isChanged = true;
+      }
+      const TranslationValue& value = values[entry];
+      (void)builder.appendUTF8(source + kept, offset - kept).appendUTF8(replacements.data() + value.offset,
+                                                                         value.sizeInBytes);
+      offset += size;
+      kept = offset;
+    }
+    if (!isChanged) return text;
+    // The builder sums the graphemes of the pieces as they are appended.
+    return builder.appendUTF8(source + kept, sizeInBytes - kept).build();
+  }
+
+  ReplacementAutomaton::ReplacementAutomaton(const String* patterns, const String* replacements,
+                                             const size_t count) noexcept {
+    for (size_t index = 0; index < count; ++index) {
+      if (patterns[index].begin() == patterns[index].end()) {
+        raise(Signal::ValueError, ExceptionReason::EmptyReplacementPattern);
+        return;
+      }
+    }
+
+    // The bytes absent from the patterns share the column 0, which keeps the table narrow.
+    for (size_t index = 0; index < count; ++index) {
+      for (const char* byte = patterns[index].begin(); byte < patterns[index].end(); ++byte) {
+        uint16_t& byteClass = byteClasses[static_cast<uint8_t>(*byte)];
+        if (byteClass == 0) byteClass = static_cast<uint16_t>(classCount++);
+      }
+    }
+
+    // The trie of the patterns, with -1 for the missing edges.
+    std::vector<int32_t> edges(classCount, -1);
+    std::vector<int32_t> terminals{-1};
+    depths.assign(1, 0);
+    patternSizes.reserve(count);
+    replacementValues.reserve(count);
+    for (size_t index = 0; index < count; ++index) {
+      uint32_t state = 0;
+      for (const char* byte = patterns[index].begin(); byte < patterns[index].end(); ++byte) {
+        const size_t edge = state * classCount + byteClasses[static_cast<uint8_t>(*byte)];
+        if (edges[edge] < 0) {
+          edges[edge] = static_cast<int32_t>(depths.size());
+          depths.push_back(depths[state] + 1);
+          terminals.push_back(-1);
+          edges.resize(edges.size() + classCount, -1);
+        }
+        state = static_cast<uint32_t>(edges[edge]);
+      }
+      // The later pair with the same pattern wins the terminal state.
+      terminals[state] = static_cast<int32_t>(index);
+      patternSizes.push_back(static_cast<uint32_t>(patterns[index].end() - patterns[index].begin()));
+      const size_t replacementSize = replacements[index].end() - replacements[index].begin();
+      replacementValues.push_back({static_cast<uint32_t>(replacementText.size()), static_cast<uint32_t>(replacementSize)});
+      replacementText.append(replacements[index].begin(), replacementSize);
+    }
+
+    // The breadth-first traversal resolves the failure links into the complete transition table, and
+    // every state inherits the longest match of its failure state, which is always shallower.
+    const size_t stateCount = depths.size();
+    transitions.assign(stateCount * classCount, 0);
+    matches.assign(stateCount, -1);
+    std::vector<uint32_t> failures(stateCount, 0), queue;
+    queue.reserve(stateCount);
+    for (size_t column = 0; column < classCount; ++column) {
+      if (edges[column] < 0) continue;
+      transitions[column] = static_cast<uint32_t>(edges[column]);
+      queue.push_back(transitions[column]);
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+      const uint32_t state = queue[head];
+      matches[state] = terminals[state] >= 0 ? terminals[state] : matches[failures[state]];
+      for (size_t column = 0; column < classCount; ++column) {
+        const uint32_t fallback = transitions[failures[state] * classCount + column];
+        const int32_t next = edges[state * classCount + column];
+        if (next < 0) {
+          transitions[state * classCount + column] = fallback;
+          continue;
+        }
+        failures[next] = fallback;
+        transitions[state * classCount + column] = static_cast<uint32_t>(next);
+        queue.push_back(static_cast<uint32_t>(next));
+      }
+    }
+  }
+
+  String ReplacementAutomaton::replace(const String& text) const noexcept {
+    if (transitions.empty()) return text;
+    const char* source = text.begin();
+    const size_t sizeInBytes = text.end() - source;
+    StringBuilder builder;
+    bool isChanged = false;
+    // The best match found so far is pending until no match starting at or before it can appear.
+    bool isPending = false;
+    size_t pendingStart = 0, written = 0, position = 0;
+    int32_t pendingPattern = -1;
+    uint32_t state = 0;
+
+    const auto considerMatch = [&]() {
+      const int32_t pattern = matches[state];
+      if (pattern < 0) return;
+      const size_t start = position - patternSizes[pattern];
+      if (!isPending || start < pendingStart ||
+          (start == pendingStart && patternSizes[pattern] > patternSizes[pendingPattern])) {
+        isPending = true;
+        pendingStart = start;
+        pendingPattern = pattern;
+      }
+    };
+    const auto commitMatch = [&]() {
+      if (!isChanged) {
+        (void)builder.reserve(sizeInBytes);
+        isChanged = true;
+      }
+      const TranslationValue& value = replacementValues[pendingPattern];
+      (void)builder.appendUTF8(source + written, pendingStart - written)
+          .appendUTF8(replacementText.data() + value.offset, value.sizeInBytes);
+      written = pendingStart + patternSizes[pendingPattern];
+      isPending = false;
+    };
+
+    while (true) {
+      if (position == sizeInBytes) {
+        if (!isPending) break;
+        // The bytes after the last match may still hold more matches.
+        commitMatch();
+        position = written;
+        state = 0;
+        continue;
+      }
+      state = transitions[state * classCount + byteClasses[static_cast<uint8_t>(source[position++])]];
+      considerMatch();
+      // The prefix the automaton is in starts past the pending match, so no better match can appear.
+      // The scan restarts right after the replaced text, since the matches overlapping the pending one
+      // were discarded, and it never reads more than the longest pattern again.
+      if (isPending && position - depths[state] > pendingStart) {
+        commitMatch();
+        position = written;
+        state = 0;
+      }
+    }
+    if (!isChanged) return text;
+    return builder.appendUTF8(source + written, sizeInBytes - written).build();
+  }
+}
@@ -0,0 +1,304 @@
+#include "types/help/unicode/cases.hh"
+
+#include <bit>
+#include <cstdint>
+#include <utility>
+
+#include "types/help/unicode/graphemes.hh"
+#include "database.hh"
+#include "utf8.hh"
+#include "../vectorisation.hh"
+namespace mamba {
+  constexpr uint32_t CapitalSigma = 0x3A3, SmallSigma = 0x3C3, FinalSigma = 0x3C2;
+  constexpr char CaseBit = 0x20;
+
+  /// Converts the ASCII text flipping the case bit of the selected letters.
+  /// @param shouldFlipUpper Tells if the uppercase letters must become lowercase.
+  /// @param shouldFlipLower Tells if the lowercase letters must become uppercase.
+  typedef void (*AsciiCaseKernel)(const char* source, char* destination, size_t sizeInBytes,
+                                  bool shouldFlipUpper, bool shouldFlipLower);
+
+  /// Finds the first ASCII letter whose case would be flipped, with the same selection as above.
+  typedef size_t (*AsciiCaseScanner)(const char* source, size_t sizeInBytes, bool shouldFlipUpper,
+                                     bool shouldFlipLower);
+
+  inline bool isAsciiUpper(const char character) noexcept {
+    return character >= 'A' && character <= 'Z';
+  }
+
+  inline bool isAsciiLower(const char character) noexcept {
+    return character >= 'a' && character <= 'z';
+  }
+
+  inline bool shouldFlip(const char character, const bool shouldFlipUpper, const bool shouldFlipLower) noexcept {
+    return (shouldFlipUpper && isAsciiUpper(character)) || (shouldFlipLower && isAsciiLower(character));
+  }
+
+  void flipAsciiCaseScalar(const char* source, char* destination, const size_t sizeInBytes,
+                           const bool shouldFlipUpper, const bool shouldFlipLower) {
+    for (size_t offset = 0; offset < sizeInBytes; ++offset) {
+      const char character = source[offset];
+      destination[offset] = shouldFlip(character, shouldFlipUpper, shouldFlipLower)
+                            ? static_cast<char>(character ^ CaseBit) : character;
+    }
+  }
+
+  size_t scanAsciiCaseScalar(const char* source, const size_t sizeInBytes, const bool shouldFlipUpper,
+                             const bool shouldFlipLower) {
+    size_t offset = 0;
+    while (offset < sizeInBytes && !shouldFlip(source[offset], shouldFlipUpper, shouldFlipLower)) ++offset;
+    return offset;
+  }
+
+#if defined(MAMBA_X86_64)
+  /// Computes the mask of the letters to flip within 16 ASCII bytes. Since ASCII bytes never have
+  /// their highest bit set, the signed comparisons of SSE2 are safe to use as range checks.
+  inline __m128i selectLettersSSE2(const __m128i block, const __m128i upperSelection,
+                                   const __m128i lowerSelection) noexcept {
+    const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8('A' - 1)),
+                                        _mm_cmplt_epi8(block, _mm_set1_epi8('Z' + 1)));
+    const __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8('a' - 1)),
+                                        _mm_cmplt_epi8(block, _mm_set1_epi8('z' + 1)));
+    return _mm_or_si128(_mm_and_si128(upper, upperSelection), _mm_and_si128(lower, lowerSelection));
+  }
+
+  void flipAsciiCaseSSE2(const char* source, char* destination, const size_t sizeInBytes,
+                         const bool shouldFlipUpper, const bool shouldFlipLower) {
+    const __m128i upperSelection = _mm_set1_epi8(shouldFlipUpper ? CaseBit : 0);
+    const __m128i lowerSelection = _mm_set1_epi8(shouldFlipLower ? CaseBit : 0);
+    size_t offset = 0;
+    for (; offset + 16 <= sizeInBytes; offset += 16) {
+      const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + offset));
+      const __m128i flips = selectLettersSSE2(block, upperSelection, lowerSelection);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + offset), _mm_xor_si128(block, flips));
+    }
+    flipAsciiCaseScalar(source + offset, destination + offset, sizeInBytes - offset, shouldFlipUpper,
+                        shouldFlipLower);
+  }
+
+  size_t scanAsciiCaseSSE2(const char* source, const size_t sizeInBytes, const bool shouldFlipUpper,
+                           const bool shouldFlipLower) {
+    const __m128i upperSelection = _mm_set1_epi8(shouldFlipUpper ? -1 : 0);
+    const __m128i lowerSelection = _mm_set1_epi8(shouldFlipLower ? -1 : 0);
+    size_t offset = 0;
+    for (; offset + 16 <= sizeInBytes; offset += 16) {
+      const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + offset));
+      const auto mask = static_cast<uint32_t>(
+          _mm_movemask_epi8(selectLettersSSE2(block, upperSelection, lowerSelection)));
+      if (mask != 0) return offset + std::countr_zero(mask);
+    }
+    return offset + scanAsciiCaseScalar(source + offset, sizeInBytes - offset, shouldFlipUpper, shouldFlipLower);
+  }
+
+  /// Converts ASCII text into the title case: a letter following another letter becomes lowercase,
+  /// while any other letter becomes uppercase. The mask of letters is shifted by one byte to find
+  /// out which letters follow letters, carrying the last lane over into the next block.
+  void convertAsciiTitleSSE2(const char* source, char* destination, const size_t sizeInBytes) {
+    __m128i carry = _mm_setzero_si128();
+    size_t offset = 0;
+    for (; offset + 16 <= sizeInBytes; offset += 16) {
+      const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + offset));
+      const __m128i upper = selectLettersSSE2(block, _mm_set1_epi8(-1), _mm_setzero_si128());
+      const __m128i lower = selectLettersSSE2(block, _mm_setzero_si128(), _mm_set1_epi8(-1));
+      const __m128i letters = _mm_or_si128(upper, lower);
+      const __m128i followsLetter = _mm_or_si128(_mm_slli_si128(letters, 1), carry);
+      carry = _mm_srli_si128(letters, 15);
+      const __m128i flips = _mm_or_si128(_mm_and_si128(followsLetter, upper), _mm_andnot_si128(followsLetter, lower));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + offset),
+                       _mm_xor_si128(block, _mm_and_si128(flips, _mm_set1_epi8(CaseBit))));
+    }
+    bool isPreviousLetter = offset > 0 && (isAsciiUpper(source[offset - 1]) || isAsciiLower(source[offset - 1]));
+    for (; offset < sizeInBytes; ++offset) {
+      const char character = source[offset];
+      const bool isLetter = isAsciiUpper(character) || isAsciiLower(character);
+      const bool shouldBeFlipped = isPreviousLetter ? isAsciiUpper(character) : isAsciiLower(character);
+      destination[offset] = shouldBeFlipped ? static_cast<char>(character ^ CaseBit) : character;
+      isPreviousLetter = isLetter;
+    }
+  }
+#endif
+
+#if defined(MAMBA_AVX2_KERNELS)
+  MAMBA_TARGET_AVX2 inline __m256i selectLettersAVX2(const __m256i block, const __m256i upperSelection,
+                                                     const __m256i lowerSelection) noexcept {
+    const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8('A' - 1)),
+                                           _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), block));
+    const __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8('a' - 1)),
+                                           _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), block));
+    return _mm256_or_si256(_mm256_and_si256(upper, upperSelection), _mm256_and_si256(lower, lowerSelection));
+  }
+
+  MAMBA_TARGET_AVX2 void flipAsciiCaseAVX2(const char* source, char* destination, const size_t sizeInBytes,
+                                           const bool shouldFlipUpper, const bool shouldFlipLower) {
+    const __m256i upperSelection = _mm256_set1_epi8(shouldFlipUpper ? CaseBit : 0);
+    const __m256i lowerSelection = _mm256_set1_epi8(shouldFlipLower ? CaseBit : 0);
+    size_t offset = 0;
+    for (; offset + 32 <= sizeInBytes; offset += 32) {
+      const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + offset));
+      const __m256i flips = selectLettersAVX2(block, upperSelection, lowerSelection);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + offset), _mm256_xor_si256(block, flips));
+    }
+    flipAsciiCaseSSE2(source + offset, destination + offset, sizeInBytes - offset, shouldFlipUpper, shouldFlipLower);
+  }
+
+  MAMBA_TARGET_AVX2 size_t scanAsciiCaseAVX2(const char* source, const size_t sizeInBytes,
+                                             const bool shouldFlipUpper, const bool shouldFlipLower) {
+    const __m256i upperSelection = _mm256_set1_epi8(shouldFlipUpper ? -1 : 0);
+    const __m256i lowerSelection = _mm256_set1_epi8(shouldFlipLower ? -1 : 0);
+    size_t offset = 0;
+    for (; offset + 32 <= sizeInBytes; offset += 32) {
+      const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + offset));
+      const auto mask = static_cast<uint32_t>(
+          _mm256_movemask_epi8(selectLettersAVX2(block, upperSelection, lowerSelection)));
+      if (mask != 0) return offset + _tzcnt_u32(mask);
+    }
+    return offset + scanAsciiCaseSSE2(source + offset, sizeInBytes - offset, shouldFlipUpper, shouldFlipLower);
+  }
+#endif
+
+  /// Picks the widest ASCII case kernels supported by the host. Resolved once on the first conversion.
+  std::pair<AsciiCaseKernel, AsciiCaseScanner> selectAsciiCaseKernels() noexcept {
+    [[maybe_unused]] const InstructionSet instructionSet = getSupportedInstructionSet();
+#if defined(MAMBA_AVX2_KERNELS)
+    if (instructionSet == InstructionSet::AVX2) return {flipAsciiCaseAVX2, scanAsciiCaseAVX2};
+#endif
+#if defined(MAMBA_X86_64)
+    if (instructionSet >= InstructionSet::SSE2) return {flipAsciiCaseSSE2, scanAsciiCaseSSE2};
+#endif
+    return {flipAsciiCaseScalar, scanAsciiCaseScalar};
+  }
+
+  const std::pair<AsciiCaseKernel, AsciiCaseScanner>& getAsciiCaseKernels() noexcept {
+    static const std::pair<AsciiCaseKernel, AsciiCaseScanner> kernels = selectAsciiCaseKernels();
+    return kernels;
+  }
+
+  size_t findFirstAsciiCaseChange(const char* source, const size_t sizeInBytes,
+                                  const CaseConversion conversion) noexcept {
+    const bool shouldFlipUpper = conversion != CaseConversion::Upper;
+    const bool shouldFlipLower = conversion == CaseConversion::Upper || conversion == CaseConversion::Swap;
+    return getAsciiCaseKernels().second(source, sizeInBytes, shouldFlipUpper, shouldFlipLower);
+  }
+
+  void convertAsciiCase(const char* source, char* destination, const size_t sizeInBytes,
+                        const CaseConversion conversion) noexcept {
+    const AsciiCaseKernel flip = getAsciiCaseKernels().first;
+    switch (conversion) {
+      case CaseConversion::Lower:
+      case CaseConversion::Fold: return flip(source, destination, sizeInBytes, true, false);
+      case CaseConversion::Upper: return flip(source, destination, sizeInBytes, false, true);
+      case CaseConversion::Swap: return flip(source, destination, sizeInBytes, true, true);
+      case CaseConversion::Capitalize:
+        if (sizeInBytes == 0) return;
+        destination[0] = isAsciiLower(source[0]) ? static_cast<char>(source[0] ^ CaseBit) : source[0];
+        return flip(source + 1, destination + 1, sizeInBytes - 1, true, false);
+      case CaseConversion::Title:
+#if defined(MAMBA_X86_64)
+        return convertAsciiTitleSSE2(source, destination, sizeInBytes);
+#else
+        for (size_t offset = 0; offset < sizeInBytes; ++offset) {
+          const char character = source[offset];
+          const bool isPreviousLetter = offset > 0 && (isAsciiUpper(source[offset - 1]) ||
+                                                       isAsciiLower(source[offset - 1]));
+          const bool shouldBeFlipped = isPreviousLetter ? isAsciiUpper(character) : isAsciiLower(character);
+          destination[offset] = shouldBeFlipped ? static_cast<char>(character ^ CaseBit) : character;
+        }
+#endif
+    }
+  }
+
+  /// Tells if the capital sigma at the cursor ends a word and must become the final sigma (ς). It is
+  /// the case when it follows a cased letter and is not followed by one, ignoring case-ignorable
+  /// characters such as apostrophes and combining marks in between.
+  /// @param beginning The pointer to the start of the text.
+  /// @param cursor The pointer to the capital sigma.
+  /// @param ending The pointer past the end of the text.
+  /// @return True if the sigma is final.
+  bool isFinalSigma(const char* beginning, const char* cursor, const char* ending) noexcept {
+    int size;
+    bool isPrecededByCased = false;
+    for (const char* previous = cursor; previous > beginning;) {
+      previous = stepBackTrustedUTF8(previous);
+      const uint32_t flags = getCharacterRecord(decodeTrustedUTF8(previous, size)).flags;
+      if ((flags & CaseIgnorableFlag) != 0) continue;
+      isPrecededByCased = (flags & CasedFlag) != 0;
+      break;
+    }
+    if (!isPrecededByCased) return false;
+    (void)decodeTrustedUTF8(cursor, size);
+    for (const char* next = cursor + size; next < ending; next += size) {
+      const uint32_t flags = getCharacterRecord(decodeTrustedUTF8(next, size)).flags;
+      if ((flags & CaseIgnorableFlag) == 0) return (flags & CasedFlag) == 0;
+    }
+    return true;
+  }
+
+  /// Maps the character into the lower case, taking the final sigma rule into account.
+  inline int mapLowerCase(const uint32_t codePoint, const char* beginning, const char* cursor, const char* ending,
+                          uint32_t* output) noexcept {
+    if (codePoint != CapitalSigma) return mapCase(codePoint, CaseMapping::Lower, output);
+    output[0] = isFinalSigma(beginning, cursor, ending) ? FinalSigma : SmallSigma;
+    return 1;
+  }
+
+  /// Walks the text and hands every converted character over to the consumer, so that measuring
+  /// and writing the conversion share the same logic.
+  /// @param consume The callable taking the original code point, the array of converted code
+  /// points and their count.
+  template<typename Consumer> void walkCaseConversion(const char* source, const size_t sizeInBytes,
+                                                      const CaseConversion conversion, Consumer&& consume) {
+    const char* ending = source + sizeInBytes;
+    bool isPreviousCased = false;
+    uint32_t mapped[3];
+    int size;
+    for (const char* cursor = source; cursor < ending; cursor += size) {
+      const uint32_t codePoint = decodeTrustedUTF8(cursor, size);
+      int count = 1;
+      switch (conversion) {
+        case CaseConversion::Lower: count = mapLowerCase(codePoint, source, cursor, ending, mapped); break;
+        case CaseConversion::Upper: count = mapCase(codePoint, CaseMapping::Upper, mapped); break;
+        case CaseConversion::Fold: count = mapCase(codePoint, CaseMapping::Fold, mapped); break;
+        case CaseConversion::Swap: {
+          const uint32_t flags = getCharacterRecord(codePoint).flags;
+          if ((flags & UppercaseFlag) != 0) count = mapLowerCase(codePoint, source, cursor, ending, mapped);
+          else if ((flags & LowercaseFlag) != 0) count = mapCase(codePoint, CaseMapping::Upper, mapped);
+          else mapped[0] = codePoint;
+          break;
+        }
+        case CaseConversion::Title:
+          count = isPreviousCased ? mapLowerCase(codePoint, source, cursor, ending, mapped)
+                                  : mapCase(codePoint, CaseMapping::Title, mapped);
+          isPreviousCased = (getCharacterRecord(codePoint).flags & CasedFlag) != 0;
+          break;
+        case CaseConversion::Capitalize:
+          count = cursor == source ? mapCase(codePoint, CaseMapping::Title, mapped)
+                                   : mapLowerCase(codePoint, source, cursor, ending, mapped);
+          break;
+      }
+      consume(codePoint, mapped, count);
+    }
+  }
+
+  CaseConversionSummary measureCaseConversion(const char* source, const size_t sizeInBytes,
+                                              const CaseConversion conversion) noexcept {
+    CaseConversionSummary summary;
+    walkCaseConversion(source, sizeInBytes, conversion, [&summary](const uint32_t codePoint, const uint32_t* mapped,
+                                                                   const int count) {
+      summary.isChanged |= count != 1 || mapped[0] != codePoint;
+      summary.graphemes += count;
+      for (int next = 0; next < count; ++next) {
+        summary.sizeInBytes += getSizeOfUTF8Grapheme(mapped[next]);
+        summary.isOnlyAscii &= mapped[next] < 0x80;
+      }
+    });
+    return summary;
+  }
+
+  void writeCaseConversion(const char* source, const size_t sizeInBytes, char* destination,
+                           const CaseConversion conversion) noexcept {
+    walkCaseConversion(source, sizeInBytes, conversion, [&destination](const uint32_t, const uint32_t* mapped,
+                                                                       const int count) {
+      for (int next = 0; next < count; ++next) destination += encodeUTF8(mapped[next], destination);
+    });
+  }
+}
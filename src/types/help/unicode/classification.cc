@@ -0,0 +1,212 @@
+#include "types/help/unicode/graphemes.hh"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "database.hh"
+#include "utf8.hh"
+#include "../vectorisation.hh"
+namespace mamba {
+  constexpr uint32_t PredicateBits = 1 << AsciiBit | 1 << AlphaBit | 1 << AlphaNumericBit | 1 << NumericBit |
+                                     1 << DigitBit | 1 << DecimalBit | 1 << IdentifierBit | 1 << LowerBit |
+                                     1 << UpperBit | 1 << PrintableBit | 1 << SpaceBit | 1 << TitleBit;
+  constexpr uint32_t AlphaNumericFlags = AlphabeticFlag | DecimalFlag | DigitFlag | NumericFlag;
+
+  /// The number of bytes classified one character at a time once a vectorised kernel stops at a
+  /// non-ASCII block, so that the kernel is not restarted after every single multibyte character.
+  constexpr size_t ScalarStride = 32;
+
+  /// Classifies the longest prefix of whole ASCII blocks and folds the result into the state.
+  /// @return The number of bytes classified, a multiple of the block size.
+  typedef size_t (*AsciiClassifier)(const char* data, size_t sizeInBytes, uint32_t& state);
+
+  /// Folds a single character into the state, which is the raw value of StringBitmask.
+  /// @param codePoint The Unicode code point of the character.
+  /// @param state The bitmask of the characters before this one.
+  /// @return The bitmask including this character.
+  uint32_t classifyCharacter(const uint32_t codePoint, uint32_t state) noexcept {
+    const uint32_t flags = getCharacterRecord(codePoint).flags;
+    const bool isFirst = (state & 1 << InitialisedBit) == 0;
+    if (isFirst) state = PredicateBits | 1 << PreviousCharacterIsSpaceBit | 1 << InitialisedBit;
+
+    uint32_t failures = 0;
+    if (codePoint >= 0x80) failures |= 1 << AsciiBit;
+    if ((flags & AlphabeticFlag) == 0) failures |= 1 << AlphaBit;
+    if ((flags & AlphaNumericFlags) == 0) failures |= 1 << AlphaNumericBit;
+    if ((flags & NumericFlag) == 0) failures |= 1 << NumericBit;
+    if ((flags & DigitFlag) == 0) failures |= 1 << DigitBit;
+    if ((flags & DecimalFlag) == 0) failures |= 1 << DecimalBit;
+    if ((flags & (isFirst ? IdentifierStartFlag : IdentifierContinueFlag)) == 0) failures |= 1 << IdentifierBit;
+    if ((flags & PrintableFlag) == 0) failures |= 1 << PrintableBit;
+    if ((flags & SpaceFlag) == 0) failures |= 1 << SpaceBit;
+    if ((flags & (UppercaseFlag | TitlecaseFlag)) != 0) failures |= 1 << LowerBit;
+    if ((flags & (LowercaseFlag | TitlecaseFlag)) != 0) failures |= 1 << UpperBit;
+
+    // A title begins every word with an uppercase or titlecase character, followed by lowercase ones.
+    const bool isPreviousUncased = (state & 1 << PreviousCharacterIsSpaceBit) != 0;
+    if ((flags & (UppercaseFlag | TitlecaseFlag)) != 0) {
+      if (!isPreviousUncased) failures |= 1 << TitleBit;
+    } else if ((flags & LowercaseFlag) != 0) {
+      if (isPreviousUncased) failures |= 1 << TitleBit;
+    } else {
+      return (state & ~failures) | 1 << PreviousCharacterIsSpaceBit;
+    }
+    return (state & ~failures & ~(1u << PreviousCharacterIsSpaceBit)) | 1 << CasedBit;
+  }
+
+  size_t classifyAsciiScalar(const char*, const size_t, uint32_t&) {
+    return 0;
+  }
+
+  /// Folds the failures accumulated over an ASCII run into the state.
+  /// @param failures The bytes-wise OR of the lanes that failed each predicate, already reduced into bits.
+  /// @param isLastCased Tells if the last byte of the run was a letter.
+  uint32_t foldAsciiRun(const uint32_t state, uint32_t failures, const bool hasUpper, const bool hasLower,
+                        const bool isLastCased) noexcept {
+    if (hasUpper) failures |= 1 << LowerBit;
+    if (hasLower) failures |= 1 << UpperBit;
+    uint32_t result = state & ~failures;
+    if (hasUpper || hasLower) result |= 1 << CasedBit;
+    if (isLastCased) result &= ~(1u << PreviousCharacterIsSpaceBit);
+    else result |= 1 << PreviousCharacterIsSpaceBit;
+    return result;
+  }
+
+#if defined(MAMBA_X86_64)
+  /// Selects the lanes within the inclusive range. The signed comparisons are safe on ASCII bytes.
+  inline __m128i selectRangeSSE2(const __m128i block, const char lowest, const char highest) noexcept {
+    return _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(static_cast<char>(lowest - 1))),
+                         _mm_cmplt_epi8(block, _mm_set1_epi8(static_cast<char>(highest + 1))));
+  }
+
+  size_t classifyAsciiSSE2(const char* data, const size_t sizeInBytes, uint32_t& state) {
+    const __m128i ones = _mm_set1_epi8(-1);
+    __m128i notAlpha = _mm_setzero_si128(), notAlphaNumeric = notAlpha, notDigit = notAlpha, notIdentifier = notAlpha,
+            notPrintable = notAlpha, notSpace = notAlpha, anyUpper = notAlpha, anyLower = notAlpha,
+            titleFailures = notAlpha;
+    __m128i carry = (state & 1 << PreviousCharacterIsSpaceBit) != 0 ? _mm_setzero_si128() : _mm_cvtsi32_si128(0xFF);
+    size_t offset = 0;
+    for (; offset + 16 <= sizeInBytes; offset += 16) {
+      const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+      if (_mm_movemask_epi8(block) != 0) break;
+      const __m128i upper = selectRangeSSE2(block, 'A', 'Z'), lower = selectRangeSSE2(block, 'a', 'z');
+      const __m128i alpha = _mm_or_si128(upper, lower), digit = selectRangeSSE2(block, '0', '9');
+      const __m128i alphaNumeric = _mm_or_si128(alpha, digit);
+      const __m128i identifier = _mm_or_si128(alphaNumeric, _mm_cmpeq_epi8(block, _mm_set1_epi8('_')));
+      const __m128i space = _mm_or_si128(selectRangeSSE2(block, '\t', '\r'), selectRangeSSE2(block, '\x1C', ' '));
+      notAlpha = _mm_or_si128(notAlpha, _mm_xor_si128(alpha, ones));
+      notAlphaNumeric = _mm_or_si128(notAlphaNumeric, _mm_xor_si128(alphaNumeric, ones));
+      notDigit = _mm_or_si128(notDigit, _mm_xor_si128(digit, ones));
+      notIdentifier = _mm_or_si128(notIdentifier, _mm_xor_si128(identifier, ones));
+      notPrintable = _mm_or_si128(notPrintable, _mm_xor_si128(selectRangeSSE2(block, ' ', '~'), ones));
+      notSpace = _mm_or_si128(notSpace, _mm_xor_si128(space, ones));
+      anyUpper = _mm_or_si128(anyUpper, upper);
+      anyLower = _mm_or_si128(anyLower, lower);
+      const __m128i followsCased = _mm_or_si128(_mm_slli_si128(alpha, 1), carry);
+      carry = _mm_srli_si128(alpha, 15);
+      titleFailures = _mm_or_si128(titleFailures, _mm_or_si128(_mm_and_si128(upper, followsCased),
+                                                                _mm_andnot_si128(followsCased, lower)));
+    }
+    if (offset == 0) return 0;
+
+    uint32_t failures = 0;
+    if (_mm_movemask_epi8(notAlpha) != 0) failures |= 1 << AlphaBit;
+    if (_mm_movemask_epi8(notAlphaNumeric) != 0) failures |= 1 << AlphaNumericBit;
+    if (_mm_movemask_epi8(notDigit) != 0) failures |= 1 << NumericBit | 1 << DigitBit | 1 << DecimalBit;
+    if (_mm_movemask_epi8(notIdentifier) != 0) failures |= 1 << IdentifierBit;
+    if (_mm_movemask_epi8(notPrintable) != 0) failures |= 1 << PrintableBit;
+    if (_mm_movemask_epi8(notSpace) != 0) failures |= 1 << SpaceBit;
+    if (_mm_movemask_epi8(titleFailures) != 0) failures |= 1 << TitleBit;
+    state = foldAsciiRun(state, failures, _mm_movemask_epi8(anyUpper) != 0, _mm_movemask_epi8(anyLower) != 0,
+                         _mm_cvtsi128_si32(carry) != 0);
+    return offset;
+  }
+#endif
+
+#if defined(MAMBA_AVX2_KERNELS)
+  MAMBA_TARGET_AVX2 inline __m256i selectRangeAVX2(const __m256i block, const char lowest,
+                                                   const char highest) noexcept {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8(static_cast<char>(lowest - 1))),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(highest + 1)), block));
+  }
+
+  MAMBA_TARGET_AVX2 size_t classifyAsciiAVX2(const char* data, const size_t sizeInBytes, uint32_t& state) {
+    const __m256i ones = _mm256_set1_epi8(-1);
+    __m256i notAlpha = _mm256_setzero_si256(), notAlphaNumeric = notAlpha, notDigit = notAlpha,
+            notIdentifier = notAlpha, notPrintable = notAlpha, notSpace = notAlpha, anyUpper = notAlpha,
+            anyLower = notAlpha, titleFailures = notAlpha;
+    // Only the last lane of the previous block matters, as it is shifted into the first lane of the next one.
+    __m256i previousAlpha = (state & 1 << PreviousCharacterIsSpaceBit) != 0 ? _mm256_setzero_si256() : ones;
+    size_t offset = 0;
+    for (; offset + 32 <= sizeInBytes; offset += 32) {
+      const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset));
+      if (_mm256_movemask_epi8(block) != 0) break;
+      const __m256i upper = selectRangeAVX2(block, 'A', 'Z'), lower = selectRangeAVX2(block, 'a', 'z');
+      const __m256i alpha = _mm256_or_si256(upper, lower), digit = selectRangeAVX2(block, '0', '9');
+      const __m256i alphaNumeric = _mm256_or_si256(alpha, digit);
+      const __m256i identifier = _mm256_or_si256(alphaNumeric, _mm256_cmpeq_epi8(block, _mm256_set1_epi8('_')));
+      const __m256i space = _mm256_or_si256(selectRangeAVX2(block, '\t', '\r'), selectRangeAVX2(block, '\x1C', ' '));
+      notAlpha = _mm256_or_si256(notAlpha, _mm256_xor_si256(alpha, ones));
+      notAlphaNumeric = _mm256_or_si256(notAlphaNumeric, _mm256_xor_si256(alphaNumeric, ones));
+      notDigit = _mm256_or_si256(notDigit, _mm256_xor_si256(digit, ones));
+      notIdentifier = _mm256_or_si256(notIdentifier, _mm256_xor_si256(identifier, ones));
+      notPrintable = _mm256_or_si256(notPrintable, _mm256_xor_si256(selectRangeAVX2(block, ' ', '~'), ones));
+      notSpace = _mm256_or_si256(notSpace, _mm256_xor_si256(space, ones));
+      anyUpper = _mm256_or_si256(anyUpper, upper);
+      anyLower = _mm256_or_si256(anyLower, lower);
+      const __m256i followsCased =
+          _mm256_alignr_epi8(alpha, _mm256_permute2x128_si256(previousAlpha, alpha, 0x21), 15);
+      previousAlpha = alpha;
+      titleFailures = _mm256_or_si256(titleFailures, _mm256_or_si256(_mm256_and_si256(upper, followsCased),
+                                                                     _mm256_andnot_si256(followsCased, lower)));
+    }
+    if (offset == 0) return 0;
+
+    uint32_t failures = 0;
+    if (_mm256_movemask_epi8(notAlpha) != 0) failures |= 1 << AlphaBit;
+    if (_mm256_movemask_epi8(notAlphaNumeric) != 0) failures |= 1 << AlphaNumericBit;
+    if (_mm256_movemask_epi8(notDigit) != 0) failures |= 1 << NumericBit | 1 << DigitBit | 1 << DecimalBit;
+    if (_mm256_movemask_epi8(notIdentifier) != 0) failures |= 1 << IdentifierBit;
+    if (_mm256_movemask_epi8(notPrintable) != 0) failures |= 1 << PrintableBit;
+    if (_mm256_movemask_epi8(notSpace) != 0) failures |= 1 << SpaceBit;
+    if (_mm256_movemask_epi8(titleFailures) != 0) failures |= 1 << TitleBit;
+    state = foldAsciiRun(state, failures, _mm256_movemask_epi8(anyUpper) != 0, _mm256_movemask_epi8(anyLower) != 0,
+                         static_cast<uint32_t>(_mm256_movemask_epi8(previousAlpha)) >> 31 != 0);
+    return offset;
+  }
+#endif
+
+  /// Picks the widest ASCII classifier supported by the host. Resolved once on the first classification.
+  AsciiClassifier selectAsciiClassifier() noexcept {
+    [[maybe_unused]] const InstructionSet instructionSet = getSupportedInstructionSet();
+#if defined(MAMBA_AVX2_KERNELS)
+    if (instructionSet == InstructionSet::AVX2) return classifyAsciiAVX2;
+#endif
+#if defined(MAMBA_X86_64)
+    if (instructionSet >= InstructionSet::SSE2) return classifyAsciiSSE2;
+#endif
+    return classifyAsciiScalar;
+  }
+
+  void setBitmaskFlagsForCharacter(const char* character, StringBitmask& flags) {
+    int size;
+    const uint32_t state = static_cast<uint32_t>(flags.to_ulong());
+    flags = StringBitmask(classifyCharacter(decodeTrustedUTF8(character, size), state));
+  }
+
+  StringBitmask classifyUTF8Characters(const char* data, const size_t sizeInBytes) noexcept {
+    static const AsciiClassifier classifyAscii = selectAsciiClassifier();
+    if (sizeInBytes == 0) return {1 << AsciiBit | 1 << PrintableBit | 1 << InitialisedBit};
+
+    // The first character is classified alone, since it is the only one that must start an identifier.
+    int size;
+    uint32_t state = classifyCharacter(decodeTrustedUTF8(data, size), 0);
+    size_t offset = size;
+    while (offset < sizeInBytes) {
+      offset += classifyAscii(data + offset, sizeInBytes - offset, state);
+      const size_t stop = std::min(offset + ScalarStride, sizeInBytes);
+      for (; offset < stop; offset += size) state = classifyCharacter(decodeTrustedUTF8(data + offset, size), state);
+    }
+    return {state};
+  }
+}
@@ -0,0 +1,811 @@
+#include "types/help/unicode/conversions.hh"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <sys/types.h>
+#include <type_traits>
+
+#include "context.hh"
+#include "types/help/unicode/graphemes.hh"
+#include "decoding.hh"
+#include "utf8.hh"
+#include "../vectorisation.hh"
+namespace mamba {
+  constexpr char ReplacementCharacter[] = "\xEF\xBF\xBD";
+  constexpr char HexadecimalDigits[] = "0123456789abcdef";
+
+  /// The number of input bytes transcoded one character at a time once a vectorised kernel stops,
+  /// so that the kernel is not restarted after every single character it cannot handle.
+  constexpr size_t TranscodingScalarStride = 64;
+
+  /// The vectorised kernels behind the transcoders. Each of them processes the longest prefix made of
+  /// whole blocks that it can handle and returns the number of input bytes it consumed, leaving the rest
+  /// to the scalar code. The UTF-16 and UTF-32 kernels take the byte order of their code units.
+  struct TranscodingKernels {
+    size_t (*findNonAscii)(const char* source, size_t sizeInBytes);
+    size_t (*countSupplementaryLeads)(const char* source, size_t sizeInBytes);
+    size_t (*widenAsciiIntoUTF16)(const char* source, size_t sizeInBytes, char* destination);
+    size_t (*widenAsciiIntoUTF32)(const char* source, size_t sizeInBytes, char* destination);
+    size_t (*narrowAsciiFromUTF16)(const char* source, size_t sizeInBytes, bool isBigEndian, char* destination);
+    size_t (*narrowAsciiFromUTF32)(const char* source, size_t sizeInBytes, bool isBigEndian, char* destination);
+    size_t (*measureUTF16)(const char* source, size_t sizeInBytes, bool isBigEndian, size_t& outputSize);
+    size_t (*measureUTF32)(const char* source, size_t sizeInBytes, bool isBigEndian, size_t& outputSize);
+  };
+
+  /// The character decoded from the input, or the invalid sequence that must be substituted.
+  struct DecodedCharacter {
+    uint32_t codePoint;
+    int size;
+    bool isValid;
+  };
+
+  inline bool isContinuationByte(const unsigned char byte) noexcept {
+    return (byte & 0xC0) == 0x80;
+  }
+
+  inline bool isSurrogate(const uint32_t codePoint) noexcept {
+    return (codePoint & 0xFFFFF800) == 0xD800;
+  }
+
+  inline uint16_t readUTF16Unit(const unsigned char* source, const bool isBigEndian) noexcept {
+    return isBigEndian ? static_cast<uint16_t>(source[0] << 8 | source[1])
+                       : static_cast<uint16_t>(source[1] << 8 | source[0]);
+  }
+
+  inline uint32_t readUTF32Unit(const unsigned char* source, const bool isBigEndian) noexcept {
+    uint32_t unit;
+    (void)std::memcpy(&unit, source, sizeof(unit));
+    return isBigEndian == (std::endian::native == std::endian::big) ? unit : __builtin_bswap32(unit);
+  }
+
+  inline void writeUTF16Unit(char* destination, const uint32_t unit) noexcept {
+    destination[0] = static_cast<char>(unit & 0xFF);
+    destination[1] = static_cast<char>(unit >> 8);
+  }
+
+  inline void writeUTF32Unit(char* destination, const uint32_t unit) noexcept {
+    for (int byte = 0; byte < 4; ++byte) destination[byte] = static_cast<char>(unit >> (8 * byte));
+  }
+
+  /// Decodes the UTF-8 sequence. Invalid sequences span their maximal subpart as recommended by Unicode,
+  /// which is the longest prefix that could begin a valid sequence, or a single byte if there is none.
+  DecodedCharacter decodeUTF8Character(const unsigned char* source, const size_t remaining, bool) noexcept {
+    const unsigned char lead = source[0];
+    if (lead < 0x80) return {lead, 1, true};
+    if (lead < 0xC2 || lead > 0xF4) return {0, 1, false};
+    if (lead < 0xE0) {
+      if (remaining < 2 || !isContinuationByte(source[1])) return {0, 1, false};
+      return {(lead & 0x1Fu) << 6 | (source[1] & 0x3Fu), 2, true};
+    }
+    // The second byte excludes the overlong encodings, the surrogates and the code points beyond U+10FFFF.
+    const unsigned char lowest = lead == 0xE0 ? 0xA0 : lead == 0xF0 ? 0x90 : 0x80;
+    const unsigned char highest = lead == 0xED ? 0x9F : lead == 0xF4 ? 0x8F : 0xBF;
+    if (remaining < 2 || source[1] < lowest || source[1] > highest) return {0, 1, false};
+    if (remaining < 3 || !isContinuationByte(source[2])) return {0, 2, false};
+    if (lead < 0xF0) return {(lead & 0x0Fu) << 12 | (source[1] & 0x3Fu) << 6 | (source[2] & 0x3Fu), 3, true};
+    if (remaining < 4 || !isContinuationByte(source[3])) return {0, 3, false};
+    return {(lead & 0x07u) << 18 | (source[1] & 0x3Fu) << 12 | (source[2] & 0x3Fu) << 6 | (source[3] & 0x3Fu), 4, true};
+  }
+
+  DecodedCharacter decodeUTF16Character(const unsigned char* source, const size_t remaining,
+                                        const bool isBigEndian) noexcept {
+    if (remaining < 2) return {0, static_cast<int>(remaining), false};
+    const uint16_t unit = readUTF16Unit(source, isBigEndian);
+    if (!isSurrogate(unit)) return {unit, 2, true};
+    if (unit >= 0xDC00) return {0, 2, false};
+    if (remaining < 4) return {0, static_cast<int>(remaining), false};
+    const uint16_t low = readUTF16Unit(source + 2, isBigEndian);
+    if (low < 0xDC00 || low > 0xDFFF) return {0, 2, false};
+    return {0x10000 + ((unit - 0xD800u) << 10 | (low - 0xDC00u)), 4, true};
+  }
+
+  DecodedCharacter decodeUTF32Character(const unsigned char* source, const size_t remaining,
+                                        const bool isBigEndian) noexcept {
+    if (remaining < 4) return {0, static_cast<int>(remaining), false};
+    const uint32_t unit = readUTF32Unit(source, isBigEndian);
+    return {unit, 4, unit <= 0x10FFFF && !isSurrogate(unit)};
+  }
+
+  /// Substitutes the invalid sequence met while decoding as the policy prescribes.
+  /// @param bytes The invalid sequence.
+  /// @param size The number of bytes in the invalid sequence.
+  /// @param destination The buffer receiving the substitute, or nullptr to only measure it.
+  /// @return The size of the substitute in bytes, or -1 if the policy does not allow substituting.
+  ssize_t substituteDecodingError(const StringEncodingPolicy policy, const unsigned char* bytes, const int size,
+                                  char* destination) noexcept {
+    switch (policy) {
+      case StringEncodingPolicy::Ignore: return 0;
+      case StringEncodingPolicy::Replace:
+        if (destination != nullptr) (void)std::memcpy(destination, ReplacementCharacter, 3);
+        return 3;
+      case StringEncodingPolicy::BackslashReplace:
+        for (int byte = 0; destination != nullptr && byte < size; ++byte) {
+          char* escape = destination + 4 * byte;
+          escape[0] = '\\';
+          escape[1] = 'x';
+          escape[2] = HexadecimalDigits[bytes[byte] >> 4];
+          escape[3] = HexadecimalDigits[bytes[byte] & 0xF];
+        }
+        return 4 * size;
+      default: return -1;
+    }
+  }
+
+  /// Substitutes the character that ASCII cannot represent as the policy prescribes.
+  /// @param codePoint The Unicode code point of the character.
+  /// @param destination The buffer receiving the substitute, or nullptr to only measure it.
+  /// @return The size of the substitute in bytes, or -1 if the policy does not allow substituting.
+  ssize_t substituteEncodingError(const StringEncodingPolicy policy, const uint32_t codePoint,
+                                  char* destination) noexcept {
+    switch (policy) {
+      case StringEncodingPolicy::Ignore: return 0;
+      case StringEncodingPolicy::Replace:
+        if (destination != nullptr) destination[0] = '?';
+        return 1;
+      case StringEncodingPolicy::BackslashReplace:
+      case StringEncodingPolicy::NameReplace: {
+        const int digits = codePoint < 0x100 ? 2 : codePoint < 0x10000 ? 4 : 8;
+        if (destination != nullptr) {
+          destination[0] = '\\';
+          destination[1] = digits == 2 ? 'x' : digits == 4 ? 'u' : 'U';
+          for (int digit = 0; digit < digits; ++digit)
+            destination[2 + digit] = HexadecimalDigits[(codePoint >> (4 * (digits - 1 - digit))) & 0xF];
+        }
+        return 2 + digits;
+      }
+      case StringEncodingPolicy::XMLCharRefReplace: {
+        int digits = 1;
+        for (uint32_t remainder = codePoint / 10; remainder != 0; remainder /= 10) ++digits;
+        if (destination != nullptr) {
+          destination[0] = '&';
+          destination[1] = '#';
+          uint32_t remainder = codePoint;
+          for (int digit = digits; digit > 0; --digit, remainder /= 10)
+            destination[1 + digit] = static_cast<char>('0' + remainder % 10);
+          destination[2 + digits] = ';';
+        }
+        return 3 + digits;
+      }
+      default: return -1;
+    }
+  }
+
+  size_t findNonAsciiScalar(const char* source, const size_t sizeInBytes) {
+    size_t offset = 0;
+    for (; offset + sizeof(uint64_t) <= sizeInBytes; offset += sizeof(uint64_t)) {
+      uint64_t word;
+      (void)std::memcpy(&word, source + offset, sizeof(word));
+      if ((word & 0x8080808080808080) != 0) break;
+    }
+    while (offset < sizeInBytes && static_cast<unsigned char>(source[offset]) < 0x80) ++offset;
+    return offset;
+  }
+
+  size_t countSupplementaryLeadsScalar(const char* source, const size_t sizeInBytes) {
+    size_t leads = 0;
+    for (size_t offset = 0; offset < sizeInBytes; ++offset) leads += static_cast<unsigned char>(source[offset]) >= 0xF0;
+    return leads;
+  }
+
+  size_t widenAsciiScalar(const char*, const size_t, char*) {
+    return 0;
+  }
+
+  size_t narrowAsciiScalar(const char*, const size_t, const bool, char*) {
+    return 0;
+  }
+
+  size_t measureUnitsScalar(const char*, const size_t, const bool, size_t&) {
+    return 0;
+  }
+
+#if defined(MAMBA_X86_64)
+  /// Swaps the bytes within every 16-bit lane.
+  inline __m128i swapUTF16BytesSSE2(const __m128i block) noexcept {
+    return _mm_or_si128(_mm_slli_epi16(block, 8), _mm_srli_epi16(block, 8));
+  }
+
+  /// Swaps the bytes within every 32-bit lane.
+  inline __m128i swapUTF32BytesSSE2(const __m128i block) noexcept {
+    const __m128i halves = _mm_or_si128(_mm_slli_epi32(block, 16), _mm_srli_epi32(block, 16));
+    return swapUTF16BytesSSE2(halves);
+  }
+
+  size_t findNonAsciiSSE2(const char* source, const size_t sizeInBytes) {
+    size_t offset = 0;
+    for (; offset + 16 <= sizeInBytes; offset += 16) {
+      const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + offset));
+      const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(block));
+      if (mask != 0) return offset + std::countr_zero(mask);
+    }
+    return offset + findNonAsciiScalar(source + offset, sizeInBytes - offset);
+  }
+
+  size_t countSupplementaryLeadsSSE2(const char* source, const size_t sizeInBytes) {
+    const __m128i threshold = _mm_set1_epi8(static_cast<char>(0xF0));
+    size_t offset = 0, leads = 0;
+    for (; offset + 16 <= sizeInBytes; offset += 16) {
+      const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + offset));
+      const __m128i isLead = _mm_cmpeq_epi8(_mm_max_epu8(block, threshold), block);
+      leads += std::popcount(static_cast<uint32_t>(_mm_movemask_epi8(isLead)));
+    }
+    return leads + countSupplementaryLeadsScalar(source + offset, sizeInBytes - offset);
+  }
+
+  size_t widenAsciiIntoUTF16SSE2(const char* source, const size_t sizeInBytes, char* destination) {
+    size_t offset = 0;
+    for (; offset + 16 <= sizeInBytes; offset += 16) {
+      const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + offset));
+      if (_mm_movemask_epi8(block) != 0) break;
+      auto* output = reinterpret_cast<__m128i*>(destination + 2 * offset);
+      _mm_storeu_si128(output, _mm_unpacklo_epi8(block, _mm_setzero_si128()));
+      _mm_storeu_si128(output + 1, _mm_unpackhi_epi8(block, _mm_setzero_si128()));
+    }
+    return offset;
+  }
+
+  size_t widenAsciiIntoUTF32SSE2(const char* source, const size_t sizeInBytes, char* destination) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t offset = 0;
+    for (; offset + 16 <= sizeInBytes; offset += 16) {
+      const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + offset));
+      if (_mm_movemask_epi8(block) != 0) break;
+      const __m128i low = _mm_unpacklo_epi8(block, zero), high = _mm_unpackhi_epi8(block, zero);
+      auto* output = reinterpret_cast<__m128i*>(destination + 4 * offset);
+      _mm_storeu_si128(output, _mm_unpacklo_epi16(low, zero));
+      _mm_storeu_si128(output + 1, _mm_unpackhi_epi16(low, zero));
+      _mm_storeu_si128(output + 2, _mm_unpacklo_epi16(high, zero));
+      _mm_storeu_si128(output + 3, _mm_unpackhi_epi16(high, zero));
+    }
+    return offset;
+  }
+
+  size_t narrowAsciiFromUTF16SSE2(const char* source, const size_t sizeInBytes, const bool isBigEndian,
+                                  char* destination) {
+    const __m128i nonAsciiBits = _mm_set1_epi16(static_cast<int16_t>(0xFF80));
+    size_t offset = 0;
+    for (; offset + 32 <= sizeInBytes; offset += 32) {
+      __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + offset));
+      __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + offset + 16));
+      if (isBigEndian) {
+        first = swapUTF16BytesSSE2(first);
+        second = swapUTF16BytesSSE2(second);
+      }
+      const __m128i units = _mm_and_si128(_mm_or_si128(first, second), nonAsciiBits);
+      if (_mm_movemask_epi8(_mm_cmpeq_epi16(units, _mm_setzero_si128())) != 0xFFFF) break;
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + offset / 2), _mm_packus_epi16(first, second));
+    }
+    return offset;
+  }
+
+  size_t narrowAsciiFromUTF32SSE2(const char* source, const size_t sizeInBytes, const bool isBigEndian,
+                                  char* destination) {
+    const __m128i nonAsciiBits = _mm_set1_epi32(static_cast<int32_t>(0xFFFFFF80));
+    size_t offset = 0;
+    for (; offset + 32 <= sizeInBytes; offset += 32) {
+      __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + offset));
+      __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + offset + 16));
+      if (isBigEndian) {
+        first = swapUTF32BytesSSE2(first);
+        second = swapUTF32BytesSSE2(second);
+      }
+      const __m128i units = _mm_and_si128(_mm_or_si128(first, second), nonAsciiBits);
+      if (_mm_movemask_epi8(_mm_cmpeq_epi32(units, _mm_setzero_si128())) != 0xFFFF) break;
+      const __m128i words = _mm_packs_epi32(first, second);
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(destination + offset / 4), _mm_packus_epi16(words, words));
+    }
+    return offset;
+  }
+
+  /// Adds up the UTF-8 sizes of blocks of 8 UTF-16 code units, stopping at the first block holding a
+  /// surrogate. Each unit takes 3 bytes, minus one if it is below U+0800 and minus another one if it is
+  /// below U+0080, and since the mask of each 16-bit lane has 2 bits, the population counts are halved.
+  size_t measureUTF16SSE2(const char* source, const size_t sizeInBytes, const bool isBigEndian,
+                          size_t& outputSize) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t offset = 0;
+    for (; offset + 16 <= sizeInBytes; offset += 16) {
+      __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + offset));
+      if (isBigEndian) units = swapUTF16BytesSSE2(units);
+      const __m128i blocks = _mm_and_si128(units, _mm_set1_epi16(static_cast<int16_t>(0xF800)));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi16(blocks, _mm_set1_epi16(static_cast<int16_t>(0xD800)))) != 0) break;
+      const auto belowU0800 = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(blocks, zero)));
+      const auto belowU0080 = static_cast<uint32_t>(_mm_movemask_epi8(
+          _mm_cmpeq_epi16(_mm_and_si128(units, _mm_set1_epi16(static_cast<int16_t>(0xFF80))), zero)));
+      outputSize += 24 - (std::popcount(belowU0800) + std::popcount(belowU0080)) / 2;
+    }
+    return offset;
+  }
+
+  /// Counts the 32-bit lanes holding values below the power of 2.
+  inline int countUnitsBelowSSE2(const __m128i units, const int32_t limit) noexcept {
+    const __m128i highBits = _mm_and_si128(units, _mm_set1_epi32(-limit));
+    return std::popcount(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi32(highBits, _mm_setzero_si128())))) / 4;
+  }
+
+  /// Adds up the UTF-8 sizes of blocks of 4 UTF-32 code units, stopping at the first block holding an
+  /// invalid code point, the same way as measureUTF16SSE2() does.
+  size_t measureUTF32SSE2(const char* source, const size_t sizeInBytes, const bool isBigEndian,
+                          size_t& outputSize) {
+    const __m128i signBit = _mm_set1_epi32(static_cast<int32_t>(0x80000000));
+    const __m128i largestCodePoint = _mm_set1_epi32(static_cast<int32_t>(0x8010FFFF));
+    size_t offset = 0;
+    for (; offset + 16 <= sizeInBytes; offset += 16) {
+      __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + offset));
+      if (isBigEndian) units = swapUTF32BytesSSE2(units);
+      // SSE2 lacks unsigned comparisons, so flipping the sign bit turns them into signed ones.
+      const __m128i isBeyondUnicode = _mm_cmpgt_epi32(_mm_xor_si128(units, signBit), largestCodePoint);
+      const __m128i isInSurrogates = _mm_cmpeq_epi32(
+          _mm_and_si128(units, _mm_set1_epi32(static_cast<int32_t>(0xFFFFF800))), _mm_set1_epi32(0xD800));
+      if (_mm_movemask_epi8(_mm_or_si128(isBeyondUnicode, isInSurrogates)) != 0) break;
+      outputSize += 16 - (countUnitsBelowSSE2(units, 0x80) + countUnitsBelowSSE2(units, 0x800) +
+                          countUnitsBelowSSE2(units, 0x10000));
+    }
+    return offset;
+  }
+#endif
+
+#if defined(MAMBA_AVX2_KERNELS)
+  MAMBA_TARGET_AVX2 inline __m256i swapUTF16BytesAVX2(const __m256i block) noexcept {
+    const __m256i order = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                           1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    return _mm256_shuffle_epi8(block, order);
+  }
+
+  MAMBA_TARGET_AVX2 inline __m256i swapUTF32BytesAVX2(const __m256i block) noexcept {
+    const __m256i order = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                           3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    return _mm256_shuffle_epi8(block, order);
+  }
+
+  MAMBA_TARGET_AVX2 size_t findNonAsciiAVX2(const char* source, const size_t sizeInBytes) {
+    size_t offset = 0;
+    for (; offset + 32 <= sizeInBytes; offset += 32) {
+      const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + offset));
+      const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(block));
+      if (mask != 0) return offset + _tzcnt_u32(mask);
+    }
+    return offset + findNonAsciiSSE2(source + offset, sizeInBytes - offset);
+  }
+
+  MAMBA_TARGET_AVX2 size_t countSupplementaryLeadsAVX2(const char* source, const size_t sizeInBytes) {
+    const __m256i threshold = _mm256_set1_epi8(static_cast<char>(0xF0));
+    size_t offset = 0, leads = 0;
+    for (; offset + 32 <= sizeInBytes; offset += 32) {
+      const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + offset));
+      const __m256i isLead = _mm256_cmpeq_epi8(_mm256_max_epu8(block, threshold), block);
+      leads += _mm_popcnt_u32(static_cast<uint32_t>(_mm256_movemask_epi8(isLead)));
+    }
+    return leads + countSupplementaryLeadsSSE2(source + offset, sizeInBytes - offset);
+  }
+
+  MAMBA_TARGET_AVX2 size_t widenAsciiIntoUTF16AVX2(const char* source, const size_t sizeInBytes,
+                                                   char* destination) {
+    size_t offset = 0;
+    for (; offset + 32 <= sizeInBytes; offset += 32) {
+      const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + offset));
+      if (_mm256_movemask_epi8(block) != 0) break;
+      auto* output = reinterpret_cast<__m256i*>(destination + 2 * offset);
+      _mm256_storeu_si256(output, _mm256_cvtepu8_epi16(_mm256_castsi256_si128(block)));
+      _mm256_storeu_si256(output + 1, _mm256_cvtepu8_epi16(_mm256_extracti128_si256(block, 1)));
+    }
+    return offset + widenAsciiIntoUTF16SSE2(source + offset, sizeInBytes - offset, destination + 2 * offset);
+  }
+
+  MAMBA_TARGET_AVX2 size_t widenAsciiIntoUTF32AVX2(const char* source, const size_t sizeInBytes,
+                                                   char* destination) {
+    size_t offset = 0;
+    for (; offset + 32 <= sizeInBytes; offset += 32) {
+      const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + offset));
+      if (_mm256_movemask_epi8(block) != 0) break;
+      auto* output = reinterpret_cast<__m256i*>(destination + 4 * offset);
+      for (int quarter = 0; quarter < 4; ++quarter) {
+        const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + offset + 8 * quarter));
+        _mm256_storeu_si256(output + quarter, _mm256_cvtepu8_epi32(bytes));
+      }
+    }
+    return offset + widenAsciiIntoUTF32SSE2(source + offset, sizeInBytes - offset, destination + 4 * offset);
+  }
+
+  MAMBA_TARGET_AVX2 size_t narrowAsciiFromUTF16AVX2(const char* source, const size_t sizeInBytes,
+                                                    const bool isBigEndian, char* destination) {
+    const __m256i nonAsciiBits = _mm256_set1_epi16(static_cast<int16_t>(0xFF80));
+    size_t offset = 0;
+    for (; offset + 64 <= sizeInBytes; offset += 64) {
+      __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + offset));
+      __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + offset + 32));
+      if (isBigEndian) {
+        first = swapUTF16BytesAVX2(first);
+        second = swapUTF16BytesAVX2(second);
+      }
+      if (!_mm256_testz_si256(_mm256_or_si256(first, second), nonAsciiBits)) break;
+      // Packing works within 128-bit lanes, so the quarters must be put back in order afterwards.
+      const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(first, second), 0xD8);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + offset / 2), packed);
+    }
+    return offset + narrowAsciiFromUTF16SSE2(source + offset, sizeInBytes - offset, isBigEndian,
+                                             destination + offset / 2);
+  }
+
+  MAMBA_TARGET_AVX2 size_t narrowAsciiFromUTF32AVX2(const char* source, const size_t sizeInBytes,
+                                                    const bool isBigEndian, char* destination) {
+    const __m256i nonAsciiBits = _mm256_set1_epi32(static_cast<int32_t>(0xFFFFFF80));
+    size_t offset = 0;
+    for (; offset + 64 <= sizeInBytes; offset += 64) {
+      __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + offset));
+      __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + offset + 32));
+      if (isBigEndian) {
+        first = swapUTF32BytesAVX2(first);
+        second = swapUTF32BytesAVX2(second);
+      }
+      if (!_mm256_testz_si256(_mm256_or_si256(first, second), nonAsciiBits)) break;
+      const __m256i words = _mm256_permute4x64_epi64(_mm256_packs_epi32(first, second), 0xD8);
+      const __m256i bytes = _mm256_permute4x64_epi64(_mm256_packus_epi16(words, words), 0x08);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + offset / 4), _mm256_castsi256_si128(bytes));
+    }
+    return offset + narrowAsciiFromUTF32SSE2(source + offset, sizeInBytes - offset, isBigEndian,
+                                             destination + offset / 4);
+  }
+
+  MAMBA_TARGET_AVX2 size_t measureUTF16AVX2(const char* source, const size_t sizeInBytes, const bool isBigEndian,
+                                            size_t& outputSize) {
+    const __m256i zero = _mm256_setzero_si256();
+    size_t offset = 0;
+    for (; offset + 32 <= sizeInBytes; offset += 32) {
+      __m256i units = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + offset));
+      if (isBigEndian) units = swapUTF16BytesAVX2(units);
+      const __m256i blocks = _mm256_and_si256(units, _mm256_set1_epi16(static_cast<int16_t>(0xF800)));
+      if (!_mm256_testz_si256(_mm256_cmpeq_epi16(blocks, _mm256_set1_epi16(static_cast<int16_t>(0xD800))),
+                              _mm256_set1_epi8(-1))) break;
+      const auto belowU0800 = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(blocks, zero)));
+      const auto belowU0080 = static_cast<uint32_t>(_mm256_movemask_epi8(
+          _mm256_cmpeq_epi16(_mm256_and_si256(units, _mm256_set1_epi16(static_cast<int16_t>(0xFF80))), zero)));
+      outputSize += 48 - (_mm_popcnt_u32(belowU0800) + _mm_popcnt_u32(belowU0080)) / 2;
+    }
+    return offset + measureUTF16SSE2(source + offset, sizeInBytes - offset, isBigEndian, outputSize);
+  }
+
+  MAMBA_TARGET_AVX2 inline int countUnitsBelowAVX2(const __m256i units, const int32_t limit) noexcept {
+    const __m256i highBits = _mm256_and_si256(units, _mm256_set1_epi32(-limit));
+    const __m256i isBelow = _mm256_cmpeq_epi32(highBits, _mm256_setzero_si256());
+    return static_cast<int>(_mm_popcnt_u32(static_cast<uint32_t>(_mm256_movemask_epi8(isBelow)))) / 4;
+  }
+
+  MAMBA_TARGET_AVX2 size_t measureUTF32AVX2(const char* source, const size_t sizeInBytes, const bool isBigEndian,
+                                            size_t& outputSize) {
+    const __m256i largestCodePoint = _mm256_set1_epi32(0x10FFFF);
+    size_t offset = 0;
+    for (; offset + 32 <= sizeInBytes; offset += 32) {
+      __m256i units = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + offset));
+      if (isBigEndian) units = swapUTF32BytesAVX2(units);
+      const __m256i isWithinUnicode = _mm256_cmpeq_epi32(_mm256_min_epu32(units, largestCodePoint), units);
+      const __m256i isInSurrogates = _mm256_cmpeq_epi32(
+          _mm256_and_si256(units, _mm256_set1_epi32(static_cast<int32_t>(0xFFFFF800))), _mm256_set1_epi32(0xD800));
+      if (_mm256_movemask_epi8(_mm256_andnot_si256(isInSurrogates, isWithinUnicode)) != -1) break;
+      outputSize += 32 - (countUnitsBelowAVX2(units, 0x80) + countUnitsBelowAVX2(units, 0x800) +
+                          countUnitsBelowAVX2(units, 0x10000));
+    }
+    return offset + measureUTF32SSE2(source + offset, sizeInBytes - offset, isBigEndian, outputSize);
+  }
+#endif
+
+  /// Picks the widest transcoding kernels supported by the host. Resolved once on the first conversion.
+  TranscodingKernels selectTranscodingKernels() noexcept {
+    [[maybe_unused]] const InstructionSet instructionSet = getSupportedInstructionSet();
+#if defined(MAMBA_AVX2_KERNELS)
+    if (instructionSet == InstructionSet::AVX2)
+      return {findNonAsciiAVX2, countSupplementaryLeadsAVX2, widenAsciiIntoUTF16AVX2, widenAsciiIntoUTF32AVX2,
+              narrowAsciiFromUTF16AVX2, narrowAsciiFromUTF32AVX2, measureUTF16AVX2, measureUTF32AVX2};
+#endif
+#if defined(MAMBA_X86_64)
+    if (instructionSet >= InstructionSet::SSE2)
+      return {findNonAsciiSSE2, countSupplementaryLeadsSSE2, widenAsciiIntoUTF16SSE2, widenAsciiIntoUTF32SSE2,
+              narrowAsciiFromUTF16SSE2, narrowAsciiFromUTF32SSE2, measureUTF16SSE2, measureUTF32SSE2};
+#endif
+    return {findNonAsciiScalar, countSupplementaryLeadsScalar, widenAsciiScalar, widenAsciiScalar,
+            narrowAsciiScalar, narrowAsciiScalar, measureUnitsScalar, measureUnitsScalar};
+  }
+
+  const TranscodingKernels& getTranscodingKernels() noexcept {
+    static const TranscodingKernels kernels = selectTranscodingKernels();
+    return kernels;
+  }
+
+  /// Allocates the output of the transcoder on the pool.
+  /// @param sizeInBytes The exact size of the output.
+  /// @param isTerminated Tells if the output is a string that must be followed by the zero terminator.
+  /// @return The allocation, whose destination is nullptr if the pool is exhausted.
+  GarbageCollected<char> gatherTranscodedOutput(const size_t sizeInBytes, const bool isTerminated) noexcept {
+    GarbageCollected<char> output = gather(sizeInBytes + isTerminated, GarbageCollectionGeneration::Eden);
+    if (output.destination == nullptr) raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+    else if (isTerminated) output.destination[sizeInBytes] = '\0';
+    return output;
+  }
+
+  /// The decoders differ in how they decode a single character and in the kernels accelerating them.
+  struct UTF8Decoding {
+    static constexpr ExceptionReason Failure = ExceptionReason::UTF8ToUTF8ConversionFailure;
+    static constexpr size_t UnitSize = 1;
+
+    static DecodedCharacter decode(const unsigned char* source, const size_t remaining, const bool isBigEndian) {
+      return decodeUTF8Character(source, remaining, isBigEndian);
+    }
+
+    static size_t measure(const TranscodingKernels& kernels, const char* source, const size_t sizeInBytes, bool,
+                          size_t& outputSize) {
+      const size_t run = kernels.findNonAscii(source, sizeInBytes);
+      outputSize += run;
+      return run;
+    }
+
+    static size_t write(const TranscodingKernels& kernels, const char* source, const size_t sizeInBytes, bool,
+                        char*& destination) {
+      const size_t run = kernels.findNonAscii(source, sizeInBytes);
+      (void)std::memcpy(destination, source, run);
+      destination += run;
+      return run;
+    }
+  };
+
+  struct UTF16Decoding {
+    static constexpr ExceptionReason Failure = ExceptionReason::UTF16ToUTF8ConversionFailure;
+    static constexpr size_t UnitSize = 2;
+
+    static DecodedCharacter decode(const unsigned char* source, const size_t remaining, const bool isBigEndian) {
+      return decodeUTF16Character(source, remaining, isBigEndian);
+    }
+
+    static size_t measure(const TranscodingKernels& kernels, const char* source, const size_t sizeInBytes,
+                          const bool isBigEndian, size_t& outputSize) {
+      return kernels.measureUTF16(source, sizeInBytes, isBigEndian, outputSize);
+    }
+
+    static size_t write(const TranscodingKernels& kernels, const char* source, const size_t sizeInBytes,
+                        const bool isBigEndian, char*& destination) {
+      const size_t run = kernels.narrowAsciiFromUTF16(source, sizeInBytes, isBigEndian, destination);
+      destination += run / 2;
+      return run;
+    }
+  };
+
+  struct UTF32Decoding {
+    static constexpr ExceptionReason Failure = ExceptionReason::UTF32ToUTF8ConversionFailure;
+    static constexpr size_t UnitSize = 4;
+
+    static DecodedCharacter decode(const unsigned char* source, const size_t remaining, const bool isBigEndian) {
+      return decodeUTF32Character(source, remaining, isBigEndian);
+    }
+
+    static size_t measure(const TranscodingKernels& kernels, const char* source, const size_t sizeInBytes,
+                          const bool isBigEndian, size_t& outputSize) {
+      return kernels.measureUTF32(source, sizeInBytes, isBigEndian, outputSize);
+    }
+
+    static size_t write(const TranscodingKernels& kernels, const char* source, const size_t sizeInBytes,
+                        const bool isBigEndian, char*& destination) {
+      const size_t run = kernels.narrowAsciiFromUTF32(source, sizeInBytes, isBigEndian, destination);
+      destination += run / 4;
+      return run;
+    }
+  };
+
+  /// The first pass of the decoders: validates the input and measures the UTF-8 text it decodes into.
+  template<typename Decoding> DecodingSummary measureDecoding(const char* source, const size_t sizeInBytes,
+                                                              const bool isBigEndian,
+                                                              const StringEncodingPolicy policy) noexcept {
+    const TranscodingKernels& kernels = getTranscodingKernels();
+    const auto* bytes = reinterpret_cast<const unsigned char*>(source);
+    DecodingSummary summary;
+    size_t offset = 0;
+    while (offset < sizeInBytes) {
+      const size_t run = Decoding::measure(kernels, source + offset, sizeInBytes - offset, isBigEndian,
+                                           summary.sizeInBytes);
+      summary.graphemes += run / Decoding::UnitSize;
+      offset += run;
+      const size_t stop = std::min(offset + TranscodingScalarStride, sizeInBytes);
+      while (offset < stop) {
+        const DecodedCharacter character = Decoding::decode(bytes + offset, sizeInBytes - offset, isBigEndian);
+        if (character.isValid) {
+          summary.sizeInBytes += getSizeOfUTF8Grapheme(character.codePoint);
+          ++summary.graphemes;
+          offset += character.size;
+          continue;
+        }
+        const ssize_t substitute = substituteDecodingError(policy, bytes + offset, character.size, nullptr);
+        if (substitute < 0) {
+          summary.isValid = false;
+          return summary;
+        }
+        // Replacing yields the single U+FFFD character, while escaping yields ASCII characters only.
+        summary.sizeInBytes += substitute;
+        summary.graphemes += policy == StringEncodingPolicy::Replace ? 1 : substitute;
+        summary.hasErrors = true;
+        offset += character.size;
+      }
+    }
+    return summary;
+  }
+
+  /// The second pass of the decoders: writes the UTF-8 text measured by the first one. Valid UTF-8 is
+  /// copied as a whole.
+  template<typename Decoding> char* writeDecoding(const char* source, const size_t sizeInBytes,
+                                                  const bool isBigEndian, const DecodingSummary& summary,
+                                                  const StringEncodingPolicy policy, char* destination) noexcept {
+    if constexpr (std::is_same_v<Decoding, UTF8Decoding>) {
+      if (!summary.hasErrors) {
+        (void)std::memcpy(destination, source, sizeInBytes);
+        return destination + sizeInBytes;
+      }
+    }
+    const TranscodingKernels& kernels = getTranscodingKernels();
+    const auto* bytes = reinterpret_cast<const unsigned char*>(source);
+    size_t offset = 0;
+    while (offset < sizeInBytes) {
+      offset += Decoding::write(kernels, source + offset, sizeInBytes - offset, isBigEndian, destination);
+      const size_t stop = std::min(offset + TranscodingScalarStride, sizeInBytes);
+      while (offset < stop) {
+        const DecodedCharacter character = Decoding::decode(bytes + offset, sizeInBytes - offset, isBigEndian);
+        if (character.isValid) destination += encodeUTF8(character.codePoint, destination);
+        else destination += substituteDecodingError(policy, bytes + offset, character.size, destination);
+        offset += character.size;
+      }
+    }
+    return destination;
+  }
+
+  /// Decodes the input into a string allocated on the pool.
+  template<typename Decoding> GarbageCollected<char> decodeIntoString(const char* source, const size_t sizeInBytes,
+                                                                      const bool isBigEndian,
+                                                                      const StringEncodingPolicy policy) noexcept {
+    const DecodingSummary summary = measureDecoding<Decoding>(source, sizeInBytes, isBigEndian, policy);
+    if (!summary.isValid) {
+      raise(Signal::UnicodeDecodeError, Decoding::Failure);
+      return {};
+    }
+    GarbageCollected<char> output = gatherTranscodedOutput(summary.sizeInBytes, true);
+    if (output.destination != nullptr)
+      (void)writeDecoding<Decoding>(source, sizeInBytes, isBigEndian, summary, policy, output.destination);
+    return output;
+  }
+
+  DecodingSummary measureUTF8Decoding(const char* source, const size_t sizeInBytes,
+                                      const StringEncodingPolicy policy) noexcept {
+    return measureDecoding<UTF8Decoding>(source, sizeInBytes, false, policy);
+  }
+
+  char* writeUTF8Decoding(const char* source, const size_t sizeInBytes, const DecodingSummary& summary,
+                          const StringEncodingPolicy policy, char* destination) noexcept {
+    return writeDecoding<UTF8Decoding>(source, sizeInBytes, false, summary, policy, destination);
+  }
+
+  size_t getUTF8SequenceSize(const char* source, const size_t sizeInBytes) noexcept {
+    return decodeUTF8Character(reinterpret_cast<const unsigned char*>(source), sizeInBytes, false).size;
+  }
+
+  size_t getIncompleteUTF8Suffix(const char* source, const size_t sizeInBytes) noexcept {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(source);
+    for (size_t suffix = 1; suffix <= std::min<size_t>(3, sizeInBytes); ++suffix) {
+      const unsigned char lead = bytes[sizeInBytes - suffix];
+      if (isContinuationByte(lead)) continue;
+      if (lead < 0xC2 || lead > 0xF4 || suffix >= static_cast<size_t>(std::countl_one(lead))) return 0;
+      // The suffix is incomplete if all of its bytes make up the maximal subpart of the sequence.
+      return decodeUTF8Character(bytes + sizeInBytes - suffix, suffix, false).size == static_cast<int>(suffix)
+             ? suffix : 0;
+    }
+    return 0;
+  }
+
+  GarbageCollected<char> encodeStringIntoASCII(const char* string, const size_t sizeInBytes, size_t,
+                                               const StringEncodingPolicy policy) noexcept {
+    const TranscodingKernels& kernels = getTranscodingKernels();
+    const size_t asciiPrefix = kernels.findNonAscii(string, sizeInBytes);
+    size_t outputSize = asciiPrefix, offset = asciiPrefix;
+    int size;
+    while (offset < sizeInBytes) {
+      const ssize_t substitute = substituteEncodingError(policy, decodeTrustedUTF8(string + offset, size), nullptr);
+      if (substitute < 0) {
+        raise(Signal::UnicodeEncodeError, ExceptionReason::UTF8ToASCIIConversionFailure);
+        return {};
+      }
+      offset += size;
+      const size_t run = kernels.findNonAscii(string + offset, sizeInBytes - offset);
+      outputSize += substitute + run;
+      offset += run;
+    }
+
+    GarbageCollected<char> output = gatherTranscodedOutput(outputSize, false);
+    if (output.destination == nullptr) return output;
+    (void)std::memcpy(output.destination, string, asciiPrefix);
+    char* destination = output.destination + asciiPrefix;
+    for (offset = asciiPrefix; offset < sizeInBytes;) {
+      destination += substituteEncodingError(policy, decodeTrustedUTF8(string + offset, size), destination);
+      offset += size;
+      const size_t run = kernels.findNonAscii(string + offset, sizeInBytes - offset);
+      (void)std::memcpy(destination, string + offset, run);
+      destination += run;
+      offset += run;
+    }
+    return output;
+  }
+
+  GarbageCollected<char> encodeStringIntoUTF16(const char* string, const size_t sizeInBytes, const size_t graphemes,
+                                               StringEncodingPolicy) noexcept {
+    // Every grapheme takes a single code unit, except those beyond the BMP, which take a surrogate pair
+    // and are exactly the ones encoded with 4 bytes in UTF-8.
+    const TranscodingKernels& kernels = getTranscodingKernels();
+    const size_t units = graphemes + kernels.countSupplementaryLeads(string, sizeInBytes);
+    GarbageCollected<char> output = gatherTranscodedOutput(2 * (units + 1), false);
+    if (output.destination == nullptr) return output;
+
+    char* destination = output.destination;
+    writeUTF16Unit(destination, 0xFEFF);
+    destination += 2;
+    size_t offset = 0;
+    int size;
+    while (offset < sizeInBytes) {
+      const size_t run = kernels.widenAsciiIntoUTF16(string + offset, sizeInBytes - offset, destination);
+      offset += run;
+      destination += 2 * run;
+      for (const size_t stop = std::min(offset + TranscodingScalarStride, sizeInBytes); offset < stop; offset += size) {
+        const uint32_t codePoint = decodeTrustedUTF8(string + offset, size);
+        if (codePoint < 0x10000) {
+          writeUTF16Unit(destination, codePoint);
+          destination += 2;
+        } else {
+          writeUTF16Unit(destination, 0xD800 + ((codePoint - 0x10000) >> 10));
+          writeUTF16Unit(destination + 2, 0xDC00 + ((codePoint - 0x10000) & 0x3FF));
+          destination += 4;
+        }
+      }
+    }
+    return output;
+  }
+
+  GarbageCollected<char> encodeStringIntoUTF32(const char* string, const size_t sizeInBytes, const size_t graphemes,
+                                               StringEncodingPolicy) noexcept {
+    const TranscodingKernels& kernels = getTranscodingKernels();
+    GarbageCollected<char> output = gatherTranscodedOutput(4 * (graphemes + 1), false);
+    if (output.destination == nullptr) return output;
+
+    char* destination = output.destination;
+    writeUTF32Unit(destination, 0xFEFF);
+    destination += 4;
+    size_t offset = 0;
+    int size;
+    while (offset < sizeInBytes) {
+      const size_t run = kernels.widenAsciiIntoUTF32(string + offset, sizeInBytes - offset, destination);
+      offset += run;
+      destination += 4 * run;
+      for (const size_t stop = std::min(offset + TranscodingScalarStride, sizeInBytes); offset < stop; offset += size) {
+        writeUTF32Unit(destination, decodeTrustedUTF8(string + offset, size));
+        destination += 4;
+      }
+    }
+    return output;
+  }
+
+  GarbageCollected<char> decodeUTF8IntoString(const char* utf8Bytes, const size_t sizeInBytes,
+                                              const StringEncodingPolicy policy) noexcept {
+    return decodeIntoString<UTF8Decoding>(utf8Bytes, sizeInBytes, false, policy);
+  }
+
+  GarbageCollected<char> decodeUTF16IntoString(const char* utf16Bytes, const size_t sizeInBytes,
+                                               const StringEncodingPolicy policy) noexcept {
+    if (sizeInBytes >= 2 && std::memcmp(utf16Bytes, "\xFF\xFE", 2) == 0)
+      return decodeIntoString<UTF16Decoding>(utf16Bytes + 2, sizeInBytes - 2, false, policy);
+    if (sizeInBytes >= 2 && std::memcmp(utf16Bytes, "\xFE\xFF", 2) == 0)
+      return decodeIntoString<UTF16Decoding>(utf16Bytes + 2, sizeInBytes - 2, true, policy);
+    return decodeIntoString<UTF16Decoding>(utf16Bytes, sizeInBytes, false, policy);
+  }
+
+  GarbageCollected<char> decodeUTF32IntoString(const char* utf32Bytes, const size_t sizeInBytes,
+                                               const StringEncodingPolicy policy) noexcept {
+    if (sizeInBytes >= 4 && std::memcmp(utf32Bytes, "\xFF\xFE\0\0", 4) == 0)
+      return decodeIntoString<UTF32Decoding>(utf32Bytes + 4, sizeInBytes - 4, false, policy);
+    if (sizeInBytes >= 4 && std::memcmp(utf32Bytes, "\0\0\xFE\xFF", 4) == 0)
+      return decodeIntoString<UTF32Decoding>(utf32Bytes + 4, sizeInBytes - 4, true, policy);
+    return decodeIntoString<UTF32Decoding>(utf32Bytes, sizeInBytes, false, policy);
+  }
+}
@@ -0,0 +1,81 @@
+/*+================================================================================================
+  File:        database.hh
+
+  Summary:     Internal access to the Unicode character properties needed by the string methods.
+               The properties are stored in a two-stage table: the code point is split into the
+               block number and the offset within the block, the first stage maps the block number
+               into one of the deduplicated blocks, and the second stage maps the offset into the
+               index of the character record. Since most of the 1114112 code points share a handful
+               of records, the whole database takes about 90 kilobytes and a lookup costs 2 loads.
+
+  Notes:       The tables are generated by make-database.py into database.cc, which must never be
+               edited by hand.
+
+  Constants:   LowercaseFlag, UppercaseFlag, CasedFlag, CaseIgnorableFlag, TitlecaseFlag, AlphabeticFlag,
+               DecimalFlag, DigitFlag, NumericFlag, PrintableFlag, SpaceFlag, IdentifierStartFlag,
+               IdentifierContinueFlag
+
+  Classes:     CaseMapping, CharacterRecord
+
+  Functions:   getCharacterRecord(uint32_t), mapCase(uint32_t, CaseMapping, uint32_t*)
+
+  Available under Apache Licence v2. Mamba Authors (2024)
+=================================================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mamba {
+  constexpr uint32_t LowercaseFlag = 1 << 0, UppercaseFlag = 1 << 1, CasedFlag = 1 << 2, CaseIgnorableFlag = 1 << 3,
+      TitlecaseFlag = 1 << 4, AlphabeticFlag = 1 << 5, DecimalFlag = 1 << 6, DigitFlag = 1 << 7, NumericFlag = 1 << 8,
+      PrintableFlag = 1 << 9, SpaceFlag = 1 << 10, IdentifierStartFlag = 1 << 11, IdentifierContinueFlag = 1 << 12;
+  constexpr auto CharacterRecordBlockShift = 7;
+
+  /// The case mappings defined by Unicode, in the order their deltas are stored in the record.
+  enum class CaseMapping : uint8_t {
+    Lower, Upper, Title, Fold
+  };
+
+  /// Describes every character sharing the same properties. The case mappings are stored as the
+  /// difference between the mapped and the original code points, so that whole alphabets such as
+  /// Latin or Cyrillic share a single record. The mappings that change the length of the string,
+  /// such as ß becoming SS in the upper case, are instead stored in the SpecialCasings array.
+  struct CharacterRecord {
+    int32_t caseDeltas[4];
+    uint16_t specialCasings[4];
+    uint32_t flags;
+  };
+
+  extern const CharacterRecord CharacterRecords[];
+  extern const uint32_t SpecialCasings[];
+  extern const uint16_t CharacterRecordBlocks[];
+  extern const uint16_t CharacterRecordIndexes[];
+
+  /// Looks up the properties of the character.
+  /// @param codePoint The Unicode code point of the character.
+  /// @return The record describing the character. Code points beyond Unicode share the empty record.
+  inline const CharacterRecord& getCharacterRecord(const uint32_t codePoint) noexcept {
+    if (codePoint > 0x10FFFF) return CharacterRecords[0];
+    const size_t block = CharacterRecordBlocks[codePoint >> CharacterRecordBlockShift];
+    const size_t offset = codePoint & ((1 << CharacterRecordBlockShift) - 1);
+    return CharacterRecords[CharacterRecordIndexes[(block << CharacterRecordBlockShift) | offset]];
+  }
+
+  /// Applies the full case mapping to the character, which may produce up to 3 characters.
+  /// @param codePoint The Unicode code point of the character to map.
+  /// @param mapping The case mapping to apply.
+  /// @param output The array of at least 3 code points receiving the mapped characters.
+  /// @return The number of characters written into the output.
+  inline int mapCase(const uint32_t codePoint, const CaseMapping mapping, uint32_t* output) noexcept {
+    const CharacterRecord& record = getCharacterRecord(codePoint);
+    const auto kind = static_cast<size_t>(mapping);
+    if (record.specialCasings[kind] == 0) {
+      output[0] = static_cast<uint32_t>(static_cast<int32_t>(codePoint) + record.caseDeltas[kind]);
+      return 1;
+    }
+    const uint32_t* special = SpecialCasings + record.specialCasings[kind];
+    for (uint32_t next = 0; next < special[0]; ++next) output[next] = special[next + 1];
+    return static_cast<int>(special[0]);
+  }
+}
@@ -0,0 +1,59 @@
+/*+================================================================================================
+  File:        decoding.hh
+
+  Summary:     Internal access to the 2 passes of the UTF-8 decoder behind decodeUTF8IntoString(), so
+               that the incremental decoder can measure and write the pieces of a stream without
+               going through an intermediate buffer and without validating its output again.
+
+  Classes:     DecodingSummary
+
+  Functions:   measureUTF8Decoding(const char*, size_t, StringEncodingPolicy),
+               writeUTF8Decoding(const char*, size_t, const DecodingSummary&, StringEncodingPolicy, char*),
+               getUTF8SequenceSize(const char*, size_t), getIncompleteUTF8Suffix(const char*, size_t)
+
+  Available under Apache Licence v2. Mamba Authors (2024)
+=================================================================================================+*/
+#pragma once
+
+#include <cstddef>
+
+#include "types/help/unicode/conversions.hh"
+
+namespace mamba {
+  /// Describes the UTF-8 text the decoder produces from the input.
+  struct DecodingSummary {
+    size_t sizeInBytes = 0, graphemes = 0;
+    bool hasErrors = false, isValid = true;
+  };
+
+  /// Validates the UTF-8 input and measures the text it decodes into.
+  /// @param source The pointer to the first byte of the input.
+  /// @param sizeInBytes The number of bytes in the input.
+  /// @param policy String encoding policy that states how to substitute invalid sequences.
+  /// @return The summary of the output, which is not valid if the policy forbids substituting an error.
+  DecodingSummary measureUTF8Decoding(const char* source, size_t sizeInBytes, StringEncodingPolicy policy) noexcept;
+
+  /// Writes the text measured by measureUTF8Decoding().
+  /// @param source The pointer to the first byte of the input.
+  /// @param sizeInBytes The number of bytes in the input.
+  /// @param summary The summary returned by measureUTF8Decoding() for the same input and policy.
+  /// @param policy String encoding policy that states how to substitute invalid sequences.
+  /// @param destination The buffer holding at least summary.sizeInBytes free bytes.
+  /// @return The pointer past the last byte written.
+  char* writeUTF8Decoding(const char* source, size_t sizeInBytes, const DecodingSummary& summary,
+                          StringEncodingPolicy policy, char* destination) noexcept;
+
+  /// Measures the first sequence of the input, either the valid character or the invalid sequence that the
+  /// decoder substitutes as a whole.
+  /// @param source The pointer to the first byte of the input.
+  /// @param sizeInBytes The number of bytes in the input, at least 1.
+  /// @return The number of bytes in the sequence.
+  size_t getUTF8SequenceSize(const char* source, size_t sizeInBytes) noexcept;
+
+  /// Finds out if the input ends in the middle of a multibyte sequence that more input could complete.
+  /// @param source The pointer to the first byte of the input.
+  /// @param sizeInBytes The number of bytes in the input.
+  /// @return The number of bytes in the incomplete sequence, 0 if the input ends at a sequence boundary
+  /// or with an invalid sequence that no more input could fix.
+  size_t getIncompleteUTF8Suffix(const char* source, size_t sizeInBytes) noexcept;
+}
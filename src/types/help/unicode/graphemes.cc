@@ -0,0 +1,68 @@
+#include "types/help/unicode/graphemes.hh"
+
+#include <bit>
+#include <cstring>
+
+#include "exceptions.hh"
+namespace mamba {
+  constexpr uint64_t ContinuationBytesMask = 0x8080808080808080;
+
+  /// Tells if the byte is a UTF-8 continuation byte of the form 10xxxxxx.
+  /// @param byte The byte to inspect.
+  /// @return True if the byte continues a multibyte sequence, false if it begins a grapheme.
+  inline bool isContinuationByte(const unsigned char byte) noexcept {
+    return (byte & 0xC0) == 0x80;
+  }
+
+  uint32_t getUnicodePointForUTF8(const char* source) {
+    // Recover from the pointer landing in the middle of a multibyte sequence.
+    for (int step = 0; step < 3 && isContinuationByte(*source); ++step) --source;
+    const auto* bytes = reinterpret_cast<const unsigned char*>(source);
+    const int size = getSizeOfUTF8Grapheme(source);
+    uint32_t codePoint;
+    switch (size) {
+      case 1: return bytes[0];
+      case 2: codePoint = bytes[0] & 0x1F; break;
+      case 3: codePoint = bytes[0] & 0x0F; break;
+      default: codePoint = bytes[0] & 0x07; break;
+    }
+    for (int next = 1; next < size; ++next) {
+      if (!isContinuationByte(bytes[next])) throw InvalidUTF8Composition("Truncated UTF-8 multibyte sequence");
+      codePoint = (codePoint << 6) | (bytes[next] & 0x3F);
+    }
+    if (getSizeOfUTF8Grapheme(codePoint) != size) throw InvalidUTF8Composition("Overlong UTF-8 sequence");
+    if (codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+      throw InvalidUTF8Composition("UTF-8 sequence encodes an invalid Unicode code point");
+    return codePoint;
+  }
+
+  int getSizeOfUTF8Grapheme(const char* data) {
+    const auto leadingByte = static_cast<unsigned char>(*data);
+    if (leadingByte < 0x80) return 1;
+    if (leadingByte >= 0xC2 && leadingByte <= 0xDF) return 2;
+    if ((leadingByte & 0xF0) == 0xE0) return 3;
+    if (leadingByte >= 0xF0 && leadingByte <= 0xF4) return 4;
+    throw InvalidUTF8Composition("Invalid UTF-8 leading byte");
+  }
+
+  int getSizeOfUTF8Grapheme(const uint32_t unicodeCodePoint) {
+    if (unicodeCodePoint < 0x80) return 1;
+    if (unicodeCodePoint < 0x800) return 2;
+    if (unicodeCodePoint < 0x10000) return 3;
+    return 4;
+  }
+
+  size_t countUTF8Graphemes(const char* data, const size_t sizeInBytes) noexcept {
+    size_t continuationBytes = 0, offset = 0;
+    for (; offset + sizeof(uint64_t) <= sizeInBytes; offset += sizeof(uint64_t)) {
+      uint64_t word;
+      (void)std::memcpy(&word, data + offset, sizeof(word));
+      // A continuation byte has its highest bit set and the next one unset, so shifting the
+      // inverted word by one lines the second bit up with the first within every byte.
+      continuationBytes += std::popcount(word & (~word << 1) & ContinuationBytesMask);
+    }
+    for (; offset < sizeInBytes; ++offset)
+      if (isContinuationByte(static_cast<unsigned char>(data[offset]))) ++continuationBytes;
+    return sizeInBytes - continuationBytes;
+  }
+}
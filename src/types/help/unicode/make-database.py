@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+"""Generates database.cc, the two-stage Unicode character tables used by the string methods.
+
+The tables are derived from the Unicode Character Database bundled with the Python interpreter
+running this script, so that Mamba agrees with CPython on every character. Run it from the
+repository root whenever the interpreter's Unicode version changes:
+
+    python3 src/types/help/unicode/make-database.py > src/types/help/unicode/database.cc
+"""
+import unicodedata
+
+BlockShift = 7
+BlockSize = 1 << BlockShift
+MaximalCodePoint = 0x110000
+
+LowercaseFlag, UppercaseFlag, CasedFlag, CaseIgnorableFlag = 1 << 0, 1 << 1, 1 << 2, 1 << 3
+TitlecaseFlag, AlphabeticFlag, DecimalFlag, DigitFlag, NumericFlag = 1 << 4, 1 << 5, 1 << 6, 1 << 7, 1 << 8
+PrintableFlag, SpaceFlag, IdentifierStartFlag, IdentifierContinueFlag = 1 << 9, 1 << 10, 1 << 11, 1 << 12
+
+# Characters with the Word_Break property of MidLetter, MidNumLet or Single_Quote are case-ignorable
+# in addition to the general categories below, see DerivedCoreProperties.txt.
+WordBreakCaseIgnorable = {0x0027, 0x002E, 0x003A, 0x00B7, 0x0387, 0x055F, 0x05F4, 0x2018, 0x2019, 0x2024,
+                          0x2027, 0xFE13, 0xFE52, 0xFE55, 0xFF07, 0xFF0E, 0xFF1A}
+
+
+def compute_flags(character):
+    code_point, category = ord(character), unicodedata.category(character)
+    flags = 0
+    if character.islower(): flags |= LowercaseFlag
+    if character.isupper(): flags |= UppercaseFlag
+    if character.islower() or character.isupper() or category == 'Lt': flags |= CasedFlag
+    if category in ('Mn', 'Me', 'Cf', 'Lm', 'Sk') or code_point in WordBreakCaseIgnorable: flags |= CaseIgnorableFlag
+    # The remaining flags mirror the single-character results of the str.is*() predicates.
+    if category == 'Lt': flags |= TitlecaseFlag
+    if character.isalpha(): flags |= AlphabeticFlag
+    if character.isdecimal(): flags |= DecimalFlag
+    if character.isdigit(): flags |= DigitFlag
+    if character.isnumeric(): flags |= NumericFlag
+    if character.isprintable(): flags |= PrintableFlag
+    if character.isspace(): flags |= SpaceFlag
+    if character.isidentifier(): flags |= IdentifierStartFlag
+    if ('a' + character).isidentifier(): flags |= IdentifierContinueFlag
+    return flags
+
+
+def main():
+    special_casings, special_offsets = [0], {}
+    records, record_indexes, indexes = {}, {}, []
+
+    def intern_special(sequence):
+        if sequence not in special_offsets:
+            special_offsets[sequence] = len(special_casings)
+            special_casings.extend((len(sequence),) + sequence)
+        return special_offsets[sequence]
+
+    identity = ((0, 0, 0, 0), (0, 0, 0, 0), 0)
+    records[identity] = 0
+    for code_point in range(MaximalCodePoint):
+        if 0xD800 <= code_point <= 0xDFFF:
+            indexes.append(0)
+            continue
+        character = chr(code_point)
+        deltas, specials = [], []
+        for mapping in (str.lower, str.upper, str.title, str.casefold):
+            mapped = mapping(character)
+            if len(mapped) == 1:
+                deltas.append(ord(mapped) - code_point)
+                specials.append(0)
+            else:
+                deltas.append(0)
+                specials.append(intern_special(tuple(map(ord, mapped))))
+        record = (tuple(deltas), tuple(specials), compute_flags(character))
+        indexes.append(records.setdefault(record, len(records)))
+
+    blocks, block_indexes = {}, []
+    for beginning in range(0, MaximalCodePoint, BlockSize):
+        block = tuple(indexes[beginning:beginning + BlockSize])
+        block_indexes.append(blocks.setdefault(block, len(blocks)))
+    assert len(blocks) <= 0xFFFF and len(records) <= 0xFFFF
+
+    print('// Generated by make-database.py from the Unicode Character Database %s. Do not edit.'
+          % unicodedata.unidata_version)
+    print('#include "database.hh"')
+    print('namespace mamba {')
+    print('  const CharacterRecord CharacterRecords[] = {')
+    for deltas, specials, flags in records:
+        print('    {{%s}, {%s}, 0x%X},' % (', '.join(map(str, deltas)), ', '.join(map(str, specials)), flags))
+    print('  };\n')
+    print_array('uint32_t', 'SpecialCasings', special_casings)
+    print_array('uint16_t', 'CharacterRecordBlocks', block_indexes)
+    print_array('uint16_t', 'CharacterRecordIndexes', [index for block in blocks for index in block])
+    print('}')
+
+
+def print_array(type_name, name, values, per_line=20):
+    print('  const %s %s[] = {' % (type_name, name))
+    for beginning in range(0, len(values), per_line):
+        print('    ' + ', '.join(map(str, values[beginning:beginning + per_line])) + ',')
+    print('  };\n')
+
+
+if __name__ == '__main__':
+    main()
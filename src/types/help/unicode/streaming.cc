@@ -0,0 +1,64 @@
+#include "types/help/unicode/streaming.hh"
+
+#include <algorithm>
+#include <cstring>
+
+#include "context.hh"
+#include "types/String.hh"
+#include "decoding.hh"
+namespace mamba {
+  IncrementalUTF8Decoder::IncrementalUTF8Decoder(const StringEncodingPolicy policy) noexcept : policy{policy} { }
+
+  String IncrementalUTF8Decoder::decode(const char* chunk, const size_t sizeInBytes, const bool isFinal) noexcept {
+    // Complete the sequence held back from the previous chunk with the first bytes of this one.
+    char head[sizeof(pending)];
+    size_t headSize = 0, consumed = 0;
+    if (pendingSize > 0) {
+      const size_t available = std::min(sizeof(head) - pendingSize, sizeInBytes);
+      (void)std::memcpy(head, pending, pendingSize);
+      (void)std::memcpy(head + pendingSize, chunk, available);
+      if (!isFinal && getIncompleteUTF8Suffix(head, pendingSize + available) == pendingSize + available) {
+        (void)std::memcpy(pending, head, pendingSize + available);
+        pendingSize += available;
+        return {};
+      }
+      // The held back bytes are a valid prefix, so the sequence spans at least them, either valid or not.
+      headSize = getUTF8SequenceSize(head, pendingSize + available);
+      consumed = headSize - pendingSize;
+    }
+    const size_t tailSize = isFinal ? 0 : getIncompleteUTF8Suffix(chunk + consumed, sizeInBytes - consumed);
+    const size_t bodySize = sizeInBytes - consumed - tailSize;
+
+    const DecodingSummary headSummary = measureUTF8Decoding(head, headSize, policy);
+    const DecodingSummary bodySummary = measureUTF8Decoding(chunk + consumed, bodySize, policy);
+    pendingSize = 0;
+    if (!headSummary.isValid || !bodySummary.isValid) {
+      raise(Signal::UnicodeDecodeError, ExceptionReason::UTF8ToUTF8ConversionFailure);
+      return {};
+    }
+    (void)std::memcpy(pending, chunk + sizeInBytes - tailSize, tailSize);
+    pendingSize = static_cast<uint8_t>(tailSize);
+
+    const size_t size = headSummary.sizeInBytes + bodySummary.sizeInBytes;
+    const size_t graphemes = headSummary.graphemes + bodySummary.graphemes;
+    if (size == 0) return {};
+    GarbageCollected<char> buffer = gather(size + 1, GarbageCollectionGeneration::Eden);
+    if (buffer.destination == nullptr) {
+      raise(Signal::MemoryError, ExceptionReason::HostRanOutOfMemory);
+      return {};
+    }
+    char* destination = writeUTF8Decoding(head, headSize, headSummary, policy, buffer.destination);
+    destination = writeUTF8Decoding(chunk + consumed, bodySize, bodySummary, policy, destination);
+    *destination = '\0';
+    // Every character beyond ASCII takes at least 2 bytes, so the text is ASCII if it has a byte per grapheme.
+    return {buffer, size, graphemes, size == graphemes};
+  }
+
+  size_t IncrementalUTF8Decoder::getPendingSize() const noexcept {
+    return pendingSize;
+  }
+
+  void IncrementalUTF8Decoder::reset() noexcept {
+    pendingSize = 0;
+  }
+}
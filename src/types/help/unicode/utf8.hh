@@ -0,0 +1,86 @@
+/*+================================================================================================
+  File:        utf8.hh
+
+  Summary:     Internal inline routines to walk UTF-8 text that is already known to be valid, such
+               as the contents of a String. They skip every check that getUnicodePointForUTF8()
+               performs, since strings are validated once when they are constructed. Also the
+               test of the ASCII whitespace that int(), float() and bytes.fromhex() skip.
+
+  Classes:     None
+
+  Functions:   decodeTrustedUTF8(const char*, int&), encodeUTF8(uint32_t, char*),
+               stepBackTrustedUTF8(const char*), isAsciiWhitespace(char)
+
+  Available under Apache Licence v2. Mamba Authors (2024)
+=================================================================================================+*/
+#pragma once
+
+#include <bit>
+#include <cstdint>
+
+namespace mamba {
+  /// Decodes the code point of the grapheme beginning at the pointer.
+  /// @param source The pointer to the leading byte of a valid UTF-8 sequence.
+  /// @param size Output set to the number of bytes the sequence takes.
+  /// @return The Unicode code point of the grapheme.
+  inline uint32_t decodeTrustedUTF8(const char* source, int& size) noexcept {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(source);
+    const int leadingOnes = std::countl_one(bytes[0]);
+    switch (leadingOnes) {
+      case 0:
+        size = 1;
+        return bytes[0];
+      case 2:
+        size = 2;
+        return (bytes[0] & 0x1Fu) << 6 | (bytes[1] & 0x3Fu);
+      case 3:
+        size = 3;
+        return (bytes[0] & 0x0Fu) << 12 | (bytes[1] & 0x3Fu) << 6 | (bytes[2] & 0x3Fu);
+      default:
+        size = 4;
+        return (bytes[0] & 0x07u) << 18 | (bytes[1] & 0x3Fu) << 12 | (bytes[2] & 0x3Fu) << 6 | (bytes[3] & 0x3Fu);
+    }
+  }
+
+  /// Encodes the code point into UTF-8.
+  /// @param codePoint The Unicode code point to encode, not larger than U+10FFFF.
+  /// @param destination The buffer with at least 4 free bytes.
+  /// @return The number of bytes written.
+  inline int encodeUTF8(const uint32_t codePoint, char* destination) noexcept {
+    auto* bytes = reinterpret_cast<unsigned char*>(destination);
+    if (codePoint < 0x80) {
+      bytes[0] = static_cast<unsigned char>(codePoint);
+      return 1;
+    }
+    if (codePoint < 0x800) {
+      bytes[0] = static_cast<unsigned char>(0xC0 | codePoint >> 6);
+      bytes[1] = static_cast<unsigned char>(0x80 | (codePoint & 0x3F));
+      return 2;
+    }
+    if (codePoint < 0x10000) {
+      bytes[0] = static_cast<unsigned char>(0xE0 | codePoint >> 12);
+      bytes[1] = static_cast<unsigned char>(0x80 | (codePoint >> 6 & 0x3F));
+      bytes[2] = static_cast<unsigned char>(0x80 | (codePoint & 0x3F));
+      return 3;
+    }
+    bytes[0] = static_cast<unsigned char>(0xF0 | codePoint >> 18);
+    bytes[1] = static_cast<unsigned char>(0x80 | (codePoint >> 12 & 0x3F));
+    bytes[2] = static_cast<unsigned char>(0x80 | (codePoint >> 6 & 0x3F));
+    bytes[3] = static_cast<unsigned char>(0x80 | (codePoint & 0x3F));
+    return 4;
+  }
+
+  /// Moves the pointer back to the leading byte of the previous grapheme.
+  /// @param source The pointer to the leading byte of a grapheme that is not the first one.
+  /// @return The pointer to the leading byte of the grapheme before it.
+  inline const char* stepBackTrustedUTF8(const char* source) noexcept {
+    do --source;
+    while ((static_cast<unsigned char>(*source) & 0xC0) == 0x80);
+    return source;
+  }
+
+  /// Tells if the character is the ASCII whitespace int(), float() and bytes.fromhex() skip around the digits.
+  inline bool isAsciiWhitespace(const char character) noexcept {
+    return character == ' ' || (character >= '\t' && character <= '\r');
+  }
+}
@@ -0,0 +1,26 @@
+#include "vectorisation.hh"
+namespace mamba {
+  /// Performs the actual CPUID query behind getSupportedInstructionSet().
+  /// @return The widest instruction set available on the host.
+  InstructionSet detectInstructionSet() noexcept {
+#if defined(MAMBA_AVX2_KERNELS)
+    __builtin_cpu_init();
+    // The AVX2 kernels are compiled with every extension MAMBA_TARGET_AVX2 enables, which some hosts and virtual
+    // machines mask independently of AVX2.
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2") &&
+        __builtin_cpu_supports("popcnt") && __builtin_cpu_supports("lzcnt")) {
+      return InstructionSet::AVX2;
+    }
+    return InstructionSet::SSE2;
+#elif defined(MAMBA_X86_64)
+    return InstructionSet::SSE2;
+#else
+    return InstructionSet::Scalar;
+#endif
+  }
+
+  InstructionSet getSupportedInstructionSet() noexcept {
+    static const InstructionSet supportedInstructionSet = detectInstructionSet();
+    return supportedInstructionSet;
+  }
+}
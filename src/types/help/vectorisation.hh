@@ -0,0 +1,41 @@
+/*+================================================================================================
+  File:        vectorisation.hh
+
+  Summary:     Internal helpers for the SIMD kernels used by the built-in types. Mamba is compiled
+               for the baseline of the target architecture, so wider instruction sets such as AVX2
+               are never assumed at compile time: kernels that benefit from them are compiled with
+               the per-function target attribute and selected at runtime once the host processor
+               has been queried.
+
+  Classes:     InstructionSet
+
+  Functions:   getSupportedInstructionSet()
+
+  Available under Apache Licence v2. Mamba Authors (2024)
+=================================================================================================+*/
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define MAMBA_X86_64 1
+#include <immintrin.h>
+#endif
+
+#if defined(MAMBA_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define MAMBA_AVX2_KERNELS 1
+#define MAMBA_TARGET_AVX2 __attribute__((target("avx2,bmi,bmi2,popcnt,lzcnt")))
+#endif
+
+namespace mamba {
+  /// The widest family of vector instructions the host processor supports and that Mamba has
+  /// kernels for. The values are ordered, so a kernel requiring SSE2 may run on any set that
+  /// compares greater or equal to it.
+  enum class InstructionSet {
+    Scalar, SSE2, AVX2
+  };
+
+  /// Queries the processor for the instruction sets it supports. The query is only performed
+  /// on the first call and cached afterwards, so it is cheap enough to be used when selecting
+  /// a kernel, although hot paths should still resolve their kernel once and keep the pointer.
+  /// @return The widest instruction set available on the host.
+  InstructionSet getSupportedInstructionSet() noexcept;
+}
@@ -27,6 +27,25 @@ TEST(ActiveSetMemory, pushingAndPopping) {
   EXPECT_EQ(top, bottom);
 }
 
+TEST(ActiveSetMemory, recyclingSmallBlocks) {
+  mamba::ActiveSetMemory memory;
+  std::byte* block = memory.gather(40);
+  memory.recycle(block, 40);
+  EXPECT_EQ(memory.gather(33), block);
+  EXPECT_NE(memory.gather(40), block);
+  std::byte* large = memory.gather(400);
+  memory.recycle(large, 400);
+  EXPECT_NE(memory.gather(400), large);
+
+  // Popping a frame drops its blocks from the freelists, since its memory goes back to the stack.
+  memory.push();
+  std::byte* framed = memory.gather(40);
+  memory.recycle(framed, 40);
+  memory.pop();
+  EXPECT_EQ(memory.gather(16), framed);
+  EXPECT_EQ(memory.gather(40), framed + 16);
+}
+
 TEST(ActiveSetMemory, declineGatheringIfNotEnoughCapacity) {
   mamba::ActiveSetMemory memory;
   const std::byte* result = memory.gather(4 * mamba::DefaultStackSize);
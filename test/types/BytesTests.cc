@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "context.hh"
+#include "types/Bytes.hh"
+#include "types/String.hh"
+#include "PoolFrameTest.hh"
+
+class BytesTest : public PoolFrameTest {};
+
+TEST_F(BytesTest, viewingWithoutCopying) {
+  const mamba::Bytes bytes("header:payload:footer");
+  const mamba::MemoryView view(bytes);
+  EXPECT_TRUE(view.isReadOnly());
+  EXPECT_EQ(view.len(), 21U);
+  EXPECT_EQ(view[0], mamba::Object('h'));
+  EXPECT_EQ(view[-1], mamba::Object('r'));
+  EXPECT_EQ(view[21], mamba::Object());
+
+  const mamba::MemoryView payload = view.slice(7, -7);
+  EXPECT_EQ(payload.data(), view.data() + 7);
+  EXPECT_TRUE(payload == mamba::MemoryView(mamba::Bytes("payload")));
+  EXPECT_TRUE(payload.tobytes() == mamba::Bytes("payload"));
+  EXPECT_EQ(view.slice(-100, 3).len(), 3U);
+  EXPECT_EQ(view.slice(15, 5).len(), 0U);
+  EXPECT_EQ(view.slice(18, 100).len(), 3U);
+
+  // Writing through the view of bytes is refused, and the view of a bytearray writes into it.
+  payload.set(0, 'P');
+  EXPECT_TRUE(bytes == mamba::Bytes("header:payload:footer"));
+  mamba::Bytearray array(view);
+  const mamba::MemoryView writable = mamba::MemoryView(array).slice(7, 14);
+  EXPECT_FALSE(writable.isReadOnly());
+  writable.set(0, 'P');
+  writable.set(-1, 256);
+  EXPECT_EQ(array[7], mamba::Object('P'));
+  EXPECT_EQ(array[13], mamba::Object('d'));
+  EXPECT_FALSE(array == mamba::Bytearray(view));
+}
+
+TEST_F(BytesTest, findingAndCounting) {
+  std::string text;
+  for (int index = 0; index < 1000; ++index) text += static_cast<char>('a' + index % 7);
+  const mamba::Bytes bytes(text);
+  EXPECT_EQ(bytes.count("a"), 143U);
+  EXPECT_EQ(bytes.count("g"), 142U);
+  EXPECT_EQ(bytes.count("z"), 0U);
+  EXPECT_EQ(bytes.count("abc"), 143U);
+  EXPECT_EQ(bytes.count(""), 1001U);
+  EXPECT_EQ(bytes.find("gab"), 6);
+  EXPECT_EQ(bytes.find("ga"), 6);
+  EXPECT_EQ(bytes.find("ac"), -1);
+  EXPECT_TRUE(bytes.contains("efg"));
+  EXPECT_FALSE(bytes.contains("gg"));
+  EXPECT_EQ(mamba::MemoryView(bytes).slice(500, 600).count("c"), 14U);
+
+  // The counters of the lanes are flushed before the bytes equal to the needle overflow them.
+  mamba::Bytearray zeros(10000);
+  EXPECT_EQ(zeros.count(mamba::Needle(std::string_view("\0", 1))), 10000U);
+  zeros.set(9999, 1);
+  zeros.set(17, 1);
+  EXPECT_EQ(zeros.count(mamba::Needle(std::string_view("\0", 1))), 9998U);
+  EXPECT_EQ(zeros.find(mamba::Needle(std::string_view("\1", 1))), 17);
+}
+
+TEST_F(BytesTest, encodingHexadecimal) {
+  mamba::Bytearray array;
+  for (int value = 0; value < 256; ++value) array.append(value);
+  array.append(300);
+  EXPECT_EQ(array.len(), 256U);
+  const mamba::String digits = array.hex();
+  EXPECT_EQ(digits.len(), 512U);
+  EXPECT_TRUE(mamba::MemoryView(array).slice(0, 20).hex() == "000102030405060708090a0b0c0d0e0f10111213");
+  EXPECT_TRUE(mamba::MemoryView(array).slice(250, 256).hex() == "fafbfcfdfeff");
+  EXPECT_TRUE(mamba::Bytes::fromhex(digits) == mamba::Bytes(mamba::MemoryView(array)));
+  EXPECT_TRUE(mamba::Bytes::fromhex(" 0A ff\n12 ") == mamba::Bytes("\x0a\xff\x12"));
+  EXPECT_EQ(mamba::Bytes::fromhex("0g").len(), 0U);
+  EXPECT_EQ(mamba::Bytes::fromhex("0 a").len(), 0U);
+  EXPECT_TRUE(mamba::Bytes().hex() == "");
+
+  // Extending the bytearray with its own view copies the bytes from where they were moved.
+  array.extend(mamba::MemoryView(array).slice(0, 200));
+  EXPECT_EQ(array.len(), 456U);
+  EXPECT_EQ(array[455], mamba::Object(199));
+  mamba::Bytearray copy = array;
+  copy.clear();
+  EXPECT_EQ(array.len(), 456U);
+  EXPECT_EQ(copy.len(), 0U);
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "context.hh"
+#include "types/ConstantTable.hh"
+#include "types/String.hh"
+#include "PoolFrameTest.hh"
+
+class ConstantTableTest : public PoolFrameTest {};
+
+TEST_F(ConstantTableTest, testingMembership) {
+  mamba::List items;
+  for (const char* name : {"add", "sub", "mul", "div", "mod", "pow", "and", "or", "xor"}) {
+    items.append(mamba::String(name));
+  }
+  for (int number = 0; number < 300; number += 3) items.append(number);
+  items.append(0.5);
+  const mamba::ConstantTable table{mamba::Frozenset(items)};
+  EXPECT_EQ(table.len(), 110U);
+  EXPECT_TRUE(table.contains(mamba::String("xor")));
+  EXPECT_FALSE(table.contains(mamba::String("not")));
+  for (int number = 0; number < 300; ++number) EXPECT_EQ(table.contains(number), number % 3 == 0);
+  EXPECT_TRUE(table.contains(297.0));
+  EXPECT_TRUE(table.contains(0.5));
+  EXPECT_FALSE(table.contains(mamba::Object()));
+  EXPECT_EQ(table[mamba::String("add")], mamba::Object());
+
+  // The keys sharing their hashes with other keys, as -1 and -2 do, are told apart after the table.
+  mamba::List twins;
+  twins.append(-1);
+  twins.append(-2);
+  twins.append(7);
+  const mamba::ConstantTable small{mamba::Frozenset(twins)};
+  EXPECT_EQ(small.len(), 3U);
+  EXPECT_TRUE(small.contains(-1));
+  EXPECT_TRUE(small.contains(-2));
+  EXPECT_TRUE(small.contains(-2.0));
+  EXPECT_FALSE(small.contains(-3));
+  EXPECT_FALSE(mamba::ConstantTable().contains(7));
+  EXPECT_EQ(mamba::ConstantTable().len(), 0U);
+}
+
+TEST_F(ConstantTableTest, indexingDictionaries) {
+  mamba::Dictionary items;
+  for (int code = 0; code < 200; ++code) items.set(code * 7, code);
+  items.set(mamba::String("default"), -1);
+  const mamba::ConstantTable table(items);
+  EXPECT_EQ(table.len(), 201U);
+  for (int code = 0; code < 200; ++code) EXPECT_EQ(table[code * 7], mamba::Object(code));
+  EXPECT_EQ(table[mamba::String("default")], mamba::Object(-1));
+  EXPECT_EQ(table[6], mamba::Object());
+  EXPECT_EQ(table.get(6, 42), mamba::Object(42));
+  EXPECT_EQ(table.get(7.0, 42), mamba::Object(1));
+
+  // The copies of the handle share the table.
+  const mamba::ConstantTable copy = table;
+  EXPECT_EQ(copy[1393], mamba::Object(199));
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "context.hh"
+#include "types/Dictionary.hh"
+#include "types/Float.hh"
+#include "types/Integer.hh"
+#include "types/String.hh"
+#include "PoolFrameTest.hh"
+
+class DictionaryTest : public PoolFrameTest {};
+
+TEST_F(DictionaryTest, numbersHashLikePython) {
+  const mamba::Integer large = mamba::Integer(1) << mamba::Integer(100);
+  EXPECT_EQ(mamba::Object(-1).hash(), static_cast<size_t>(-2));
+  EXPECT_EQ(mamba::Object(0.5).hash(), 1152921504606846976U);
+  EXPECT_EQ(mamba::Object(-1.5).hash(), static_cast<size_t>(-1152921504606846977));
+  EXPECT_EQ(mamba::Object(large).hash(), 549755813888U);
+  EXPECT_EQ(mamba::Object(0x1p100).hash(), 549755813888U);
+  EXPECT_EQ(mamba::Object(1e100).hash(), 1822893315824342674U);
+  EXPECT_EQ(mamba::Object(0x1p-30).hash(), 2147483648U);
+  EXPECT_EQ(mamba::Object(1.0 / 3).hash(), 768614336404564608U);
+  const mamba::Integer negative = mamba::Integer(0) - (mamba::Integer(1) << mamba::Integer(70)) - mamba::Integer(5);
+  EXPECT_EQ(mamba::Object(negative).hash(), static_cast<size_t>(-517));
+  EXPECT_EQ(mamba::Object(7).hash(), mamba::Object(7.0).hash());
+}
+
+TEST_F(DictionaryTest, settingAndGetting) {
+  mamba::Dictionary dictionary;
+  for (int key = 0; key < 300; ++key) dictionary.set(key, key * 2);
+  EXPECT_EQ(dictionary.len(), 300U);
+  EXPECT_EQ(dictionary[299], mamba::Object(598));
+  // The equal integers and floats are the same key.
+  EXPECT_EQ(dictionary[mamba::Object(150.0)], mamba::Object(300));
+  dictionary.set(10.0, mamba::String("ten"));
+  EXPECT_EQ(dictionary.len(), 300U);
+  EXPECT_TRUE(dictionary[10].asString() == mamba::String("ten"));
+  EXPECT_FALSE(dictionary.contains(300));
+  EXPECT_FALSE(dictionary.contains(0.5));
+  EXPECT_EQ(dictionary[300], mamba::Object());
+  EXPECT_EQ(dictionary.get(-1, 5), mamba::Object(5));
+  EXPECT_EQ(dictionary.setdefault(-1, 6), mamba::Object(6));
+  EXPECT_EQ(dictionary.setdefault(-1, 7), mamba::Object(6));
+  EXPECT_TRUE(mamba::Dictionary().get(mamba::String("missing")) == mamba::Object());
+
+  mamba::Dictionary strings;
+  for (int index = 0; index < 100; ++index) {
+    strings.set(mamba::String(std::string_view("key-" + std::to_string(index))), index);
+  }
+  EXPECT_EQ(strings[mamba::String("key-42")], mamba::Object(42));
+  EXPECT_FALSE(strings.contains(mamba::String("key-100")));
+  strings.set(mamba::Object(), 1);
+  EXPECT_EQ(strings[mamba::Object()], mamba::Object(1));
+}
+
+TEST_F(DictionaryTest, keepsInsertionOrder) {
+  mamba::Dictionary dictionary;
+  for (int key = 0; key < 100; ++key) dictionary.set(key % 2 == 0 ? key : 1000 - key, key);
+  for (int key = 0; key < 100; key += 3) dictionary.remove(key % 2 == 0 ? key : 1000 - key);
+  EXPECT_EQ(dictionary.pop(2), mamba::Object(2));
+  EXPECT_EQ(dictionary.pop(2), mamba::Object());
+  // The removed keys go to the end when they are set again, and the rest keep their places.
+  dictionary.set(0, -1);
+  mamba::List keys, values;
+  for (int key = 1; key < 100; ++key) {
+    if (key % 3 == 0 || key == 2) continue;
+    keys.append(key % 2 == 0 ? key : 1000 - key);
+    values.append(key);
+  }
+  keys.append(0);
+  values.append(-1);
+  EXPECT_EQ(dictionary.keys(), keys);
+  EXPECT_EQ(dictionary.values(), values);
+
+  // Churning a single key compacts the vacant entries rather than growing the table for good.
+  for (int round = 0; round < 10000; ++round) {
+    dictionary.set(-5, round);
+    dictionary.remove(-5);
+  }
+  EXPECT_EQ(dictionary.keys(), keys);
+}
+
+TEST_F(DictionaryTest, copyingAndUpdating) {
+  mamba::Dictionary first, second;
+  for (int key = 0; key < 50; ++key) first.set(key, key);
+  for (int key = 25; key < 75; ++key) second.set(key, -key);
+  mamba::Dictionary copy = first;
+  copy.update(second);
+  EXPECT_EQ(first.len(), 50U);
+  EXPECT_EQ(copy.len(), 75U);
+  EXPECT_EQ(copy[10], mamba::Object(10));
+  EXPECT_EQ(copy[30], mamba::Object(-30));
+  EXPECT_EQ(copy.keys()[50], mamba::Object(50));
+
+  mamba::Dictionary reordered;
+  for (int key = 74; key >= 0; --key) reordered.set(key, key < 25 ? key : -key);
+  EXPECT_TRUE(copy == reordered);
+  reordered.set(0, 1);
+  EXPECT_FALSE(copy == reordered);
+  copy.clear();
+  EXPECT_EQ(copy.len(), 0U);
+  EXPECT_TRUE(copy == mamba::Dictionary());
+}
+
+TEST_F(DictionaryTest, sharingKeys) {
+  mamba::SharedKeys attributes;
+  const mamba::String x("x"), y("y"), z("z");
+  mamba::Dictionary first(attributes), second(attributes), third(attributes), fourth(attributes);
+  first.set(x, 1);
+  first.set(y, 2);
+  first.set(z, 3);
+  second.set(x, 4);
+  second.set(y, 5);
+  second.set(z, 6);
+  second.set(x, 7);
+  EXPECT_TRUE(first.isSplit());
+  EXPECT_TRUE(second.isSplit());
+  EXPECT_EQ(attributes.len(), 3U);
+  EXPECT_EQ(second[x], mamba::Object(7));
+  EXPECT_EQ(second.get(mamba::String("w"), 0), mamba::Object(0));
+  EXPECT_FALSE(first == second);
+  EXPECT_EQ(second.keys(), first.keys());
+
+  // A copy shares the keys, and only the instance holding all of them adds one.
+  mamba::Dictionary copy = first;
+  EXPECT_TRUE(copy.isSplit());
+  EXPECT_TRUE(copy == first);
+  copy.set(mamba::String("w"), 8);
+  EXPECT_TRUE(copy.isSplit());
+  EXPECT_EQ(attributes.len(), 4U);
+  third.set(x, 9);
+  EXPECT_FALSE(third.contains(y));
+  EXPECT_FALSE(third.contains(mamba::String("w")));
+
+  // Skipping a shared key, adding a key the others lack or removing one combines the dictionary.
+  third.set(z, 10);
+  EXPECT_FALSE(third.isSplit());
+  fourth.set(x, 11);
+  fourth.set(mamba::String("v"), 12);
+  EXPECT_FALSE(fourth.isSplit());
+  EXPECT_EQ(attributes.len(), 4U);
+  EXPECT_EQ(first.pop(y), mamba::Object(2));
+  EXPECT_FALSE(first.isSplit());
+  mamba::List keys;
+  keys.append(x);
+  keys.append(z);
+  EXPECT_EQ(first.keys(), keys);
+  EXPECT_EQ(third.keys(), keys);
+  EXPECT_EQ(third[z], mamba::Object(10));
+  EXPECT_EQ(fourth[mamba::String("v")], mamba::Object(12));
+  EXPECT_EQ(copy[mamba::String("w")], mamba::Object(8));
+
+  // The shared keys stop growing at their limit.
+  mamba::SharedKeys many;
+  mamba::Dictionary wide(many);
+  for (int key = 0; key < 40; ++key) {
+    wide.set(mamba::String(mamba::Integer(key)), key);
+    EXPECT_EQ(wide.isSplit(), key < 30);
+  }
+  EXPECT_EQ(many.len(), mamba::SharedKeys::MaximalCount);
+  EXPECT_EQ(wide.len(), 40U);
+  EXPECT_EQ(wide[mamba::String(mamba::Integer(39))], mamba::Object(39));
+
+  // The keys other than strings are not shared, so the instances keep the keys they set, equal or not.
+  mamba::SharedKeys numbers;
+  mamba::Dictionary real(numbers), integral(numbers);
+  real.set(0.0, 1);
+  integral.set(0, 2);
+  EXPECT_FALSE(real.isSplit());
+  EXPECT_FALSE(integral.isSplit());
+  EXPECT_EQ(numbers.len(), 0U);
+  EXPECT_EQ(integral.keys()[0].getType(), mamba::ObjectType::Integer);
+  EXPECT_EQ(real.keys()[0].getType(), mamba::ObjectType::Float);
+  EXPECT_EQ(integral[0.0], mamba::Object(2));
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include "context.hh"
+#include "types/Float.hh"
+#include "types/String.hh"
+#include "PoolFrameTest.hh"
+
+class FloatTest : public PoolFrameTest {};
+
+/// Gives the bits of the parsed literal, so that the signs of zeros and the last bits are compared too.
+uint64_t parsedBits(const char* literal) {
+  return std::bit_cast<uint64_t>(static_cast<double>(mamba::Float(mamba::String(literal))));
+}
+
+TEST_F(FloatTest, reprFollowsPython) {
+  EXPECT_EQ(view(mamba::Float(0.1).repr()), "0.1");
+  EXPECT_EQ(view(mamba::Float(0.1 + 0.2).repr()), "0.30000000000000004");
+  EXPECT_EQ(view(mamba::Float(1.0).repr()), "1.0");
+  EXPECT_EQ(view(mamba::Float(-2.5).repr()), "-2.5");
+  EXPECT_EQ(view(mamba::Float(1e15).repr()), "1000000000000000.0");
+  EXPECT_EQ(view(mamba::Float(1e16).repr()), "1e+16");
+  EXPECT_EQ(view(mamba::Float(123456789012345680.0).repr()), "1.2345678901234568e+17");
+  EXPECT_EQ(view(mamba::Float(0.0001).repr()), "0.0001");
+  EXPECT_EQ(view(mamba::Float(0.00001).repr()), "1e-05");
+  EXPECT_EQ(view(mamba::Float(1e100).repr()), "1e+100");
+  EXPECT_EQ(view(mamba::Float(5e-324).repr()), "5e-324");
+  EXPECT_EQ(view(mamba::Float(2.2250738585072014e-308).repr()), "2.2250738585072014e-308");
+  EXPECT_EQ(view(mamba::Float(1.7976931348623157e308).repr()), "1.7976931348623157e+308");
+  EXPECT_EQ(view(mamba::Float(9007199254740993.0).repr()), "9007199254740992.0");
+  EXPECT_EQ(view(mamba::Float(-0.0).repr()), "-0.0");
+  EXPECT_EQ(view(mamba::Float(std::numeric_limits<double>::infinity()).repr()), "inf");
+  EXPECT_EQ(view(mamba::Float(-std::numeric_limits<double>::infinity()).repr()), "-inf");
+  EXPECT_EQ(view(mamba::Float(-std::numeric_limits<double>::quiet_NaN()).repr()), "nan");
+  EXPECT_EQ(view(mamba::String(mamba::Float(1.5))), "1.5");
+}
+
+TEST_F(FloatTest, reprRoundTrips) {
+  uint64_t state = 1;
+  for (size_t round = 0; round < 1000; ++round) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    const auto value = std::bit_cast<double>(state);
+    if (std::isnan(value)) continue;
+    const mamba::String text = mamba::Float(value).repr();
+    EXPECT_EQ(parsedBits(std::string(view(text)).c_str()), state) << view(text);
+  }
+}
+
+TEST_F(FloatTest, decimalLiterals) {
+  EXPECT_EQ(parsedBits("0.1"), std::bit_cast<uint64_t>(0.1));
+  EXPECT_EQ(parsedBits("  -1_000.25e-1_0\n"), std::bit_cast<uint64_t>(-1000.25e-10));
+  EXPECT_EQ(parsedBits("+.5"), std::bit_cast<uint64_t>(0.5));
+  EXPECT_EQ(parsedBits("5."), std::bit_cast<uint64_t>(5.0));
+  EXPECT_EQ(parsedBits("-0"), std::bit_cast<uint64_t>(-0.0));
+  EXPECT_EQ(parsedBits("1e400"), std::bit_cast<uint64_t>(std::numeric_limits<double>::infinity()));
+  EXPECT_EQ(parsedBits("1e-400"), 0U);
+  EXPECT_EQ(parsedBits("4.9406564584124654e-324"), 1U);
+  EXPECT_EQ(parsedBits("-InFiNiTy"), std::bit_cast<uint64_t>(-std::numeric_limits<double>::infinity()));
+  EXPECT_TRUE(std::isnan(static_cast<double>(mamba::Float(mamba::String("nan")))));
+  // The literals just above and just below the midpoint between 2^53 and its successor need every digit.
+  EXPECT_EQ(parsedBits("9007199254740993"), 0x4340000000000000U);
+  EXPECT_EQ(parsedBits("9_007_199_254_740_993.000_000_000_000_000_000_01"), 0x4340000000000001U);
+  EXPECT_EQ(parsedBits("9007199254740992.999999999999999999999"), 0x4340000000000000U);
+  EXPECT_EQ(parsedBits("1.7976931348623158e308"), 0x7FEFFFFFFFFFFFFFU);
+  EXPECT_EQ(parsedBits("1.7976931348623159e308"), 0x7FF0000000000000U);
+}
+
+TEST_F(FloatTest, invalidLiterals) {
+  for (const char* literal : {"", " ", "-", ".", "e5", "1e", "1e+", "_1", "1_", "1__0", "1_.5", "1._5", "1e_5",
+                              "0x10", "1.5.", "infinit", "nan1", "1 2", "١"}) {
+    EXPECT_EQ(parsedBits(literal), 0U) << literal;
+  }
+}
+
+TEST_F(FloatTest, arithmetic) {
+  EXPECT_EQ(mamba::Float(0.5) + mamba::Float(0.25), mamba::Float(0.75));
+  EXPECT_EQ(mamba::Float(1.0) / mamba::Float(0.0), mamba::Float());
+  EXPECT_EQ(-mamba::Float(2.0) * mamba::Float(3.0), mamba::Float(-6.0));
+  EXPECT_TRUE(mamba::Float(3.0).is_integer());
+  EXPECT_FALSE(mamba::Float(3.5).is_integer());
+  EXPECT_FALSE(mamba::Float(std::numeric_limits<double>::infinity()).is_integer());
+}
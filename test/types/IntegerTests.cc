@@ -0,0 +1,301 @@
+#include <gtest/gtest.h>
+#include "context.hh"
+#include "types/Integer.hh"
+#include "types/String.hh"
+#include "types/help/arithmetic.hh"
+#include "PoolFrameTest.hh"
+
+class IntegerTest : public PoolFrameTest {};
+
+/// Creates the integer from its cells, the least significant first.
+mamba::Integer fromCells(const std::initializer_list<uint32_t> values, const size_t repeat = 1) {
+  mamba::GarbageCollected<uint32_t> cells = mamba::gatherAlignedCells(values.size() * repeat);
+  size_t index = 0;
+  for (size_t round = 0; round < repeat; ++round) for (const uint32_t value : values) cells.destination[index++] = value;
+  return cells;
+}
+
+/// Generates the pseudo-random integer of the given number of cells.
+mamba::Integer randomInteger(const size_t size, uint64_t& state) {
+  mamba::GarbageCollected<uint32_t> cells = mamba::gatherAlignedCells(size);
+  for (size_t index = 0; index < size; ++index) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    cells.destination[index] = static_cast<uint32_t>(state >> 32);
+  }
+  return cells;
+}
+
+TEST_F(IntegerTest, signedArithmetic) {
+  EXPECT_EQ(mamba::Integer(7) * mamba::Integer(-6), mamba::Integer(-42));
+  EXPECT_EQ(mamba::Integer(-7) + mamba::Integer(7), mamba::Integer());
+  EXPECT_EQ(mamba::Integer(5) - mamba::Integer(12), mamba::Integer(-7));
+  EXPECT_EQ(mamba::Integer(-5) - mamba::Integer(-12), mamba::Integer(7));
+  EXPECT_LT(mamba::Integer(-12), mamba::Integer(-5));
+  EXPECT_GT(mamba::Integer(3), mamba::Integer(-50));
+  EXPECT_EQ(fromCells({0xFFFFFFFF}) + size_t{1}, fromCells({0, 1}));
+  EXPECT_EQ(fromCells({0, 1}) - mamba::Integer(1), fromCells({0xFFFFFFFF}));
+  EXPECT_EQ(fromCells({0xFFFFFFFF, 0xFFFFFFFF}) * size_t{0xFFFFFFFF}, fromCells({1, 0xFFFFFFFF, 0xFFFFFFFE}));
+
+  mamba::Integer counter;
+  for (int step = 0; step < 1000; ++step) counter += mamba::Integer(step);
+  EXPECT_EQ(counter, mamba::Integer(499500));
+}
+
+TEST_F(IntegerTest, squaresOfLargestIntegers) {
+  // (2^32n - 1)^2 = 2^64n - 2^(32n + 1) + 1 for operands handled by every multiplication algorithm.
+  for (const size_t size : {10, 40, 100, 200, 1000}) {
+    mamba::split();
+    const mamba::Integer largest = fromCells({0xFFFFFFFF}, size);
+    mamba::GarbageCollected<uint32_t> expected = mamba::gatherAlignedCells(2 * size);
+    for (size_t index = 0; index < 2 * size; ++index) expected.destination[index] = index < size ? 0 : 0xFFFFFFFF;
+    expected.destination[0] = 1;
+    expected.destination[size] = 0xFFFFFFFE;
+    EXPECT_EQ(largest * largest, mamba::Integer(expected)) << size << " cells";
+    mamba::untie();
+  }
+}
+
+TEST_F(IntegerTest, multiplicationAlgorithmsAgree) {
+  uint64_t state = 42;
+  for (const auto& [leftSize, rightSize] : {std::pair{50, 60}, {170, 200}, {700, 650}, {40, 900}, {300, 1000}}) {
+    mamba::split();
+    const mamba::Integer left = randomInteger(leftSize, state), right = randomInteger(rightSize, state);
+    const mamba::Integer other = mamba::Integer(0) - randomInteger(rightSize / 2, state);
+    EXPECT_EQ(left * (right + other), left * right + left * other) << leftSize << "x" << rightSize;
+    EXPECT_EQ((left * right) * other, left * (right * other)) << leftSize << "x" << rightSize;
+    EXPECT_EQ(left * right, right * left) << leftSize << "x" << rightSize;
+    mamba::untie();
+  }
+}
+
+TEST_F(IntegerTest, smallIntegersStayOffThePool) {
+  const void* top = mamba::gather(0, mamba::GarbageCollectionGeneration::Eden).destination;
+  mamba::Integer counter, product(1);
+  for (size_t step = 0; step < 10000; ++step) counter += step;
+  for (int factor = 1; factor <= 20; ++factor) product *= mamba::Integer(factor);
+  counter -= size_t{49995000};
+  EXPECT_EQ(mamba::gather(0, mamba::GarbageCollectionGeneration::Eden).destination, top);
+  EXPECT_EQ(counter, mamba::Integer());
+  EXPECT_EQ(product, fromCells({0x82B40000, 0x21C3677C}));
+
+  // The results outgrowing the machine word move to the cells, and come back once they fit again.
+  const mamba::Integer largest = fromCells({0xFFFFFFFF, 0x7FFFFFFF});
+  const mamba::Integer outgrown = largest + mamba::Integer(1);
+  EXPECT_EQ(outgrown, fromCells({0, 0x80000000}));
+  EXPECT_GT(outgrown, largest);
+  EXPECT_EQ(outgrown - mamba::Integer(1), largest);
+  EXPECT_EQ(mamba::Integer(0) - outgrown, (mamba::Integer(0) - largest) - mamba::Integer(1));
+  EXPECT_LT(mamba::Integer(0) - outgrown, mamba::Integer(0) - largest);
+  EXPECT_EQ(largest * mamba::Integer(-2), mamba::Integer(0) - fromCells({0xFFFFFFFE, 0xFFFFFFFF}));
+  EXPECT_EQ(largest * size_t{4} - largest * mamba::Integer(3), largest);
+}
+
+TEST_F(IntegerTest, decimalLiterals) {
+  EXPECT_EQ(mamba::Integer(mamba::String(" -1_000_000\n")), mamba::Integer(-1000000));
+  EXPECT_EQ(mamba::Integer(mamba::String("+0042")), mamba::Integer(42));
+  EXPECT_EQ(mamba::Integer(mamba::String("18446744073709551616")), fromCells({0, 0, 1}));
+  EXPECT_EQ(mamba::Integer(mamba::String("18_446_744_073_709_551_616")), fromCells({0, 0, 1}));
+  EXPECT_EQ(view(mamba::Integer(mamba::String("-9223372036854775808")).str()), "-9223372036854775808");
+  EXPECT_EQ(view(fromCells({0, 0, 1}).str()), "18446744073709551616");
+  EXPECT_EQ(view(mamba::String(fromCells({0xFFFFFFFF}, 3) * mamba::Integer(-1))),
+             "-79228162514264337593543950335");
+  for (const char* invalid : {"", " ", "-", "1__0", "_1", "1_", "12a", "1 2", "0x10"}) {
+    EXPECT_EQ(mamba::Integer(mamba::String(invalid)), mamba::Integer()) << invalid;
+  }
+}
+
+TEST_F(IntegerTest, decimalConversionsRoundTrip) {
+  // Powers of ten and their neighbours around the sizes at which the conversions split the digits.
+  for (const size_t count : {19, 20, 97, 359, 360, 361, 575, 576, 577, 700, 1152, 1153, 2000}) {
+    mamba::split();
+    const std::string power = "1" + std::string(count, '0'), nines(count, '9');
+    const mamba::Integer value{mamba::String(std::string_view(power))};
+    EXPECT_EQ(view(value.str()), power) << count << " digits";
+    EXPECT_EQ(view((value - mamba::Integer(1)).str()), nines) << count << " digits";
+    EXPECT_EQ(mamba::Integer(mamba::String(std::string_view(nines))), value - mamba::Integer(1)) << count << " digits";
+    mamba::untie();
+  }
+  uint64_t state = 7;
+  for (const size_t size : {3, 20, 37, 38, 80, 250}) {
+    mamba::split();
+    const mamba::Integer value = randomInteger(size, state) * mamba::Integer(-1);
+    EXPECT_EQ(mamba::Integer(value.str()), value) << size << " cells";
+    mamba::untie();
+  }
+}
+
+TEST_F(IntegerTest, conversionLimit) {
+  const size_t limit = mamba::getIntegerToStringConversionLimit();
+  mamba::setIntegerToStringConversionLimit(20);
+  EXPECT_EQ(mamba::Integer(mamba::String("1_0000_0000_0000_0000_0000")), mamba::Integer());
+  EXPECT_EQ(view(mamba::Integer(mamba::String("-99999999999999999999")).str()), "-99999999999999999999");
+  EXPECT_EQ(mamba::Integer(mamba::String("1" + std::string(40, '0'))), mamba::Integer());
+  EXPECT_EQ(view(fromCells({1}, 4).str()), "");
+  mamba::setIntegerToStringConversionLimit(0);
+  EXPECT_EQ(mamba::Integer(mamba::String("1" + std::string(40, '0'))).str().len(), 41);
+  mamba::setIntegerToStringConversionLimit(limit);
+}
+
+TEST_F(IntegerTest, bitwiseOperationsUseTwosComplement) {
+  EXPECT_EQ(mamba::Integer(-6) & mamba::Integer(13), mamba::Integer(8));
+  EXPECT_EQ(mamba::Integer(-6) >> mamba::Integer(1), mamba::Integer(-3));
+  EXPECT_EQ(mamba::Integer(-7) >> mamba::Integer(100), mamba::Integer(-1));
+  EXPECT_EQ(mamba::Integer(1) << mamba::Integer(64), fromCells({0, 0, 1}));
+  EXPECT_EQ(~fromCells({0, 0, 1}), mamba::Integer() - fromCells({1, 0, 1}));
+  EXPECT_EQ((mamba::Integer(1) << mamba::Integer(1000)).bit_length(), 1001);
+  EXPECT_EQ(fromCells({0xFFFFFFFF}, 40).bit_count(), 1280);
+
+  // The identities hold for operands long enough for the vector kernels, with either sign.
+  uint64_t state = 11;
+  for (const size_t size : {1, 3, 17, 40, 100}) {
+    mamba::split();
+    const mamba::Integer left = randomInteger(size + 2, state), right = randomInteger(size, state);
+    const mamba::Integer negative = mamba::Integer() - left;
+    EXPECT_EQ(left ^ right, (left | right) - (left & right)) << size << " cells";
+    EXPECT_EQ((negative & right) + (negative | right), negative + right) << size << " cells";
+    EXPECT_EQ((negative ^ right) ^ right, negative) << size << " cells";
+    EXPECT_EQ(~negative, left - mamba::Integer(1)) << size << " cells";
+    for (const int shift : {0, 1, 31, 32, 33, 200}) {
+      EXPECT_EQ((left << mamba::Integer(shift)) >> mamba::Integer(shift), left) << size << " cells";
+      EXPECT_EQ(negative >> mamba::Integer(shift), ~((left - mamba::Integer(1)) >> mamba::Integer(shift)));
+      EXPECT_EQ((left << mamba::Integer(shift)).bit_count(), left.bit_count()) << size << " cells";
+    }
+    mamba::untie();
+  }
+}
+
+TEST_F(IntegerTest, divisionFloorsTheQuotient) {
+  EXPECT_EQ(mamba::Integer(7) / mamba::Integer(-2), mamba::Integer(-4));
+  EXPECT_EQ(mamba::Integer(7) % mamba::Integer(-2), mamba::Integer(-1));
+  EXPECT_EQ(mamba::Integer(-7) / mamba::Integer(2), mamba::Integer(-4));
+  EXPECT_EQ(mamba::Integer(-7) % mamba::Integer(2), mamba::Integer(1));
+  EXPECT_EQ(mamba::Integer(-8) % mamba::Integer(2), mamba::Integer());
+  EXPECT_EQ(mamba::Integer(5) / mamba::Integer(0), mamba::Integer());
+  EXPECT_EQ(fromCells({0, 0x80000000}) * mamba::Integer(-1) / mamba::Integer(-1), fromCells({0, 0x80000000}));
+  EXPECT_EQ(fromCells({0, 0, 1}) / size_t{10}, fromCells({0x99999999, 0x19999999}));
+  EXPECT_EQ(fromCells({0, 0, 1}) % size_t{10}, mamba::Integer(6));
+  EXPECT_EQ(mamba::Integer(-3) % fromCells({0, 0, 1}), fromCells({0xFFFFFFFD, 0xFFFFFFFF}));
+
+  // The quotient and remainder rebuild the dividend with Algorithm D and the recursive division alike.
+  uint64_t state = 5;
+  for (const auto& [dividendSize, divisorSize] : {std::pair{3, 1}, {40, 2}, {90, 45}, {310, 120}, {600, 250}}) {
+    mamba::split();
+    const mamba::Integer divisor = randomInteger(divisorSize, state) + mamba::Integer(1);
+    for (const mamba::Integer& dividend : {randomInteger(dividendSize, state),
+                                           mamba::Integer() - randomInteger(dividendSize, state)}) {
+      const mamba::Integer quotient = dividend / divisor, remainder = dividend % divisor;
+      EXPECT_EQ(quotient * divisor + remainder, dividend) << dividendSize << "/" << divisorSize << " cells";
+      EXPECT_GE(remainder, mamba::Integer()) << dividendSize << "/" << divisorSize << " cells";
+      EXPECT_LT(remainder, divisor) << dividendSize << "/" << divisorSize << " cells";
+      EXPECT_EQ((dividend * divisor) / divisor, dividend) << dividendSize << "/" << divisorSize << " cells";
+    }
+    mamba::untie();
+  }
+}
+
+TEST_F(IntegerTest, modularPowerFollowsPython) {
+  EXPECT_EQ(mamba::Integer(3).pow(mamba::Integer(200), mamba::Integer(1000003)), mamba::Integer(333986));
+  EXPECT_EQ(mamba::Integer(-7).pow(mamba::Integer(13), mamba::Integer(-100)), mamba::Integer(-7));
+  EXPECT_EQ(mamba::Integer(5).pow(mamba::Integer(-1), mamba::Integer(17)), mamba::Integer(7));
+  EXPECT_EQ(mamba::Integer(4).pow(mamba::Integer(-1), mamba::Integer(18)), mamba::Integer());
+  EXPECT_EQ(mamba::Integer(4).pow(mamba::Integer(3), mamba::Integer()), mamba::Integer());
+  EXPECT_EQ(mamba::Integer(2).pow(mamba::Integer(-1)), mamba::Integer());
+  EXPECT_EQ(mamba::Integer(-3).pow(mamba::Integer(5)), mamba::Integer(-243));
+  EXPECT_EQ(fromCells({0x5D6B4B87, 0x2BDC54}).pow(mamba::Integer(987654321), fromCells({0xFFFFFFC5, 0xFFFFFFFF})),
+            fromCells({0x6FD87217, 0xEDEDF2CE}));
+  EXPECT_EQ(fromCells({3, 0, 0x40}).pow(mamba::Integer(65537), fromCells({0, 0, 1})),
+            fromCells({0xBADC0003, 0xCBA2490}));
+
+  // Fermat's little theorem on the primes 2^255 - 19 and 2^521 - 1, of a fixed and a variable number of words.
+  uint64_t state = 9;
+  for (const size_t bits : {255, 521}) {
+    const mamba::Integer prime = (mamba::Integer(1) << mamba::Integer(static_cast<int>(bits))) -
+                                 mamba::Integer(bits == 255 ? 19 : 1);
+    const mamba::Integer base = randomInteger(bits / 32, state);
+    EXPECT_EQ(base.pow(prime - mamba::Integer(1), prime), mamba::Integer(1)) << bits << " bits";
+    EXPECT_EQ(base.powConstantTime(prime - mamba::Integer(1), prime), mamba::Integer(1)) << bits << " bits";
+  }
+
+  // The inverse modulo the Mersenne prime 2^1279 - 1 takes over a thousand steps of Euclid in bounded memory.
+  const mamba::Integer mersenne = (mamba::Integer(1) << mamba::Integer(1279)) - mamba::Integer(1);
+  const mamba::Integer unit = randomInteger(39, state), inverse = unit.pow(mamba::Integer(-1), mersenne);
+  EXPECT_EQ(inverse * unit % mersenne, mamba::Integer(1));
+  EXPECT_EQ(unit.pow(mamba::Integer(-3), mersenne), inverse.pow(mamba::Integer(3), mersenne));
+  EXPECT_EQ((unit * mersenne).pow(mamba::Integer(-1), mersenne * mamba::Integer(3)), mamba::Integer());
+
+  // Sliding and fixed windows agree on odd moduli, and the division path matches the plain power on even ones.
+  for (const size_t size : {8, 16, 32, 64, 70}) {
+    mamba::split();
+    const mamba::Integer odd = randomInteger(size, state) * mamba::Integer(2) + mamba::Integer(1);
+    const mamba::Integer base = randomInteger(size + 3, state), exponent = randomInteger(size, state);
+    EXPECT_EQ(base.pow(exponent, odd), base.powConstantTime(exponent, odd)) << size << " cells";
+    const mamba::Integer even = odd + mamba::Integer(1);
+    EXPECT_EQ(base.pow(mamba::Integer(5), even), base.pow(mamba::Integer(5)) % even) << size << " cells";
+    EXPECT_EQ(base.pow(mamba::Integer(5), odd), base.pow(mamba::Integer(5)) % odd) << size << " cells";
+    mamba::untie();
+  }
+}
+
+/// Spells the bytes out in hexadecimal for comparison.
+std::string hexadecimal(const std::byte* bytes, const size_t count) {
+  std::string text;
+  for (size_t index = 0; index < count; ++index) {
+    text += "0123456789abcdef"[static_cast<uint8_t>(bytes[index]) >> 4];
+    text += "0123456789abcdef"[static_cast<uint8_t>(bytes[index]) & 15];
+  }
+  return text;
+}
+
+TEST_F(IntegerTest, bytesFollowPython) {
+  EXPECT_EQ(hexadecimal(mamba::Integer(1024).to_bytes(2).destination, 2), "0400");
+  EXPECT_EQ(hexadecimal(mamba::Integer(1024).to_bytes(3, false).destination, 3), "000400");
+  EXPECT_EQ(hexadecimal(mamba::Integer(-1).to_bytes(3).destination, 3), "ffffff");
+  EXPECT_EQ(hexadecimal(mamba::Integer(-128).to_bytes().destination, 1), "80");
+  EXPECT_EQ(hexadecimal(mamba::Integer(255).to_bytes(1, true, false).destination, 1), "ff");
+  EXPECT_EQ(mamba::Integer(128).to_bytes().destination, nullptr);
+  EXPECT_EQ(mamba::Integer(-129).to_bytes().destination, nullptr);
+  EXPECT_EQ(mamba::Integer(-1).to_bytes(8, true, false).destination, nullptr);
+  const mamba::Integer wide = fromCells({0x04030201, 0x08070605, 0x0C0B0A09});
+  EXPECT_EQ(hexadecimal(wide.to_bytes(13).destination, 13), "000c0b0a090807060504030201");
+  const mamba::Integer negative = mamba::Integer() - wide;
+  EXPECT_EQ(hexadecimal(negative.to_bytes(13, false).destination, 13), "fffdfcfbfaf9f8f7f6f5f4f3ff");
+  EXPECT_EQ(mamba::Integer::from_bytes(negative.to_bytes(13, false), false), negative);
+  EXPECT_EQ(mamba::Integer::from_bytes(wide.to_bytes(12, true, false), true, false), wide);
+  EXPECT_EQ(mamba::Integer::from_bytes(mamba::Integer(-256).to_bytes(2)), mamba::Integer(-256));
+  EXPECT_EQ(mamba::Integer::from_bytes(mamba::Integer(-256).to_bytes(2), true, false), mamba::Integer(65280));
+
+  // The vector kernels reverse the long byte strings, and negative values invert all but their lowest bytes.
+  uint64_t state = 3;
+  for (const size_t size : {5, 9, 40, 333}) {
+    mamba::split();
+    const mamba::Integer magnitude = randomInteger(size, state) << mamba::Integer(64);
+    for (const mamba::Integer& value : {magnitude, mamba::Integer() - magnitude}) {
+      for (const bool isBigEndian : {true, false}) {
+        const mamba::GarbageCollected<std::byte> bytes = value.to_bytes(4 * size + 9, isBigEndian);
+        EXPECT_EQ(mamba::Integer::from_bytes(bytes, isBigEndian), value) << size << " cells";
+      }
+    }
+    mamba::untie();
+  }
+}
+
+TEST_F(IntegerTest, packedBytesRoundTrip) {
+  const mamba::Integer fields[] = {mamba::Integer(1), mamba::Integer(-2), mamba::Integer(300), mamba::Integer(-40000)};
+  const mamba::GarbageCollected<std::byte> packed = mamba::Integer::to_bytes(fields, 4, 4);
+  EXPECT_EQ(hexadecimal(packed.destination, packed.capacity), "00000001fffffffe0000012cffff63c0");
+  mamba::Integer unpacked[4];
+  EXPECT_EQ(mamba::Integer::from_bytes(packed, 4, unpacked), 4);
+  for (size_t index = 0; index < 4; ++index) EXPECT_EQ(unpacked[index], fields[index]) << index;
+  EXPECT_EQ(mamba::Integer::to_bytes(fields, 4, 1).destination, nullptr);
+
+  // The fields wider than a word share one allocation of cells.
+  uint64_t state = 8;
+  mamba::Integer wide[6], restored[6];
+  for (size_t index = 0; index < 6; ++index) {
+    wide[index] = randomInteger(4, state);
+    if (index % 2 == 1) wide[index] = mamba::Integer() - wide[index];
+  }
+  const mamba::GarbageCollected<std::byte> bytes = mamba::Integer::to_bytes(wide, 6, 20, false);
+  EXPECT_EQ(mamba::Integer::from_bytes(bytes, 20, restored, false), 6);
+  for (size_t index = 0; index < 6; ++index) EXPECT_EQ(restored[index], wide[index]) << index;
+}
@@ -0,0 +1,236 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include "context.hh"
+#include "types/Float.hh"
+#include "types/Integer.hh"
+#include "types/List.hh"
+#include "types/String.hh"
+#include "PoolFrameTest.hh"
+
+class ListTest : public PoolFrameTest {};
+
+TEST_F(ListTest, numbersStayUnboxed) {
+  mamba::List integers, floats;
+  for (int value = 0; value < 1000; ++value) {
+    integers.append(value);
+    floats.append(value * 0.5);
+  }
+  EXPECT_EQ(integers.getStorage(), mamba::ListStorage::Integers);
+  EXPECT_EQ(floats.getStorage(), mamba::ListStorage::Floats);
+  EXPECT_EQ(integers.len(), 1000U);
+  EXPECT_EQ(integers[-1], mamba::Object(999));
+  EXPECT_EQ(floats[3], mamba::Object(1.5));
+  EXPECT_EQ(integers.index(500), 500U);
+  EXPECT_EQ(integers.index(500.0), 500U);
+  EXPECT_EQ(floats.count(2), 1U);
+  EXPECT_FALSE(floats.contains(0.25));
+}
+
+TEST_F(ListTest, heterogeneousInsertBoxes) {
+  mamba::List list;
+  list.append(1);
+  list.append(2);
+  list.insert(0, 0.5);
+  EXPECT_EQ(list.getStorage(), mamba::ListStorage::Objects);
+  list.append(mamba::String("three"));
+  const mamba::Integer large = mamba::Integer(1) << mamba::Integer(100);
+  list.append(large);
+  ASSERT_EQ(list.len(), 5U);
+  EXPECT_EQ(list[0].asFloat(), mamba::Float(0.5));
+  EXPECT_EQ(list[1], mamba::Object(1.0));
+  EXPECT_TRUE(list[3].asString() == mamba::String("three"));
+  EXPECT_EQ(list[4].asInteger(), large);
+  EXPECT_EQ(list.index(mamba::Object(0x1p100)), 4U);
+
+  // An integer too large for a machine word boxes a list of integers too.
+  mamba::List integers;
+  integers.append(7);
+  integers.append(large);
+  EXPECT_EQ(integers.getStorage(), mamba::ListStorage::Objects);
+  EXPECT_EQ(integers[0], mamba::Object(7));
+}
+
+TEST_F(ListTest, emptyListAdoptsFirstElement) {
+  mamba::List list;
+  list.reserve(100);
+  list.append(2.5);
+  EXPECT_EQ(list.getStorage(), mamba::ListStorage::Floats);
+  (void)list.pop();
+  list.clear();
+  list.append(mamba::String("text"));
+  EXPECT_EQ(list.getStorage(), mamba::ListStorage::Objects);
+
+  // The emptied list of integers extended with objects counts its buffer again in the wider items.
+  mamba::List emptied, names;
+  emptied.append(1);
+  (void)emptied.pop();
+  for (const char* name : {"first", "second", "third", "fourth"}) names.append(mamba::String(name));
+  emptied.extend(names);
+  EXPECT_EQ(emptied.getStorage(), mamba::ListStorage::Objects);
+  ssize_t index = 0;
+  for (const char* name : {"first", "second", "third", "fourth"}) {
+    EXPECT_EQ(emptied[index++], mamba::Object(mamba::String(name)));
+  }
+}
+
+TEST_F(ListTest, editing) {
+  mamba::List list;
+  for (int value = 0; value < 10; ++value) list.append(value);
+  list.insert(-100, -1);
+  list.insert(100, 10);
+  list.remove(5);
+  list.set(-2, 90);
+  EXPECT_EQ(list.pop(0), mamba::Object(-1));
+  EXPECT_EQ(list.pop(), mamba::Object(10));
+  list.reverse();
+  mamba::List expected;
+  for (const int value : {90, 8, 7, 6, 4, 3, 2, 1, 0}) expected.append(value);
+  EXPECT_EQ(list, expected);
+
+  list.extend(list);
+  EXPECT_EQ(list.len(), 18U);
+  EXPECT_EQ(list.count(90), 2U);
+  const mamba::List copy = list;
+  list.extend(expected);
+  list.set(0, 0.5);
+  EXPECT_EQ(copy.len(), 18U);
+  EXPECT_EQ(copy[0], mamba::Object(90));
+  EXPECT_EQ(copy.getStorage(), mamba::ListStorage::Integers);
+  EXPECT_EQ(list.len(), 27U);
+
+  // The out-of-range indexes leave the list as it is.
+  EXPECT_EQ(list[27], mamba::Object());
+  EXPECT_EQ(list[-28], mamba::Object());
+  EXPECT_EQ(list.index(1000), SIZE_MAX);
+  EXPECT_EQ(mamba::List().pop(), mamba::Object());
+}
+
+TEST_F(ListTest, sortsUnboxedNumbers) {
+  std::mt19937_64 generator(42);
+  // The integers are built from 31-bit halves, since they have no constructor from 64-bit values.
+  const auto toInteger = [](const int64_t value) {
+    return (mamba::Integer(static_cast<int>(value >> 31)) << mamba::Integer(31)) +
+           mamba::Integer(static_cast<int>(value & 0x7FFFFFFF));
+  };
+  for (const uint64_t range : {uint64_t{1000}, uint64_t{1} << 61}) {
+    // The lists are reserved, as the pool of a test holds only a few growing lists of this size.
+    mamba::List integers, floats;
+    integers.reserve(800);
+    floats.reserve(800);
+    std::vector<int64_t> expectedIntegers;
+    std::vector<double> expectedFloats;
+    for (int index = 0; index < 800; ++index) {
+      const auto value = static_cast<int64_t>(generator() % range) - static_cast<int64_t>(range / 2);
+      expectedIntegers.push_back(value);
+      expectedFloats.push_back(static_cast<double>(value) / 3);
+      integers.append(toInteger(value));
+      floats.append(expectedFloats.back());
+    }
+    integers.sort();
+    floats.sort(true);
+    std::sort(expectedIntegers.begin(), expectedIntegers.end());
+    std::sort(expectedFloats.begin(), expectedFloats.end(), std::greater<>());
+    ASSERT_EQ(integers.getStorage(), mamba::ListStorage::Integers);
+    for (size_t index = 0; index < 800; ++index) {
+      ASSERT_EQ(integers[static_cast<ssize_t>(index)], mamba::Object(toInteger(expectedIntegers[index])));
+      ASSERT_EQ(floats[static_cast<ssize_t>(index)], mamba::Object(expectedFloats[index]));
+    }
+  }
+
+  // The negative zeros keep their places among the positive ones they equal.
+  mamba::List floats;
+  for (int index = 0; index < 300; ++index) floats.append(index % 3 == 0 ? -0.0 : (index % 3 == 1 ? 0.0 : -1.0 * index));
+  floats.sort();
+  for (ssize_t index = 0; index < 100; ++index) EXPECT_EQ(floats[index], mamba::Object(-1.0 * (299 - 3 * index)));
+  for (ssize_t index = 100; index < 300; ++index) {
+    EXPECT_EQ(std::signbit(floats[index].asFloat().operator double()), index % 2 == 0);
+  }
+}
+
+TEST_F(ListTest, sortsObjectsStably) {
+  // The equal integers and floats tell which of them came first, so the order is checked against a stable sort.
+  std::mt19937_64 generator(7);
+  for (const size_t pattern : {0, 1, 2, 3}) {
+    mamba::List list;
+    list.reserve(600);
+    std::vector<std::pair<int64_t, bool>> expected;
+    for (size_t index = 0; index < 600; ++index) {
+      int64_t value = static_cast<int64_t>(generator() % 500);
+      // Sorted runs of varying lengths, and runs that barely interleave, exercise the merges and galloping.
+      if (pattern == 1) value = static_cast<int64_t>(index % 150);
+      if (pattern == 2) value = index < 300 ? static_cast<int64_t>(index) : static_cast<int64_t>(600 - index);
+      if (pattern == 3) value = static_cast<int64_t>((index * 7) % 600 / 20);
+      const bool isFloat = generator() % 2 == 0;
+      expected.emplace_back(value, isFloat);
+      if (isFloat) list.append(static_cast<double>(value));
+      else list.append(mamba::Integer(value));
+    }
+    list.sort(pattern == 3);
+    if (pattern == 3) {
+      std::stable_sort(expected.begin(), expected.end(), [](const auto& left, const auto& right) {
+        return left.first > right.first;
+      });
+    } else {
+      std::stable_sort(expected.begin(), expected.end(), [](const auto& left, const auto& right) {
+        return left.first < right.first;
+      });
+    }
+    for (size_t index = 0; index < expected.size(); ++index) {
+      const mamba::Object item = list[static_cast<ssize_t>(index)];
+      ASSERT_EQ(item.getType(), expected[index].second ? mamba::ObjectType::Float : mamba::ObjectType::Integer);
+      ASSERT_EQ(item, mamba::Object(mamba::Integer(expected[index].first)));
+    }
+  }
+
+  // The large integers are ordered with the floats by their exact values.
+  const mamba::Integer large = (mamba::Integer(1) << mamba::Integer(64)) + mamba::Integer(1);
+  const mamba::Integer negative = mamba::Integer(0) - large;
+  mamba::List list;
+  for (const mamba::Object& item : {mamba::Object(0x1p64), mamba::Object(large), mamba::Object(negative),
+                                     mamba::Object(-0x1p70), mamba::Object(2.5), mamba::Object(2)}) {
+    list.append(item);
+  }
+  list.sort();
+  EXPECT_EQ(list[0], mamba::Object(-0x1p70));
+  EXPECT_EQ(list[1], mamba::Object(negative));
+  EXPECT_EQ(list[2], mamba::Object(2));
+  EXPECT_EQ(list[3], mamba::Object(2.5));
+  EXPECT_EQ(list[4], mamba::Object(0x1p64));
+  EXPECT_EQ(list[5], mamba::Object(large));
+}
+
+TEST_F(ListTest, sortsStrings) {
+  std::mt19937_64 generator(3);
+  mamba::List list;
+  std::vector<std::string> expected;
+  for (int index = 0; index < 150; ++index) {
+    // The strings share long prefixes, so that many of them tie on the cached bytes.
+    std::string text = index % 2 == 0 ? "prefix-shared-" : "pre";
+    for (uint64_t length = generator() % 4; length > 0; --length) text += static_cast<char>('a' + generator() % 3);
+    if (index % 50 == 0) text += "\xC3\xA9";
+    expected.push_back(text);
+    list.append(mamba::String(std::string_view(text)));
+  }
+  list.sort();
+  std::sort(expected.begin(), expected.end());
+  for (size_t index = 0; index < expected.size(); ++index) {
+    ASSERT_TRUE(list[static_cast<ssize_t>(index)].asString() == mamba::String(std::string_view(expected[index])));
+  }
+  EXPECT_TRUE(mamba::String("ab") < mamba::String("abc"));
+  EXPECT_TRUE(mamba::String("\xC3\xA9") > mamba::String("z"));
+  EXPECT_TRUE(mamba::String("") <= mamba::String(""));
+}
+
+TEST_F(ListTest, sortRejectsUnorderableTypes) {
+  mamba::List list;
+  list.append(2);
+  list.append(mamba::String("one"));
+  list.append(1);
+  const mamba::List copy = list;
+  list.sort();
+  EXPECT_EQ(list, copy);
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <string_view>
+#include "givers/memory.hh"
+#include "types/String.hh"
+
+/// Runs every test in its own memory frame, dropping whatever it allocated on the shared pool.
+class PoolFrameTest : public testing::Test {
+ protected:
+  void SetUp() override { mamba::split(); }
+  void TearDown() override { mamba::untie(); }
+};
+
+/// Exposes the bytes of the string for comparison.
+inline std::string_view view(const mamba::String& text) {
+  return {text.begin(), static_cast<size_t>(text.end() - text.begin())};
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "context.hh"
+#include "types/Sets.hh"
+#include "types/String.hh"
+#include "PoolFrameTest.hh"
+
+class SetsTest : public PoolFrameTest {};
+
+/// Builds the set of the integers from the first up to the last, excluding it, in the step.
+mamba::Set makeRange(const int first, const int last, const int step = 1) {
+  mamba::Set result;
+  for (int element = first; element < last; element += step) result.add(element);
+  return result;
+}
+
+TEST_F(SetsTest, addingAndRemoving) {
+  mamba::Set set = makeRange(0, 200);
+  set.add(10.0);
+  set.add(199);
+  EXPECT_EQ(set.len(), 200U);
+  EXPECT_TRUE(set.contains(150));
+  EXPECT_TRUE(set.contains(150.0));
+  EXPECT_FALSE(set.contains(200));
+  set.add(mamba::String("name"));
+  set.add(mamba::Object());
+  EXPECT_TRUE(set.contains(mamba::String("name")));
+  EXPECT_TRUE(set.contains(mamba::Object()));
+  set.remove(mamba::String("name"));
+  set.discard(mamba::Object());
+  set.discard(mamba::Object());
+  set.remove(-1);
+  for (int element = 0; element < 200; element += 2) set.remove(element);
+  EXPECT_EQ(set.len(), 100U);
+  EXPECT_FALSE(set.contains(0));
+  EXPECT_TRUE(set.contains(1));
+
+  // Churning an element reuses the deleted slots rather than growing the table for good.
+  for (int round = 0; round < 10000; ++round) {
+    set.add(-5 - round % 3);
+    set.discard(-5 - round % 3);
+  }
+  EXPECT_EQ(set.len(), 100U);
+  EXPECT_EQ(set.elements().len(), 100U);
+
+  mamba::Set popped;
+  while (set.len() > 0) popped.add(set.pop());
+  EXPECT_TRUE(popped == makeRange(1, 200, 2));
+  EXPECT_EQ(set.pop(), mamba::Object());
+
+  mamba::List items;
+  for (int item = 0; item < 40; ++item) items.append(item % 7);
+  EXPECT_TRUE(mamba::Set(items) == makeRange(0, 7));
+}
+
+TEST_F(SetsTest, setAlgebra) {
+  const mamba::Set multiples = makeRange(0, 100, 2), odd = makeRange(1, 100, 2), large = makeRange(50, 150);
+  EXPECT_TRUE((multiples | large) == (large | multiples));
+  EXPECT_EQ((multiples | large).len(), 125U);
+  EXPECT_TRUE((multiples & large) == makeRange(50, 100, 2));
+  EXPECT_TRUE((large & multiples) == makeRange(50, 100, 2));
+  EXPECT_TRUE((multiples - large) == makeRange(0, 50, 2));
+  EXPECT_EQ((large - multiples).len(), 75U);
+  EXPECT_FALSE((large - multiples).contains(60));
+  EXPECT_TRUE((large - multiples).contains(61));
+  EXPECT_EQ((multiples & odd).len(), 0U);
+  EXPECT_TRUE((multiples | odd) == makeRange(0, 100));
+  EXPECT_TRUE((multiples - mamba::Set()) == multiples);
+  EXPECT_TRUE((mamba::Set() - multiples) == mamba::Set());
+
+  EXPECT_TRUE(makeRange(50, 100, 3).issubset(large));
+  EXPECT_FALSE(multiples.issubset(large));
+  EXPECT_TRUE(mamba::Set().issubset(odd));
+
+  mamba::Set merged = odd;
+  merged.update(multiples);
+  merged.update(merged);
+  EXPECT_EQ(merged.len(), 100U);
+  EXPECT_EQ(odd.len(), 50U);
+  merged.clear();
+  EXPECT_TRUE(merged == mamba::Set());
+}
+
+TEST_F(SetsTest, frozensetsHashLikePython) {
+  EXPECT_EQ(mamba::Frozenset().hash(), 133146708735736U);
+  mamba::List items;
+  for (int item = 3; item > 0; --item) items.append(item);
+  const mamba::Frozenset small(items);
+  EXPECT_EQ(small.hash(), static_cast<size_t>(-272375401224217160));
+  mamba::Set mixed;
+  mixed.add(-1);
+  mixed.add(0.5);
+  EXPECT_EQ(mamba::Frozenset(mixed).hash(), static_cast<size_t>(-201126909462601672));
+  const mamba::Frozenset range(makeRange(0, 100));
+  EXPECT_EQ(range.hash(), 4411996150312757951U);
+
+  // The order of the insertion does not matter, and the cached hashes tell the unequal frozensets apart.
+  mamba::Set reversed;
+  for (int element = 99; element >= 0; --element) reversed.add(element);
+  EXPECT_TRUE(mamba::Frozenset(reversed) == range);
+  EXPECT_FALSE(range == mamba::Frozenset(makeRange(0, 99)));
+  EXPECT_TRUE((range & small) == small);
+  EXPECT_EQ((range - small).len(), 97U);
+  EXPECT_TRUE((small | range).issubset(range));
+  EXPECT_TRUE(range.contains(42.0));
+}
@@ -0,0 +1,299 @@
+#include <string>
+#include <gtest/gtest.h>
+#include "types/String.hh"
+#include "types/help/builder.hh"
+#include "PoolFrameTest.hh"
+
+class StringTest : public PoolFrameTest {};
+
+TEST_F(StringTest, findInAsciiText) {
+  const mamba::String text = "The quick brown fox jumps over the lazy dog";
+  EXPECT_EQ(text.find("quick"), 4);
+  EXPECT_EQ(text.find("the"), 31);
+  EXPECT_EQ(text.find("cat"), -1);
+  EXPECT_EQ(text.find("o", 13), 17);
+  EXPECT_EQ(text.find("fox", 0, 18), -1);
+  EXPECT_EQ(text.find(""), 0);
+  EXPECT_EQ(text.find("", 43), 43);
+  EXPECT_EQ(text.find("", 44), -1);
+}
+
+TEST_F(StringTest, rfindInAsciiText) {
+  const mamba::String text = "abcabcabc";
+  EXPECT_EQ(text.rfind("abc"), 6);
+  EXPECT_EQ(text.rfind("abc", 0, 8), 3);
+  EXPECT_EQ(text.rfind("c", 0, 2), -1);
+  EXPECT_EQ(text.rfind(""), 9);
+  EXPECT_EQ(text.rindex("bca"), 4);
+  EXPECT_EQ(text.index("cab"), 2);
+}
+
+TEST_F(StringTest, searchReturnsGraphemeIndexes) {
+  const mamba::String text = "Привіт, світе! Ще раз світе";
+  EXPECT_EQ(text.len(), 27);
+  EXPECT_EQ(text.find("світе"), 8);
+  EXPECT_EQ(text.rfind("світе"), 22);
+  EXPECT_EQ(text.find("світе", 9), 22);
+  EXPECT_EQ(text.find("!"), 13);
+  EXPECT_EQ(text.count("і"), 3);
+}
+
+TEST_F(StringTest, searchAcrossVectorBlocks) {
+  std::string haystack(300, 'x');
+  haystack.replace(200, 6, "needle");
+  haystack.replace(37, 6, "needle");
+  const mamba::String text = std::string_view(haystack);
+  EXPECT_EQ(text.find("needle"), 37);
+  EXPECT_EQ(text.rfind("needle"), 200);
+  EXPECT_EQ(text.find("needle", 38), 200);
+  EXPECT_EQ(text.rfind("needle", 0, 205), 37);
+  EXPECT_EQ(text.count("needle"), 2);
+  EXPECT_EQ(text.count("x"), 288);
+  EXPECT_EQ(text.count(""), 301);
+}
+
+TEST_F(StringTest, pathologicalPatternsFallBackToTwoWay) {
+  const std::string haystack = std::string(20000, 'a') + "b" + std::string(100, 'a');
+  const std::string periodicTail = "ab" + std::string(101, 'a'), periodicHead = "b" + std::string(99, 'a');
+  const mamba::String text = std::string_view(haystack);
+  const mamba::Needle needle = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab";
+  EXPECT_EQ(text.find(needle), 19961);
+  EXPECT_EQ(text.rfind(needle), 19961);
+  EXPECT_EQ(text.find(mamba::Needle(periodicTail)), -1);
+  EXPECT_EQ(text.rfind(mamba::Needle(periodicHead)), 20000);
+  EXPECT_EQ(text.count(needle), 1);
+}
+
+TEST_F(StringTest, membership) {
+  const mamba::String text = "lorem ipsum dolor";
+  EXPECT_TRUE(mamba::String("ipsum").in(text));
+  EXPECT_FALSE(mamba::String("dolores").in(text));
+  EXPECT_TRUE(mamba::String("").in(text));
+}
+
+TEST_F(StringTest, asciiCaseConversions) {
+  const std::string sentence = "Hello, World! 123 the QUICK brown fox's tail jumps over the lazy dog";
+  const mamba::String text = std::string_view(sentence);
+  EXPECT_EQ(view(text.lower()), "hello, world! 123 the quick brown fox's tail jumps over the lazy dog");
+  EXPECT_EQ(view(text.upper()), "HELLO, WORLD! 123 THE QUICK BROWN FOX'S TAIL JUMPS OVER THE LAZY DOG");
+  EXPECT_EQ(view(text.swapcase()), "hELLO, wORLD! 123 THE quick BROWN FOX'S TAIL JUMPS OVER THE LAZY DOG");
+  EXPECT_EQ(view(text.title()), "Hello, World! 123 The Quick Brown Fox'S Tail Jumps Over The Lazy Dog");
+  EXPECT_EQ(view(text.capitalize()), "Hello, world! 123 the quick brown fox's tail jumps over the lazy dog");
+  EXPECT_EQ(view(text.casefold()), view(text.lower()));
+}
+
+TEST_F(StringTest, unchangedCaseConversionsShareTheString) {
+  const mamba::String text = "already lowercase text, 42";
+  EXPECT_EQ(text.lower().data(), text.data());
+  EXPECT_EQ(text.casefold().data(), text.data());
+  EXPECT_NE(text.upper().data(), text.data());
+}
+
+TEST_F(StringTest, unicodeCaseConversions) {
+  const mamba::String german = "Straße";
+  EXPECT_EQ(view(german.upper()), "STRASSE");
+  EXPECT_EQ(german.upper().len(), 7);
+  EXPECT_EQ(view(german.casefold()), "strasse");
+  EXPECT_EQ(view(mamba::String("ΟΔΟΣ ΣΑΣ").lower()), "οδος σας");
+  EXPECT_EQ(view(mamba::String("Київ і Львів").upper()), "КИЇВ І ЛЬВІВ");
+  EXPECT_EQ(view(mamba::String("ǆemal ﬁsh").title()), "ǅemal Fish");
+  EXPECT_EQ(view(mamba::String("ÉCOLE").swapcase()), "école");
+  EXPECT_EQ(view(mamba::String("éCOLE").capitalize()), "École");
+  EXPECT_EQ(view(mamba::String("K").lower()), "k"); // Kelvin sign lowers into ASCII.
+}
+
+TEST_F(StringTest, asciiPredicates) {
+  const std::string identifier = "snake_case_identifier_with_digits_0123456789_and_more_of_them";
+  const std::string sentence = "This Is A Title Spanning Several Vector Blocks Of Text";
+  EXPECT_TRUE(mamba::String(std::string_view(identifier)).isidentifier());
+  EXPECT_TRUE(mamba::String(std::string_view(identifier)).islower());
+  EXPECT_FALSE(mamba::String(std::string_view(identifier)).isalnum());
+  EXPECT_FALSE(mamba::String("9lives").isidentifier());
+  EXPECT_TRUE(mamba::String(std::string_view(sentence)).istitle());
+  EXPECT_FALSE(mamba::String(std::string_view(sentence + "oF")).istitle());
+  EXPECT_TRUE(mamba::String("01234567890123456789012345678901234567890").isdigit());
+  EXPECT_FALSE(mamba::String("0123456789012345678901234567890123456789-").isdecimal());
+  EXPECT_TRUE(mamba::String(" \t\r\n\x0b\x0c\x1c                                ").isspace());
+  EXPECT_FALSE(mamba::String("visible text with a line break at the end\n").isprintable());
+  EXPECT_TRUE(mamba::String("UPPER CASE TEXT 42, WITH PUNCTUATION!").isupper());
+  EXPECT_FALSE(mamba::String("1234").isupper());
+}
+
+TEST_F(StringTest, unicodePredicates) {
+  EXPECT_TRUE(mamba::String("Жовтень").isalpha());
+  EXPECT_TRUE(mamba::String("Жовтень").istitle());
+  EXPECT_TRUE(mamba::String("ǅemal").istitle());
+  EXPECT_TRUE(mamba::String("²³").isdigit());
+  EXPECT_FALSE(mamba::String("²³").isdecimal());
+  EXPECT_TRUE(mamba::String("¾٣").isnumeric());
+  EXPECT_TRUE(mamba::String("٣٤").isdecimal());
+  EXPECT_TRUE(mamba::String("变量_1").isidentifier());
+  EXPECT_TRUE(mamba::String("　 ").isspace());
+  EXPECT_FALSE(mamba::String("non breaking").isprintable());
+  EXPECT_TRUE(mamba::String("àbc and plenty of ascii letters after the accent").islower());
+  EXPECT_FALSE(mamba::String("àbc and plenty of ascii letters after the accenT").islower());
+}
+
+TEST_F(StringTest, emptyStringPredicates) {
+  const mamba::String empty;
+  EXPECT_TRUE(empty.isascii());
+  EXPECT_TRUE(empty.isprintable());
+  EXPECT_FALSE(empty.isalpha());
+  EXPECT_FALSE(empty.isspace());
+  EXPECT_FALSE(empty.islower());
+  EXPECT_FALSE(empty.isidentifier());
+}
+
+TEST_F(StringTest, hashOfEqualStrings) {
+  EXPECT_EQ(mamba::String().hash(), 0);
+  const std::string longText(200, 'k');
+  for (const std::string& text : {std::string("a"), std::string("key"), std::string("sixteen letters!"),
+                                  std::string("ключ словаря"), longText}) {
+    const mamba::String first(text), second(text);
+    EXPECT_EQ(first.hash(), second.hash());
+    EXPECT_NE(first.hash(), 0);
+    EXPECT_TRUE(first == second);
+  }
+  EXPECT_NE(mamba::String("key").hash(), mamba::String("kez").hash());
+  EXPECT_NE(mamba::String(longText).hash(), mamba::String(longText + "k").hash());
+  EXPECT_FALSE(mamba::String("key") == mamba::String("kez"));
+}
+
+TEST_F(StringTest, hashIsResetWhenReplaced) {
+  mamba::String text = "first key";
+  const size_t first = text.hash();
+  text = "second key";
+  EXPECT_NE(text.hash(), first);
+  EXPECT_EQ(text.hash(), mamba::String("second key").hash());
+  mamba::String moved = std::move(text);
+  EXPECT_EQ(moved.hash(), mamba::String("second key").hash());
+}
+
+TEST_F(StringTest, formatReplacementFields) {
+  const mamba::String values[] = {"spam", "ünï", "it's"};
+  const mamba::String names[] = {"food"};
+  const mamba::FormatArguments arguments{values, 3, names, values, 1};
+  EXPECT_EQ(view(mamba::String("{} and {}").format(arguments)), "spam and ünï");
+  EXPECT_EQ(view(mamba::String("{1}{0}{1} {{}} {food}!").format(arguments)), "ünïspamünï {} spam!");
+  EXPECT_EQ(view(mamba::String("[{:>6}|{:*^8}|{:.2}]").format(arguments)), "[  spam|**ünï***|it]");
+  EXPECT_EQ(view(mamba::String("[{0:06}|{1:★<5}|{2:5.1}]").format(arguments)), "[spam00|ünï★★|i    ]");
+  EXPECT_EQ(view(mamba::String("{2!r} {1!a} {0!r:.3}").format(arguments)), "\"it's\" '\\xfcn\\xef' 'sp");
+
+  const mamba::String formatted = mamba::String("{1:>5}").format(arguments);
+  EXPECT_EQ(formatted.len(), 5);
+  EXPECT_FALSE(formatted.isascii());
+}
+
+TEST_F(StringTest, formatRejectsMalformedTemplates) {
+  const mamba::String values[] = {"spam"};
+  const mamba::FormatArguments arguments{values, 1};
+  for (const char* pattern : {"{", "}", "{0", "{0:d}", "{:+}", "{0}{}", "{!x}", "{1}", "{name}", "{:{}}"}) {
+    EXPECT_EQ(mamba::String(pattern).format(arguments).len(), 0) << pattern;
+  }
+}
+
+TEST_F(StringTest, percentFormatting) {
+  const mamba::String values[] = {"spam", "ünï"};
+  EXPECT_EQ(view(mamba::String("Hello, %s!") % values[0]), "Hello, spam!");
+  const mamba::String more[] = {"spam", "ünï", "eggs", "ünï", "x"};
+  EXPECT_EQ(view(mamba::String("[%6s|%-5s|%.2s|%r|%%|%c]") % mamba::FormatArguments{more, 5}),
+            "[  spam|ünï  |eg|'ünï'|%|x]");
+  const mamba::String names[] = {"food"};
+  EXPECT_EQ(view(mamba::String("%(food)s=%(food)a") % mamba::FormatArguments{nullptr, 0, names, more, 1}),
+            "spam='spam'");
+  EXPECT_EQ(view(mamba::String("%s %s") % mamba::FormatArguments{more, 5}), "");
+  EXPECT_EQ(view(mamba::String("%d") % values[0]), "");
+  EXPECT_EQ(view(mamba::String("%s %s") % values[0]), "");
+  EXPECT_EQ(view(mamba::String("%y") % values[0]), "");
+}
+
+TEST_F(StringTest, builderAppendsTrustedPieces) {
+  mamba::StringBuilder builder;
+  const mamba::String text = "héllo wörld";
+  (void)builder.append(text, 6, 100).appendCharacter(0x1F600).appendCharacter('!', 3).appendInteger(INT64_MIN);
+  (void)builder.append(text, 0, 5).appendInteger(0).appendUTF8("ß", 2).append(mamba::String());
+  EXPECT_EQ(builder.len(), 36);
+  const mamba::String built = builder.build();
+  EXPECT_EQ(view(built), "wörld😀!!!-9223372036854775808héllo0ß");
+  EXPECT_EQ(built.len(), 36);
+  EXPECT_FALSE(built.isascii());
+  EXPECT_EQ(built.find("ß"), 35);
+  EXPECT_EQ(builder.len(), 0);
+
+  const mamba::String ascii = builder.appendInteger(42).append(text, 0, 1).build();
+  EXPECT_EQ(view(ascii), "42h");
+  EXPECT_TRUE(ascii.isascii());
+  EXPECT_EQ(view(builder.appendCharacter(0xD800).build()), "");
+  mamba::StringBuilder huge;
+  EXPECT_EQ(view(huge.appendCharacter(0x1F600, SIZE_MAX / 2).build()), "");
+}
+
+TEST_F(StringTest, concatenationAndRepetition) {
+  mamba::String text = "ab";
+  text += "ç";
+  EXPECT_EQ(view(text), "abç");
+  EXPECT_EQ(text.len(), 3);
+  EXPECT_EQ(view(text * 3), "abçabçabç");
+  EXPECT_EQ((text * 3).len(), 9);
+  EXPECT_EQ(view(text * 0), "");
+  EXPECT_EQ(view(mamba::String("x") + mamba::String()), "x");
+}
+
+TEST_F(StringTest, paddingMatchesPython) {
+  const mamba::String text = "abc";
+  EXPECT_EQ(view(text.center(6, "*")), "*abc**");
+  EXPECT_EQ(view(text.center(7, "é")), "ééabcéé");
+  EXPECT_EQ(view(mamba::String("ab").center(5)), "  ab ");
+  EXPECT_EQ(view(text.ljust(5, "★")), "abc★★");
+  EXPECT_EQ(text.ljust(5, "★").len(), 5);
+  EXPECT_EQ(view(text.rjust(4)), " abc");
+  EXPECT_EQ(view(text.rjust(2)), "abc");
+  EXPECT_EQ(view(text.center(6, "**")), "");
+  EXPECT_EQ(view(mamba::String("-42").zfill(5)), "-0042");
+  EXPECT_EQ(view(mamba::String("ü").zfill(3)), "00ü");
+}
+
+TEST_F(StringTest, replaceMatchesPython) {
+  const mamba::String text = "spam, spam and ëggs";
+  EXPECT_EQ(view(text.replace("spam", "ham")), "ham, ham and ëggs");
+  EXPECT_EQ(view(text.replace("spam", "ham", 1)), "ham, spam and ëggs");
+  EXPECT_EQ(view(text.replace("ëggs", "")), "spam, spam and ");
+  EXPECT_EQ(text.replace("ëggs", "").len(), 15);
+  EXPECT_EQ(view(text.replace("tea", "ham")), view(text));
+  EXPECT_EQ(view(mamba::String("äb").replace("", "-")), "-ä-b-");
+  EXPECT_EQ(view(mamba::String("äb").replace("", "-", 2)), "-ä-b");
+}
+
+TEST_F(StringTest, translateMatchesPython) {
+  const mamba::String text("The spam, ëggs and ham.\r\n");
+  const auto identifiers = mamba::String::maketrans(" ,.", "___");
+  EXPECT_EQ(view(text.translate(identifiers)), "The_spam__ëggs_and_ham_\r\n");
+  EXPECT_EQ(text.translate(identifiers).len(), text.len());
+  EXPECT_EQ(view(text.translate(mamba::String::maketrans("", "", "aeiou"))), "Th spm, ëggs nd hm.\r\n");
+  EXPECT_EQ(view(text.translate(mamba::String::maketrans("ëa", "ea", "\r"))), "The spam, eggs and ham.\n");
+  EXPECT_EQ(mamba::String("\t\u0301").translate(mamba::String::maketrans("\t", "e")).len(),
+            mamba::String("e\u0301").len());
+
+  const mamba::String keys[] = {"ë", "&", "ж", "a", "ж"};
+  const mamba::String values[] = {"e", "&amp;", "zh", "", "ž"};
+  const mamba::Translator table(keys, values, 5);
+  EXPECT_EQ(view(mamba::String("жëlt & jam").translate(table)), "želt &amp; jm");
+  EXPECT_EQ(view(mamba::String("plain text").translate(mamba::Translator())), "plain text");
+}
+
+TEST_F(StringTest, replaceAutomatonIsLeftmostLongest) {
+  const mamba::String patterns[] = {"<", ">", "&", "\"", "&lt;"};
+  const mamba::String replacements[] = {"&lt;", "&gt;", "&amp;", "&quot;", "<"};
+  const mamba::ReplacementAutomaton escaping(patterns, replacements, 4);
+  EXPECT_EQ(view(mamba::String("<a href=\"x\">&</a>").replace(escaping)),
+            "&lt;a href=&quot;x&quot;&gt;&amp;&lt;/a&gt;");
+  const mamba::ReplacementAutomaton swapping(patterns + 2, replacements + 2, 3);
+  EXPECT_EQ(view(mamba::String("&lt;&&lt").replace(swapping)), "<&amp;&amp;lt");
+
+  const mamba::String words[] = {"he", "she", "his", "hers", "sh"};
+  const mamba::String marks[] = {"1", "2", "3", "4", "5"};
+  const mamba::ReplacementAutomaton automaton(words, marks, 5);
+  EXPECT_EQ(view(mamba::String("ushers ahishe").replace(automaton)), "u2rs a31");
+  EXPECT_EQ(view(mamba::String("nothing").replace(automaton)), "nothing");
+  EXPECT_EQ(mamba::String("shë").replace(automaton).len(), 2);
+}
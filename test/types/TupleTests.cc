@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include "context.hh"
+#include "types/String.hh"
+#include "types/Tuple.hh"
+#include "PoolFrameTest.hh"
+
+class TupleTest : public PoolFrameTest {};
+
+TEST_F(TupleTest, packingAndIndexing) {
+  const mamba::Tuple pair{1, mamba::String("two")}, empty;
+  EXPECT_EQ(pair.len(), 2U);
+  EXPECT_EQ(empty.len(), 0U);
+  EXPECT_EQ(pair[0], mamba::Object(1));
+  EXPECT_TRUE(pair[-1].asString() == mamba::String("two"));
+  EXPECT_EQ(pair[2], mamba::Object());
+  EXPECT_EQ(pair[-3], mamba::Object());
+  EXPECT_EQ(empty[0], mamba::Object());
+  EXPECT_TRUE(pair.contains(1.0));
+  EXPECT_FALSE(empty.contains(mamba::Object()));
+
+  mamba::List items;
+  for (int item = 0; item < 20; ++item) items.append(item % 3);
+  const mamba::Tuple many(items);
+  EXPECT_EQ(many.len(), 20U);
+  EXPECT_EQ(many[-1], mamba::Object(1));
+  EXPECT_EQ(many.count(2), 6U);
+  EXPECT_EQ(many.index(2), 2U);
+  EXPECT_EQ(many.index(3), SIZE_MAX);
+
+  // The copies share the elements, and the equal tuples compare equal whether they hashed or not.
+  const mamba::Tuple copy = many;
+  EXPECT_TRUE(copy == many);
+  EXPECT_TRUE(mamba::Tuple(items) == many);
+  (void)many.hash();
+  EXPECT_TRUE(mamba::Tuple(items) == many);
+  items.append(0);
+  EXPECT_FALSE(mamba::Tuple(items) == many);
+  EXPECT_FALSE(pair == (mamba::Tuple{1, mamba::String("three")}));
+  EXPECT_TRUE(empty == mamba::Tuple(mamba::List()));
+}
+
+TEST_F(TupleTest, hashesLikePython) {
+  EXPECT_EQ(mamba::Tuple().hash(), 5740354900026072187U);
+  const mamba::Tuple numbers{1, 2, 3};
+  EXPECT_EQ(numbers.hash(), 529344067295497451U);
+  EXPECT_EQ(numbers.hash(), 529344067295497451U);
+  EXPECT_EQ((mamba::Tuple{0.5, -1}).hash(), 6150435046063548694U);
+  EXPECT_EQ((mamba::Tuple{1.0, 2.0, 3.0}).hash(), numbers.hash());
+}
+
+TEST_F(TupleTest, releasedBlocksAreReused) {
+  const auto* before = static_cast<const std::byte*>(mamba::gather(1, mamba::GarbageCollectionGeneration::Eden).destination);
+  for (int round = 0; round < 1000; ++round) {
+    mamba::Tuple result{round, round + 1};
+    EXPECT_EQ(result[1], mamba::Object(round + 1));
+    result.release();
+    EXPECT_EQ(result.len(), 0U);
+  }
+  // Only the first tuple took a new block, which every later one reused.
+  const auto* after = static_cast<const std::byte*>(mamba::gather(1, mamba::GarbageCollectionGeneration::Eden).destination);
+  EXPECT_LT(after - before, 100);
+
+  // The blocks of a frame are not reused once the frame is reclaimed.
+  mamba::split();
+  mamba::Tuple inner{1, 2};
+  inner.release();
+  mamba::untie();
+  const mamba::Tuple outer{3, 4};
+  const mamba::String filler("filler");
+  EXPECT_EQ(outer[0], mamba::Object(3));
+  EXPECT_EQ(outer[1], mamba::Object(4));
+}
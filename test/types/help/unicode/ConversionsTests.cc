@@ -0,0 +1,86 @@
+#include <string>
+#include <gtest/gtest.h>
+#include "types/String.hh"
+#include "../../PoolFrameTest.hh"
+
+using mamba::StringEncodingPolicy;
+
+class ConversionsTest : public PoolFrameTest {};
+
+std::string bytes(const mamba::GarbageCollected<char>& output, const bool isTerminated = false) {
+  if (output.destination == nullptr) return "<failed>";
+  return {output.destination, output.capacity - isTerminated};
+}
+
+mamba::GarbageCollected<char> encode(const std::string& text, const char* encoding,
+                                     const StringEncodingPolicy policy = StringEncodingPolicy::Strict) {
+  const size_t graphemes = mamba::countUTF8Graphemes(text.data(), text.size());
+  if (std::string_view(encoding) == "ascii") return mamba::encodeStringIntoASCII(text.data(), text.size(), graphemes, policy);
+  if (std::string_view(encoding) == "utf-16") return mamba::encodeStringIntoUTF16(text.data(), text.size(), graphemes, policy);
+  return mamba::encodeStringIntoUTF32(text.data(), text.size(), graphemes, policy);
+}
+
+TEST_F(ConversionsTest, encodeIntoUTF16AndUTF32) {
+  const std::string text = "Hello, Київ! 😀" + std::string(40, 'x');
+  const std::string utf16 = bytes(encode(text, "utf-16")), utf32 = bytes(encode(text, "utf-32"));
+  ASSERT_EQ(utf16.size(), 2 + 2 * (13 + 2 + 40));
+  EXPECT_EQ(utf16.substr(0, 6), std::string("\xFF\xFEH\0e\0", 6));
+  EXPECT_EQ(utf16.substr(16, 2), "\x1A\x04"); // К
+  EXPECT_EQ(utf16.substr(28, 4), std::string("\x3D\xD8\x00\xDE", 4)); // 😀 as a surrogate pair
+  ASSERT_EQ(utf32.size(), 4 + 4 * (14 + 40));
+  EXPECT_EQ(utf32.substr(56, 4), std::string("\x00\xF6\x01\x00", 4));
+  EXPECT_EQ(bytes(mamba::decodeUTF16IntoString(utf16.data(), utf16.size(), StringEncodingPolicy::Strict), true), text);
+  EXPECT_EQ(bytes(mamba::decodeUTF32IntoString(utf32.data(), utf32.size(), StringEncodingPolicy::Strict), true), text);
+}
+
+TEST_F(ConversionsTest, encodeIntoAsciiFollowsThePolicy) {
+  const std::string text = "naïve café 😀";
+  EXPECT_EQ(bytes(encode(text, "ascii")), "<failed>");
+  EXPECT_EQ(bytes(encode(text, "ascii", StringEncodingPolicy::Ignore)), "nave caf ");
+  EXPECT_EQ(bytes(encode(text, "ascii", StringEncodingPolicy::Replace)), "na?ve caf? ?");
+  EXPECT_EQ(bytes(encode(text, "ascii", StringEncodingPolicy::BackslashReplace)), "na\\xefve caf\\xe9 \\U0001f600");
+  EXPECT_EQ(bytes(encode(text, "ascii", StringEncodingPolicy::XMLCharRefReplace)), "na&#239;ve caf&#233; &#128512;");
+  EXPECT_EQ(bytes(encode(std::string(100, 'a'), "ascii")), std::string(100, 'a'));
+}
+
+TEST_F(ConversionsTest, decodeInvalidInputFollowsThePolicy) {
+  const std::string utf8 = "ok\xC3\x28 \xE2\x82 end";
+  EXPECT_EQ(bytes(mamba::decodeUTF8IntoString(utf8.data(), utf8.size(), StringEncodingPolicy::Strict)), "<failed>");
+  EXPECT_EQ(bytes(mamba::decodeUTF8IntoString(utf8.data(), utf8.size(), StringEncodingPolicy::Replace), true),
+            "ok\xEF\xBF\xBD( \xEF\xBF\xBD end");
+  EXPECT_EQ(bytes(mamba::decodeUTF8IntoString(utf8.data(), utf8.size(), StringEncodingPolicy::BackslashReplace), true),
+            "ok\\xc3( \\xe2\\x82 end");
+
+  const std::string utf16 = std::string("\xFE\xFF\x00h\xD8\x3D\x00i", 8); // big-endian with a lone high surrogate
+  EXPECT_EQ(bytes(mamba::decodeUTF16IntoString(utf16.data(), utf16.size(), StringEncodingPolicy::Ignore), true), "hi");
+  const std::string utf32 = std::string("a\0\0\0\0\0\x11\0", 8); // U+110000 lies beyond Unicode
+  EXPECT_EQ(bytes(mamba::decodeUTF32IntoString(utf32.data(), utf32.size(), StringEncodingPolicy::Replace), true),
+            "a\xEF\xBF\xBD");
+}
+
+TEST_F(ConversionsTest, incrementalDecoderCarriesSequencesAcrossChunks) {
+  const std::string text = "Ж😀 ok";
+  mamba::IncrementalUTF8Decoder decoder;
+  std::string decoded;
+  for (const char byte : text) decoded += view(decoder.decode(&byte, 1));
+  EXPECT_EQ(decoded, text);
+  EXPECT_EQ(decoder.getPendingSize(), 0);
+
+  EXPECT_EQ(view(decoder.decode("a\xF0\x9F", 3)), "a");
+  const mamba::String completed = decoder.decode("\x98\x80z", 3);
+  EXPECT_EQ(view(completed), "😀z");
+  EXPECT_EQ(completed.len(), 2);
+  EXPECT_FALSE(completed.isascii());
+}
+
+TEST_F(ConversionsTest, incrementalDecoderAppliesThePolicy) {
+  mamba::IncrementalUTF8Decoder decoder(StringEncodingPolicy::Replace);
+  EXPECT_EQ(view(decoder.decode("x\xE2\x82", 3)), "x");
+  EXPECT_EQ(decoder.getPendingSize(), 2);
+  EXPECT_EQ(view(decoder.decode("(", 1)), "\xEF\xBF\xBD(");
+  EXPECT_EQ(view(decoder.decode("\xC3", 1)), "");
+  EXPECT_EQ(view(decoder.decode("", 0, true)), "\xEF\xBF\xBD");
+
+  mamba::IncrementalUTF8Decoder strict;
+  EXPECT_EQ(strict.decode("\xFFinvalid", 8).len(), 0);
+}